@@ -0,0 +1,159 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+#include "lite/utils/cp_logging.h"
+
+namespace paddle {
+namespace lite_api {
+
+/*
+ * AsyncRunner runs the tasks with a fixed number of workers in the order of
+ * the submission, the argument of a task is the id of the worker running it.
+ * It serves PaddlePredictor::RunAsync and PredictorPool.
+ */
+class AsyncRunner {
+ public:
+  using Task = std::function<void(int)>;
+
+  explicit AsyncRunner(int num_threads) {
+    CHECK_GT(num_threads, 0);
+    num_workers_ = num_threads;
+    for (int i = 0; i < num_threads; i++) {
+      workers_.emplace_back(&AsyncRunner::WorkerMain, this, i);
+    }
+  }
+
+  // The pending tasks are done before the workers exit.
+  ~AsyncRunner() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    task_cond_.notify_all();
+    for (auto& worker : workers_) {
+      if (worker.joinable()) worker.join();
+    }
+  }
+
+  void Submit(Task task) {
+    // Notify under the lock, as the task may release the runner on a worker
+    // as soon as it is picked.
+    std::lock_guard<std::mutex> lock(mutex_);
+    tasks_.emplace_back(std::move(task));
+    ++num_unfinished_;
+    task_cond_.notify_one();
+  }
+
+  // Wait until all of the submitted tasks are done. It must not be called by
+  // the tasks, which would wait for themselves.
+  void Wait() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cond_.wait(lock, [this] { return num_unfinished_ == 0; });
+  }
+
+  // Whether the calling thread is one of the workers.
+  bool IsWorker() const {
+    for (auto& worker : workers_) {
+      if (worker.get_id() == std::this_thread::get_id()) return true;
+    }
+    return false;
+  }
+
+  // Wait for the tasks and release the runner, as the owner of the tasks is
+  // going away. If it is called by a task, e.g. the callback of a run drops
+  // the last reference to the predictor, the pending tasks are dropped and
+  // the workers release the runner once they exit, instead of waiting for
+  // themselves.
+  static void Release(std::shared_ptr<AsyncRunner>* runner) {
+    CHECK(runner);
+    if (!*runner) return;
+    AsyncRunner* raw = runner->get();
+    if (!raw->IsWorker()) {
+      raw->Wait();
+      runner->reset();
+      return;
+    }
+    {
+      std::lock_guard<std::mutex> lock(raw->mutex_);
+      raw->num_unfinished_ -= static_cast<int>(raw->tasks_.size());
+      raw->tasks_.clear();
+      raw->stop_ = true;
+      raw->self_ = std::move(*runner);
+      for (auto& worker : raw->workers_) {
+        worker.detach();
+      }
+      raw->task_cond_.notify_all();
+    }
+  }
+
+ private:
+  static void WorkerMain(AsyncRunner* runner, int worker_id) {
+    runner->WorkerLoop(worker_id);
+    // Keep a released runner alive until its last worker exits.
+    std::shared_ptr<AsyncRunner> self;
+    {
+      std::lock_guard<std::mutex> lock(runner->mutex_);
+      self = runner->self_;
+      if (--runner->num_workers_ == 0) runner->self_.reset();
+    }
+  }
+
+  void WorkerLoop(int worker_id) {
+    while (true) {
+      Task task;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        task_cond_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
+        if (tasks_.empty()) return;
+        task = std::move(tasks_.front());
+        tasks_.pop_front();
+      }
+      task(worker_id);
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        --num_unfinished_;
+        done_cond_.notify_all();
+      }
+    }
+  }
+
+  AsyncRunner(const AsyncRunner&) = delete;
+  AsyncRunner& operator=(const AsyncRunner&) = delete;
+
+  std::vector<std::thread> workers_;
+  std::mutex mutex_;
+  std::condition_variable task_cond_;
+  std::condition_variable done_cond_;
+  std::deque<Task> tasks_;
+  // The number of the tasks which are submitted but not finished.
+  int num_unfinished_{0};
+  // The number of the workers which have not exited.
+  int num_workers_{0};
+  bool stop_{false};
+  // Set by Release on a worker.
+  std::shared_ptr<AsyncRunner> self_;
+};
+
+}  // namespace lite_api
+}  // namespace paddle
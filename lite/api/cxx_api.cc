@@ -308,6 +308,7 @@ void Predictor::Build(const std::string &model_path,
                       const std::vector<std::string> &passes,
                       lite_api::LiteModelType model_type,
                       const lite_api::CxxModelBuffer &model_buffer) {
+  MemoryKindGuard guard(MemoryKind::kWeight);
   switch (model_type) {
     case lite_api::LiteModelType::kProtobuf: {
       bool combined_param = false;
@@ -337,6 +338,8 @@ void Predictor::Build(const std::string &model_path,
 void Predictor::Build(const std::shared_ptr<cpp::ProgramDesc> &program_desc,
                       const std::vector<Place> &valid_places,
                       const std::vector<std::string> &passes) {
+  // The weights are loaded or transformed by the passes.
+  MemoryKindGuard guard(MemoryKind::kWeight);
   program_desc_ = program_desc;
   // `inner_places` is used to optimize passes
   std::vector<Place> inner_places = valid_places;
@@ -367,9 +370,26 @@ void Predictor::Build(const std::shared_ptr<cpp::ProgramDesc> &program_desc,
   CheckPaddleOpVersions(program_desc);
 }
 
+void Predictor::PrepareShapeBuckets(
+    const std::vector<lite_api::InputShapeBucket> &buckets) {
+  if (buckets.empty()) return;
+  if (!program_generated_) {
+    GenRuntimeProgram();
+  }
+  program_->PrepareShapeBuckets(*program_desc_, input_names_, buckets);
+}
+
 void Predictor::GenRuntimeProgram() {
   program_ = optimizer_.GenRuntimeProgram();
   CHECK_EQ(exec_scope_, program_->exec_scope());
+  // The control flow ops create the programs of their sub-blocks from
+  // program_desc_, so it is updated to the optimized sub-blocks, whose vars
+  // may be renamed by memory_optimize_pass.
+  if (program_->block_size() > 1) {
+    program_->SaveToProgram(program_desc_);
+  }
+  program_->set_memory_arena(memory_arena_);
+  program_->set_inter_op_threads(inter_op_threads_);
   program_generated_ = true;
 }
 
@@ -13,12 +13,14 @@
 // limitations under the License.
 
 #pragma once
+#include <functional>
 #include <map>
 #include <memory>
 #include <mutex>  //NOLINT
 #include <string>
 #include <utility>
 #include <vector>
+#include "lite/api/async_runner.h"
 #include "lite/api/paddle_api.h"
 #include "lite/core/op_lite.h"
 #include "lite/core/optimizer.h"
@@ -156,6 +158,32 @@ class LITE_API Predictor {
 
   void GenRuntimeProgram();
 
+  // Pack the activations into the memory arenas, see RuntimeProgram.
+  void set_memory_arena(bool x) {
+    memory_arena_ = x;
+    if (program_) {
+      program_->set_memory_arena(x);
+    }
+  }
+  // Run the independent ops concurrently, see RuntimeProgram.
+  void set_inter_op_threads(int threads) {
+    inter_op_threads_ = threads;
+    if (program_) {
+      program_->set_inter_op_threads(threads);
+    }
+  }
+  // The tracer of the runtime program, see RuntimeProgram::tracer.
+  profile::Tracer* tracer() {
+    if (!program_generated_) {
+      GenRuntimeProgram();
+    }
+    return program_->tracer();
+  }
+  // Prepare the shapes and the memory of all of the buckets by running them
+  // once, see RuntimeProgram::PrepareShapeBuckets.
+  void PrepareShapeBuckets(
+      const std::vector<lite_api::InputShapeBucket>& buckets);
+
   // Run the predictor for a single batch of data.
   void Run() {
     if (!program_generated_) {
@@ -219,6 +247,8 @@ class LITE_API Predictor {
   Scope* exec_scope_;
   std::shared_ptr<RuntimeProgram> program_;
   bool program_generated_{false};
+  bool memory_arena_{false};
+  int inter_op_threads_{1};
   std::vector<std::string> input_names_;
   std::vector<std::string> output_names_;
   std::vector<Place> valid_places_;
@@ -234,6 +264,10 @@ class CxxPaddleApiImpl : public lite_api::PaddlePredictor {
       : raw_predictor_(raw_predictor) {
     status_is_cloned_ = true;
   }
+  // The runs of RunAsync use the members of this class.
+  ~CxxPaddleApiImpl() override {
+    lite_api::AsyncRunner::Release(&async_runner_);
+  }
 
   /// Create a new predictor from a config.
   void Init(const lite_api::CxxConfig& config);
@@ -273,11 +307,22 @@ class CxxPaddleApiImpl : public lite_api::PaddlePredictor {
       lite_api::LiteModelType model_type = lite_api::LiteModelType::kProtobuf,
       bool record_info = false) override;
 
+  void EnableProfiler(double sample_rate = 1.0,
+                      size_t capacity = 16384) override;
+  void DisableProfiler() override;
+  std::string GetProfilerTrace(bool clear = false) override;
+
+  void RunAsync(std::function<void()> callback = nullptr) override;
+  void WaitAsync() override;
+
  private:
   std::shared_ptr<Predictor> raw_predictor_;
   lite_api::CxxConfig config_;
   std::mutex mutex_;
   bool status_is_cloned_;
+  // Created by the first RunAsync.
+  std::once_flag async_runner_flag_;
+  std::shared_ptr<lite_api::AsyncRunner> async_runner_;
 };
 
 /*
@@ -18,6 +18,8 @@
 #include <string>
 #include "lite/api/paddle_api.h"
 #include "lite/core/device_info.h"
+#include "lite/core/kernel_tuner.h"
+#include "lite/core/mir/embedding_quant_pass.h"
 #include "lite/core/mir/pass_manager.h"
 #include "lite/core/mir/post_quant_dynamic_pass.h"
 #include "lite/core/version.h"
@@ -88,11 +90,20 @@ void CxxPaddleApiImpl::Init(const lite_api::CxxConfig &config) {
       CHECK(pass);
       pass->SetQuantType(config.quant_type());
     }
+    if (config.embedding_quant_type() != lite_api::EmbeddingQuantType::NONE) {
+      passes.push_back("embedding_quant_pass");
+      auto *pass = mir::PassManager::Global().LookUp<mir::EmbeddingQuantPass>(
+          "embedding_quant_pass");
+      CHECK(pass);
+      pass->SetQuantType(config.embedding_quant_type());
+    }
     raw_predictor_->Build(config, places, passes);
   } else {
     raw_predictor_->PrepareFeedFetch();
     CHECK(raw_predictor_) << "The Predictor can not be nullptr in Clone mode.";
   }
+  raw_predictor_->set_memory_arena(config.memory_arena());
+  raw_predictor_->set_inter_op_threads(config.inter_op_threads());
   mode_ = config.power_mode();
   threads_ = config.threads();
 #ifdef LITE_WITH_NPU
@@ -132,6 +143,10 @@ void CxxPaddleApiImpl::Init(const lite_api::CxxConfig &config) {
           << real_num_threads;
 #endif
 
+  if (!config.kernel_tune_file().empty()) {
+    lite::KernelTuner::Global().Enable(config.kernel_tune_file());
+  }
+
   auto preferred_inputs = config.preferred_inputs_for_warmup();
   for (auto &preferred_input : preferred_inputs) {
     auto &input_tensors = preferred_input.second;
@@ -176,6 +191,12 @@ void CxxPaddleApiImpl::Init(const lite_api::CxxConfig &config) {
     }
     Run();
   }
+
+#ifdef LITE_WITH_ARM
+  lite::DeviceInfo::Global().SetRunMode(mode_, threads_);
+#endif
+  raw_predictor_->PrepareShapeBuckets(config.input_shape_buckets());
+  lite::KernelTuner::Global().Flush();
 }
 
 std::unique_ptr<lite_api::Tensor> CxxPaddleApiImpl::GetInput(int i) {
@@ -206,6 +227,23 @@ void CxxPaddleApiImpl::Run() {
   lite::DeviceInfo::Global().SetRunMode(mode_, threads_);
 #endif
   raw_predictor_->Run();
+  lite::KernelTuner::Global().Flush();
+}
+
+void CxxPaddleApiImpl::RunAsync(std::function<void()> callback) {
+  std::call_once(async_runner_flag_, [this] {
+    async_runner_ = std::make_shared<lite_api::AsyncRunner>(1);
+  });
+  async_runner_->Submit([this, callback](int) {
+    Run();
+    if (callback) callback();
+  });
+}
+
+void CxxPaddleApiImpl::WaitAsync() {
+  if (async_runner_) {
+    async_runner_->Wait();
+  }
 }
 
 std::shared_ptr<lite_api::PaddlePredictor> CxxPaddleApiImpl::Clone() {
@@ -251,6 +289,23 @@ void CxxPaddleApiImpl::SaveOptimizedModel(const std::string &model_dir,
   raw_predictor_->SaveModel(model_dir, model_type, record_info);
 }
 
+void CxxPaddleApiImpl::EnableProfiler(double sample_rate, size_t capacity) {
+  raw_predictor_->tracer()->Enable(sample_rate, capacity);
+}
+
+void CxxPaddleApiImpl::DisableProfiler() {
+  raw_predictor_->tracer()->Disable();
+}
+
+std::string CxxPaddleApiImpl::GetProfilerTrace(bool clear) {
+  auto* tracer = raw_predictor_->tracer();
+  std::string trace = tracer->ExportChromeTrace();
+  if (clear) {
+    tracer->Clear();
+  }
+  return trace;
+}
+
 }  // namespace lite
 
 namespace lite_api {
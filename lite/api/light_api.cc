@@ -15,17 +15,24 @@
 #include "lite/api/light_api.h"
 #include <algorithm>
 #include <map>
+#include <set>
 
 namespace paddle {
 namespace lite {
 
 void LightPredictor::Build(const std::string& lite_model_file,
-                           bool model_from_memory) {
+                           bool model_from_memory,
+                           bool use_mmap) {
+  MemoryKindGuard guard(MemoryKind::kWeight);
   if (model_from_memory) {
     LoadModelNaiveFromMemory(
         lite_model_file, scope_.get(), program_desc_.get());
   } else {
-    LoadModelNaiveFromFile(lite_model_file, scope_.get(), program_desc_.get());
+    LoadModelNaiveFromFile(
+        lite_model_file, scope_.get(), program_desc_.get(), use_mmap);
+    if (use_mmap) {
+      AdviseEmbeddingTables();
+    }
   }
 
   // For weight quantization of post training, load the int8/16 weights
@@ -33,7 +40,38 @@ void LightPredictor::Build(const std::string& lite_model_file,
   DequantizeWeight();
   BuildRuntimeProgram(program_desc_);
   PrepareFeedFetch();
-  program_desc_.reset();
+}
+
+LightPredictor::LightPredictor(
+    const std::shared_ptr<cpp::ProgramDesc>& program_desc,
+    const std::shared_ptr<Scope>& root,
+    const std::vector<std::string>& var_names)
+    : scope_(root), program_desc_(program_desc) {
+  CHECK(program_desc_);
+  CHECK(scope_);
+  BuildRuntimeProgram(program_desc_, var_names);
+  PrepareFeedFetch();
+}
+
+std::unique_ptr<LightPredictor> LightPredictor::Clone(
+    const std::vector<std::string>& var_names) const {
+  CHECK(program_desc_) << "The program desc is released, create the predictor "
+                          "with MobileConfig::set_enable_clone to clone it.";
+  // The weights are dequantized and the feed and fetch vars are created in
+  // the root scope already, so only the runtime program is built.
+  std::unique_ptr<LightPredictor> predictor(
+      new LightPredictor(program_desc_, scope_, var_names));
+  predictor->program_->set_memory_arena(program_->memory_arena());
+  predictor->program_->set_inter_op_threads(program_->inter_op_threads());
+  predictor->PrepareShapeBuckets(input_shape_buckets_);
+  return predictor;
+}
+
+void LightPredictor::PrepareShapeBuckets(
+    const std::vector<lite_api::InputShapeBucket>& buckets) {
+  CHECK(program_desc_) << "The program desc is released.";
+  input_shape_buckets_ = buckets;
+  program_->PrepareShapeBuckets(*program_desc_, input_names_, buckets);
 }
 
 void LightPredictor::Build(const std::string& model_dir,
@@ -41,6 +79,7 @@ void LightPredictor::Build(const std::string& model_dir,
                            const std::string& param_buffer,
                            lite_api::LiteModelType model_type,
                            bool model_from_memory) {
+  MemoryKindGuard guard(MemoryKind::kWeight);
   switch (model_type) {
 #ifndef LITE_ON_TINY_PUBLISH
     case lite_api::LiteModelType::kProtobuf:
@@ -136,8 +175,11 @@ void LightPredictor::PrepareFeedFetch() {
 }
 
 void LightPredictor::BuildRuntimeProgram(
-    const std::shared_ptr<const cpp::ProgramDesc>& program_desc) {
+    const std::shared_ptr<const cpp::ProgramDesc>& program_desc,
+    const std::vector<std::string>& private_var_names) {
   auto* exe_scope = &scope_->NewScope();
+  std::set<std::string> private_vars(private_var_names.begin(),
+                                     private_var_names.end());
   // Prepare workspace
   scope_->Var("feed")->GetMutable<std::vector<lite::Tensor>>();
   scope_->Var("fetch")->GetMutable<std::vector<lite::Tensor>>();
@@ -153,7 +195,12 @@ void LightPredictor::BuildRuntimeProgram(
         exe_scope->Var(var_desc->Name());
       } else {
         if (var_desc->Name() == "feed" || var_desc->Name() == "fetch") continue;
-        scope_->Var(var_desc->Name());
+        auto* var = scope_->Var(var_desc->Name());
+        if (private_vars.count(var_desc->Name())) {
+          // The ops are attached to the private copy in the exec scope.
+          auto* private_var = exe_scope->Var(var_desc->Name());
+          private_var->GetMutable<Tensor>()->CopyDataFrom(var->Get<Tensor>());
+        }
       }
     }
   }
@@ -162,6 +209,23 @@ void LightPredictor::BuildRuntimeProgram(
   program_.reset(new RuntimeProgram(program_desc, exe_scope, kRootBlockIdx));
 }
 
+void LightPredictor::AdviseEmbeddingTables() {
+  static const std::set<std::string> embedding_ops{
+      "lookup_table", "lookup_table_v2", "fused_embedding_seq_pool"};
+  for (size_t i = 0; i < program_desc_->BlocksSize(); i++) {
+    auto* block = program_desc_->GetBlock<cpp::BlockDesc>(i);
+    for (size_t k = 0; k < block->OpsSize(); ++k) {
+      auto* op_desc = block->GetOp<cpp::OpDesc>(k);
+      if (!embedding_ops.count(op_desc->Type())) continue;
+      auto* var = scope_->FindVar(op_desc->Input("W").front());
+      if (!var) continue;
+      const auto& table = var->Get<lite::Tensor>();
+      model_parser::MappedFile::AdviseRandomAccess(table.raw_data(),
+                                                   table.memory_size());
+    }
+  }
+}
+
 void LightPredictor::DequantizeWeight() {
   std::shared_ptr<const cpp::ProgramDesc> program_desc = program_desc_;
 #define PROCESS_CONV2D_DATA()                                             \
@@ -19,11 +19,14 @@
 #pragma once
 
 #include <algorithm>
+#include <functional>
 #include <map>
 #include <memory>
+#include <mutex>  // NOLINT
 #include <string>
 #include <utility>
 #include <vector>
+#include "lite/api/async_runner.h"
 #include "lite/api/paddle_api.h"
 #include "lite/core/context.h"
 #include "lite/core/program.h"
@@ -42,12 +45,14 @@ class LITE_API LightPredictor {
  public:
   // constructor function of LightPredictor, `lite_model_file` refers to data in
   // model file or buffer,`model_from_memory` refers to whther to load model
-  // from memory.
+  // from memory, `use_mmap` refers to whether to map the model file into
+  // memory.
   LightPredictor(const std::string& lite_model_file,
-                 bool model_from_memory = false) {
+                 bool model_from_memory = false,
+                 bool use_mmap = false) {
     scope_ = std::make_shared<Scope>();
     program_desc_ = std::make_shared<cpp::ProgramDesc>();
-    Build(lite_model_file, model_from_memory);
+    Build(lite_model_file, model_from_memory, use_mmap);
   }
 
   // NOTE: This is a deprecated API and will be removed in latter release.
@@ -64,6 +69,29 @@ class LITE_API LightPredictor {
 
   void Run() { program_->Run(); }
 
+  // Create a predictor which shares the program desc and the persistable vars
+  // of the root scope with this one, and owns its exec scope and runtime
+  // program. The persistable vars in `var_names` are copied into the exec
+  // scope of the new predictor instead of being shared.
+  std::unique_ptr<LightPredictor> Clone(
+      const std::vector<std::string>& var_names = {}) const;
+  // Release the program desc once the predictor is prepared. Afterwards the
+  // predictor can neither be cloned nor prepare the shape buckets.
+  void ReleaseProgramDesc() { program_desc_.reset(); }
+
+  // Pack the activations into the memory arenas, see RuntimeProgram.
+  void set_memory_arena(bool x) { program_->set_memory_arena(x); }
+  // Run the independent ops concurrently, see RuntimeProgram.
+  void set_inter_op_threads(int threads) {
+    program_->set_inter_op_threads(threads);
+  }
+  // The tracer of the runtime program, see RuntimeProgram::tracer.
+  profile::Tracer* tracer() { return program_->tracer(); }
+  // Prepare the shapes and the memory of all of the buckets by running them
+  // once, see RuntimeProgram::PrepareShapeBuckets.
+  void PrepareShapeBuckets(
+      const std::vector<lite_api::InputShapeBucket>& buckets);
+
   // Get offset-th col of feed inputs.
   Tensor* GetInput(size_t offset);
   // get input by name.
@@ -84,7 +112,8 @@ class LITE_API LightPredictor {
 
  private:
   void Build(const std::string& lite_model_file,
-             bool model_from_memory = false);
+             bool model_from_memory = false,
+             bool use_mmap = false);
 
   // NOTE: This is a deprecated API and will be removed in latter release.
   void Build(
@@ -94,10 +123,22 @@ class LITE_API LightPredictor {
       lite_api::LiteModelType model_type = lite_api::LiteModelType::kProtobuf,
       bool model_from_memory = false);
 
+  // Create a predictor from the program desc and the root scope of a loaded
+  // model, see Clone.
+  LightPredictor(const std::shared_ptr<cpp::ProgramDesc>& program_desc,
+                 const std::shared_ptr<Scope>& root,
+                 const std::vector<std::string>& var_names);
+
+  // The persistable vars in `private_var_names` are copied from the root scope
+  // into the exec scope.
   void BuildRuntimeProgram(
-      const std::shared_ptr<const cpp::ProgramDesc>& program_desc);
+      const std::shared_ptr<const cpp::ProgramDesc>& program_desc,
+      const std::vector<std::string>& private_var_names = {});
 
   void DequantizeWeight();
+  // The rows of the mapped embedding tables are read at random, so they are
+  // not read ahead, and only the rows which are read become resident.
+  void AdviseEmbeddingTables();
 
  private:
   std::shared_ptr<Scope> scope_;
@@ -105,11 +146,16 @@ class LITE_API LightPredictor {
   std::shared_ptr<cpp::ProgramDesc> program_desc_;
   std::vector<std::string> input_names_;
   std::vector<std::string> output_names_;
+  std::vector<lite_api::InputShapeBucket> input_shape_buckets_;
 };
 
 class LightPredictorImpl : public lite_api::PaddlePredictor {
  public:
   LightPredictorImpl() = default;
+  // The runs of RunAsync use the members of this class.
+  ~LightPredictorImpl() override {
+    lite_api::AsyncRunner::Release(&async_runner_);
+  }
 
   std::unique_ptr<lite_api::Tensor> GetInput(int i) override;
 
@@ -130,10 +176,22 @@ class LightPredictorImpl : public lite_api::PaddlePredictor {
   std::unique_ptr<lite_api::Tensor> GetInputByName(
       const std::string& name) override;
 
+  void EnableProfiler(double sample_rate = 1.0,
+                      size_t capacity = 16384) override;
+  void DisableProfiler() override;
+  std::string GetProfilerTrace(bool clear = false) override;
+
+  void RunAsync(std::function<void()> callback = nullptr) override;
+  void WaitAsync() override;
+
   void Init(const lite_api::MobileConfig& config);
 
  private:
   std::unique_ptr<lite::LightPredictor> raw_predictor_;
+  std::mutex mutex_;
+  // Created by the first RunAsync.
+  std::once_flag async_runner_flag_;
+  std::shared_ptr<lite_api::AsyncRunner> async_runner_;
 };
 
 }  // namespace lite
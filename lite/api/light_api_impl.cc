@@ -15,6 +15,7 @@
 #include "lite/api/light_api.h"
 #include <string>
 #include "lite/api/paddle_api.h"
+#include "lite/core/kernel_tuner.h"
 #include "lite/core/version.h"
 #include "lite/model_parser/model_parser.h"
 #ifndef LITE_ON_TINY_PUBLISH
@@ -41,8 +42,11 @@ void LightPredictorImpl::Init(const lite_api::MobileConfig& config) {
                            lite_api::LiteModelType::kNaiveBuffer));
   } else {
     raw_predictor_.reset(new LightPredictor(config.lite_model_file(),
-                                            config.is_model_from_memory()));
+                                            config.is_model_from_memory(),
+                                            config.use_mmap()));
   }
+  raw_predictor_->set_memory_arena(config.memory_arena());
+  raw_predictor_->set_inter_op_threads(config.inter_op_threads());
   mode_ = config.power_mode();
   threads_ = config.threads();
 
@@ -79,6 +83,20 @@ void LightPredictorImpl::Init(const lite_api::MobileConfig& config) {
              "number of threads is:"
           << real_num_threads;
 #endif
+  if (!config.kernel_tune_file().empty()) {
+    lite::KernelTuner::Global().Enable(config.kernel_tune_file());
+  }
+
+#ifdef LITE_WITH_ARM
+  lite::DeviceInfo::Global().SetRunMode(mode_, threads_);
+#endif
+  raw_predictor_->PrepareShapeBuckets(config.input_shape_buckets());
+  lite::KernelTuner::Global().Flush();
+  // The ops keep the op descs they need, so the program desc is only kept
+  // for Clone.
+  if (!config.enable_clone()) {
+    raw_predictor_->ReleaseProgramDesc();
+  }
 }
 
 std::unique_ptr<lite_api::Tensor> LightPredictorImpl::GetInput(int i) {
@@ -97,17 +115,37 @@ void LightPredictorImpl::Run() {
   lite::DeviceInfo::Global().SetRunMode(mode_, threads_);
 #endif
   raw_predictor_->Run();
+  lite::KernelTuner::Global().Flush();
+}
+
+void LightPredictorImpl::RunAsync(std::function<void()> callback) {
+  std::call_once(async_runner_flag_, [this] {
+    async_runner_ = std::make_shared<lite_api::AsyncRunner>(1);
+  });
+  async_runner_->Submit([this, callback](int) {
+    Run();
+    if (callback) callback();
+  });
+}
+
+void LightPredictorImpl::WaitAsync() {
+  if (async_runner_) {
+    async_runner_->Wait();
+  }
 }
 
 std::shared_ptr<lite_api::PaddlePredictor> LightPredictorImpl::Clone() {
-  LOG(FATAL) << "The Clone API is not supported in LigthPredictor";
-  return nullptr;
+  return Clone(std::vector<std::string>());
 }
 
 std::shared_ptr<lite_api::PaddlePredictor> LightPredictorImpl::Clone(
     const std::vector<std::string>& var_names) {
-  LOG(FATAL) << "The Clone API is not supported in LigthPredictor";
-  return nullptr;
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto predictor = std::make_shared<LightPredictorImpl>();
+  predictor->raw_predictor_ = raw_predictor_->Clone(var_names);
+  predictor->mode_ = mode_;
+  predictor->threads_ = threads_;
+  return predictor;
 }
 
 std::string LightPredictorImpl::GetVersion() const { return lite::version(); }
@@ -123,6 +161,23 @@ std::unique_ptr<lite_api::Tensor> LightPredictorImpl::GetInputByName(
       new lite_api::Tensor(raw_predictor_->GetInputByName(name)));
 }
 
+void LightPredictorImpl::EnableProfiler(double sample_rate, size_t capacity) {
+  raw_predictor_->tracer()->Enable(sample_rate, capacity);
+}
+
+void LightPredictorImpl::DisableProfiler() {
+  raw_predictor_->tracer()->Disable();
+}
+
+std::string LightPredictorImpl::GetProfilerTrace(bool clear) {
+  auto* tracer = raw_predictor_->tracer();
+  std::string trace = tracer->ExportChromeTrace();
+  if (clear) {
+    tracer->Clear();
+  }
+  return trace;
+}
+
 std::vector<std::string> LightPredictorImpl::GetInputNames() {
   return raw_predictor_->GetInputNames();
 }
@@ -95,5 +95,34 @@ TEST(LightAPI, loadNaiveBuffer) {
   }
 }
 
+TEST(LightAPI, shape_buckets) {
+  if (FLAGS_optimized_model.empty()) {
+    FLAGS_optimized_model = "lite_naive_model";
+  }
+  LightPredictor predictor(FLAGS_optimized_model, "", "");
+  std::vector<lite_api::InputShapeBucket> buckets(2);
+  buckets[0].shapes = {{1, 100}};
+  buckets[1].shapes = {{100, 100}};
+  predictor.PrepareShapeBuckets(buckets);
+
+  // Switching between the buckets never reallocates the output.
+  const void* output_data = nullptr;
+  for (int64_t batch : {1, 100, 1}) {
+    auto* input_tensor = predictor.GetInput(0);
+    input_tensor->Resize(DDim(std::vector<int64_t>({batch, 100})));
+    auto* data = input_tensor->mutable_data<float>();
+    for (int i = 0; i < batch * 100; i++) {
+      data[i] = i;
+    }
+    predictor.Run();
+    const auto* output = predictor.GetOutput(0);
+    EXPECT_EQ(output->dims()[0], batch);
+    if (output_data) {
+      EXPECT_EQ(output->raw_data(), output_data);
+    }
+    output_data = output->raw_data();
+  }
+}
+
 }  // namespace lite
 }  // namespace paddle
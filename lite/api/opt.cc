@@ -65,6 +65,10 @@ DEFINE_string(quant_type,
               "QUANT_INT16",
               "Set the quant_type for post_quant_dynamic, "
               "and it should be QUANT_INT8 or QUANT_INT16 for now.");
+DEFINE_string(embedding_quant_type,
+              "NONE",
+              "Compress the embedding tables of lookup_table for x86, "
+              "and it should be NONE, QUANT_INT8 or QUANT_FP16.");
 DEFINE_bool(record_tailoring_info,
             false,
             "Record kernels and operators information of the optimized model "
@@ -170,7 +174,8 @@ void RunOptimize(const std::string& model_dir,
                  const std::vector<Place>& valid_places,
                  bool record_tailoring_info,
                  bool quant_model,
-                 const std::string& quant_type) {
+                 const std::string& quant_type,
+                 const std::string& embedding_quant_type) {
   if (!model_file.empty() && !param_file.empty()) {
     LOG(WARNING)
         << "Load combined-param model. Option model_dir will be ignored";
@@ -189,6 +194,13 @@ void RunOptimize(const std::string& model_dir,
   } else {
     LOG(FATAL) << "Unsupported quant type: " << quant_type;
   }
+  if (embedding_quant_type == "QUANT_INT8") {
+    config.set_embedding_quant_type(EmbeddingQuantType::QUANT_INT8);
+  } else if (embedding_quant_type == "QUANT_FP16") {
+    config.set_embedding_quant_type(EmbeddingQuantType::QUANT_FP16);
+  } else if (embedding_quant_type != "NONE") {
+    LOG(FATAL) << "Unsupported embedding quant type: " << embedding_quant_type;
+  }
   auto predictor = lite_api::CreatePaddlePredictor(config);
 
   LiteModelType model_type;
@@ -309,6 +321,7 @@ void PrintHelpInfo() {
       "  Arguments of mode quantization in opt:\n"
       "        `--quant_model=(true|false)`\n"
       "        `--quant_type=(QUANT_INT8|QUANT_INT16)`\n"
+      "        `--embedding_quant_type=(NONE|QUANT_INT8|QUANT_FP16)`\n"
       "  Arguments of model checking and ops information:\n"
       "        `--print_all_ops=true`   Display all the valid operators of "
       "Paddle-Lite\n"
@@ -460,7 +473,8 @@ void Main() {
                 valid_places,
                 FLAGS_record_tailoring_info,
                 FLAGS_quant_model,
-                FLAGS_quant_type);
+                FLAGS_quant_type,
+                FLAGS_embedding_quant_type);
     return;
   }
 
@@ -501,7 +515,8 @@ void Main() {
                 valid_places,
                 FLAGS_record_tailoring_info,
                 FLAGS_quant_model,
-                FLAGS_quant_type);
+                FLAGS_quant_type,
+                FLAGS_embedding_quant_type);
     LOG(INFO) << "Optimize done. ";
   }
 
@@ -17,8 +17,10 @@
 #include <functional>
 #include <utility>
 
+#include "lite/api/async_runner.h"
 #include "lite/core/context.h"
 #include "lite/core/device_info.h"
+#include "lite/core/memory.h"
 #include "lite/core/target_wrapper.h"
 #include "lite/core/tensor.h"
 
@@ -252,6 +254,60 @@ void PaddlePredictor::SaveOptimizedModel(const std::string &model_dir,
       << "The SaveOptimizedModel API is only supported by CxxConfig predictor.";
 }
 
+void PaddlePredictor::EnableProfiler(double sample_rate, size_t capacity) {
+  LOG(WARNING) << "The profiler is not supported by this predictor.";
+}
+
+void PaddlePredictor::DisableProfiler() {}
+
+std::string PaddlePredictor::GetProfilerTrace(bool clear) { return ""; }
+
+MemoryUsage PaddlePredictor::GetMemoryUsage(TargetType target) {
+  auto &stats = lite::MemoryStats::Global();
+  MemoryUsage usage;
+  usage.target = target;
+  usage.total = stats.Get(target);
+  for (int i = 0; i < static_cast<int>(MemoryKind::NUM); i++) {
+    usage.kinds.push_back(stats.Get(target, static_cast<MemoryKind>(i)));
+  }
+  return usage;
+}
+
+void PaddlePredictor::ResetPeakMemoryUsage() {
+  lite::MemoryStats::Global().ResetPeak();
+}
+
+void PaddlePredictor::RunAsync(std::function<void()> callback) {
+  Run();
+  if (callback) callback();
+}
+
+void PaddlePredictor::WaitAsync() {}
+
+PredictorPool::PredictorPool(std::shared_ptr<PaddlePredictor> predictor,
+                             int size) {
+  CHECK(predictor);
+  CHECK_GT(size, 0);
+  predictors_.push_back(predictor);
+  for (int i = 1; i < size; i++) {
+    predictors_.push_back(predictor->Clone());
+  }
+  runner_ = std::make_shared<AsyncRunner>(size);
+}
+
+PredictorPool::~PredictorPool() { Wait(); }
+
+void PredictorPool::Submit(Task feed, Task done) {
+  runner_->Submit([this, feed, done](int worker_id) {
+    auto *predictor = predictors_[worker_id].get();
+    if (feed) feed(predictor);
+    predictor->Run();
+    if (done) done(predictor);
+  });
+}
+
+void PredictorPool::Wait() { runner_->Wait(); }
+
 template <typename ConfigT>
 std::shared_ptr<PaddlePredictor> CreatePaddlePredictor(const ConfigT &) {
   return std::shared_ptr<PaddlePredictor>();
@@ -294,6 +350,18 @@ void ConfigBase::set_opencl_precision(CLPrecisionType p) {
 #endif
 }
 
+void ConfigBase::set_opencl_cache_dir(const std::string &cache_dir) {
+#ifdef LITE_WITH_OPENCL
+  if (paddle::lite_api::IsOpenCLBackendValid()) {
+    opencl_cache_dir_ = cache_dir;
+    paddle::lite::CLRuntime::Global()->set_cache_dir(cache_dir);
+#ifdef LITE_WITH_LOG
+    LOG(INFO) << "opencl_cache_dir:" << cache_dir;
+#endif
+  }
+#endif
+}
+
 void ConfigBase::set_power_mode(paddle::lite_api::PowerMode mode) {
 #ifdef LITE_WITH_ARM
   lite::DeviceInfo::Global().SetRunMode(mode, threads_);
@@ -317,6 +385,13 @@ void ConfigBase::set_x86_math_num_threads(int threads) {
 int ConfigBase::x86_math_num_threads() const { return x86_math_num_threads_; }
 #endif
 
+void ConfigBase::add_input_shape_bucket(const std::vector<shape_t> &shapes,
+                                        const std::vector<lod_t> &lods) {
+  CHECK(lods.empty() || lods.size() == shapes.size())
+      << "The lods should be empty or one for each of the inputs.";
+  input_shape_buckets_.push_back(InputShapeBucket{shapes, lods});
+}
+
 CxxModelBuffer::CxxModelBuffer(const char *program_buffer,
                                size_t program_buffer_size,
                                const char *params_buffer,
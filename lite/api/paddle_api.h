@@ -19,6 +19,7 @@
 
 #ifndef PADDLE_LITE_API_H_  // NOLINT
 #define PADDLE_LITE_API_H_
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
@@ -42,6 +43,22 @@ enum class L3CacheSetMethod {
   // kAutoGrow = 3,   // Not supported yet, least memory consumption.
 };
 
+// The shapes and lods of all of the inputs of a predictor, the lods can be
+// empty if none of the inputs has one.
+struct LITE_API InputShapeBucket {
+  std::vector<shape_t> shapes;
+  std::vector<lod_t> lods;
+};
+
+// The memory allocated on a target by the whole process, see
+// PaddlePredictor::GetMemoryUsage.
+struct LITE_API MemoryUsage {
+  TargetType target{TargetType::kHost};
+  MemoryCounter total;
+  // The counters of every kind, indexed by MemoryKind.
+  std::vector<MemoryCounter> kinds;
+};
+
 // return true if current device supports OpenCL model
 LITE_API bool IsOpenCLBackendValid(bool check_fp16_valid = false);
 
@@ -85,6 +102,8 @@ struct LITE_API Tensor {
   void* raw_tensor_;
 };
 
+class AsyncRunner;
+
 /// The PaddlePredictor defines the basic interfaces for different kinds of
 /// predictors.
 class LITE_API PaddlePredictor {
@@ -130,11 +149,75 @@ class LITE_API PaddlePredictor {
 
   virtual ~PaddlePredictor() = default;
 
+  // NOTE: The virtual functions below are appended after the destructor, so
+  // that the layout of the vtable stays compatible with the applications
+  // built with the earlier releases. Keep adding the new ones at the end.
+
+  /// Run on the worker thread of this predictor, and call `callback` on the
+  /// worker once the run is done. The runs are done in the order of the
+  /// calls, the inputs should not be changed and the outputs should not be
+  /// read until the callback of the run is called. The predictors which do
+  /// not support it run synchronously.
+  virtual void RunAsync(std::function<void()> callback = nullptr);
+  /// Wait until all of the runs of RunAsync are done. It must not be called
+  /// by the callbacks.
+  virtual void WaitAsync();
+
+  /// Trace the ops of the main block in the runs sampled with the
+  /// probability `sample_rate`, the latest `capacity` events are kept. It
+  /// can be toggled between the runs, and costs nearly nothing when off.
+  virtual void EnableProfiler(double sample_rate = 1.0,
+                              size_t capacity = 16384);
+  virtual void DisableProfiler();
+  /// The traced events in the Chrome trace event format, which is loaded by
+  /// chrome://tracing and Perfetto. The events are dropped if `clear`.
+  virtual std::string GetProfilerTrace(bool clear = false);
+
+  /// The memory allocated on `target` by the buffers of the tensors, the
+  /// weights, the workspaces and the packs of the kernels. The host, x86 and
+  /// arm memory is counted as host. The allocations are counted for the
+  /// whole process, so the other predictors are included.
+  virtual MemoryUsage GetMemoryUsage(TargetType target = TargetType::kHost);
+  /// Restart the peaks from the current usage, such as after the warm up.
+  virtual void ResetPeakMemoryUsage();
+
  protected:
   int threads_{1};
   lite_api::PowerMode mode_{lite_api::LITE_POWER_NO_BIND};
 };
 
+/// PredictorPool serves the requests with a predictor and its clones, each
+/// one on its own worker thread. A request is served by the first idle
+/// predictor, so the inputs copy, the computation and the outputs fetch of
+/// the consecutive requests are overlapped.
+class LITE_API PredictorPool {
+ public:
+  using Task = std::function<void(PaddlePredictor*)>;
+
+  /// Serve the requests with `predictor` and `size - 1` clones of it. A light
+  /// weight predictor has to be created with MobileConfig::set_enable_clone.
+  PredictorPool(std::shared_ptr<PaddlePredictor> predictor, int size);
+  /// Wait until all of the requests are done.
+  ~PredictorPool();
+
+  /// Queue a request, `feed` sets the inputs of the predictor which serves
+  /// it, then the predictor runs and `done` reads the outputs, all of them
+  /// on the worker of the predictor. The requests are started in the order
+  /// of the calls.
+  void Submit(Task feed, Task done);
+  /// Wait until all of the requests are done.
+  void Wait();
+
+  int size() const { return static_cast<int>(predictors_.size()); }
+
+ private:
+  PredictorPool(const PredictorPool&) = delete;
+  PredictorPool& operator=(const PredictorPool&) = delete;
+
+  std::vector<std::shared_ptr<PaddlePredictor>> predictors_;
+  std::shared_ptr<AsyncRunner> runner_;
+};
+
 /// Base class for all the configs.
 class LITE_API ConfigBase {
   std::string model_dir_;
@@ -143,10 +226,15 @@ class LITE_API ConfigBase {
   // gpu opencl
   CLTuneMode opencl_tune_mode_{CL_TUNE_NONE};
   CLPrecisionType opencl_precision_{CL_PRECISION_AUTO};
+  std::string opencl_cache_dir_;
   // to save subgraph model for npu/xpu/...
   std::string subgraph_model_cache_dir_{""};
   int device_id_{0};
   int x86_math_num_threads_ = 1;
+  bool memory_arena_{false};
+  int inter_op_threads_{1};
+  std::vector<InputShapeBucket> input_shape_buckets_;
+  std::string kernel_tune_file_;
 
  public:
   explicit ConfigBase(PowerMode mode = LITE_POWER_NO_BIND, int threads = 1);
@@ -163,6 +251,11 @@ class LITE_API ConfigBase {
   void set_opencl_tune(CLTuneMode tune_mode = CL_TUNE_NONE);
   // set GPU opencl precision
   void set_opencl_precision(CLPrecisionType p = CL_PRECISION_AUTO);
+  // set GPU opencl cache dir, the compiled programs and the tuned local work
+  // sizes are saved in the existing dir and reused by the later predictors.
+  // It should be set before the predictor is created.
+  void set_opencl_cache_dir(const std::string& cache_dir);
+  const std::string& opencl_cache_dir() const { return opencl_cache_dir_; }
   // set subgraph_model_dir
   void set_subgraph_model_cache_dir(std::string subgraph_model_cache_dir) {
     subgraph_model_cache_dir_ = subgraph_model_cache_dir;
@@ -176,6 +269,36 @@ class LITE_API ConfigBase {
   // set x86_math_num_threads
   void set_x86_math_num_threads(int threads);
   int x86_math_num_threads() const;
+  // set memory_arena, the activations will be packed into one pre-planned
+  // memory arena per target after the first run, which reduces the peak
+  // memory usage.
+  void set_memory_arena(bool memory_arena) { memory_arena_ = memory_arena; }
+  bool memory_arena() const { return memory_arena_; }
+  // set inter_op_threads, the independent ops are run concurrently by a pool
+  // of `threads` workers, and the `threads` of the intra-op parallelism are
+  // divided among them. Only the host kernels are supported.
+  void set_inter_op_threads(int threads) { inter_op_threads_ = threads; }
+  int inter_op_threads() const { return inter_op_threads_; }
+  // add_input_shape_bucket, declare the shapes of the inputs which the
+  // predictor will run with. The predictor is run once per bucket with zeros
+  // when it is created, then the output shapes of all of the ops are cached
+  // and the activations are allocated for the largest bucket, so switching
+  // between the buckets neither infers shapes nor allocates memory. The
+  // kernels still keep the state of the last shape only, e.g. the ones which
+  // re-pack the weights or re-tune for a new shape do it again on a switch.
+  void add_input_shape_bucket(const std::vector<shape_t>& shapes,
+                              const std::vector<lod_t>& lods = {});
+  const std::vector<InputShapeBucket>& input_shape_buckets() const {
+    return input_shape_buckets_;
+  }
+  // set kernel_tune_file, enable the auto-tuning of the kernels which have
+  // several implementations, e.g. conv. Every eligible implementation is
+  // timed at the first run of a shape with the configured threads, and the
+  // fastest is recorded in the file and reused by the later loads.
+  void set_kernel_tune_file(const std::string& path) {
+    kernel_tune_file_ = path;
+  }
+  const std::string& kernel_tune_file() const { return kernel_tune_file_; }
 };
 
 class LITE_API CxxModelBuffer {
@@ -206,6 +329,7 @@ class LITE_API CxxConfig : public ConfigBase {
   std::vector<std::string> passes_internal_{};
   bool quant_model_{false};  // Enable post_quant_dynamic in opt
   QuantType quant_type_{QuantType::QUANT_INT16};
+  EmbeddingQuantType embedding_quant_type_{EmbeddingQuantType::NONE};
   std::map<int, std::vector<std::shared_ptr<void>>>
       preferred_inputs_for_warmup_;
 #ifdef LITE_WITH_CUDA
@@ -309,6 +433,14 @@ class LITE_API CxxConfig : public ConfigBase {
   bool quant_model() const { return quant_model_; }
   void set_quant_type(QuantType quant_type) { quant_type_ = quant_type; }
   QuantType quant_type() const { return quant_type_; }
+  // Compress the embedding tables of lookup_table(_v2) to int8 or fp16, they
+  // are dequantized row by row in the lookup kernels of x86.
+  void set_embedding_quant_type(EmbeddingQuantType type) {
+    embedding_quant_type_ = type;
+  }
+  EmbeddingQuantType embedding_quant_type() const {
+    return embedding_quant_type_;
+  }
 };
 
 /// MobileConfig is the config for the light weight predictor, it will skip
@@ -321,6 +453,12 @@ class LITE_API MobileConfig : public ConfigBase {
   // model data readed from file or memory buffer in combined format.
   std::string lite_model_file_;
 
+  // whether to map the model file into memory instead of reading it.
+  bool use_mmap_{false};
+
+  // whether to keep the program desc so that the predictor can be cloned.
+  bool enable_clone_{false};
+
   // NOTE: This is a deprecated variable and will be removed in latter release.
   std::string model_buffer_;
   std::string param_buffer_;
@@ -342,6 +480,21 @@ class LITE_API MobileConfig : public ConfigBase {
   // abandoned in v3.0.
   bool model_from_memory() const { return model_from_memory_; }
 
+  // set use_mmap, the model file is mapped into memory and the params are
+  // used in place without being copied, which speeds up the loading and
+  // shares the physical pages among the processes which load the same model.
+  // Only the model files saved with the aligned params benefit from it.
+  // The embedding tables are paged in by the rows which are read, so only
+  // the hot rows of the large tables are resident.
+  void set_use_mmap(bool x) { use_mmap_ = x; }
+  bool use_mmap() const { return use_mmap_; }
+
+  // set enable_clone, the program desc of the model is kept for the lifetime
+  // of the predictor so that it can be cloned, e.g. by PredictorPool.
+  // Otherwise the program desc is released once the predictor is created.
+  void set_enable_clone(bool x) { enable_clone_ = x; }
+  bool enable_clone() const { return enable_clone_; }
+
   // NOTE: This is a deprecated API and will be removed in latter release.
   void set_model_buffer(const char* model_buffer,
                         size_t model_buffer_size,
@@ -15,6 +15,10 @@
 #include "lite/api/paddle_api.h"
 #include <gflags/gflags.h>
 #include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <future>  // NOLINT
+#include <vector>
 #include "lite/utils/cp_logging.h"
 #include "lite/utils/io.h"
 
@@ -141,6 +145,111 @@ TEST(LightApi, run) {
   EXPECT_NEAR(out[1], -28.8729, 1e-3);
 }
 
+TEST(LightApi, clone) {
+  lite_api::MobileConfig config;
+  config.set_model_from_file(FLAGS_model_dir + ".opt2.naive.nb");
+  config.set_enable_clone(true);
+  auto predictor = lite_api::CreatePaddlePredictor(config);
+  // The cloned predictor shares the weights and has its own activations.
+  auto cloned_predictor = predictor->Clone();
+  ASSERT_TRUE(cloned_predictor);
+  EXPECT_EQ(cloned_predictor->GetInputNames(), predictor->GetInputNames());
+
+  for (auto& p : {predictor, cloned_predictor}) {
+    auto input_tensor = p->GetInput(0);
+    input_tensor->Resize(std::vector<int64_t>({100, 100}));
+    auto* data = input_tensor->mutable_data<float>();
+    for (int i = 0; i < 100 * 100; i++) {
+      data[i] = i;
+    }
+  }
+  cloned_predictor->Run();
+  predictor->Run();
+
+  auto output = predictor->GetOutput(0);
+  auto cloned_output = cloned_predictor->GetOutput(0);
+  EXPECT_NE(output->data<float>(), cloned_output->data<float>());
+  EXPECT_NEAR(cloned_output->data<float>()[0], 50.2132, 1e-3);
+  EXPECT_NEAR(cloned_output->data<float>()[1], -28.8729, 1e-3);
+}
+
+TEST(LightApi, run_async) {
+  lite_api::MobileConfig config;
+  config.set_model_from_file(FLAGS_model_dir + ".opt2.naive.nb");
+  auto predictor = lite_api::CreatePaddlePredictor(config);
+  auto input_tensor = predictor->GetInput(0);
+  input_tensor->Resize(std::vector<int64_t>({100, 100}));
+  auto* data = input_tensor->mutable_data<float>();
+  for (int i = 0; i < 100 * 100; i++) {
+    data[i] = i;
+  }
+
+  std::atomic<int> num_done{0};
+  predictor->RunAsync([&] {
+    auto output = predictor->GetOutput(0);
+    EXPECT_NEAR(output->data<float>()[0], 50.2132, 1e-3);
+    num_done++;
+  });
+  predictor->WaitAsync();
+  EXPECT_EQ(num_done, 1);
+}
+
+// The callback may drop the last reference to the predictor, which is then
+// destroyed on the worker of RunAsync.
+TEST(LightApi, run_async_release_in_callback) {
+  lite_api::MobileConfig config;
+  config.set_model_from_file(FLAGS_model_dir + ".opt2.naive.nb");
+  auto predictor = lite_api::CreatePaddlePredictor(config);
+  auto input_tensor = predictor->GetInput(0);
+  input_tensor->Resize(std::vector<int64_t>({100, 100}));
+  auto* data = input_tensor->mutable_data<float>();
+  for (int i = 0; i < 100 * 100; i++) {
+    data[i] = i;
+  }
+
+  std::promise<float> result;
+  auto* raw = predictor.get();
+  raw->RunAsync([&] {
+    float out = predictor->GetOutput(0)->data<float>()[0];
+    predictor.reset();
+    result.set_value(out);
+  });
+  auto future = result.get_future();
+  ASSERT_EQ(future.wait_for(std::chrono::seconds(60)),
+            std::future_status::ready);
+  EXPECT_NEAR(future.get(), 50.2132, 1e-3);
+  EXPECT_EQ(predictor, nullptr);
+}
+
+TEST(LightApi, predictor_pool) {
+  lite_api::MobileConfig config;
+  config.set_model_from_file(FLAGS_model_dir + ".opt2.naive.nb");
+  config.set_enable_clone(true);
+  PredictorPool pool(lite_api::CreatePaddlePredictor(config), 2);
+  EXPECT_EQ(pool.size(), 2);
+
+  const int num_requests = 8;
+  std::vector<float> results(num_requests, 0.f);
+  for (int r = 0; r < num_requests; r++) {
+    auto feed = [](PaddlePredictor* p) {
+      auto input_tensor = p->GetInput(0);
+      input_tensor->Resize(std::vector<int64_t>({100, 100}));
+      auto* data = input_tensor->mutable_data<float>();
+      for (int i = 0; i < 100 * 100; i++) {
+        data[i] = i;
+      }
+    };
+    auto done = [&results, r](PaddlePredictor* p) {
+      results[r] = p->GetOutput(0)->data<float>()[1];
+    };
+    pool.Submit(feed, done);
+  }
+  pool.Wait();
+  for (auto result : results) {
+    EXPECT_NEAR(result, -28.8729, 1e-3);
+  }
+}
+
 // Demo2 for Loading model from memory
 TEST(MobileConfig, LoadfromMemory) {
   // Get naive buffer
@@ -107,7 +107,15 @@ const std::string& PrecisionToStr(PrecisionType precision) {
 
 const std::string& DataLayoutToStr(DataLayoutType layout) {
   static const std::string datalayout2string[] = {
-      "unk", "NCHW", "any", "NHWC", "ImageDefault", "ImageFolder", "ImageNW"};
+      "unk",
+      "NCHW",
+      "any",
+      "NHWC",
+      "ImageDefault",
+      "ImageFolder",
+      "ImageNW",
+      "NCHWc8",
+      "NCHWc16"};
   auto x = static_cast<int>(layout);
   CHECK_LT(x, static_cast<int>(DATALAYOUT(NUM)));
   return datalayout2string[x];
@@ -157,7 +165,9 @@ const std::string& DataLayoutRepr(DataLayoutType layout) {
                                                   "kNHWC",
                                                   "kImageDefault",
                                                   "kImageFolder",
-                                                  "kImageNW"};
+                                                  "kImageNW",
+                                                  "kNCHWc8",
+                                                  "kNCHWc16"};
   auto x = static_cast<int>(layout);
   CHECK_LT(x, static_cast<int>(DATALAYOUT(NUM)));
   return datalayout2string[x];
@@ -198,7 +208,9 @@ std::set<DataLayoutType> ExpandValidLayouts(DataLayoutType layout) {
                                                    DATALAYOUT(kNHWC),
                                                    DATALAYOUT(kImageDefault),
                                                    DATALAYOUT(kImageFolder),
-                                                   DATALAYOUT(kImageNW)});
+                                                   DATALAYOUT(kImageNW),
+                                                   DATALAYOUT(kNCHWc8),
+                                                   DATALAYOUT(kNCHWc16)});
   if (layout == DATALAYOUT(kAny)) {
     return valid_set;
   }
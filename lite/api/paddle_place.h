@@ -82,8 +82,10 @@ enum class DataLayoutType : int {
   kImageDefault = 4,  // for opencl image2d
   kImageFolder = 5,   // for opencl image2d
   kImageNW = 6,       // for opencl image2d
+  kNCHWc8 = 7,        // [N, C/8, H, W, 8], the channels are blocked by 8
+  kNCHWc16 = 8,       // [N, C/16, H, W, 16], the channels are blocked by 16
   kAny = 2,           // any data layout
-  NUM = 7,            // number of fields.
+  NUM = 9,            // number of fields.
 };
 
 typedef enum {
@@ -157,6 +159,31 @@ enum class QuantType : int {
   QUANT_INT16,
 };
 
+// The storage of the tables of lookup_table(_v2) compressed by opt, the
+// INT8 tables have a scale for every row.
+enum class EmbeddingQuantType : int {
+  NONE,
+  QUANT_INT8,
+  QUANT_FP16,
+};
+
+// The kinds of the memory allocated by the buffers of the library.
+enum class MemoryKind : int {
+  kOther = 0,  // the inputs set by the users, and the others
+  kWeight = 1,
+  kActivation = 2,
+  kWorkspace = 3,
+  kKernelPack = 4,  // the kernel-private data, such as the packed weights
+  NUM = 5,          // number of fields.
+};
+
+// The counters of the allocations of a target, in bytes.
+struct MemoryCounter {
+  int64_t current_bytes{0};
+  int64_t peak_bytes{0};
+  int64_t num_allocs{0};
+};
+
 template <typename T>
 struct PrecisionTypeTrait {
   constexpr static PrecisionType Type() { return PrecisionType::kUnk; }
@@ -42,6 +42,10 @@ USE_MIR_PASS(lite_var_conv_2d_activation_fuse_pass);
 USE_MIR_PASS(lite_match_matrix_activation_fuse_pass);
 USE_MIR_PASS(lite_scales_fuse_pass);
 USE_MIR_PASS(lite_sequence_reverse_embedding_fuse_pass);
+USE_MIR_PASS(lite_embedding_seq_pool_fuse_pass);
+USE_MIR_PASS(lite_multihead_attention_fuse_pass);
+USE_MIR_PASS(lite_elementwise_add_layer_norm_fuse_pass);
+USE_MIR_PASS(lite_fc_gelu_fuse_pass);
 USE_MIR_PASS(lite_elementwise_activation_fuse_pass);
 USE_MIR_PASS(lite_quant_dequant_fuse_pass);
 USE_MIR_PASS(type_precision_cast_pass);
@@ -49,6 +53,7 @@ USE_MIR_PASS(type_layout_cast_pass);
 USE_MIR_PASS(type_layout_cast_preprocess_pass);
 USE_MIR_PASS(memory_optimize_pass);
 USE_MIR_PASS(lite_reshape_fuse_pass);
+USE_MIR_PASS(concat_split_inplace_pass);
 USE_MIR_PASS(multi_stream_analysis_pass);
 USE_MIR_PASS(elementwise_mul_constant_eliminate_pass)
 USE_MIR_PASS(npu_subgraph_pass);
@@ -59,6 +64,8 @@ USE_MIR_PASS(mlu_subgraph_pass);
 USE_MIR_PASS(mlu_postprocess_pass);
 USE_MIR_PASS(weight_quantization_preprocess_pass);
 USE_MIR_PASS(post_quant_dynamic_pass);
+USE_MIR_PASS(embedding_quant_pass);
+USE_MIR_PASS(constant_folding_pass);
 USE_MIR_PASS(apu_subgraph_pass);
 USE_MIR_PASS(quantized_op_attributes_inference_pass);
 USE_MIR_PASS(control_flow_op_unused_inputs_and_outputs_eliminate_pass)
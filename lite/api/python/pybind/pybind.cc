@@ -44,6 +44,9 @@ using lite::LightPredictorImpl;
 using lite_api::CxxConfig;
 using lite_api::DataLayoutType;
 using lite_api::MLUCoreVersion;
+using lite_api::MemoryCounter;
+using lite_api::MemoryKind;
+using lite_api::MemoryUsage;
 using lite_api::MobileConfig;
 using lite_api::OptBase;
 using lite_api::Place;
@@ -87,6 +90,7 @@ static void BindLitePowerMode(py::module *m);
 static void BindLitePlace(py::module *m);
 static void BindLiteTensor(py::module *m);
 static void BindLiteMLUCoreVersion(py::module *m);
+static void BindLiteMemoryUsage(py::module *m);
 
 void BindLiteApi(py::module *m) {
   BindLiteCxxConfig(m);
@@ -95,6 +99,7 @@ void BindLiteApi(py::module *m) {
   BindLitePlace(m);
   BindLiteTensor(m);
   BindLiteMLUCoreVersion(m);
+  BindLiteMemoryUsage(m);
 #ifndef LITE_ON_TINY_PUBLISH
   BindLiteCxxPredictor(m);
 #endif
@@ -187,6 +192,27 @@ void BindLiteMLUCoreVersion(py::module *m) {
       .value("LITE_MLU_270", MLUCoreVersion::MLU_270);
 }
 
+void BindLiteMemoryUsage(py::module *m) {
+  py::enum_<MemoryKind>(*m, "MemoryKind")
+      .value("Other", MemoryKind::kOther)
+      .value("Weight", MemoryKind::kWeight)
+      .value("Activation", MemoryKind::kActivation)
+      .value("Workspace", MemoryKind::kWorkspace)
+      .value("KernelPack", MemoryKind::kKernelPack);
+
+  py::class_<MemoryCounter>(*m, "MemoryCounter")
+      .def_readonly("current_bytes", &MemoryCounter::current_bytes)
+      .def_readonly("peak_bytes", &MemoryCounter::peak_bytes)
+      .def_readonly("num_allocs", &MemoryCounter::num_allocs);
+
+  py::class_<MemoryUsage>(*m, "MemoryUsage")
+      .def_readonly("target", &MemoryUsage::target)
+      .def_readonly("total", &MemoryUsage::total)
+      .def("kind", [](const MemoryUsage &self, MemoryKind kind) {
+        return self.kinds.at(static_cast<size_t>(kind));
+      });
+}
+
 void BindLitePlace(py::module *m) {
   // TargetType
   py::enum_<TargetType>(*m, "TargetType")
@@ -224,6 +250,8 @@ void BindLitePlace(py::module *m) {
       .value("ImageDefault", DataLayoutType::kImageDefault)
       .value("ImageFolder", DataLayoutType::kImageFolder)
       .value("ImageNW", DataLayoutType::kImageNW)
+      .value("NCHWc8", DataLayoutType::kNCHWc8)
+      .value("NCHWc16", DataLayoutType::kNCHWc16)
       .value("Any", DataLayoutType::kAny);
 
   // Place
@@ -305,6 +333,10 @@ void BindLiteCxxPredictor(py::module *m) {
       .def("get_output", &CxxPaddleApiImpl::GetOutput)
       .def("run", &CxxPaddleApiImpl::Run)
       .def("get_version", &CxxPaddleApiImpl::GetVersion)
+      .def("get_memory_usage",
+           &CxxPaddleApiImpl::GetMemoryUsage,
+           py::arg("target") = TargetType::kHost)
+      .def("reset_peak_memory_usage", &CxxPaddleApiImpl::ResetPeakMemoryUsage)
       .def("save_optimized_model",
            [](CxxPaddleApiImpl &self, const std::string &output_dir) {
              self.SaveOptimizedModel(output_dir,
@@ -319,7 +351,12 @@ void BindLiteLightPredictor(py::module *m) {
       .def("get_input", &LightPredictorImpl::GetInput)
       .def("get_output", &LightPredictorImpl::GetOutput)
       .def("run", &LightPredictorImpl::Run)
-      .def("get_version", &LightPredictorImpl::GetVersion);
+      .def("get_version", &LightPredictorImpl::GetVersion)
+      .def("get_memory_usage",
+           &LightPredictorImpl::GetMemoryUsage,
+           py::arg("target") = TargetType::kHost)
+      .def("reset_peak_memory_usage",
+           &LightPredictorImpl::ResetPeakMemoryUsage);
 }
 
 }  // namespace pybind
@@ -0,0 +1,190 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "lite/backends/host/math/nms.h"
+#include <algorithm>
+
+namespace paddle {
+namespace lite {
+namespace host {
+namespace math {
+
+// The candidate is checked against the kept boxes block by block, so that it
+// stops early once it is suppressed.
+static constexpr size_t kNMSBlockSize = 64;
+
+void BoxesSoA::Reserve(size_t n) {
+  xmin.reserve(n);
+  ymin.reserve(n);
+  xmax.reserve(n);
+  ymax.reserve(n);
+  area.reserve(n);
+}
+
+void BoxesSoA::Push(const float* box, float box_area) {
+  xmin.push_back(box[0]);
+  ymin.push_back(box[1]);
+  xmax.push_back(box[2]);
+  ymax.push_back(box[3]);
+  area.push_back(box_area);
+}
+
+float BBoxArea(const float* box, bool normalized) {
+  if (box[2] < box[0] || box[3] < box[1]) {
+    // If coordinate values are is invalid
+    // (e.g. xmax < xmin or ymax < ymin), return 0.
+    return 0.f;
+  } else {
+    const float w = box[2] - box[0];
+    const float h = box[3] - box[1];
+    if (normalized) {
+      return w * h;
+    } else {
+      // If coordinate values are not within range [0, 1].
+      return (w + 1) * (h + 1);
+    }
+  }
+}
+
+float JaccardOverlap(const float* box1, const float* box2, bool normalized) {
+  if (box2[0] > box1[2] || box2[2] < box1[0] || box2[1] > box1[3] ||
+      box2[3] < box1[1]) {
+    return 0.f;
+  } else {
+    const float inter_xmin = (std::max)(box1[0], box2[0]);
+    const float inter_ymin = (std::max)(box1[1], box2[1]);
+    const float inter_xmax = (std::min)(box1[2], box2[2]);
+    const float inter_ymax = (std::min)(box1[3], box2[3]);
+    const float norm = normalized ? 0.f : 1.f;
+    const float inter_w = inter_xmax - inter_xmin + norm;
+    const float inter_h = inter_ymax - inter_ymin + norm;
+    const float inter_area = inter_w * inter_h;
+    const float bbox1_area = BBoxArea(box1, normalized);
+    const float bbox2_area = BBoxArea(box2, normalized);
+    return inter_area / (bbox1_area + bbox2_area - inter_area);
+  }
+}
+
+void BatchJaccardOverlap(const float* box,
+                         float box_area,
+                         const BoxesSoA& boxes,
+                         size_t begin,
+                         size_t n,
+                         bool normalized,
+                         float* ious) {
+  const float x0 = box[0];
+  const float y0 = box[1];
+  const float x1 = box[2];
+  const float y1 = box[3];
+  const float norm = normalized ? 0.f : 1.f;
+  const float* xmin = boxes.xmin.data() + begin;
+  const float* ymin = boxes.ymin.data() + begin;
+  const float* xmax = boxes.xmax.data() + begin;
+  const float* ymax = boxes.ymax.data() + begin;
+  const float* area = boxes.area.data() + begin;
+  // Branchless, so that the loop is vectorized by the compiler.
+  for (size_t k = 0; k < n; ++k) {
+    const bool disjoint = (xmin[k] > x1) | (xmax[k] < x0) | (ymin[k] > y1) |
+                          (ymax[k] < y0);
+    const float inter_xmin = x0 < xmin[k] ? xmin[k] : x0;
+    const float inter_ymin = y0 < ymin[k] ? ymin[k] : y0;
+    const float inter_xmax = xmax[k] < x1 ? xmax[k] : x1;
+    const float inter_ymax = ymax[k] < y1 ? ymax[k] : y1;
+    const float inter_w = inter_xmax - inter_xmin + norm;
+    const float inter_h = inter_ymax - inter_ymin + norm;
+    const float inter_area = inter_w * inter_h;
+    const float iou = inter_area / (box_area + area[k] - inter_area);
+    ious[k] = disjoint ? 0.f : iou;
+  }
+}
+
+void SortScoreIndexPairs(int64_t top_k,
+                         std::vector<std::pair<float, int>>* pairs) {
+  auto cmp = [](const std::pair<float, int>& pair1,
+                const std::pair<float, int>& pair2) {
+    return pair1.first > pair2.first ||
+           (pair1.first == pair2.first && pair1.second < pair2.second);
+  };
+  if (top_k > -1 && top_k < static_cast<int64_t>(pairs->size())) {
+    std::partial_sort(
+        pairs->begin(), pairs->begin() + top_k, pairs->end(), cmp);
+    pairs->resize(top_k);
+  } else {
+    std::sort(pairs->begin(), pairs->end(), cmp);
+  }
+}
+
+void GetTopKScoreIndex(const float* scores,
+                       int64_t num,
+                       int64_t stride,
+                       float threshold,
+                       int64_t top_k,
+                       std::vector<std::pair<float, int>>* sorted_indices) {
+  sorted_indices->clear();
+  for (int64_t i = 0; i < num; ++i) {
+    const float score = scores[i * stride];
+    if (score > threshold) {
+      sorted_indices->emplace_back(score, static_cast<int>(i));
+    }
+  }
+  SortScoreIndexPairs(top_k, sorted_indices);
+}
+
+void NMSFast(const float* boxes,
+             int64_t stride,
+             const std::vector<std::pair<float, int>>& sorted_indices,
+             float nms_threshold,
+             float eta,
+             bool normalized,
+             std::vector<int>* selected_indices) {
+  selected_indices->clear();
+  BoxesSoA kept;
+  kept.Reserve(sorted_indices.size());
+  float ious[kNMSBlockSize];
+  float adaptive_threshold = nms_threshold;
+  for (auto& pair : sorted_indices) {
+    const int idx = pair.second;
+    const float* box = boxes + idx * stride;
+    const float area = BBoxArea(box, normalized);
+    bool keep = true;
+    for (size_t begin = 0; keep && begin < kept.size();
+         begin += kNMSBlockSize) {
+      size_t n = (std::min)(kNMSBlockSize, kept.size() - begin);
+      BatchJaccardOverlap(box, area, kept, begin, n, normalized, ious);
+      for (size_t k = 0; k < n; ++k) {
+        keep &= ious[k] <= adaptive_threshold;
+      }
+    }
+    if (keep) {
+      selected_indices->push_back(idx);
+      kept.Push(box, area);
+      if (eta < 1 && adaptive_threshold > 0.5) {
+        adaptive_threshold *= eta;
+      }
+    }
+  }
+}
+
+void ParallelFor(int64_t n, const std::function<void(int64_t)>& func) {
+#if defined(ARM_WITH_OMP) || defined(PADDLE_WITH_MKLML)
+#pragma omp parallel for schedule(dynamic)
+#endif
+  for (int64_t i = 0; i < n; ++i) {
+    func(i);
+  }
+}
+
+}  // namespace math
+}  // namespace host
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,99 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+namespace host {
+namespace math {
+
+/*
+ * The engine of the host NMS kernels, such as multiclass_nms, matrix_nms and
+ * retinanet_detection_output:
+ * - The top k of the scores are selected by a partial sort instead of sorting
+ *   all of the candidates.
+ * - The kept boxes are stored as structure of arrays, so that the IoU of a
+ *   candidate against a block of them is one vectorized loop.
+ * - The classes and the images are independent, and run by ParallelFor.
+ * Only the boxes of [xmin, ymin, xmax, ymax] are supported, the results are
+ * the same as the pairwise JaccardOverlap.
+ */
+
+// The boxes of [xmin, ymin, xmax, ymax] and their areas as structure of arrays.
+struct BoxesSoA {
+  std::vector<float> xmin;
+  std::vector<float> ymin;
+  std::vector<float> xmax;
+  std::vector<float> ymax;
+  std::vector<float> area;
+
+  void Reserve(size_t n);
+  void Push(const float* box, float box_area);
+  size_t size() const { return area.size(); }
+};
+
+float BBoxArea(const float* box, bool normalized);
+
+float JaccardOverlap(const float* box1, const float* box2, bool normalized);
+
+// Compute the IoU of `box` against the boxes [begin, begin + n) into `ious`,
+// `box` is the first box of JaccardOverlap.
+void BatchJaccardOverlap(const float* box,
+                         float box_area,
+                         const BoxesSoA& boxes,
+                         size_t begin,
+                         size_t n,
+                         bool normalized,
+                         float* ious);
+
+// Sort the pairs of (score, index) in the descending order of the scores,
+// and the ties in the ascending order of the indices as a stable sort of the
+// pairs ordered by the indices does, then keep the first `top_k` pairs if
+// top_k > -1.
+void SortScoreIndexPairs(int64_t top_k,
+                         std::vector<std::pair<float, int>>* pairs);
+
+// Select the top k of the scores above the threshold, the score of the i-th
+// box is scores[i * stride].
+void GetTopKScoreIndex(const float* scores,
+                       int64_t num,
+                       int64_t stride,
+                       float threshold,
+                       int64_t top_k,
+                       std::vector<std::pair<float, int>>* sorted_indices);
+
+// Greedy NMS of the boxes in the order of `sorted_indices`, the i-th box is
+// at boxes + i * stride. The threshold is multiplied by `eta` after a box is
+// kept if eta < 1 and the threshold is still above 0.5.
+void NMSFast(const float* boxes,
+             int64_t stride,
+             const std::vector<std::pair<float, int>>& sorted_indices,
+             float nms_threshold,
+             float eta,
+             bool normalized,
+             std::vector<int>* selected_indices);
+
+// Run func(i) for every i in [0, n), on the threads of OpenMP if enabled.
+void ParallelFor(int64_t n, const std::function<void(int64_t)>& func);
+
+}  // namespace math
+}  // namespace host
+}  // namespace lite
+}  // namespace paddle
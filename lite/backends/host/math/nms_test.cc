@@ -0,0 +1,253 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/host/math/nms.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+namespace host {
+namespace math {
+
+// The helpers of the host NMS kernels before they shared this engine, the
+// engine should give the same results.
+namespace ref {
+
+static bool SortScorePairDescend(const std::pair<float, int>& pair1,
+                                 const std::pair<float, int>& pair2) {
+  return pair1.first > pair2.first;
+}
+
+static void GetMaxScoreIndex(
+    const std::vector<float>& scores,
+    const float threshold,
+    int top_k,
+    std::vector<std::pair<float, int>>* sorted_indices) {
+  for (size_t i = 0; i < scores.size(); ++i) {
+    if (scores[i] > threshold) {
+      sorted_indices->push_back(std::make_pair(scores[i], i));
+    }
+  }
+  std::stable_sort(
+      sorted_indices->begin(), sorted_indices->end(), SortScorePairDescend);
+  if (top_k > -1 && top_k < static_cast<int>(sorted_indices->size())) {
+    sorted_indices->resize(top_k);
+  }
+}
+
+static float BBoxArea(const float* box, const bool normalized) {
+  if (box[2] < box[0] || box[3] < box[1]) {
+    return 0.f;
+  } else {
+    const float w = box[2] - box[0];
+    const float h = box[3] - box[1];
+    if (normalized) {
+      return w * h;
+    } else {
+      return (w + 1) * (h + 1);
+    }
+  }
+}
+
+static float JaccardOverlap(const float* box1,
+                            const float* box2,
+                            const bool normalized) {
+  if (box2[0] > box1[2] || box2[2] < box1[0] || box2[1] > box1[3] ||
+      box2[3] < box1[1]) {
+    return 0.f;
+  } else {
+    const float inter_xmin = (std::max)(box1[0], box2[0]);
+    const float inter_ymin = (std::max)(box1[1], box2[1]);
+    const float inter_xmax = (std::min)(box1[2], box2[2]);
+    const float inter_ymax = (std::min)(box1[3], box2[3]);
+    float norm = normalized ? 0.f : 1.f;
+    float inter_w = inter_xmax - inter_xmin + norm;
+    float inter_h = inter_ymax - inter_ymin + norm;
+    const float inter_area = inter_w * inter_h;
+    const float bbox1_area = BBoxArea(box1, normalized);
+    const float bbox2_area = BBoxArea(box2, normalized);
+    return inter_area / (bbox1_area + bbox2_area - inter_area);
+  }
+}
+
+static void NMSFast(const std::vector<float>& bbox_data,
+                    const std::vector<float>& scores,
+                    const float score_threshold,
+                    const float nms_threshold,
+                    const float eta,
+                    const int64_t top_k,
+                    std::vector<int>* selected_indices,
+                    const bool normalized) {
+  std::vector<std::pair<float, int>> sorted_indices;
+  GetMaxScoreIndex(scores, score_threshold, top_k, &sorted_indices);
+  selected_indices->clear();
+  float adaptive_threshold = nms_threshold;
+  while (sorted_indices.size() != 0) {
+    const int idx = sorted_indices.front().second;
+    bool keep = true;
+    for (size_t k = 0; k < selected_indices->size(); ++k) {
+      if (keep) {
+        const int kept_idx = (*selected_indices)[k];
+        float overlap = JaccardOverlap(bbox_data.data() + idx * 4,
+                                       bbox_data.data() + kept_idx * 4,
+                                       normalized);
+        keep = overlap <= adaptive_threshold;
+      } else {
+        break;
+      }
+    }
+    if (keep) {
+      selected_indices->push_back(idx);
+    }
+    sorted_indices.erase(sorted_indices.begin());
+    if (keep && eta < 1 && adaptive_threshold > 0.5) {
+      adaptive_threshold *= eta;
+    }
+  }
+}
+
+}  // namespace ref
+
+// Random boxes, some of them are invalid (xmax < xmin or ymax < ymin). The
+// scores are rounded so that there are ties.
+static void RandomBoxes(int num,
+                        bool normalized,
+                        std::default_random_engine* engine,
+                        std::vector<float>* boxes,
+                        std::vector<float>* scores) {
+  const float range = normalized ? 1.f : 100.f;
+  std::uniform_real_distribution<float> coord(0.f, range);
+  std::uniform_real_distribution<float> size(-0.05f * range, 0.4f * range);
+  std::uniform_int_distribution<int> score(0, 20);
+  boxes->resize(num * 4);
+  scores->resize(num);
+  for (int i = 0; i < num; ++i) {
+    float* box = boxes->data() + i * 4;
+    box[0] = coord(*engine);
+    box[1] = coord(*engine);
+    box[2] = box[0] + size(*engine);
+    box[3] = box[1] + size(*engine);
+    (*scores)[i] = score(*engine) / 20.f;
+  }
+}
+
+TEST(nms_host, jaccard_overlap) {
+  std::default_random_engine engine(0);
+  for (bool normalized : {true, false}) {
+    std::vector<float> boxes;
+    std::vector<float> scores;
+    const int num = 150;
+    RandomBoxes(num, normalized, &engine, &boxes, &scores);
+    BoxesSoA soa;
+    soa.Reserve(num);
+    for (int i = 0; i < num; ++i) {
+      const float* box = boxes.data() + i * 4;
+      EXPECT_EQ(BBoxArea(box, normalized), ref::BBoxArea(box, normalized));
+      soa.Push(box, BBoxArea(box, normalized));
+    }
+    std::vector<float> ious(num);
+    for (int i = 0; i < num; ++i) {
+      const float* box = boxes.data() + i * 4;
+      BatchJaccardOverlap(box,
+                          BBoxArea(box, normalized),
+                          soa,
+                          0,
+                          num,
+                          normalized,
+                          ious.data());
+      for (int k = 0; k < num; ++k) {
+        const float* other = boxes.data() + k * 4;
+        float expected = ref::JaccardOverlap(box, other, normalized);
+        EXPECT_EQ(JaccardOverlap(box, other, normalized), expected);
+        EXPECT_EQ(ious[k], expected) << "box " << i << " vs " << k;
+      }
+    }
+  }
+}
+
+TEST(nms_host, get_topk_score_index) {
+  std::default_random_engine engine(1);
+  for (int num : {0, 1, 7, 100, 1000}) {
+    for (int top_k : {-1, 0, 1, 10, 5000}) {
+      std::vector<float> boxes;
+      std::vector<float> scores;
+      RandomBoxes(num, true, &engine, &boxes, &scores);
+      // The scores of the i-th box is at i * 2, as the scores of a class of
+      // the unbatched inputs.
+      std::vector<float> strided(num * 2, -1.f);
+      for (int i = 0; i < num; ++i) {
+        strided[i * 2] = scores[i];
+      }
+      std::vector<std::pair<float, int>> expected;
+      ref::GetMaxScoreIndex(scores, 0.3f, top_k, &expected);
+      std::vector<std::pair<float, int>> result;
+      GetTopKScoreIndex(strided.data(), num, 2, 0.3f, top_k, &result);
+      EXPECT_EQ(result, expected) << "num " << num << ", top_k " << top_k;
+    }
+  }
+}
+
+TEST(nms_host, nms_fast) {
+  std::default_random_engine engine(2);
+  for (bool normalized : {true, false}) {
+    for (int num : {1, 30, 500}) {
+      for (float eta : {1.f, 0.9f}) {
+        for (int top_k : {-1, 20}) {
+          std::vector<float> boxes;
+          std::vector<float> scores;
+          RandomBoxes(num, normalized, &engine, &boxes, &scores);
+          std::vector<int> expected;
+          ref::NMSFast(
+              boxes, scores, 0.1f, 0.6f, eta, top_k, &expected, normalized);
+          std::vector<std::pair<float, int>> sorted_indices;
+          GetTopKScoreIndex(
+              scores.data(), num, 1, 0.1f, top_k, &sorted_indices);
+          std::vector<int> result;
+          NMSFast(boxes.data(),
+                  4,
+                  sorted_indices,
+                  0.6f,
+                  eta,
+                  normalized,
+                  &result);
+          EXPECT_EQ(result, expected) << "normalized " << normalized
+                                      << ", num " << num << ", eta " << eta
+                                      << ", top_k " << top_k;
+        }
+      }
+    }
+  }
+}
+
+TEST(nms_host, parallel_for) {
+  const int n = 1000;
+  std::vector<std::atomic<int>> counts(n);
+  for (auto& count : counts) {
+    count = 0;
+  }
+  ParallelFor(n, [&](int64_t i) { counts[i]++; });
+  for (int i = 0; i < n; ++i) {
+    EXPECT_EQ(counts[i], 1);
+  }
+}
+
+}  // namespace math
+}  // namespace host
+}  // namespace lite
+}  // namespace paddle
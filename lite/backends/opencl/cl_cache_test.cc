@@ -0,0 +1,155 @@
+/* Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "lite/backends/opencl/cl_context.h"
+#include "lite/backends/opencl/cl_runtime.h"
+
+namespace paddle {
+namespace lite {
+
+TEST(cl_cache_test, program_cache_key) {
+  const std::vector<unsigned char> source{'a', 'b', 'c'};
+  const std::string key =
+      ProgramCacheKey("device", "image/pool_kernel.cl", "-DA", source);
+  EXPECT_EQ(key,
+            ProgramCacheKey("device", "image/pool_kernel.cl", "-DA", source));
+  // Every part of the key matters.
+  EXPECT_NE(key,
+            ProgramCacheKey("device2", "image/pool_kernel.cl", "-DA", source));
+  EXPECT_NE(key,
+            ProgramCacheKey("device", "image/fc_kernel.cl", "-DA", source));
+  EXPECT_NE(key,
+            ProgramCacheKey("device", "image/pool_kernel.cl", "-DB", source));
+  EXPECT_NE(key,
+            ProgramCacheKey(
+                "device", "image/pool_kernel.cl", "-DA", {'a', 'b', 'd'}));
+  // The key fits in the first line of the cache file.
+  const std::string multi_line_key =
+      ProgramCacheKey("dev\nice", "image/pool_kernel.cl", "-DA", source);
+  EXPECT_EQ(multi_line_key.find('\n'), std::string::npos);
+
+  const std::string path = CacheFilePath("dir", "opencl_program_", key);
+  EXPECT_EQ(path, CacheFilePath("dir", "opencl_program_", key));
+  EXPECT_EQ(path.find("dir/opencl_program_"), 0u);
+  EXPECT_EQ(path.size(), std::string("dir/opencl_program_").size() + 16);
+  EXPECT_NE(path, CacheFilePath("dir", "opencl_program_", key + " "));
+}
+
+TEST(cl_cache_test, program_binary_round_trip) {
+  const std::string key = "device|image/pool_kernel.cl|-DA|123";
+  const std::string path = CacheFilePath(".", "opencl_program_", key) + ".bin";
+  // The binary may hold any bytes, including the line breaks.
+  std::vector<unsigned char> binary{0x7f, 'E', 'L', 'F', '\n', 0, '\r', 0xff};
+  ASSERT_TRUE(WriteProgramBinary(path, key, binary));
+
+  std::vector<unsigned char> loaded;
+  ASSERT_TRUE(ReadProgramBinary(path, key, &loaded));
+  EXPECT_EQ(loaded, binary);
+  // A binary saved with another key, e.g. by another driver, is not loaded.
+  EXPECT_FALSE(ReadProgramBinary(path, key + "1", &loaded));
+
+  // The file is replaced as a whole.
+  binary.resize(3);
+  ASSERT_TRUE(WriteProgramBinary(path, key, binary));
+  ASSERT_TRUE(ReadProgramBinary(path, key, &loaded));
+  EXPECT_EQ(loaded, binary);
+
+  std::remove(path.c_str());
+  EXPECT_FALSE(ReadProgramBinary(path, key, &loaded));
+}
+
+// The cases below need an OpenCL device.
+TEST(cl_cache_test, cached_program) {
+  auto* runtime = CLRuntime::Global();
+  ASSERT_TRUE(runtime->IsInitSuccess()) << "No OpenCL device is found";
+  // The precision is added to the build options if it is not given.
+  EXPECT_NE(runtime->BuildOptions("").find("-DCL_DTYPE_"), std::string::npos);
+  EXPECT_EQ(runtime->BuildOptions("-DCL_DTYPE_float").find("-DCL_DTYPE_half"),
+            std::string::npos);
+
+  const std::string file_name = "image/pool_kernel.cl";
+  const std::string options = "-DCL_DTYPE_float";
+  const std::string key =
+      ProgramCacheKey(runtime->DeviceKey(),
+                      file_name,
+                      runtime->BuildOptions(options),
+                      opencl_kernels_files.at(file_name));
+  const std::string path = CacheFilePath(".", "opencl_program_", key) + ".bin";
+  std::remove(path.c_str());
+
+  runtime->set_cache_dir(".");
+  {
+    // The compiled binary is saved.
+    CLContext context;
+    context.AddKernel("pool_max", file_name, options);
+  }
+  std::vector<unsigned char> binary;
+  EXPECT_TRUE(ReadProgramBinary(path, key, &binary));
+  {
+    // And it is loaded by the later contexts.
+    CLContext context;
+    context.AddKernel("pool_max", file_name, options);
+  }
+  runtime->set_cache_dir("");
+  std::remove(path.c_str());
+}
+
+TEST(cl_cache_test, cached_tuned_lws) {
+  auto* runtime = CLRuntime::Global();
+  ASSERT_TRUE(runtime->IsInitSuccess()) << "No OpenCL device is found";
+  const std::string path =
+      CacheFilePath(".",
+                    "opencl_tuned_lws_",
+                    runtime->DeviceKey() + "|" + runtime->BuildOptions("")) +
+      ".txt";
+  std::remove(path.c_str());
+
+  runtime->set_cache_dir(".");
+  runtime->set_auto_tune(lite_api::CL_TUNE_NORMAL);
+  const std::string key = "pool_max/1x8x16x16";
+  {
+    // The tuned sizes are saved.
+    CLContext context;
+    cl::NDRange lws;
+    EXPECT_FALSE(context.HasTunedLocalWorkSizeMap(key, &lws));
+    context.SetTunedLocalWorkSizeMap(key, cl::NDRange{4, 2, 1});
+  }
+  {
+    // And they are loaded by the later contexts of the same mode.
+    CLContext context;
+    cl::NDRange lws;
+    ASSERT_TRUE(context.HasTunedLocalWorkSizeMap(key, &lws));
+    EXPECT_EQ(lws[0], 4u);
+    EXPECT_EQ(lws[1], 2u);
+    EXPECT_EQ(lws[2], 1u);
+  }
+  {
+    // The sizes tuned by a cheaper mode are not reused.
+    runtime->set_auto_tune(lite_api::CL_TUNE_EXHAUSTIVE);
+    CLContext context;
+    cl::NDRange lws;
+    EXPECT_FALSE(context.HasTunedLocalWorkSizeMap(key, &lws));
+  }
+  runtime->set_auto_tune(lite_api::CL_TUNE_NONE);
+  runtime->set_cache_dir("");
+  std::remove(path.c_str());
+}
+
+}  // namespace lite
+}  // namespace paddle
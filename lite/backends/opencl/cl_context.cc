@@ -10,7 +10,13 @@ See the License for the specific language governing permissions and
 limitations under the License. */
 
 #include "lite/backends/opencl/cl_context.h"
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <iterator>
 #include <memory>
+#include <sstream>
 #include <string>
 #include <utility>
 #include "lite/api/paddle_place.h"
@@ -22,6 +28,145 @@ limitations under the License. */
 namespace paddle {
 namespace lite {
 
+namespace {
+
+// FNV-1a, the names of the cache files must be stable across the processes.
+uint64_t HashString(const std::string &str) {
+  uint64_t hash = 14695981039346656037ULL;
+  for (unsigned char c : str) {
+    hash ^= c;
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+std::string CacheFile(const std::string &prefix, const std::string &key) {
+  return CacheFilePath(CLRuntime::Global()->cache_dir(), prefix, key);
+}
+
+}  // namespace
+
+std::string ProgramCacheKey(const std::string &device_key,
+                            const std::string &file_name,
+                            const std::string &build_options,
+                            const std::vector<unsigned char> &source) {
+  std::string key =
+      device_key + "|" + file_name + "|" + build_options + "|" +
+      std::to_string(HashString(std::string(source.begin(), source.end())));
+  // The key is saved as the first line of the cache file.
+  for (auto &c : key) {
+    if (c == '\n') c = ' ';
+  }
+  return key;
+}
+
+std::string CacheFilePath(const std::string &cache_dir,
+                          const std::string &prefix,
+                          const std::string &key) {
+  char hash[17];
+  snprintf(hash,
+           sizeof(hash),
+           "%016llx",
+           static_cast<unsigned long long>(HashString(key)));  // NOLINT
+  return cache_dir + "/" + prefix + hash;
+}
+
+bool ReadProgramBinary(const std::string &path,
+                       const std::string &key,
+                       std::vector<unsigned char> *binary) {
+  CHECK(binary);
+  std::ifstream in(path, std::ios::binary);
+  std::string saved_key;
+  if (!in || !std::getline(in, saved_key) || saved_key != key) return false;
+  binary->assign(std::istreambuf_iterator<char>(in),
+                 std::istreambuf_iterator<char>());
+  return !binary->empty();
+}
+
+bool WriteProgramBinary(const std::string &path,
+                        const std::string &key,
+                        const std::vector<unsigned char> &binary) {
+  // Renamed after written, the concurrent processes never read a partial file.
+  std::string tmp_path = path + ".tmp" + std::to_string(clock());
+  {
+    std::ofstream out(tmp_path, std::ios::binary);
+    out << key << "\n";
+    out.write(reinterpret_cast<const char *>(binary.data()), binary.size());
+    if (!out) {
+      LOG(WARNING) << "Failed to write the program cache " << tmp_path;
+      out.close();
+      std::remove(tmp_path.c_str());
+      return false;
+    }
+  }
+  if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+    std::remove(tmp_path.c_str());
+    return false;
+  }
+  return true;
+}
+
+CLContext::CLContext() {
+  if (CLRuntime::Global()->cache_dir().empty()) return;
+  int tune_mode = static_cast<int>(CLRuntime::Global()->auto_tune());
+  std::ifstream file(TunedLocalWorkSizeFile());
+  std::string line;
+  while (std::getline(file, line)) {
+    std::istringstream ss(line);
+    int mode = 0;
+    size_t lws[3];
+    std::string key;
+    if (!(ss >> mode >> lws[0] >> lws[1] >> lws[2] >> key)) {
+      LOG(WARNING) << "Invalid record of the tuned local work sizes: " << line;
+      continue;
+    }
+    // The sizes tuned by a cheaper mode are tuned again.
+    if (mode < tune_mode) continue;
+    tuned_lwss_map_[key] = cl::NDRange{lws[0], lws[1], lws[2]};
+  }
+  VLOG(3) << "Loaded " << tuned_lwss_map_.size()
+          << " tuned local work sizes from " << TunedLocalWorkSizeFile();
+}
+
+std::string CLContext::TunedLocalWorkSizeFile() {
+  // The kernels differ in the precisions.
+  std::string key = CLRuntime::Global()->DeviceKey() + "|" +
+                    CLRuntime::Global()->BuildOptions("");
+  return CacheFile("opencl_tuned_lws_", key) + ".txt";
+}
+
+std::unique_ptr<cl::Program> CLContext::GetCachedProgram(
+    const std::string &file_name, const std::string &options) {
+  auto runtime = CLRuntime::Global();
+  if (runtime->cache_dir().empty()) return nullptr;
+  auto source = opencl_kernels_files.find(file_name);
+  CHECK(source != opencl_kernels_files.end())
+      << "Cannot find the OpenCL kernel file: " << file_name;
+  // The binary is verified by the full key saved in the first line.
+  std::string key = ProgramCacheKey(runtime->DeviceKey(),
+                                    file_name,
+                                    runtime->BuildOptions(options),
+                                    source->second);
+  std::string path = CacheFile("opencl_program_", key) + ".bin";
+
+  std::vector<unsigned char> binary;
+  if (ReadProgramBinary(path, key, &binary)) {
+    auto program = runtime->CreateProgramWithBinary(GetContext(), binary);
+    if (program && runtime->BuildProgram(program.get(), options)) {
+      VLOG(3) << " --- program " << file_name << " loaded from " << path;
+      return program;
+    }
+    LOG(WARNING) << "The cached program " << path << " is invalid, rebuild it";
+  }
+
+  auto program = runtime->CreateProgram(GetContext(), file_name);
+  if (!runtime->BuildProgram(program.get(), options)) return program;
+  if (runtime->GetProgramBinary(*program, &binary)) {
+    WriteProgramBinary(path, key, binary);
+  }
+  return program;
+}
+
 cl::CommandQueue &CLContext::GetCommandQueue() {
   return CLRuntime::Global()->command_queue();
 }
@@ -41,14 +186,17 @@ cl::Program &CLContext::GetProgram(const std::string &file_name,
     return *(it->second);
   }
 
-  auto program = CLRuntime::Global()->CreateProgram(GetContext(), file_name);
+  auto program = GetCachedProgram(file_name, options);
+  if (program == nullptr) {
+    program = CLRuntime::Global()->CreateProgram(GetContext(), file_name);
 #ifdef LITE_WITH_LOG
-  VLOG(3) << " --- begin build program -> " << program_key << " --- ";
+    VLOG(3) << " --- begin build program -> " << program_key << " --- ";
 #endif
-  CLRuntime::Global()->BuildProgram(program.get(), options);
+    CLRuntime::Global()->BuildProgram(program.get(), options);
 #ifdef LITE_WITH_LOG
-  VLOG(3) << " --- end build program -> " << program_key << " --- ";
+    VLOG(3) << " --- end build program -> " << program_key << " --- ";
 #endif
+  }
 
   programs_[program_key] = std::move(program);
 
@@ -268,6 +416,15 @@ void CLContext::SetTunedLocalWorkSizeMap(const std::string &key,
                << lws[2];
   }
   tuned_lwss_map_.insert(std::pair<std::string, cl::NDRange>(key, lws));
+  if (CLRuntime::Global()->cache_dir().empty()) return;
+  std::ofstream file(TunedLocalWorkSizeFile(), std::ios::app);
+  if (!file) {
+    LOG(WARNING) << "Failed to write the tuned local work sizes to "
+                 << TunedLocalWorkSizeFile();
+    return;
+  }
+  file << static_cast<int>(CLRuntime::Global()->auto_tune()) << " " << lws[0]
+       << " " << lws[1] << " " << lws[2] << " " << key << "\n";
 }
 
 std::map<std::string, cl::NDRange> CLContext::GetTunedLocalWorkSizeMap() {
@@ -24,8 +24,35 @@ limitations under the License. */
 namespace paddle {
 namespace lite {
 
+// The key of the binary of an OpenCL kernel file built with the full build
+// options on a device, see CLRuntime::DeviceKey. The source is hashed as it
+// changes across the versions.
+std::string ProgramCacheKey(const std::string &device_key,
+                            const std::string &file_name,
+                            const std::string &build_options,
+                            const std::vector<unsigned char> &source);
+
+// The cache file in `cache_dir` named by `prefix` and the hash of `key`.
+std::string CacheFilePath(const std::string &cache_dir,
+                          const std::string &prefix,
+                          const std::string &key);
+
+// Read the program binary saved with `key`, false if the file is missing or
+// it is saved with another key.
+bool ReadProgramBinary(const std::string &path,
+                       const std::string &key,
+                       std::vector<unsigned char> *binary);
+
+// Save the program binary with `key` as the first line.
+bool WriteProgramBinary(const std::string &path,
+                        const std::string &key,
+                        const std::vector<unsigned char> &binary);
+
 class CLContext {
  public:
+  // The tuned local work sizes in the cache dir of CLRuntime are loaded.
+  CLContext();
+
   ~CLContext() {
     GetCommandQueue().finish();
     for (size_t kidx = 0; kidx < kernels_.size(); ++kidx) {
@@ -79,6 +106,13 @@ class CLContext {
   cl::NDRange GetTunedLocalWorkSizeFromMap(const std::string &key);
 
  private:
+  // Build the program from the binary in the cache dir, or from the source
+  // and save the binary. nullptr if the cache is disabled or unusable.
+  std::unique_ptr<cl::Program> GetCachedProgram(const std::string &file_name,
+                                                const std::string &options);
+
+  std::string TunedLocalWorkSizeFile();
+
   std::map<std::string, std::unique_ptr<cl::Program>> programs_;
   std::vector<std::shared_ptr<cl::Kernel>> kernels_;
   std::map<std::string, int> kernel_offset_;
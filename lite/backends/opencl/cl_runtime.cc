@@ -10,6 +10,7 @@ See the License for the specific language governing permissions and
 limitations under the License. */
 
 #include "lite/backends/opencl/cl_runtime.h"
+#include <algorithm>
 #include <string>
 #include <utility>
 #include <vector>
@@ -145,7 +146,46 @@ std::unique_ptr<cl::UserEvent> CLRuntime::CreateEvent(
   return std::move(event);
 }
 
-bool CLRuntime::BuildProgram(cl::Program* program, const std::string& options) {
+std::unique_ptr<cl::Program> CLRuntime::CreateProgramWithBinary(
+    const cl::Context& context, const std::vector<unsigned char>& binary) {
+  cl::Program::Binaries binaries{binary};
+  std::vector<cl_int> binary_status;
+  auto prog = std::unique_ptr<cl::Program>(new cl::Program(
+      context, {device()}, binaries, &binary_status, &status_));
+  if (status_ != CL_SUCCESS || binary_status.empty() ||
+      binary_status[0] != CL_SUCCESS) {
+    VLOG(3) << "Failed to create the program with the binary, status: "
+            << status_;
+    return nullptr;
+  }
+  return std::move(prog);
+}
+
+bool CLRuntime::GetProgramBinary(const cl::Program& program,
+                                 std::vector<unsigned char>* binary) {
+  CHECK(binary);
+  std::vector<std::vector<unsigned char>> binaries;
+  status_ = program.getInfo(CL_PROGRAM_BINARIES, &binaries);
+  if (status_ != CL_SUCCESS || binaries.size() != 1 || binaries[0].empty()) {
+    VLOG(3) << "Failed to get the binary of the program, status: " << status_;
+    return false;
+  }
+  *binary = std::move(binaries[0]);
+  return true;
+}
+
+std::string CLRuntime::DeviceKey() {
+  std::string key = platform().getInfo<CL_PLATFORM_NAME>() + "|" +
+                    platform().getInfo<CL_PLATFORM_VERSION>() + "|" +
+                    device().getInfo<CL_DEVICE_NAME>() + "|" +
+                    device().getInfo<CL_DEVICE_VERSION>() + "|" +
+                    device().getInfo<CL_DRIVER_VERSION>();
+  // The strings of the info may end with '\0'.
+  key.erase(std::remove(key.begin(), key.end(), '\0'), key.end());
+  return key;
+}
+
+std::string CLRuntime::BuildOptions(const std::string& options) {
   /* -I +CLRuntime::Global()->cl_path() + "/cl_kernel"*/
   std::string build_option = options + " -cl-fast-relaxed-math -cl-mad-enable";
   if (build_option.find("CL_DTYPE_") == std::string::npos) {
@@ -155,6 +195,11 @@ bool CLRuntime::BuildProgram(cl::Program* program, const std::string& options) {
       build_option += " -DCL_DTYPE_float -DCL_DTYPE_FLOAT_FORCE ";
     }
   }
+  return build_option;
+}
+
+bool CLRuntime::BuildProgram(cl::Program* program, const std::string& options) {
+  std::string build_option = BuildOptions(options);
 #ifdef LITE_WITH_LOG
   VLOG(4) << "precision_:" << static_cast<size_t>(precision_);
   VLOG(4) << "OpenCL build_option: " << build_option;
@@ -129,6 +129,26 @@ class CLRuntime {
 
   bool BuildProgram(cl::Program* program, const std::string& options = "");
 
+  // The full options to build a program with `options`, the precision is
+  // added if not given.
+  std::string BuildOptions(const std::string& options);
+
+  std::unique_ptr<cl::Program> CreateProgramWithBinary(
+      const cl::Context& context, const std::vector<unsigned char>& binary);
+
+  // The binary of a built program for the device, false if unavailable.
+  bool GetProgramBinary(const cl::Program& program,
+                        std::vector<unsigned char>* binary);
+
+  // The compiled programs and the tuned local work sizes are saved in the
+  // cache dir, and reused by the later processes. Empty to disable.
+  void set_cache_dir(const std::string& cache_dir) { cache_dir_ = cache_dir; }
+  const std::string& cache_dir() const { return cache_dir_; }
+
+  // Identifies the platform, the device and the driver, the caches are never
+  // reused by the others.
+  std::string DeviceKey();
+
   bool IsInitSuccess() { return is_platform_device_init_success_; }
 
   std::string cl_path() { return cl_path_; }
@@ -207,6 +227,8 @@ class CLRuntime {
 
   std::string cl_path_;
 
+  std::string cache_dir_;
+
   std::shared_ptr<cl::Platform> platform_{nullptr};
 
   std::shared_ptr<cl::Context> context_{nullptr};
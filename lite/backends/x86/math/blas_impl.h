@@ -16,6 +16,9 @@
 #include <limits>
 #include <vector>
 #include "lite/backends/x86/math/math_function.h"
+#ifndef PADDLE_WITH_MKLML
+#include "lite/backends/x86/math/sgemm.h"
+#endif
 
 namespace paddle {
 namespace lite {
@@ -245,9 +248,52 @@ struct CBlas<double> {
 
 template <>
 struct CBlas<float> {
-  template <typename... ARGS>
-  static void GEMM(ARGS... args) {
-    cblas_sgemm(args...);
+  // The row major sgemm is computed by the in-tree kernels, which are faster
+  // than the most of the cblas libraries on the cpus with AVX2 or AVX-512.
+  static void GEMM(const CBLAS_ORDER order,
+                   const CBLAS_TRANSPOSE trans_a,
+                   const CBLAS_TRANSPOSE trans_b,
+                   const int M,
+                   const int N,
+                   const int K,
+                   const float alpha,
+                   const float *A,
+                   const int lda,
+                   const float *B,
+                   const int ldb,
+                   const float beta,
+                   float *C,
+                   const int ldc) {
+    if (order != CblasRowMajor) {
+      cblas_sgemm(order,
+                  trans_a,
+                  trans_b,
+                  M,
+                  N,
+                  K,
+                  alpha,
+                  A,
+                  lda,
+                  B,
+                  ldb,
+                  beta,
+                  C,
+                  ldc);
+      return;
+    }
+    Sgemm(trans_a != CblasNoTrans,
+          trans_b != CblasNoTrans,
+          M,
+          N,
+          K,
+          alpha,
+          A,
+          lda,
+          B,
+          ldb,
+          beta,
+          C,
+          ldc);
   }
 
   template <typename... ARGS>
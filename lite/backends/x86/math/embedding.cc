@@ -0,0 +1,123 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/math/embedding.h"
+#include <cstring>
+#if defined(__AVX2__) || defined(__F16C__)
+#include <immintrin.h>
+#endif
+#include "lite/utils/cp_logging.h"
+#include "lite/utils/float16.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+template <bool kAdd>
+static void DequantRow(const int8_t* row, float scale, int64_t n, float* out) {
+  int64_t i = 0;
+#ifdef __AVX2__
+  __m256 vscale = _mm256_set1_ps(scale);
+  for (; i + 8 <= n; i += 8) {
+    __m128i q = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(row + i));
+    __m256 x = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(q)),
+                             vscale);
+    if (kAdd) x = _mm256_add_ps(x, _mm256_loadu_ps(out + i));
+    _mm256_storeu_ps(out + i, x);
+  }
+#endif
+  for (; i < n; i++) {
+    float x = row[i] * scale;
+    out[i] = kAdd ? out[i] + x : x;
+  }
+}
+
+template <bool kAdd>
+static void DequantRow(const float16* row, int64_t n, float* out) {
+  int64_t i = 0;
+#ifdef __F16C__
+  for (; i + 8 <= n; i += 8) {
+    __m256 x = _mm256_cvtph_ps(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i)));
+    if (kAdd) x = _mm256_add_ps(x, _mm256_loadu_ps(out + i));
+    _mm256_storeu_ps(out + i, x);
+  }
+#endif
+  for (; i < n; i++) {
+    float x = static_cast<float>(row[i]);
+    out[i] = kAdd ? out[i] + x : x;
+  }
+}
+
+EmbeddingTable::EmbeddingTable(const Tensor& table,
+                               const std::vector<float>& scales)
+    : data_(table.raw_data()), precision_(table.precision()) {
+  CHECK_EQ(table.dims().size(), 2UL);
+  height_ = table.dims()[0];
+  width_ = table.dims()[1];
+  if (precision_ == PRECISION(kInt8)) {
+    CHECK_EQ(static_cast<int64_t>(scales.size()), height_)
+        << "The int8 embedding table needs a scale for every row.";
+    scales_ = scales.data();
+  } else if (precision_ != PRECISION(kFP16)) {
+    // The others are the tables of fp32.
+    precision_ = PRECISION(kFloat);
+  }
+}
+
+void EmbeddingTable::CopyRow(int64_t id, float* out) const {
+  switch (precision_) {
+    case PRECISION(kInt8):
+      DequantRow<false>(static_cast<const int8_t*>(data_) + id * width_,
+                        scales_[id],
+                        width_,
+                        out);
+      break;
+    case PRECISION(kFP16):
+      DequantRow<false>(
+          static_cast<const float16*>(data_) + id * width_, width_, out);
+      break;
+    default:
+      std::memcpy(out,
+                  static_cast<const float*>(data_) + id * width_,
+                  width_ * sizeof(float));
+  }
+}
+
+void EmbeddingTable::AddRow(int64_t id, float* out) const {
+  switch (precision_) {
+    case PRECISION(kInt8):
+      DequantRow<true>(static_cast<const int8_t*>(data_) + id * width_,
+                       scales_[id],
+                       width_,
+                       out);
+      break;
+    case PRECISION(kFP16):
+      DequantRow<true>(
+          static_cast<const float16*>(data_) + id * width_, width_, out);
+      break;
+    default: {
+      const float* row = static_cast<const float*>(data_) + id * width_;
+      for (int64_t i = 0; i < width_; i++) {
+        out[i] += row[i];
+      }
+    }
+  }
+}
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,60 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "lite/api/paddle_place.h"
+#include "lite/core/tensor.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+// Whether the table is compressed by embedding_quant_pass.
+inline bool IsCompressedEmbedding(const Tensor& table) {
+  return table.precision() == PRECISION(kInt8) ||
+         table.precision() == PRECISION(kFP16);
+}
+
+// Reads the rows of an embedding table in fp32, or compressed by
+// embedding_quant_pass to int8 with a scale per row or to fp16. The rows are
+// dequantized when they are read, so only the read rows of a memory-mapped
+// table become resident.
+class EmbeddingTable {
+ public:
+  EmbeddingTable(const Tensor& table, const std::vector<float>& scales);
+
+  int64_t height() const { return height_; }
+  int64_t width() const { return width_; }
+
+  // out = table[id]
+  void CopyRow(int64_t id, float* out) const;
+  // out += table[id]
+  void AddRow(int64_t id, float* out) const;
+
+ private:
+  const void* data_{nullptr};
+  const float* scales_{nullptr};
+  PrecisionType precision_{PRECISION(kFloat)};
+  int64_t height_{0};
+  int64_t width_{0};
+};
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
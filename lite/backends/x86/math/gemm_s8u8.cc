@@ -0,0 +1,328 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/math/gemm_s8u8.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+#include "lite/backends/x86/cpu_info.h"
+#include "lite/backends/x86/math/gemm_s8u8_kernel.h"
+#include "lite/backends/x86/parallel.h"
+#include "lite/utils/cp_logging.h"
+#include "lite/utils/macros.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+namespace {
+
+constexpr int kRefMR = 4;
+constexpr int kRefNR = 8;
+
+void GemmS8u8KernelRef(int k4, const int8_t* a, const uint8_t* b, int32_t* c) {
+  int32_t acc[kRefMR][kRefNR] = {};
+  for (int p = 0; p < k4; p++) {
+    for (int i = 0; i < kRefMR; i++) {
+      for (int j = 0; j < kRefNR; j++) {
+        for (int t = 0; t < 4; t++) {
+          acc[i][j] += static_cast<int32_t>(a[i * 4 + t]) *
+                       static_cast<int32_t>(b[j * 4 + t]);
+        }
+      }
+    }
+    a += kRefMR * 4;
+    b += kRefNR * 4;
+  }
+  memcpy(c, acc, sizeof(acc));
+}
+
+const GemmS8u8Kernel kGemmS8u8KernelRef = {
+    "ref", kRefMR, kRefNR, 256, GemmS8u8KernelRef};
+
+inline int RoundUp(int x, int y) { return (x + y - 1) / y * y; }
+
+const GemmS8u8Kernel& GetDefaultKernel() {
+  static const GemmS8u8Kernel* kernel = GetGemmS8u8Kernels().front();
+  return *kernel;
+}
+
+// Pack the columns [j0, j0 + n) of op(B) into the panels of nr columns, the
+// values are shifted to uint8 by adding 128.
+void PackB(const GemmS8u8Kernel& kernel,
+           bool trans_b,
+           int K,
+           int j0,
+           int n,
+           const int8_t* B,
+           int ldb,
+           uint8_t* packed) {
+  const int nr = kernel.nr;
+  const int k4 = (K + 3) / 4;
+  const int num_panels = (n + nr - 1) / nr;
+  RunParallelFor(0, num_panels, [&](int64_t begin, int64_t end) {
+    for (int64_t panel = begin; panel < end; panel++) {
+      int j_begin = static_cast<int>(panel) * nr;
+      int cols = (std::min)(nr, n - j_begin);
+      uint8_t* dst = packed + panel * nr * k4 * 4;
+      for (int p = 0; p < k4; p++) {
+        for (int j = 0; j < nr; j++) {
+          for (int t = 0; t < 4; t++) {
+            int row = p * 4 + t;
+            int col = j0 + j_begin + j;
+            int8_t v = 0;
+            if (j < cols && row < K) {
+              v = trans_b ? B[col * ldb + row] : B[row * ldb + col];
+            }
+            dst[j * 4 + t] = static_cast<uint8_t>(v + 128);
+          }
+        }
+        dst += nr * 4;
+      }
+    }
+  });
+}
+
+template <typename T>
+inline T Requantize(float v);
+
+template <>
+inline float Requantize<float>(float v) {
+  return v;
+}
+
+template <>
+inline int8_t Requantize<int8_t>(float v) {
+  int32_t q = static_cast<int32_t>(std::round(v));
+  return static_cast<int8_t>((std::min)(127, (std::max)(-127, q)));
+}
+
+}  // namespace
+
+const GemmS8u8Kernel* GetGemmS8u8KernelRef() { return &kGemmS8u8KernelRef; }
+
+std::vector<const GemmS8u8Kernel*> GetGemmS8u8Kernels() {
+  std::vector<const GemmS8u8Kernel*> kernels;
+  if (GetGemmS8u8KernelVnni() && MayIUse(avx512_core_vnni)) {
+    kernels.push_back(GetGemmS8u8KernelVnni());
+  }
+  if (GetGemmS8u8KernelAvx2() && MayIUse(avx2)) {
+    kernels.push_back(GetGemmS8u8KernelAvx2());
+  }
+  kernels.push_back(GetGemmS8u8KernelRef());
+  return kernels;
+}
+
+size_t GemmS8u8PackedASizeImpl(const GemmS8u8Kernel& kernel, int M, int K) {
+  // The packed panels of A are followed by the compensation of the rows.
+  size_t Mp = RoundUp(M, kernel.mr);
+  return Mp * RoundUp(K, 4) + Mp * sizeof(int32_t);
+}
+
+void GemmS8u8PackAImpl(const GemmS8u8Kernel& kernel,
+                       bool trans_a,
+                       int M,
+                       int K,
+                       const int8_t* A,
+                       int lda,
+                       int8_t* packed_a) {
+  const int mr = kernel.mr;
+  const int k4 = (K + 3) / 4;
+  const int num_panels = (M + mr - 1) / mr;
+  int32_t* comp = reinterpret_cast<int32_t*>(
+      packed_a + static_cast<size_t>(num_panels) * mr * k4 * 4);
+  for (int panel = 0; panel < num_panels; panel++) {
+    int8_t* dst = packed_a + static_cast<size_t>(panel) * mr * k4 * 4;
+    for (int i = 0; i < mr; i++) {
+      int row = panel * mr + i;
+      int32_t sum = 0;
+      for (int p = 0; p < k4 * 4; p++) {
+        int8_t v = 0;
+        if (row < M && p < K) {
+          v = trans_a ? A[p * lda + row] : A[row * lda + p];
+        }
+        dst[(p / 4) * mr * 4 + i * 4 + p % 4] = v;
+        sum += v;
+      }
+      comp[panel * mr + i] = 128 * sum;
+    }
+  }
+}
+
+template <typename T>
+void GemmS8u8Impl(const GemmS8u8Kernel& kernel,
+                  int M,
+                  int N,
+                  int K,
+                  const int8_t* packed_a,
+                  bool trans_b,
+                  const int8_t* B,
+                  int ldb,
+                  const float* scale,
+                  const float* bias,
+                  const GemmS8u8Act& act,
+                  bool trans_c,
+                  T* C,
+                  int ldc) {
+  CHECK_LE(kernel.mr, kGemmS8u8MaxMR);
+  CHECK_LE(kernel.nr, kGemmS8u8MaxNR);
+  if (M <= 0 || N <= 0) return;
+  const int mr = kernel.mr;
+  const int nr = kernel.nr;
+  const int k4 = (K + 3) / 4;
+  const int m_panels = (M + mr - 1) / mr;
+  const int32_t* comp = reinterpret_cast<const int32_t*>(
+      packed_a + static_cast<size_t>(m_panels) * mr * k4 * 4);
+
+  static LITE_THREAD_LOCAL std::vector<uint8_t> b_buffer;
+  b_buffer.resize(static_cast<size_t>(kernel.nc) * k4 * 4);
+
+  for (int jc = 0; jc < N; jc += kernel.nc) {
+    int nc = (std::min)(kernel.nc, N - jc);
+    PackB(kernel, trans_b, K, jc, nc, B, ldb, b_buffer.data());
+    const uint8_t* packed_b = b_buffer.data();
+    const int n_panels = (nc + nr - 1) / nr;
+    RunParallelFor(0, m_panels * n_panels, [&](int64_t begin, int64_t end) {
+      int32_t tile[kGemmS8u8MaxMR * kGemmS8u8MaxNR];
+      for (int64_t t = begin; t < end; t++) {
+        int jp = static_cast<int>(t / m_panels);
+        int ip = static_cast<int>(t % m_panels);
+        kernel.compute(k4,
+                       packed_a + static_cast<size_t>(ip) * mr * k4 * 4,
+                       packed_b + static_cast<size_t>(jp) * nr * k4 * 4,
+                       tile);
+        int rows = (std::min)(mr, M - ip * mr);
+        int cols = (std::min)(nr, nc - jp * nr);
+        for (int i = 0; i < rows; i++) {
+          int row = ip * mr + i;
+          float s = scale[row];
+          float b = bias ? bias[row] : 0.f;
+          int32_t c = comp[row];
+          const int32_t* ti = tile + i * nr;
+          for (int j = 0; j < cols; j++) {
+            int col = jc + jp * nr + j;
+            float v = static_cast<float>(ti[j] - c) * s + b;
+            v = act(v);
+            T* dst = trans_c ? C + col * ldc + row : C + row * ldc + col;
+            *dst = Requantize<T>(v);
+          }
+        }
+      }
+    });
+  }
+}
+
+template void GemmS8u8Impl<float>(const GemmS8u8Kernel&,
+                                  int,
+                                  int,
+                                  int,
+                                  const int8_t*,
+                                  bool,
+                                  const int8_t*,
+                                  int,
+                                  const float*,
+                                  const float*,
+                                  const GemmS8u8Act&,
+                                  bool,
+                                  float*,
+                                  int);
+template void GemmS8u8Impl<int8_t>(const GemmS8u8Kernel&,
+                                   int,
+                                   int,
+                                   int,
+                                   const int8_t*,
+                                   bool,
+                                   const int8_t*,
+                                   int,
+                                   const float*,
+                                   const float*,
+                                   const GemmS8u8Act&,
+                                   bool,
+                                   int8_t*,
+                                   int);
+
+size_t GemmS8u8PackedASize(int M, int K) {
+  return GemmS8u8PackedASizeImpl(GetDefaultKernel(), M, K);
+}
+
+void GemmS8u8PackA(
+    bool trans_a, int M, int K, const int8_t* A, int lda, int8_t* packed_a) {
+  GemmS8u8PackAImpl(GetDefaultKernel(), trans_a, M, K, A, lda, packed_a);
+}
+
+template <typename T>
+void GemmS8u8(int M,
+              int N,
+              int K,
+              const int8_t* packed_a,
+              bool trans_b,
+              const int8_t* B,
+              int ldb,
+              const float* scale,
+              const float* bias,
+              const GemmS8u8Act& act,
+              bool trans_c,
+              T* C,
+              int ldc) {
+  GemmS8u8Impl<T>(GetDefaultKernel(),
+                  M,
+                  N,
+                  K,
+                  packed_a,
+                  trans_b,
+                  B,
+                  ldb,
+                  scale,
+                  bias,
+                  act,
+                  trans_c,
+                  C,
+                  ldc);
+}
+
+template void GemmS8u8<float>(int,
+                              int,
+                              int,
+                              const int8_t*,
+                              bool,
+                              const int8_t*,
+                              int,
+                              const float*,
+                              const float*,
+                              const GemmS8u8Act&,
+                              bool,
+                              float*,
+                              int);
+template void GemmS8u8<int8_t>(int,
+                               int,
+                               int,
+                               const int8_t*,
+                               bool,
+                               const int8_t*,
+                               int,
+                               const float*,
+                               const float*,
+                               const GemmS8u8Act&,
+                               bool,
+                               int8_t*,
+                               int);
+
+const char* GemmS8u8KernelName() { return GetDefaultKernel().name; }
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
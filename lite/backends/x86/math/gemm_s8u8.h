@@ -0,0 +1,96 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+/*
+ * The int8 GEMM of the x86 int8 kernels.
+ *
+ * C = requantize(A * B), A(M x K) is the int8 weights, which are packed once
+ * by GemmS8u8PackA, and B(K x N) is the int8 activations. The activations are
+ * shifted to uint8 while being packed, so the u8 x s8 dot products of
+ * AVX512-VNNI can be used, the shift is compensated by the sums of the rows of
+ * A. The micro kernel is picked by the cpu at runtime: AVX512-VNNI, AVX2 or
+ * the plain C++ one.
+ *
+ * The int32 results are requantized row by row:
+ *   C(i, j) = act(scale[i] * A(i, :) * B(:, j) + bias[i])
+ * and rounded to [-127, 127] if the output is int8. C(i, j) is stored at
+ * C[i * ldc + j], or C[j * ldc + i] if trans_c is true.
+ */
+
+// The activation fused into the requantization. The threshold of relu6 is in
+// the scale of C, i.e. it is divided by the output scale if C is int8.
+struct GemmS8u8Act {
+  enum Type { kNone = 0, kRelu, kRelu6, kLeakyRelu };
+  Type type{kNone};
+  float threshold{6.f};
+  float alpha{0.f};
+
+  GemmS8u8Act() = default;
+  explicit GemmS8u8Act(bool relu) : type(relu ? kRelu : kNone) {}
+
+  float operator()(float v) const {
+    switch (type) {
+      case kRelu:
+        return (std::max)(v, 0.f);
+      case kRelu6:
+        return (std::min)((std::max)(v, 0.f), threshold);
+      case kLeakyRelu:
+        return v < 0.f ? v * alpha : v;
+      default:
+        return v;
+    }
+  }
+};
+
+// The size in bytes of A packed by GemmS8u8PackA.
+size_t GemmS8u8PackedASize(int M, int K);
+
+// op(A) is M x K, A is K x M if trans_a is true.
+void GemmS8u8PackA(
+    bool trans_a, int M, int K, const int8_t* A, int lda, int8_t* packed_a);
+
+// op(B) is K x N, B is N x K if trans_b is true. bias can be nullptr.
+template <typename T>
+void GemmS8u8(int M,
+              int N,
+              int K,
+              const int8_t* packed_a,
+              bool trans_b,
+              const int8_t* B,
+              int ldb,
+              const float* scale,
+              const float* bias,
+              const GemmS8u8Act& act,
+              bool trans_c,
+              T* C,
+              int ldc);
+
+// The name of the micro kernel picked at runtime, e.g. "avx512_vnni".
+const char* GemmS8u8KernelName();
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
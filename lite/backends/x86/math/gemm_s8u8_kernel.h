@@ -0,0 +1,87 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "lite/backends/x86/math/gemm_s8u8.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+// The max size of the tiles of the micro kernels.
+constexpr int kGemmS8u8MaxMR = 8;
+constexpr int kGemmS8u8MaxNR = 32;
+
+// The micro kernel of GemmS8u8.
+//
+// K is padded to a multiple of 4, and every 4 values of K are stored
+// together, so that they are multiplied and added by one instruction:
+//   a: [K / 4][mr][4] int8, the rows of A.
+//   b: [K / 4][nr][4] uint8, the columns of B plus 128.
+struct GemmS8u8Kernel {
+  const char* name;
+  // The size of the tile of C computed by one call.
+  int mr;
+  int nr;
+  // The number of the columns of B packed at a time, a multiple of nr.
+  int nc;
+  // c[mr][nr] = a * b, k4 is the number of the groups of 4 values of K.
+  void (*compute)(int k4, const int8_t* a, const uint8_t* b, int32_t* c);
+};
+
+// The kernels are compiled with their own instruction set flags, they return
+// nullptr if the instruction set is not supported by the compiler. They
+// should be called only if the CPU supports the instruction set.
+const GemmS8u8Kernel* GetGemmS8u8KernelVnni();
+const GemmS8u8Kernel* GetGemmS8u8KernelAvx2();
+const GemmS8u8Kernel* GetGemmS8u8KernelRef();
+
+// The kernels which can run on the current CPU, the fastest is the first.
+std::vector<const GemmS8u8Kernel*> GetGemmS8u8Kernels();
+
+size_t GemmS8u8PackedASizeImpl(const GemmS8u8Kernel& kernel, int M, int K);
+
+void GemmS8u8PackAImpl(const GemmS8u8Kernel& kernel,
+                       bool trans_a,
+                       int M,
+                       int K,
+                       const int8_t* A,
+                       int lda,
+                       int8_t* packed_a);
+
+template <typename T>
+void GemmS8u8Impl(const GemmS8u8Kernel& kernel,
+                  int M,
+                  int N,
+                  int K,
+                  const int8_t* packed_a,
+                  bool trans_b,
+                  const int8_t* B,
+                  int ldb,
+                  const float* scale,
+                  const float* bias,
+                  const GemmS8u8Act& act,
+                  bool trans_c,
+                  T* C,
+                  int ldc);
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
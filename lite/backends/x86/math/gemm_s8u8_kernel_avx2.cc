@@ -0,0 +1,97 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/math/gemm_s8u8_kernel.h"
+#include <cstring>
+#ifdef __AVX2__
+#include <immintrin.h>
+#define LITE_GEMM_S8U8_WITH_AVX2
+#endif
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+#ifdef LITE_GEMM_S8U8_WITH_AVX2
+
+// 6 x 8 tile. The values are widened to int16 and multiplied by
+// _mm256_madd_epi16, which never saturates unlike _mm256_maddubs_epi16. Each
+// row has 2 accumulators, the low one for the columns 0~3 and the high one
+// for the columns 4~7, every column has 2 partial sums which are added at the
+// end: 12 accumulators, 2 registers of B and 1 of A.
+static void GemmS8u8KernelAvx2(int k4,
+                               const int8_t* a,
+                               const uint8_t* b,
+                               int32_t* c) {
+#define GEMM_S8U8_DECLARE_ROW(i) \
+  __m256i c##i##l = _mm256_setzero_si256(), c##i##h = _mm256_setzero_si256();
+#define GEMM_S8U8_MADD_ROW(i)                                     \
+  memcpy(&a4, a + i * 4, sizeof(a4));                             \
+  av = _mm256_cvtepi8_epi16(_mm_set1_epi32(a4));                  \
+  c##i##l = _mm256_add_epi32(c##i##l, _mm256_madd_epi16(bl, av)); \
+  c##i##h = _mm256_add_epi32(c##i##h, _mm256_madd_epi16(bh, av));
+#define GEMM_S8U8_STORE_ROW(i)                                      \
+  _mm256_storeu_si256(                                              \
+      reinterpret_cast<__m256i*>(c + i * 8),                        \
+      _mm256_permute4x64_epi64(_mm256_hadd_epi32(c##i##l, c##i##h), \
+                               0xD8));
+  GEMM_S8U8_DECLARE_ROW(0)
+  GEMM_S8U8_DECLARE_ROW(1)
+  GEMM_S8U8_DECLARE_ROW(2)
+  GEMM_S8U8_DECLARE_ROW(3)
+  GEMM_S8U8_DECLARE_ROW(4)
+  GEMM_S8U8_DECLARE_ROW(5)
+  for (int p = 0; p < k4; p++) {
+    __m256i bv = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b));
+    __m256i bl = _mm256_cvtepu8_epi16(_mm256_castsi256_si128(bv));
+    __m256i bh = _mm256_cvtepu8_epi16(_mm256_extracti128_si256(bv, 1));
+    __m256i av;
+    int32_t a4;
+    GEMM_S8U8_MADD_ROW(0)
+    GEMM_S8U8_MADD_ROW(1)
+    GEMM_S8U8_MADD_ROW(2)
+    GEMM_S8U8_MADD_ROW(3)
+    GEMM_S8U8_MADD_ROW(4)
+    GEMM_S8U8_MADD_ROW(5)
+    a += 24;
+    b += 32;
+  }
+  // hadd gives the columns in the order of 0, 1, 4, 5, 2, 3, 6, 7.
+  GEMM_S8U8_STORE_ROW(0)
+  GEMM_S8U8_STORE_ROW(1)
+  GEMM_S8U8_STORE_ROW(2)
+  GEMM_S8U8_STORE_ROW(3)
+  GEMM_S8U8_STORE_ROW(4)
+  GEMM_S8U8_STORE_ROW(5)
+#undef GEMM_S8U8_STORE_ROW
+#undef GEMM_S8U8_MADD_ROW
+#undef GEMM_S8U8_DECLARE_ROW
+}
+
+static const GemmS8u8Kernel kGemmS8u8KernelAvx2 = {
+    "avx2", 6, 8, 384, GemmS8u8KernelAvx2};
+
+const GemmS8u8Kernel* GetGemmS8u8KernelAvx2() { return &kGemmS8u8KernelAvx2; }
+
+#else
+
+const GemmS8u8Kernel* GetGemmS8u8KernelAvx2() { return nullptr; }
+
+#endif
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,78 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/math/gemm_s8u8_kernel.h"
+#include <cstring>
+#if defined(__AVX512F__) && defined(__AVX512VNNI__)
+#include <immintrin.h>
+#define LITE_GEMM_S8U8_WITH_VNNI
+#endif
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+#ifdef LITE_GEMM_S8U8_WITH_VNNI
+
+// 8 x 32 tile: 16 accumulators, 2 registers of B and 1 of A. vpdpbusd
+// multiplies 4 uint8 of B by 4 int8 of A and adds them to an int32.
+static void GemmS8u8KernelVnni(int k4,
+                               const int8_t* a,
+                               const uint8_t* b,
+                               int32_t* c) {
+#define GEMM_S8U8_DECLARE_ROW(i) \
+  __m512i c##i##0 = _mm512_setzero_si512(), c##i##1 = _mm512_setzero_si512();
+#define GEMM_S8U8_DOT_ROW(i)                      \
+  memcpy(&a4, a + i * 4, sizeof(a4));             \
+  av = _mm512_set1_epi32(a4);                     \
+  c##i##0 = _mm512_dpbusd_epi32(c##i##0, b0, av); \
+  c##i##1 = _mm512_dpbusd_epi32(c##i##1, b1, av);
+#define GEMM_S8U8_STORE_ROW(i)              \
+  _mm512_storeu_si512(c + i * 32, c##i##0); \
+  _mm512_storeu_si512(c + i * 32 + 16, c##i##1);
+#define GEMM_S8U8_FOR_ROWS(macro) \
+  macro(0) macro(1) macro(2) macro(3) macro(4) macro(5) macro(6) macro(7)
+  GEMM_S8U8_FOR_ROWS(GEMM_S8U8_DECLARE_ROW)
+  for (int p = 0; p < k4; p++) {
+    __m512i b0 = _mm512_loadu_si512(b);
+    __m512i b1 = _mm512_loadu_si512(b + 64);
+    __m512i av;
+    int32_t a4;
+    GEMM_S8U8_FOR_ROWS(GEMM_S8U8_DOT_ROW)
+    a += 32;
+    b += 128;
+  }
+  GEMM_S8U8_FOR_ROWS(GEMM_S8U8_STORE_ROW)
+#undef GEMM_S8U8_FOR_ROWS
+#undef GEMM_S8U8_STORE_ROW
+#undef GEMM_S8U8_DOT_ROW
+#undef GEMM_S8U8_DECLARE_ROW
+}
+
+static const GemmS8u8Kernel kGemmS8u8KernelVnni = {
+    "avx512_vnni", 8, 32, 512, GemmS8u8KernelVnni};
+
+const GemmS8u8Kernel* GetGemmS8u8KernelVnni() { return &kGemmS8u8KernelVnni; }
+
+#else
+
+const GemmS8u8Kernel* GetGemmS8u8KernelVnni() { return nullptr; }
+
+#endif
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,392 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/math/nchwc.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include "lite/backends/x86/parallel.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+template <int B>
+void NCHWToNCHWc(const float* x, int n, int c, int hw, float* y) {
+  const int cb_num = (c + B - 1) / B;
+  RunParallelFor(0, n * cb_num, [&](int64_t begin, int64_t end) {
+    for (int64_t idx = begin; idx < end; idx++) {
+      const int cb = idx % cb_num;
+      const int valid = (std::min)(B, c - cb * B);
+      const float* xb = x + (idx / cb_num * c + cb * B) * hw;
+      float* yb = y + idx * hw * B;
+      for (int i = 0; i < hw; i++) {
+        for (int j = 0; j < valid; j++) {
+          yb[i * B + j] = xb[j * hw + i];
+        }
+        for (int j = valid; j < B; j++) {
+          yb[i * B + j] = 0.f;
+        }
+      }
+    }
+  });
+}
+
+template <int B>
+void NCHWcToNCHW(const float* x, int n, int c, int hw, float* y) {
+  const int cb_num = (c + B - 1) / B;
+  RunParallelFor(0, n * cb_num, [&](int64_t begin, int64_t end) {
+    for (int64_t idx = begin; idx < end; idx++) {
+      const int cb = idx % cb_num;
+      const int valid = (std::min)(B, c - cb * B);
+      const float* xb = x + idx * hw * B;
+      float* yb = y + (idx / cb_num * c + cb * B) * hw;
+      for (int j = 0; j < valid; j++) {
+        for (int i = 0; i < hw; i++) {
+          yb[j * hw + i] = xb[i * B + j];
+        }
+      }
+    }
+  });
+}
+
+static bool ConvNCHWcIsDepthwise(const ConvNCHWcParam& param) {
+  return param.groups > 1 && param.groups == param.ic &&
+         param.groups == param.oc;
+}
+
+// The groups whose channels are multiples of B are computed separately,
+// the others are computed as one dense group.
+template <int B>
+static int ConvNCHWcPackedGroups(const ConvNCHWcParam& param) {
+  const int icpg = param.ic / param.groups;
+  const int ocpg = param.oc / param.groups;
+  return icpg % B == 0 && ocpg % B == 0 ? param.groups : 1;
+}
+
+template <int B>
+int64_t ConvNCHWcPackedFilterSize(const ConvNCHWcParam& param) {
+  const int64_t ocb_num = (param.oc + B - 1) / B;
+  if (ConvNCHWcIsDepthwise(param)) {
+    return ocb_num * param.kh * param.kw * B;
+  }
+  const int icpg = param.ic / ConvNCHWcPackedGroups<B>(param);
+  const int64_t icb_num = (icpg + B - 1) / B;
+  return ocb_num * icb_num * param.kh * param.kw * B * B;
+}
+
+template <int B>
+void ConvNCHWcPackFilter(const ConvNCHWcParam& param,
+                         const float* filter,
+                         float* packed_filter) {
+  const int ksize = param.kh * param.kw;
+  const int ocb_num = (param.oc + B - 1) / B;
+  std::memset(packed_filter,
+              0,
+              ConvNCHWcPackedFilterSize<B>(param) * sizeof(float));
+  if (ConvNCHWcIsDepthwise(param)) {
+    for (int o = 0; o < param.oc; o++) {
+      for (int k = 0; k < ksize; k++) {
+        packed_filter[((o / B) * ksize + k) * B + o % B] =
+            filter[o * ksize + k];
+      }
+    }
+    return;
+  }
+  const int icpg = param.ic / param.groups;
+  const int ocpg = param.oc / param.groups;
+  const int packed_groups = ConvNCHWcPackedGroups<B>(param);
+  // The input channels of the packed filter are local in the packed group.
+  const int packed_icpg = param.ic / packed_groups;
+  const int icb_num = (packed_icpg + B - 1) / B;
+  for (int ocb = 0; ocb < ocb_num; ocb++) {
+    for (int icb = 0; icb < icb_num; icb++) {
+      for (int k = 0; k < ksize; k++) {
+        float* w = packed_filter +
+                   ((static_cast<int64_t>(ocb) * icb_num + icb) * ksize + k) *
+                       B * B;
+        for (int i = 0; i < B; i++) {
+          for (int j = 0; j < B; j++) {
+            const int o = ocb * B + j;
+            const int packed_i = icb * B + i;
+            if (o >= param.oc || packed_i >= packed_icpg) continue;
+            const int g = o / ocpg;
+            int local_i = packed_i;
+            if (packed_groups == 1) {
+              // Zeros across the groups of the dense filter.
+              local_i = packed_i - g * icpg;
+              if (local_i < 0 || local_i >= icpg) continue;
+            }
+            w[i * B + j] = filter[(o * icpg + local_i) * ksize + k];
+          }
+        }
+      }
+    }
+  }
+}
+
+template <int B>
+static inline void ConvNCHWcActivate(const ConvNCHWcParam& param, float* v) {
+  switch (param.act_type) {
+    case lite_api::ActivationType::kRelu:
+      for (int i = 0; i < B; i++) {
+        v[i] = (std::max)(v[i], 0.f);
+      }
+      break;
+    case lite_api::ActivationType::kRelu6:
+      for (int i = 0; i < B; i++) {
+        v[i] = (std::min)((std::max)(v[i], 0.f), param.act_alpha);
+      }
+      break;
+    case lite_api::ActivationType::kLeakyRelu:
+      for (int i = 0; i < B; i++) {
+        v[i] = v[i] > 0.f ? v[i] : v[i] * param.act_alpha;
+      }
+      break;
+    default:
+      break;
+  }
+}
+
+// Compute T output pixels of a row from `ow0`, every weight vector of B
+// output channels is loaded once for the T pixels.
+template <int B, int T>
+static inline void ConvNCHWcPixels(const ConvNCHWcParam& param,
+                                   const float* x,
+                                   const float* w,
+                                   int icb_num,
+                                   int oh,
+                                   int ow0,
+                                   const float* bias,
+                                   float* y) {
+  static const float zeros[B] = {0.f};
+  float acc[T][B];
+  for (int t = 0; t < T; t++) {
+    for (int o = 0; o < B; o++) {
+      acc[t][o] = bias[o];
+    }
+  }
+  const int64_t plane = static_cast<int64_t>(param.ih) * param.iw * B;
+  for (int icb = 0; icb < icb_num; icb++) {
+    const float* xc = x + icb * plane;
+    const float* wc = w + static_cast<int64_t>(icb) * param.kh * param.kw * B *
+                              B;
+    for (int kh = 0; kh < param.kh; kh++) {
+      const int ih = oh * param.stride_h - param.pad_top + kh * param.dilation_h;
+      if (ih < 0 || ih >= param.ih) continue;
+      const float* xr = xc + static_cast<int64_t>(ih) * param.iw * B;
+      for (int kw = 0; kw < param.kw; kw++) {
+        const float* wk = wc + (kh * param.kw + kw) * B * B;
+        const float* xp[T];
+        for (int t = 0; t < T; t++) {
+          const int iw = (ow0 + t) * param.stride_w - param.pad_left +
+                         kw * param.dilation_w;
+          xp[t] = iw >= 0 && iw < param.iw ? xr + iw * B : zeros;
+        }
+        for (int i = 0; i < B; i++) {
+          const float* wi = wk + i * B;
+          for (int t = 0; t < T; t++) {
+            const float xv = xp[t][i];
+            for (int o = 0; o < B; o++) {
+              acc[t][o] += xv * wi[o];
+            }
+          }
+        }
+      }
+    }
+  }
+  for (int t = 0; t < T; t++) {
+    ConvNCHWcActivate<B>(param, acc[t]);
+    std::memcpy(y + t * B, acc[t], B * sizeof(float));
+  }
+}
+
+template <int B>
+static void ConvNCHWcDepthwise(const ConvNCHWcParam& param,
+                               const float* x,
+                               const float* packed_filter,
+                               const float* bias,
+                               float* y) {
+  const int cb_num = (param.oc + B - 1) / B;
+  const int ksize = param.kh * param.kw;
+  RunParallelFor(0, param.batch * cb_num, [&](int64_t begin, int64_t end) {
+    for (int64_t idx = begin; idx < end; idx++) {
+      const int cb = idx % cb_num;
+      const float* xc = x + idx * param.ih * param.iw * B;
+      const float* w = packed_filter + cb * ksize * B;
+      float* yc = y + idx * param.oh * param.ow * B;
+      float bias_block[B] = {0.f};
+      for (int o = 0; o < B && bias && cb * B + o < param.oc; o++) {
+        bias_block[o] = bias[cb * B + o];
+      }
+      for (int oh = 0; oh < param.oh; oh++) {
+        for (int ow = 0; ow < param.ow; ow++) {
+          float acc[B];
+          std::memcpy(acc, bias_block, B * sizeof(float));
+          for (int kh = 0; kh < param.kh; kh++) {
+            const int ih =
+                oh * param.stride_h - param.pad_top + kh * param.dilation_h;
+            if (ih < 0 || ih >= param.ih) continue;
+            for (int kw = 0; kw < param.kw; kw++) {
+              const int iw =
+                  ow * param.stride_w - param.pad_left + kw * param.dilation_w;
+              if (iw < 0 || iw >= param.iw) continue;
+              const float* xp = xc + (ih * param.iw + iw) * B;
+              const float* wk = w + (kh * param.kw + kw) * B;
+              for (int i = 0; i < B; i++) {
+                acc[i] += xp[i] * wk[i];
+              }
+            }
+          }
+          ConvNCHWcActivate<B>(param, acc);
+          std::memcpy(yc + (oh * param.ow + ow) * B, acc, B * sizeof(float));
+        }
+      }
+    }
+  });
+}
+
+template <int B>
+void ConvNCHWc(const ConvNCHWcParam& param,
+               const float* x,
+               const float* packed_filter,
+               const float* bias,
+               float* y) {
+  if (ConvNCHWcIsDepthwise(param)) {
+    ConvNCHWcDepthwise<B>(param, x, packed_filter, bias, y);
+    return;
+  }
+  constexpr int kTile = 4;
+  const int icb_total = (param.ic + B - 1) / B;
+  const int ocb_num = (param.oc + B - 1) / B;
+  const int packed_groups = ConvNCHWcPackedGroups<B>(param);
+  const int packed_icpg = param.ic / packed_groups;
+  const int packed_ocpg = param.oc / packed_groups;
+  const int icb_num = (packed_icpg + B - 1) / B;
+  const int64_t in_plane = static_cast<int64_t>(param.ih) * param.iw * B;
+  const int64_t out_plane = static_cast<int64_t>(param.oh) * param.ow * B;
+  const int64_t filter_block = static_cast<int64_t>(icb_num) * param.kh *
+                               param.kw * B * B;
+  RunParallelFor(0, param.batch * ocb_num, [&](int64_t begin, int64_t end) {
+    for (int64_t idx = begin; idx < end; idx++) {
+      const int n = idx / ocb_num;
+      const int ocb = idx % ocb_num;
+      const int g = ocb * B / packed_ocpg;
+      const float* xg = x + (n * icb_total + g * packed_icpg / B) * in_plane;
+      const float* w = packed_filter + ocb * filter_block;
+      float* yc = y + idx * out_plane;
+      float bias_block[B] = {0.f};
+      for (int o = 0; o < B && bias && ocb * B + o < param.oc; o++) {
+        bias_block[o] = bias[ocb * B + o];
+      }
+      for (int oh = 0; oh < param.oh; oh++) {
+        float* yr = yc + oh * param.ow * B;
+        int ow = 0;
+        for (; ow + kTile <= param.ow; ow += kTile) {
+          ConvNCHWcPixels<B, kTile>(
+              param, xg, w, icb_num, oh, ow, bias_block, yr + ow * B);
+        }
+        for (; ow < param.ow; ow++) {
+          ConvNCHWcPixels<B, 1>(
+              param, xg, w, icb_num, oh, ow, bias_block, yr + ow * B);
+        }
+      }
+    }
+  });
+}
+
+template <int B>
+void PoolNCHWc(const PoolNCHWcParam& param, const float* x, float* y) {
+  const int cb_num = (param.c + B - 1) / B;
+  RunParallelFor(0, param.batch * cb_num, [&](int64_t begin, int64_t end) {
+    for (int64_t idx = begin; idx < end; idx++) {
+      const float* xc = x + idx * param.ih * param.iw * B;
+      float* yc = y + idx * param.oh * param.ow * B;
+      for (int oh = 0; oh < param.oh; oh++) {
+        int hstart, hend;
+        if (param.adaptive) {
+          hstart = oh * param.ih / param.oh;
+          hend = ((oh + 1) * param.ih + param.oh - 1) / param.oh;
+        } else {
+          hstart = oh * param.stride_h - param.pad_top;
+          hend = (std::min)(hstart + param.kh, param.ih);
+          hstart = (std::max)(hstart, 0);
+        }
+        for (int ow = 0; ow < param.ow; ow++) {
+          int wstart, wend;
+          if (param.adaptive) {
+            wstart = ow * param.iw / param.ow;
+            wend = ((ow + 1) * param.iw + param.ow - 1) / param.ow;
+          } else {
+            wstart = ow * param.stride_w - param.pad_left;
+            wend = (std::min)(wstart + param.kw, param.iw);
+            wstart = (std::max)(wstart, 0);
+          }
+          float acc[B];
+          const float init =
+              param.is_max ? -(std::numeric_limits<float>::max)() : 0.f;
+          for (int i = 0; i < B; i++) {
+            acc[i] = init;
+          }
+          for (int h = hstart; h < hend; h++) {
+            for (int w = wstart; w < wend; w++) {
+              const float* xp = xc + (h * param.iw + w) * B;
+              if (param.is_max) {
+                for (int i = 0; i < B; i++) {
+                  acc[i] = (std::max)(acc[i], xp[i]);
+                }
+              } else {
+                for (int i = 0; i < B; i++) {
+                  acc[i] += xp[i];
+                }
+              }
+            }
+          }
+          if (!param.is_max) {
+            const int pool_size = param.exclusive || param.adaptive
+                                      ? (hend - hstart) * (wend - wstart)
+                                      : param.kh * param.kw;
+            const float scale = 1.f / pool_size;
+            for (int i = 0; i < B; i++) {
+              acc[i] *= scale;
+            }
+          }
+          std::memcpy(yc + (oh * param.ow + ow) * B, acc, B * sizeof(float));
+        }
+      }
+    }
+  });
+}
+
+#define INSTANTIATE_NCHWC_FUNCTIONS(B)                                         \
+  template void NCHWToNCHWc<B>(const float*, int, int, int, float*);         \
+  template void NCHWcToNCHW<B>(const float*, int, int, int, float*);         \
+  template int64_t ConvNCHWcPackedFilterSize<B>(const ConvNCHWcParam&);      \
+  template void ConvNCHWcPackFilter<B>(                                      \
+      const ConvNCHWcParam&, const float*, float*);                          \
+  template void ConvNCHWc<B>(                                                \
+      const ConvNCHWcParam&, const float*, const float*, const float*,       \
+      float*);                                                               \
+  template void PoolNCHWc<B>(const PoolNCHWcParam&, const float*, float*);
+
+INSTANTIATE_NCHWC_FUNCTIONS(8)
+INSTANTIATE_NCHWC_FUNCTIONS(16)
+#undef INSTANTIATE_NCHWC_FUNCTIONS
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
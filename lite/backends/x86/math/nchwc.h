@@ -0,0 +1,124 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+#include "lite/api/paddle_place.h"
+#include "lite/core/tensor.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+// In the blocked channel layout NCHWc<B>, a 4-D tensor of the dims
+// [N, C, H, W] is stored as [N, ceil(C / B), H, W, B]. The tensors keep their
+// logical NCHW dims, and the tensors of the other ranks keep the plain order.
+// The padded channels hold finite values, zeros after the reorder, so they
+// are computed as the other channels without turning into NaN.
+
+template <int B>
+inline int64_t NCHWcNumel(const DDim& dims) {
+  if (dims.size() != 4) return dims.production();
+  return dims[0] * ((dims[1] + B - 1) / B) * dims[2] * dims[3] * B;
+}
+
+// Allocate the memory of the blocked tensor `x` by its dims.
+template <int B>
+inline float* NCHWcMutableData(Tensor* x) {
+  x->set_precision(PRECISION(kFloat));
+  return static_cast<float*>(x->mutable_data(
+      TARGET(kX86), NCHWcNumel<B>(x->dims()) * sizeof(float)));
+}
+
+// y[N, C/B, HW, B] = x[N, C, HW], the padded channels are zeros.
+template <int B>
+void NCHWToNCHWc(const float* x, int n, int c, int hw, float* y);
+
+// y[N, C, HW] = x[N, C/B, HW, B]
+template <int B>
+void NCHWcToNCHW(const float* x, int n, int c, int hw, float* y);
+
+struct ConvNCHWcParam {
+  int batch{1};
+  int ic{0};
+  int ih{0};
+  int iw{0};
+  int oc{0};
+  int oh{0};
+  int ow{0};
+  int kh{1};
+  int kw{1};
+  int stride_h{1};
+  int stride_w{1};
+  int pad_top{0};
+  int pad_left{0};
+  int dilation_h{1};
+  int dilation_w{1};
+  int groups{1};
+  // Only relu, relu6 and leaky_relu are fused.
+  lite_api::ActivationType act_type{lite_api::ActivationType::kIndentity};
+  // The threshold of relu6 or the alpha of leaky_relu.
+  float act_alpha{0.f};
+};
+
+// The filter [OC, IC / groups, KH, KW] is packed once as
+//   depthwise: [OC/B, KH, KW, B]
+//   others:    [OC/B, IC/B per group, KH, KW, B(ic), B(oc)]
+// The groups whose channels are not multiples of B are packed into one
+// dense filter whose weights across the groups are zeros.
+template <int B>
+int64_t ConvNCHWcPackedFilterSize(const ConvNCHWcParam& param);
+
+template <int B>
+void ConvNCHWcPackFilter(const ConvNCHWcParam& param,
+                         const float* filter,
+                         float* packed_filter);
+
+// y = act(conv(x, filter) + bias), both x and y are blocked, `bias` of OC
+// values can be nullptr.
+template <int B>
+void ConvNCHWc(const ConvNCHWcParam& param,
+               const float* x,
+               const float* packed_filter,
+               const float* bias,
+               float* y);
+
+struct PoolNCHWcParam {
+  int batch{1};
+  int c{0};
+  int ih{0};
+  int iw{0};
+  int oh{0};
+  int ow{0};
+  int kh{1};
+  int kw{1};
+  int stride_h{1};
+  int stride_w{1};
+  int pad_top{0};
+  int pad_left{0};
+  bool is_max{true};
+  // The avg pooling divides by the number of the elements in the input only.
+  bool exclusive{true};
+  bool adaptive{false};
+};
+
+template <int B>
+void PoolNCHWc(const PoolNCHWcParam& param, const float* x, float* y);
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
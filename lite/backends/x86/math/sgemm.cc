@@ -0,0 +1,372 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/math/sgemm.h"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include "lite/backends/x86/cpu_info.h"
+#include "lite/backends/x86/math/sgemm_kernel.h"
+#include "lite/backends/x86/parallel.h"
+#include "lite/utils/cp_logging.h"
+#include "lite/utils/macros.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+namespace {
+
+constexpr int kRefMR = 4;
+constexpr int kRefNR = 8;
+
+void SgemmKernelRef(
+    int k, const float* a, const float* b, float* c, int ldc, bool accumulate) {
+  float acc[kRefMR][kRefNR] = {};
+  for (int p = 0; p < k; p++) {
+    for (int i = 0; i < kRefMR; i++) {
+      float av = a[i];
+      for (int j = 0; j < kRefNR; j++) {
+        acc[i][j] += av * b[j];
+      }
+    }
+    a += kRefMR;
+    b += kRefNR;
+  }
+  for (int i = 0; i < kRefMR; i++) {
+    float* ci = c + i * ldc;
+    for (int j = 0; j < kRefNR; j++) {
+      ci[j] = accumulate ? ci[j] + acc[i][j] : acc[i][j];
+    }
+  }
+}
+
+const SgemmKernel kSgemmKernelRef = {
+    "ref", kRefMR, kRefNR, 64, 256, 2048, SgemmKernelRef};
+
+inline int RoundUp(int x, int y) { return (x + y - 1) / y * y; }
+
+const SgemmKernel& GetDefaultKernel() {
+  static const SgemmKernel* kernel = GetSgemmKernels().front();
+  return *kernel;
+}
+
+// Pack the rows [i0, i0 + m) and the columns [p0, p0 + k) of alpha * op(A)
+// into the panels of mr rows, each panel is k x mr and stored column by
+// column, the rows out of op(A) are filled with zeros.
+void PackA(const SgemmKernel& kernel,
+           bool trans_a,
+           int i0,
+           int m,
+           int p0,
+           int k,
+           float alpha,
+           const float* A,
+           int lda,
+           float* packed) {
+  const int mr = kernel.mr;
+  const int num_panels = (m + mr - 1) / mr;
+  RunParallelFor(0, num_panels, [&](int64_t begin, int64_t end) {
+    for (int64_t panel = begin; panel < end; panel++) {
+      int i_begin = static_cast<int>(panel) * mr;
+      int rows = (std::min)(mr, m - i_begin);
+      float* dst = packed + panel * mr * k;
+      for (int p = 0; p < k; p++) {
+        for (int i = 0; i < rows; i++) {
+          int row = i0 + i_begin + i;
+          int col = p0 + p;
+          dst[i] = alpha * (trans_a ? A[col * lda + row] : A[row * lda + col]);
+        }
+        for (int i = rows; i < mr; i++) {
+          dst[i] = 0.f;
+        }
+        dst += mr;
+      }
+    }
+  });
+}
+
+// Pack the rows [p0, p0 + k) and the columns [j0, j0 + n) of op(B) into the
+// panels of nr columns, each panel is k x nr and stored row by row, the
+// columns out of op(B) are filled with zeros.
+void PackB(const SgemmKernel& kernel,
+           bool trans_b,
+           int p0,
+           int k,
+           int j0,
+           int n,
+           const float* B,
+           int ldb,
+           float* packed) {
+  const int nr = kernel.nr;
+  const int num_panels = (n + nr - 1) / nr;
+  RunParallelFor(0, num_panels, [&](int64_t begin, int64_t end) {
+    for (int64_t panel = begin; panel < end; panel++) {
+      int j_begin = static_cast<int>(panel) * nr;
+      int cols = (std::min)(nr, n - j_begin);
+      float* dst = packed + panel * nr * k;
+      for (int p = 0; p < k; p++) {
+        int row = p0 + p;
+        if (!trans_b && cols == nr) {
+          memcpy(dst, B + row * ldb + j0 + j_begin, nr * sizeof(float));
+        } else {
+          for (int j = 0; j < cols; j++) {
+            int col = j0 + j_begin + j;
+            dst[j] = trans_b ? B[col * ldb + row] : B[row * ldb + col];
+          }
+          for (int j = cols; j < nr; j++) {
+            dst[j] = 0.f;
+          }
+        }
+        dst += nr;
+      }
+    }
+  });
+}
+
+void ScaleC(int M, int N, float beta, float* C, int ldc) {
+  RunParallelFor(0, M, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      float* ci = C + i * ldc;
+      if (beta == 0.f) {
+        memset(ci, 0, N * sizeof(float));
+      } else {
+        for (int j = 0; j < N; j++) {
+          ci[j] *= beta;
+        }
+      }
+    }
+  });
+}
+
+// C[m][n] (+)= packed_a * packed_b, the tiles out of C are computed in a
+// temporary buffer.
+void ComputeBlock(const SgemmKernel& kernel,
+                  int m,
+                  int n,
+                  int k,
+                  const float* packed_a,
+                  const float* packed_b,
+                  bool accumulate,
+                  float* C,
+                  int ldc) {
+  const int mr = kernel.mr;
+  const int nr = kernel.nr;
+  const int m_panels = (m + mr - 1) / mr;
+  const int n_panels = (n + nr - 1) / nr;
+  // The tiles in the same column share the panel of B, which is larger than
+  // the panel of A.
+  RunParallelFor(0, m_panels * n_panels, [&](int64_t begin, int64_t end) {
+    float tmp[kSgemmMaxMR * kSgemmMaxNR];
+    for (int64_t tile = begin; tile < end; tile++) {
+      int jp = static_cast<int>(tile / m_panels);
+      int ip = static_cast<int>(tile % m_panels);
+      int rows = (std::min)(mr, m - ip * mr);
+      int cols = (std::min)(nr, n - jp * nr);
+      const float* a = packed_a + ip * mr * k;
+      const float* b = packed_b + jp * nr * k;
+      float* c = C + ip * mr * ldc + jp * nr;
+      if (rows == mr && cols == nr) {
+        kernel.compute(k, a, b, c, ldc, accumulate);
+        continue;
+      }
+      kernel.compute(k, a, b, tmp, nr, false);
+      for (int i = 0; i < rows; i++) {
+        float* ci = c + i * ldc;
+        const float* ti = tmp + i * nr;
+        for (int j = 0; j < cols; j++) {
+          ci[j] = accumulate ? ci[j] + ti[j] : ti[j];
+        }
+      }
+    }
+  });
+}
+
+}  // namespace
+
+const SgemmKernel* GetSgemmKernelRef() { return &kSgemmKernelRef; }
+
+std::vector<const SgemmKernel*> GetSgemmKernels() {
+  std::vector<const SgemmKernel*> kernels;
+  if (GetSgemmKernelAvx512() && MayIUse(avx512f)) {
+    kernels.push_back(GetSgemmKernelAvx512());
+  }
+  if (GetSgemmKernelAvx2() && MayIUse(avx2)) {
+    kernels.push_back(GetSgemmKernelAvx2());
+  }
+  kernels.push_back(GetSgemmKernelRef());
+  return kernels;
+}
+
+void SgemmPackBImpl(const SgemmKernel& kernel,
+                    bool trans_b,
+                    int N,
+                    int K,
+                    const float* B,
+                    int ldb,
+                    float* packed_b) {
+  // The blocks are stored in the order in which they are used by SgemmImpl,
+  // the block (pc, jc) starts at pc * Np + jc * kc.
+  const int Np = RoundUp(N, kernel.nr);
+  for (int jc = 0; jc < N; jc += kernel.nc) {
+    int nc = (std::min)(kernel.nc, N - jc);
+    for (int pc = 0; pc < K; pc += kernel.kc) {
+      int kc = (std::min)(kernel.kc, K - pc);
+      float* dst = packed_b + pc * Np + jc * kc;
+      PackB(kernel, trans_b, pc, kc, jc, nc, B, ldb, dst);
+    }
+  }
+}
+
+void SgemmImpl(const SgemmKernel& kernel,
+               bool trans_a,
+               bool trans_b,
+               int M,
+               int N,
+               int K,
+               float alpha,
+               const float* A,
+               int lda,
+               const float* B,
+               int ldb,
+               const float* packed_b,
+               float beta,
+               float* C,
+               int ldc) {
+  CHECK_LE(kernel.mr, kSgemmMaxMR);
+  CHECK_LE(kernel.nr, kSgemmMaxNR);
+  if (M <= 0 || N <= 0) return;
+  if (K <= 0 || alpha == 0.f) {
+    if (beta != 1.f) ScaleC(M, N, beta, C, ldc);
+    return;
+  }
+  // The first block of K overwrites C if beta is 0, otherwise C is scaled
+  // once and accumulated.
+  if (beta != 0.f && beta != 1.f) {
+    ScaleC(M, N, beta, C, ldc);
+  }
+
+  static LITE_THREAD_LOCAL std::vector<float> a_buffer;
+  static LITE_THREAD_LOCAL std::vector<float> b_buffer;
+  a_buffer.resize(static_cast<size_t>(kernel.mc) * kernel.kc);
+  if (!packed_b) {
+    b_buffer.resize(static_cast<size_t>(kernel.kc) *
+                    RoundUp(kernel.nc, kernel.nr));
+  }
+
+  const int Np = RoundUp(N, kernel.nr);
+  for (int jc = 0; jc < N; jc += kernel.nc) {
+    int nc = (std::min)(kernel.nc, N - jc);
+    for (int pc = 0; pc < K; pc += kernel.kc) {
+      int kc = (std::min)(kernel.kc, K - pc);
+      const float* b_block = nullptr;
+      if (packed_b) {
+        b_block = packed_b + pc * Np + jc * kc;
+      } else {
+        PackB(kernel, trans_b, pc, kc, jc, nc, B, ldb, b_buffer.data());
+        b_block = b_buffer.data();
+      }
+      bool accumulate = pc > 0 || beta != 0.f;
+      for (int ic = 0; ic < M; ic += kernel.mc) {
+        int mc = (std::min)(kernel.mc, M - ic);
+        PackA(kernel, trans_a, ic, mc, pc, kc, alpha, A, lda, a_buffer.data());
+        ComputeBlock(kernel,
+                     mc,
+                     nc,
+                     kc,
+                     a_buffer.data(),
+                     b_block,
+                     accumulate,
+                     C + ic * ldc + jc,
+                     ldc);
+      }
+    }
+  }
+}
+
+void Sgemm(bool trans_a,
+           bool trans_b,
+           int M,
+           int N,
+           int K,
+           float alpha,
+           const float* A,
+           int lda,
+           const float* B,
+           int ldb,
+           float beta,
+           float* C,
+           int ldc) {
+  SgemmImpl(GetDefaultKernel(),
+            trans_a,
+            trans_b,
+            M,
+            N,
+            K,
+            alpha,
+            A,
+            lda,
+            B,
+            ldb,
+            nullptr,
+            beta,
+            C,
+            ldc);
+}
+
+size_t SgemmPackedBSize(int N, int K) {
+  return static_cast<size_t>(K) * RoundUp(N, GetDefaultKernel().nr);
+}
+
+void SgemmPackB(
+    bool trans_b, int N, int K, const float* B, int ldb, float* packed_b) {
+  SgemmPackBImpl(GetDefaultKernel(), trans_b, N, K, B, ldb, packed_b);
+}
+
+void SgemmWithPackedB(bool trans_a,
+                      int M,
+                      int N,
+                      int K,
+                      float alpha,
+                      const float* A,
+                      int lda,
+                      const float* packed_b,
+                      float beta,
+                      float* C,
+                      int ldc) {
+  CHECK(packed_b);
+  SgemmImpl(GetDefaultKernel(),
+            trans_a,
+            false,
+            M,
+            N,
+            K,
+            alpha,
+            A,
+            lda,
+            nullptr,
+            0,
+            packed_b,
+            beta,
+            C,
+            ldc);
+}
+
+const char* SgemmKernelName() { return GetDefaultKernel().name; }
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
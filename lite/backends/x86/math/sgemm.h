@@ -0,0 +1,74 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+/*
+ * The in-tree single precision GEMM for the builds without MKL.
+ *
+ * C = alpha * op(A) * op(B) + beta * C, all of the matrices are row major,
+ * op(A) is M x K and op(B) is K x N. The matrices are split into the blocks
+ * which fit the caches, and the blocks are packed into the panels of the
+ * micro kernel, which is picked by the instruction set of the CPU at runtime:
+ * AVX-512, AVX2 with FMA or the plain C++ one. The tiles of C are computed by
+ * the threads of RunParallelFor.
+ */
+void Sgemm(bool trans_a,
+           bool trans_b,
+           int M,
+           int N,
+           int K,
+           float alpha,
+           const float* A,
+           int lda,
+           const float* B,
+           int ldb,
+           float beta,
+           float* C,
+           int ldc);
+
+// The number of floats of op(B) packed by SgemmPackB.
+size_t SgemmPackedBSize(int N, int K);
+
+// Pack op(B) (K x N) once, e.g. the constant weights of fc, so that the
+// packing is skipped by SgemmWithPackedB.
+void SgemmPackB(
+    bool trans_b, int N, int K, const float* B, int ldb, float* packed_b);
+
+void SgemmWithPackedB(bool trans_a,
+                      int M,
+                      int N,
+                      int K,
+                      float alpha,
+                      const float* A,
+                      int lda,
+                      const float* packed_b,
+                      float beta,
+                      float* C,
+                      int ldc);
+
+// The name of the micro kernel picked at runtime, e.g. "avx2".
+const char* SgemmKernelName();
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
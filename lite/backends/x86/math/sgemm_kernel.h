@@ -0,0 +1,89 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <vector>
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+// The max size of the tiles of the micro kernels.
+constexpr int kSgemmMaxMR = 16;
+constexpr int kSgemmMaxNR = 32;
+
+// The micro kernel of Sgemm and its blocking sizes.
+struct SgemmKernel {
+  const char* name;
+  // The size of the tile of C computed by one call.
+  int mr;
+  int nr;
+  // The size of the blocks of A(mc x kc) and B(kc x nc), mc is a multiple of
+  // mr and nc is a multiple of nr.
+  int mc;
+  int kc;
+  int nc;
+  // c[mr][nr] = a * b if accumulate is false, otherwise c += a * b. a is
+  // packed by columns of mr floats and b is packed by rows of nr floats, both
+  // of them have k columns or rows.
+  void (*compute)(int k,
+                  const float* a,
+                  const float* b,
+                  float* c,
+                  int ldc,
+                  bool accumulate);
+};
+
+// The kernels are compiled with their own instruction set flags, they return
+// nullptr if the instruction set is not supported by the compiler. They
+// should be called only if the CPU supports the instruction set.
+const SgemmKernel* GetSgemmKernelAvx512();
+const SgemmKernel* GetSgemmKernelAvx2();
+const SgemmKernel* GetSgemmKernelRef();
+
+// The kernels which can run on the current CPU, the fastest is the first.
+std::vector<const SgemmKernel*> GetSgemmKernels();
+
+// Sgemm with the given kernel, op(B) is packed by `kernel` if `packed_b` is
+// not nullptr, and B is ignored.
+void SgemmImpl(const SgemmKernel& kernel,
+               bool trans_a,
+               bool trans_b,
+               int M,
+               int N,
+               int K,
+               float alpha,
+               const float* A,
+               int lda,
+               const float* B,
+               int ldb,
+               const float* packed_b,
+               float beta,
+               float* C,
+               int ldc);
+
+void SgemmPackBImpl(const SgemmKernel& kernel,
+                    bool trans_b,
+                    int N,
+                    int K,
+                    const float* B,
+                    int ldb,
+                    float* packed_b);
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,93 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/math/sgemm_kernel.h"
+#if defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER))
+#include <immintrin.h>
+#define LITE_SGEMM_WITH_AVX2
+#endif
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+#ifdef LITE_SGEMM_WITH_AVX2
+
+// 6 x 16 tile: 12 accumulators, 2 registers of B and 1 of A out of the 16
+// ymm registers.
+static void SgemmKernelAvx2(
+    int k, const float* a, const float* b, float* c, int ldc, bool accumulate) {
+  __m256 c00 = _mm256_setzero_ps(), c01 = _mm256_setzero_ps();
+  __m256 c10 = _mm256_setzero_ps(), c11 = _mm256_setzero_ps();
+  __m256 c20 = _mm256_setzero_ps(), c21 = _mm256_setzero_ps();
+  __m256 c30 = _mm256_setzero_ps(), c31 = _mm256_setzero_ps();
+  __m256 c40 = _mm256_setzero_ps(), c41 = _mm256_setzero_ps();
+  __m256 c50 = _mm256_setzero_ps(), c51 = _mm256_setzero_ps();
+  for (int p = 0; p < k; p++) {
+    __m256 b0 = _mm256_loadu_ps(b);
+    __m256 b1 = _mm256_loadu_ps(b + 8);
+    __m256 av = _mm256_broadcast_ss(a);
+    c00 = _mm256_fmadd_ps(av, b0, c00);
+    c01 = _mm256_fmadd_ps(av, b1, c01);
+    av = _mm256_broadcast_ss(a + 1);
+    c10 = _mm256_fmadd_ps(av, b0, c10);
+    c11 = _mm256_fmadd_ps(av, b1, c11);
+    av = _mm256_broadcast_ss(a + 2);
+    c20 = _mm256_fmadd_ps(av, b0, c20);
+    c21 = _mm256_fmadd_ps(av, b1, c21);
+    av = _mm256_broadcast_ss(a + 3);
+    c30 = _mm256_fmadd_ps(av, b0, c30);
+    c31 = _mm256_fmadd_ps(av, b1, c31);
+    av = _mm256_broadcast_ss(a + 4);
+    c40 = _mm256_fmadd_ps(av, b0, c40);
+    c41 = _mm256_fmadd_ps(av, b1, c41);
+    av = _mm256_broadcast_ss(a + 5);
+    c50 = _mm256_fmadd_ps(av, b0, c50);
+    c51 = _mm256_fmadd_ps(av, b1, c51);
+    a += 6;
+    b += 16;
+  }
+#define SGEMM_STORE_ROW(i)                                    \
+  if (accumulate) {                                           \
+    c##i##0 = _mm256_add_ps(c##i##0, _mm256_loadu_ps(c));     \
+    c##i##1 = _mm256_add_ps(c##i##1, _mm256_loadu_ps(c + 8)); \
+  }                                                           \
+  _mm256_storeu_ps(c, c##i##0);                               \
+  _mm256_storeu_ps(c + 8, c##i##1);                           \
+  c += ldc;
+  SGEMM_STORE_ROW(0);
+  SGEMM_STORE_ROW(1);
+  SGEMM_STORE_ROW(2);
+  SGEMM_STORE_ROW(3);
+  SGEMM_STORE_ROW(4);
+  SGEMM_STORE_ROW(5);
+#undef SGEMM_STORE_ROW
+}
+
+static const SgemmKernel kSgemmKernelAvx2 = {
+    "avx2", 6, 16, 72, 256, 3072, SgemmKernelAvx2};
+
+const SgemmKernel* GetSgemmKernelAvx2() { return &kSgemmKernelAvx2; }
+
+#else
+
+const SgemmKernel* GetSgemmKernelAvx2() { return nullptr; }
+
+#endif
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
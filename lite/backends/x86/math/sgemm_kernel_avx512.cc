@@ -0,0 +1,81 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/math/sgemm_kernel.h"
+#ifdef __AVX512F__
+#include <immintrin.h>
+#define LITE_SGEMM_WITH_AVX512
+#endif
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+#ifdef LITE_SGEMM_WITH_AVX512
+
+// 12 x 32 tile: 24 accumulators, 2 registers of B and 1 of A out of the 32
+// zmm registers.
+#define SGEMM_DECLARE_ROW(i) \
+  __m512 c##i##0 = _mm512_setzero_ps(), c##i##1 = _mm512_setzero_ps();
+#define SGEMM_FMA_ROW(i)                      \
+  av = _mm512_set1_ps(a[i]);                  \
+  c##i##0 = _mm512_fmadd_ps(av, b0, c##i##0); \
+  c##i##1 = _mm512_fmadd_ps(av, b1, c##i##1);
+#define SGEMM_STORE_ROW(i)                                     \
+  if (accumulate) {                                            \
+    c##i##0 = _mm512_add_ps(c##i##0, _mm512_loadu_ps(c));      \
+    c##i##1 = _mm512_add_ps(c##i##1, _mm512_loadu_ps(c + 16)); \
+  }                                                            \
+  _mm512_storeu_ps(c, c##i##0);                                \
+  _mm512_storeu_ps(c + 16, c##i##1);                           \
+  c += ldc;
+#define SGEMM_FOR_ROWS(macro)                                             \
+  macro(0) macro(1) macro(2) macro(3) macro(4) macro(5) macro(6) macro(7) \
+      macro(8) macro(9) macro(10) macro(11)
+
+static void SgemmKernelAvx512(
+    int k, const float* a, const float* b, float* c, int ldc, bool accumulate) {
+  SGEMM_FOR_ROWS(SGEMM_DECLARE_ROW)
+  for (int p = 0; p < k; p++) {
+    __m512 b0 = _mm512_loadu_ps(b);
+    __m512 b1 = _mm512_loadu_ps(b + 16);
+    __m512 av;
+    SGEMM_FOR_ROWS(SGEMM_FMA_ROW)
+    a += 12;
+    b += 32;
+  }
+  SGEMM_FOR_ROWS(SGEMM_STORE_ROW)
+}
+
+#undef SGEMM_FOR_ROWS
+#undef SGEMM_STORE_ROW
+#undef SGEMM_FMA_ROW
+#undef SGEMM_DECLARE_ROW
+
+static const SgemmKernel kSgemmKernelAvx512 = {
+    "avx512", 12, 32, 96, 384, 4096, SgemmKernelAvx512};
+
+const SgemmKernel* GetSgemmKernelAvx512() { return &kSgemmKernelAvx512; }
+
+#else
+
+const SgemmKernel* GetSgemmKernelAvx512() { return nullptr; }
+
+#endif
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
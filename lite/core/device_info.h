@@ -80,6 +80,7 @@ class DeviceInfo {
     l3_cache_method_ = method;
     absolute_l3cache_size_ = absolute_val;
     // Realloc memory for sgemm in this context.
+    MemoryKindGuard guard(MemoryKind::kWorkspace);
     workspace_.clear();
     workspace_.Resize({llc_size()});
     workspace_.mutable_data<int8_t>();
@@ -118,6 +119,7 @@ class DeviceInfo {
 
   template <typename T>
   T* workspace_data() {
+    MemoryKindGuard guard(MemoryKind::kWorkspace);
     return reinterpret_cast<T*>(workspace_.mutable_data<int8_t>());
   }
   bool ExtendWorkspace(size_t size);
@@ -0,0 +1,200 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/inter_op_executor.h"
+#include <algorithm>
+#include <map>
+#include <set>
+#include <string>
+#include "lite/core/device_info.h"
+#include "lite/core/program.h"
+#if (defined LITE_WITH_X86) && (defined PADDLE_WITH_MKLML) && \
+    !(defined __APPLE__)
+#include <omp.h>
+#define LITE_INTER_OP_WITH_OMP
+#endif
+
+namespace paddle {
+namespace lite {
+
+// The ops which may access the vars of the sub-blocks or the devices, they
+// wait for all of the previous ops and block all of the following ops.
+static const std::set<std::string> kBarrierOpTypes = {
+    "while", "conditional_block", "conditional_block_infer", "subgraph"};
+
+static bool IsHostTarget(TargetType x) {
+  return x == TARGET(kHost) || x == TARGET(kX86) || x == TARGET(kARM);
+}
+
+static int GetIntraOpThreads() {
+#ifdef LITE_WITH_ARM
+  return DeviceInfo::Global().threads();
+#elif defined(LITE_INTER_OP_WITH_OMP)
+  return omp_get_max_threads();
+#else
+  return 1;
+#endif
+}
+
+void InterOpExecutor::SetUpWorker() {
+#ifdef LITE_WITH_ARM
+  // The device info is thread local, the workers take the run mode and the
+  // arch of the caller instead of the defaults.
+  auto& dev = DeviceInfo::Global();
+  if (dev.mode() != mode_ || dev.threads() != intra_op_threads_) {
+    dev.SetRunMode(mode_, intra_op_threads_);
+  }
+  dev.SetArch(arch_);
+#elif defined(LITE_INTER_OP_WITH_OMP)
+  if (omp_get_max_threads() != intra_op_threads_) {
+    omp_set_num_threads(intra_op_threads_);
+  }
+#endif
+}
+
+InterOpExecutor::InterOpExecutor(std::vector<Instruction>* insts,
+                                 int num_threads)
+    : insts_(insts) {
+  CHECK(insts_);
+  CHECK(IsSupported(*insts_)) << "Only the host kernels are supported.";
+  for (size_t i = 0; i < insts_->size(); i++) {
+    if ((*insts_)[i].is_feed_fetch_op()) continue;
+    nodes_.push_back(static_cast<int>(i));
+  }
+  BuildDependencies();
+  num_threads = (std::max)(1, (std::min)(num_threads, max_parallelism_));
+  thread_pool_.reset(new ThreadPool(num_threads));
+  VLOG(3) << "InterOpExecutor runs " << nodes_.size() << " instructions with "
+          << num_threads << " threads, max parallelism " << max_parallelism_;
+}
+
+bool InterOpExecutor::IsSupported(const std::vector<Instruction>& insts) {
+#if (defined __ENVIRONMENT_IPHONE_OS_VERSION_MIN_REQUIRED__) && \
+    (__ENVIRONMENT_IPHONE_OS_VERSION_MIN_REQUIRED__ < 90000)
+  // The workspace of the kernels is shared by threads without thread local
+  // storage.
+  return false;
+#endif
+  for (auto& inst : insts) {
+    if (inst.is_feed_fetch_op()) continue;
+    if (!inst.kernel() || !IsHostTarget(inst.kernel()->target())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void InterOpExecutor::BuildDependencies() {
+  int num_nodes = static_cast<int>(nodes_.size());
+  std::vector<std::set<int>> predecessors(num_nodes);
+  std::map<std::string, int> last_writer;
+  std::map<std::string, std::vector<int>> readers;
+  int last_barrier = -1;
+  for (int i = 0; i < num_nodes; i++) {
+    const auto* op_info = (*insts_)[nodes_[i]].op()->op_info();
+    bool is_barrier = kBarrierOpTypes.count(op_info->Type()) > 0;
+    if (is_barrier) {
+      for (int j = (std::max)(last_barrier, 0); j < i; j++) {
+        predecessors[i].insert(j);
+      }
+      last_barrier = i;
+    } else if (last_barrier >= 0) {
+      predecessors[i].insert(last_barrier);
+    }
+    // read-after-write
+    for (auto& name : op_info->input_names()) {
+      auto it = last_writer.find(name);
+      if (it != last_writer.end()) {
+        predecessors[i].insert(it->second);
+      }
+      readers[name].push_back(i);
+    }
+    // write-after-write and write-after-read
+    for (auto& name : op_info->output_names()) {
+      auto it = last_writer.find(name);
+      if (it != last_writer.end()) {
+        predecessors[i].insert(it->second);
+      }
+      for (auto reader : readers[name]) {
+        predecessors[i].insert(reader);
+      }
+      readers[name].clear();
+      last_writer[name] = i;
+    }
+    predecessors[i].erase(i);
+  }
+
+  successors_.assign(num_nodes, {});
+  num_predecessors_.assign(num_nodes, 0);
+  num_pending_.reset(new std::atomic<int>[num_nodes]);
+  // The width of the widest level of the graph.
+  std::vector<int> levels(num_nodes, 0);
+  std::map<int, int> level_sizes;
+  for (int i = 0; i < num_nodes; i++) {
+    for (auto pred : predecessors[i]) {
+      successors_[pred].push_back(i);
+      levels[i] = (std::max)(levels[i], levels[pred] + 1);
+    }
+    num_predecessors_[i] = static_cast<int>(predecessors[i].size());
+    max_parallelism_ = (std::max)(max_parallelism_, ++level_sizes[levels[i]]);
+  }
+}
+
+void InterOpExecutor::Run() {
+  int num_nodes = static_cast<int>(nodes_.size());
+  if (num_nodes == 0) return;
+  intra_op_threads_ =
+      (std::max)(1, GetIntraOpThreads() / thread_pool_->size());
+#ifdef LITE_WITH_ARM
+  auto& dev = DeviceInfo::Global();
+  mode_ = dev.mode();
+  arch_ = dev.arch();
+#endif
+  for (int i = 0; i < num_nodes; i++) {
+    num_pending_[i].store(num_predecessors_[i]);
+  }
+  num_finished_.store(0);
+  for (int i = 0; i < num_nodes; i++) {
+    if (num_predecessors_[i] == 0) {
+      thread_pool_->Submit([this, i](int id) { Launch(i, id); });
+    }
+  }
+  std::unique_lock<std::mutex> lock(mutex_);
+  cond_.wait(lock, [this, num_nodes] { return num_finished_ == num_nodes; });
+}
+
+void InterOpExecutor::Launch(int idx, int worker_id) {
+  SetUpWorker();
+  while (idx >= 0) {
+    (*insts_)[nodes_[idx]].Run();
+    int next = -1;
+    for (auto succ : successors_[idx]) {
+      if (num_pending_[succ].fetch_sub(1) != 1) continue;
+      if (next < 0) {
+        next = succ;
+      } else {
+        thread_pool_->Submit([this, succ](int id) { Launch(succ, id); },
+                             worker_id);
+      }
+    }
+    if (num_finished_.fetch_add(1) + 1 == static_cast<int>(nodes_.size())) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      cond_.notify_all();
+    }
+    idx = next;
+  }
+}
+
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,85 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <memory>
+#include <mutex>  // NOLINT
+#include <vector>
+#include "lite/core/device_info.h"
+#include "lite/core/thread_pool.h"
+
+namespace paddle {
+namespace lite {
+
+struct Instruction;
+
+/*
+ * InterOpExecutor runs the independent instructions of a block concurrently.
+ *
+ * The dependencies are built from the names of the input and output vars of
+ * the instructions (read-after-write, write-after-read and write-after-write),
+ * so the renamed vars of the memory optimization are respected. An instruction
+ * becomes ready once all of its predecessors are finished, like the resources
+ * in MultiStreamAnalysisPass, and is dispatched to a work-stealing thread pool.
+ * The intra-op threads of the caller are divided among the workers.
+ *
+ * Only the host kernels(kHost, kX86 and kARM) are supported, the control flow
+ * ops and the subgraph ops are run as barriers.
+ */
+class InterOpExecutor {
+ public:
+  InterOpExecutor(std::vector<Instruction>* insts, int num_threads);
+
+  // Whether the instructions can be run by InterOpExecutor.
+  static bool IsSupported(const std::vector<Instruction>& insts);
+
+  void Run();
+
+  // The max number of instructions which can run at the same time, which is
+  // useful to decide the number of threads.
+  int max_parallelism() const { return max_parallelism_; }
+
+ private:
+  void BuildDependencies();
+  // Set the intra-op threads and the device info of the calling worker as
+  // those of the caller of Run.
+  void SetUpWorker();
+  // Run the instruction, then launch its ready successors. One of them is run
+  // in place by the same worker to keep the data in its cache.
+  void Launch(int idx, int worker_id);
+
+  std::vector<Instruction>* insts_{nullptr};
+  // Indices of the instructions to run, feed and fetch are skipped.
+  std::vector<int> nodes_;
+  std::vector<std::vector<int>> successors_;
+  std::vector<int> num_predecessors_;
+  std::unique_ptr<std::atomic<int>[]> num_pending_;
+  int max_parallelism_{1};
+
+  std::unique_ptr<ThreadPool> thread_pool_;
+  int intra_op_threads_{1};
+#ifdef LITE_WITH_ARM
+  lite_api::PowerMode mode_{lite_api::LITE_POWER_NO_BIND};
+  ARMArch arch_{kARMArch_UNKOWN};
+#endif
+  std::atomic<int> num_finished_{0};
+  std::mutex mutex_;
+  std::condition_variable cond_;
+};
+
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,190 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "lite/core/inter_op_executor.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+#include "lite/core/program.h"
+
+namespace paddle {
+namespace lite {
+
+// The logical times when a kernel begins and ends, and the thread running it.
+struct RunRecord {
+  int begin{-1};
+  int end{-1};
+  std::thread::id thread_id;
+};
+
+class FakeOp : public OpLite {
+ public:
+  explicit FakeOp(const std::string& type) : OpLite(type) {}
+
+  bool CheckShape() const override { return true; }
+  bool InferShapeImpl() const override { return true; }
+  bool AttachImpl(const cpp::OpDesc& opdesc, lite::Scope* scope) override {
+    return true;
+  }
+  void AttachKernel(KernelBase* kernel) override {}
+  std::string DebugString() const override { return "fake"; }
+};
+
+template <TargetType Target>
+class RecordKernel : public KernelLite<Target, PRECISION(kFloat)> {
+ public:
+  RecordKernel(std::atomic<int>* clock, RunRecord* record)
+      : clock_(clock), record_(record) {}
+
+  void Run() override {
+    record_->thread_id = std::this_thread::get_id();
+    record_->begin = (*clock_)++;
+    // Give the independent kernels a chance to overlap.
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    record_->end = (*clock_)++;
+  }
+
+ private:
+  std::atomic<int>* clock_;
+  RunRecord* record_;
+};
+
+class InterOpTester {
+ public:
+  template <TargetType Target = TARGET(kHost)>
+  void Add(const std::string& type,
+           const std::vector<std::string>& inputs,
+           const std::vector<std::string>& outputs) {
+    cpp::OpDesc desc;
+    desc.SetType(type);
+    desc.SetInput("X", inputs);
+    desc.SetOutput("Out", outputs);
+    std::shared_ptr<OpLite> op(new FakeOp(type));
+    CHECK(op->Attach(desc, &scope_));
+    records_.emplace_back(new RunRecord());
+    std::unique_ptr<KernelBase> kernel(
+        new RecordKernel<Target>(&clock_, records_.back().get()));
+    insts_.emplace_back(op, std::move(kernel));
+  }
+
+  std::vector<Instruction>* insts() { return &insts_; }
+  std::vector<std::vector<Instruction>> TakeInsts() {
+    std::vector<std::vector<Instruction>> insts;
+    insts.emplace_back(std::move(insts_));
+    return insts;
+  }
+
+  const RunRecord& record(int i) const { return *records_[i]; }
+  // Whether the i-th instruction finishes before the j-th one begins.
+  bool Before(int i, int j) const {
+    return record(i).end >= 0 && record(i).end < record(j).begin;
+  }
+
+  void Reset() {
+    clock_ = 0;
+    for (auto& record : records_) {
+      *record = RunRecord();
+    }
+  }
+
+ private:
+  Scope scope_;
+  std::atomic<int> clock_{0};
+  std::vector<std::unique_ptr<RunRecord>> records_;
+  std::vector<Instruction> insts_;
+};
+
+// feed -> x, a = f(x), b = g(x), c = h(a, b), d = k(c), a = l(x), d -> fetch
+template <TargetType Target = TARGET(kHost)>
+static void BuildGraph(InterOpTester* tester) {
+  tester->Add("feed", {"feed"}, {"x"});
+  tester->Add("fake", {"x"}, {"a"});
+  tester->Add<Target>("fake", {"x"}, {"b"});
+  tester->Add("fake", {"a", "b"}, {"c"});
+  tester->Add("fake", {"c"}, {"d"});
+  tester->Add("fake", {"x"}, {"a"});
+  tester->Add("fetch", {"d"}, {"fetch"});
+}
+
+TEST(inter_op_executor, dependencies) {
+  InterOpTester tester;
+  BuildGraph(&tester);
+  ASSERT_TRUE(InterOpExecutor::IsSupported(*tester.insts()));
+  InterOpExecutor executor(tester.insts(), 4);
+  // a and b, then c, then d and the second a.
+  EXPECT_EQ(executor.max_parallelism(), 2);
+
+  for (int iter = 0; iter < 10; iter++) {
+    tester.Reset();
+    executor.Run();
+    // The feed and fetch ops are left to the predictor.
+    EXPECT_EQ(tester.record(0).begin, -1);
+    EXPECT_EQ(tester.record(6).begin, -1);
+    // read-after-write
+    EXPECT_TRUE(tester.Before(1, 3));
+    EXPECT_TRUE(tester.Before(2, 3));
+    EXPECT_TRUE(tester.Before(3, 4));
+    // write-after-write and write-after-read
+    EXPECT_TRUE(tester.Before(1, 5));
+    EXPECT_TRUE(tester.Before(3, 5));
+    for (int i = 1; i <= 5; i++) {
+      EXPECT_NE(tester.record(i).thread_id, std::this_thread::get_id());
+    }
+  }
+}
+
+TEST(inter_op_executor, empty_graph) {
+  InterOpTester tester;
+  tester.Add("feed", {"feed"}, {"x"});
+  tester.Add("fetch", {"x"}, {"fetch"});
+  InterOpExecutor executor(tester.insts(), 4);
+  EXPECT_EQ(executor.max_parallelism(), 1);
+  executor.Run();
+  EXPECT_EQ(tester.record(0).begin, -1);
+  EXPECT_EQ(tester.record(1).begin, -1);
+}
+
+TEST(inter_op_executor, runtime_program) {
+  InterOpTester tester;
+  BuildGraph(&tester);
+  RuntimeProgram program(tester.TakeInsts());
+  program.set_inter_op_threads(2);
+  program.Run();
+  EXPECT_TRUE(tester.Before(1, 3));
+  EXPECT_TRUE(tester.Before(3, 5));
+  EXPECT_NE(tester.record(1).thread_id, std::this_thread::get_id());
+}
+
+// A program with the kernels of the other targets falls back to the serial
+// run on the calling thread.
+TEST(inter_op_executor, fall_back_to_serial) {
+  InterOpTester tester;
+  BuildGraph<TARGET(kOpenCL)>(&tester);
+  EXPECT_FALSE(InterOpExecutor::IsSupported(*tester.insts()));
+  RuntimeProgram program(tester.TakeInsts());
+  program.set_inter_op_threads(2);
+  program.Run();
+  for (int i = 1; i <= 5; i++) {
+    EXPECT_EQ(tester.record(i).thread_id, std::this_thread::get_id());
+    EXPECT_EQ(tester.record(i).begin, 2 * (i - 1));
+  }
+}
+
+}  // namespace lite
+}  // namespace paddle
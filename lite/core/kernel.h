@@ -55,6 +55,12 @@ class KernelBase {
   /// Run kernel initialization if needed at every run (eg. input shape changed)
   virtual void ReInitWhenNeeded() {}
 
+  /// Whether the kernel supports the attributes and the persistable inputs in
+  /// its param, it is checked before the shapes of the activations are known.
+  /// The kernels which don't are never picked, e.g. the kernels of a layout
+  /// leave such ops to the kernels of the other layouts.
+  virtual bool IsParamSupported() const { return true; }
+
   /// Run the kernel. Before Run, both the param_ and context_ should be valid.
   virtual void Run() = 0;
 
@@ -78,14 +84,18 @@ class KernelBase {
 #endif
 
   void Launch() {
-    /// First run, init kernel, do weights transform once
-    if (is_first_epoch_) {
-      PrepareForRun();
-      is_first_epoch_ = false;
+    {
+      // The weights transformed by the kernel are its private packs.
+      MemoryKindGuard guard(MemoryKind::kKernelPack);
+      /// First run, init kernel, do weights transform once
+      if (is_first_epoch_) {
+        PrepareForRun();
+        is_first_epoch_ = false;
+      }
+      /// re-init the kernel if needed (input shape should be checked in conv
+      /// kernel)
+      ReInitWhenNeeded();
     }
-    /// re-init the kernel if needed (input shape should be checked in conv
-    /// kernel)
-    ReInitWhenNeeded();
 
     // Reset the workspace to make every kernel in the same thread to share the
     // temporary memory.
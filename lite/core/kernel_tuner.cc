@@ -0,0 +1,159 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/kernel_tuner.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>  // NOLINT
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include "lite/utils/cp_logging.h"
+
+namespace paddle {
+namespace lite {
+
+// Every candidate is run once to warm up, and the fastest of the timed runs
+// is compared.
+static constexpr int kTuneRepeats = 3;
+
+KernelTuner& KernelTuner::Global() {
+  static auto* x = new KernelTuner;
+  return *x;
+}
+
+void KernelTuner::Enable(const std::string& path) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  enabled_ = true;
+  path_ = path;
+  if (device_.empty()) {
+    device_ = DeviceName();
+  }
+  std::ifstream file(path);
+  std::string line;
+  while (std::getline(file, line)) {
+    if (line.empty() || line[0] == '#') continue;
+    std::istringstream ss(line);
+    std::string key;
+    int index = -1;
+    if (ss >> key >> index && index >= 0) {
+      records_[key] = index;
+    } else {
+      LOG(WARNING) << "Invalid record of the tuning file " << path << ": "
+                   << line;
+    }
+  }
+  VLOG(3) << "Loaded " << records_.size() << " tuning records from " << path;
+}
+
+void KernelTuner::Disable() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  enabled_ = false;
+}
+
+std::string KernelTuner::FullKey(const std::string& key) const {
+  std::string full_key = device_ + "|" + key;
+  for (auto& c : full_key) {
+    if (isspace(c)) c = '_';
+  }
+  return full_key;
+}
+
+int KernelTuner::Lookup(const std::string& key) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = records_.find(FullKey(key));
+  return it == records_.end() ? -1 : it->second;
+}
+
+void KernelTuner::Record(const std::string& key, int index) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  records_[FullKey(key)] = index;
+  dirty_ = true;
+}
+
+int KernelTuner::Select(const std::string& key,
+                        int num,
+                        const std::function<void(int)>& run) {
+  CHECK_GT(num, 0);
+  int best = Lookup(key);
+  if (best >= 0 && best < num) {
+    return best;
+  }
+  double best_time = (std::numeric_limits<double>::max)();
+  for (int i = 0; i < num; i++) {
+    run(i);
+    double min_time = (std::numeric_limits<double>::max)();
+    for (int j = 0; j < kTuneRepeats; j++) {
+      auto start = std::chrono::steady_clock::now();
+      run(i);
+      std::chrono::duration<double, std::micro> elapsed =
+          std::chrono::steady_clock::now() - start;
+      min_time = (std::min)(min_time, elapsed.count());
+    }
+    VLOG(3) << "Tuning " << key << ": candidate " << i << " takes "
+            << min_time << " us";
+    if (min_time < best_time) {
+      best_time = min_time;
+      best = i;
+    }
+  }
+  Record(key, best);
+  return best;
+}
+
+void KernelTuner::Flush() {
+  if (!dirty_) return;
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!enabled_ || !dirty_) return;
+  std::ofstream file(path_);
+  if (!file) {
+    LOG(WARNING) << "Failed to write the tuning file " << path_;
+    return;
+  }
+  file << "# <device>|<kernel>|<threads>|<shape> <index of the fastest>\n";
+  for (auto& record : records_) {
+    file << record.first << " " << record.second << "\n";
+  }
+  dirty_ = false;
+}
+
+std::string KernelTuner::DeviceName() {
+  // The cpu model of x86 or the hardware of arm.
+  std::ifstream file("/proc/cpuinfo");
+  std::string line;
+  std::string name;
+  while (std::getline(file, line)) {
+    bool hardware = line.compare(0, 8, "Hardware") == 0;
+    if (!hardware && (!name.empty() || line.compare(0, 10, "model name"))) {
+      continue;
+    }
+    auto colon = line.find(':');
+    if (colon == std::string::npos) continue;
+    auto pos = line.find_first_not_of(" \t", colon + 1);
+    if (pos != std::string::npos) {
+      name = line.substr(pos);
+    }
+    if (hardware) break;
+  }
+  if (name.empty()) {
+    name = "unknown";
+  }
+  for (auto& c : name) {
+    if (isspace(c) || c == '|') c = '_';
+  }
+  return name;
+}
+
+}  // namespace lite
+}  // namespace paddle
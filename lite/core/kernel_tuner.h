@@ -0,0 +1,79 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <mutex>  // NOLINT
+#include <string>
+
+namespace paddle {
+namespace lite {
+
+/*
+ * KernelTuner picks the implementation of a kernel by measuring every
+ * eligible one on the actual machine, instead of the fixed heuristics.
+ *
+ * It is enabled by a tuning file, the records of the file are loaded and the
+ * new records are written back by `Flush`. A record maps the key of the
+ * device, the number of the threads and the shape of the kernel to the index
+ * of the fastest implementation, so one file can be shared by the devices
+ * and the tuning runs only once for every shape.
+ */
+class KernelTuner {
+ public:
+  static KernelTuner& Global();
+
+  // Enable the tuning with the file `path`, the records are loaded if the
+  // file exists.
+  void Enable(const std::string& path);
+  void Disable();
+  bool enabled() const { return enabled_; }
+
+  // Returns the index of the fastest of the `num` candidates for the kernel
+  // of `key`. The recorded index is returned if any, otherwise `run(i)` which
+  // runs the i-th candidate once is timed for every candidate, and the
+  // fastest is recorded.
+  int Select(const std::string& key,
+             int num,
+             const std::function<void(int)>& run);
+
+  // Returns the recorded index of the key, -1 if not tuned.
+  int Lookup(const std::string& key) const;
+  void Record(const std::string& key, int index);
+
+  // Write the records to the tuning file if any record is added, it is cheap
+  // otherwise so it is called after every run.
+  void Flush();
+
+  // The name of the device in the records, the spaces are replaced by '_'.
+  static std::string DeviceName();
+
+ private:
+  KernelTuner() = default;
+
+  std::string FullKey(const std::string& key) const;
+
+  std::atomic<bool> enabled_{false};
+  std::atomic<bool> dirty_{false};
+  std::string path_;
+  std::string device_;
+  std::map<std::string, int> records_;
+  mutable std::mutex mutex_;
+};
+
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,67 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/kernel_tuner.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+namespace paddle {
+namespace lite {
+
+TEST(kernel_tuner, select_and_reload) {
+  const std::string path = "kernel_tuner_test.txt";
+  std::remove(path.c_str());
+  auto& tuner = KernelTuner::Global();
+  tuner.Enable(path);
+  ASSERT_TRUE(tuner.enabled());
+  EXPECT_EQ(tuner.Lookup("conv2d|t1|1,8,8"), -1);
+
+  // The candidate 1 is the fastest.
+  std::vector<int> runs(3, 0);
+  int best = tuner.Select("conv2d|t1|1,8,8", 3, [&](int i) {
+    runs[i]++;
+    std::this_thread::sleep_for(std::chrono::milliseconds(i == 1 ? 1 : 5));
+  });
+  EXPECT_EQ(best, 1);
+  for (int n : runs) {
+    EXPECT_GT(n, 1);
+  }
+  tuner.Flush();
+
+  // The record is reused without running the candidates.
+  tuner.Disable();
+  tuner.Enable(path);
+  std::fill(runs.begin(), runs.end(), 0);
+  best = tuner.Select("conv2d|t1|1,8,8", 3, [&](int i) { runs[i]++; });
+  EXPECT_EQ(best, 1);
+  EXPECT_EQ(runs, std::vector<int>(3, 0));
+
+  // The records are keyed by the device.
+  std::ifstream file(path);
+  std::string content((std::istreambuf_iterator<char>(file)),
+                      std::istreambuf_iterator<char>());
+  EXPECT_NE(content.find(KernelTuner::DeviceName() + "|conv2d|t1|1,8,8 1"),
+            std::string::npos);
+  tuner.Disable();
+  std::remove(path.c_str());
+}
+
+}  // namespace lite
+}  // namespace paddle
@@ -14,6 +14,7 @@
 
 #include <gtest/gtest.h>
 #include <cstring>
+#include <vector>
 #include "lite/core/tensor.h"
 
 namespace paddle {
@@ -58,5 +59,47 @@ TEST(tensor, shared_memory) {
 #endif
 }
 
+TEST(ddim, small_and_large_rank) {
+  // Up to 8 dims are stored inline, the others on the heap.
+  for (size_t rank : {0, 1, 4, 8, 9, 12}) {
+    std::vector<int64_t> shape(rank);
+    for (size_t i = 0; i < rank; i++) {
+      shape[i] = i + 2;
+    }
+    DDim dims(shape);
+    ASSERT_EQ(dims.size(), rank);
+    EXPECT_EQ(dims.Vectorize(), shape);
+    EXPECT_EQ(static_cast<std::vector<int64_t>>(dims.data()), shape);
+
+    DDim copied = dims;
+    EXPECT_EQ(copied, dims);
+    if (rank > 0) {
+      copied[rank - 1] = 1;
+      EXPECT_NE(copied, dims);
+      EXPECT_EQ(dims[rank - 1], static_cast<int64_t>(rank + 1));
+    }
+
+    int64_t production = 1;
+    for (auto v : shape) production *= v;
+    EXPECT_EQ(dims.production(), production);
+    EXPECT_EQ(dims.Slice(1, rank).size(), rank > 1 ? rank - 1 : 0);
+    if (rank >= 2) {
+      auto flatten = dims.Flatten2D(1);
+      ASSERT_EQ(flatten.size(), 2u);
+      EXPECT_EQ(flatten[0], shape[0]);
+      EXPECT_EQ(flatten[0] * flatten[1], production);
+    }
+  }
+
+  // Grow from the inline storage to the heap, then shrink back.
+  TensorLite tensor;
+  tensor.Resize({2, 3});
+  tensor.Resize(std::vector<int64_t>(10, 1));
+  EXPECT_EQ(tensor.dims().size(), 10u);
+  tensor.Resize({4, 5, 6});
+  EXPECT_EQ(tensor.dims(), DDim(std::vector<int64_t>({4, 5, 6})));
+  EXPECT_EQ(tensor.numel(), 120);
+}
+
 }  // namespace lite
 }  // namespace paddle
@@ -17,6 +17,78 @@
 namespace paddle {
 namespace lite {
 
+MemoryStats& MemoryStats::Global() {
+  static auto* x = new MemoryStats;
+  return *x;
+}
+
+int MemoryStats::Index(TargetType target) {
+  switch (target) {
+    case TargetType::kX86:
+    case TargetType::kARM:
+      return static_cast<int>(TargetType::kHost);
+    default:
+      return static_cast<int>(target);
+  }
+}
+
+void MemoryStats::Counter::Add(int64_t size) {
+  int64_t current = this->current.fetch_add(size) + size;
+  if (size <= 0) return;
+  allocs++;
+  int64_t peak = this->peak.load();
+  while (current > peak && !this->peak.compare_exchange_weak(peak, current)) {
+  }
+}
+
+MemoryCounter MemoryStats::Counter::Get() const {
+  MemoryCounter counter;
+  counter.current_bytes = current.load();
+  counter.peak_bytes = peak.load();
+  counter.num_allocs = allocs.load();
+  return counter;
+}
+
+void MemoryStats::Alloc(TargetType target, MemoryKind kind, size_t size) {
+  int index = Index(target);
+  totals_[index].Add(static_cast<int64_t>(size));
+  kinds_[index][static_cast<int>(kind)].Add(static_cast<int64_t>(size));
+}
+
+void MemoryStats::Free(TargetType target, MemoryKind kind, size_t size) {
+  int index = Index(target);
+  totals_[index].Add(-static_cast<int64_t>(size));
+  kinds_[index][static_cast<int>(kind)].Add(-static_cast<int64_t>(size));
+}
+
+MemoryCounter MemoryStats::Get(TargetType target) const {
+  return totals_[Index(target)].Get();
+}
+
+MemoryCounter MemoryStats::Get(TargetType target, MemoryKind kind) const {
+  return kinds_[Index(target)][static_cast<int>(kind)].Get();
+}
+
+void MemoryStats::ResetPeak() {
+  for (int i = 0; i < kNumTargets; i++) {
+    totals_[i].peak = totals_[i].current.load();
+    for (int j = 0; j < kNumKinds; j++) {
+      kinds_[i][j].peak = kinds_[i][j].current.load();
+    }
+  }
+}
+
+static LITE_THREAD_LOCAL MemoryKind current_memory_kind = MemoryKind::kOther;
+
+MemoryKindGuard::MemoryKindGuard(MemoryKind kind)
+    : prev_(current_memory_kind) {
+  current_memory_kind = kind;
+}
+
+MemoryKindGuard::~MemoryKindGuard() { current_memory_kind = prev_; }
+
+MemoryKind MemoryKindGuard::current() { return current_memory_kind; }
+
 void* TargetMalloc(TargetType target, size_t size) {
   void* data{nullptr};
   switch (target) {
@@ -14,6 +14,7 @@
 
 #pragma once
 #include <algorithm>
+#include <atomic>
 #include <string>
 #include "lite/api/paddle_place.h"
 #include "lite/core/target_wrapper.h"
@@ -110,6 +111,65 @@ void CopySync(void* dst, const void* src, size_t size, IoDirection dir) {
   }
 }
 
+using lite_api::MemoryCounter;
+using lite_api::MemoryKind;
+
+/*
+ * MemoryStats counts the memory allocated by the buffers of the process per
+ * target and per kind. The host, x86 and arm targets share the host counters
+ * as they share the allocator.
+ */
+class LITE_API MemoryStats {
+ public:
+  static MemoryStats& Global();
+
+  void Alloc(TargetType target, MemoryKind kind, size_t size);
+  void Free(TargetType target, MemoryKind kind, size_t size);
+
+  // The counters of all of the kinds.
+  MemoryCounter Get(TargetType target) const;
+  MemoryCounter Get(TargetType target, MemoryKind kind) const;
+
+  // Restart the peaks from the current usage.
+  void ResetPeak();
+
+ private:
+  struct Counter {
+    std::atomic<int64_t> current{0};
+    std::atomic<int64_t> peak{0};
+    std::atomic<int64_t> allocs{0};
+
+    void Add(int64_t size);
+    MemoryCounter Get() const;
+  };
+
+  static constexpr int kNumTargets = static_cast<int>(TargetType::NUM);
+  static constexpr int kNumKinds = static_cast<int>(MemoryKind::NUM);
+
+  MemoryStats() = default;
+  static int Index(TargetType target);
+
+  Counter totals_[kNumTargets];
+  Counter kinds_[kNumTargets][kNumKinds];
+};
+
+// The buffers allocated by the calling thread are counted as `kind` in the
+// scope of the guard. The guards can be nested, and the allocations out of
+// any guard are counted as MemoryKind::kOther.
+class LITE_API MemoryKindGuard {
+ public:
+  explicit MemoryKindGuard(MemoryKind kind);
+  ~MemoryKindGuard();
+
+  static MemoryKind current();
+
+ private:
+  MemoryKind prev_;
+
+  MemoryKindGuard(const MemoryKindGuard&) = delete;
+  MemoryKindGuard& operator=(const MemoryKindGuard&) = delete;
+};
+
 // Memory buffer manager.
 class Buffer {
  public:
@@ -121,13 +181,28 @@ class Buffer {
   size_t space() const { return space_; }
   bool own_data() const { return own_data_; }
 
+  // Mark the unowned data as detachable, such as a slice of MemoryArena or a
+  // mapped param, the buffer falls back to a private allocation instead of
+  // failing once it is too small.
+  void set_detachable(bool x) { detachable_ = x; }
+  bool detachable() const { return detachable_; }
+
   void ResetLazy(TargetType target, size_t size) {
     if (target != target_ || space_ < size) {
+      if (detachable_) {
+        // The unowned data is released by its owner.
+        data_ = nullptr;
+        space_ = 0;
+        own_data_ = true;
+        detachable_ = false;
+      }
       CHECK_EQ(own_data_, true) << "Can not reset unowned buffer.";
       Free();
       data_ = TargetMalloc(target, size);
       target_ = target;
       space_ = size;
+      kind_ = MemoryKindGuard::current();
+      MemoryStats::Global().Alloc(target_, kind_, space_);
 #ifdef LITE_WITH_OPENCL
       cl_use_image2d_ = false;
 #endif
@@ -155,6 +230,8 @@ class Buffer {
       space_ = sizeof(T) * cl_image2d_width_ * cl_image2d_height_ *
                4;  // un-used for opencl Image2D, 4 for RGBA,
       cl_use_image2d_ = true;
+      kind_ = MemoryKindGuard::current();
+      MemoryStats::Global().Alloc(target_, kind_, space_);
     }
   }
 #endif
@@ -166,6 +243,7 @@ class Buffer {
       } else {
         TargetFree(target_, data_, "cl_use_image2d_");
       }
+      MemoryStats::Global().Free(target_, kind_, space_);
     }
     data_ = nullptr;
     target_ = TargetType::kHost;
@@ -193,7 +271,10 @@ class Buffer {
   size_t cl_image2d_height_{0};  // only used for OpenCL Image2D
   void* data_{nullptr};
   bool own_data_{true};
+  bool detachable_{false};
   TargetType target_{TargetType::kHost};
+  // The kind of the owned data counted by MemoryStats.
+  MemoryKind kind_{MemoryKind::kOther};
 };
 
 }  // namespace lite
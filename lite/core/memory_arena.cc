@@ -0,0 +1,185 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/memory_arena.h"
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <utility>
+
+namespace paddle {
+namespace lite {
+
+static size_t AlignTo(size_t size, size_t alignment) {
+  return (size + alignment - 1) / alignment * alignment;
+}
+
+size_t PlanArenaOffsets(std::vector<ArenaBlock>* blocks, size_t alignment) {
+  CHECK(blocks);
+  CHECK_GT(alignment, 0u);
+  std::vector<size_t> order(blocks->size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    return (*blocks)[a].size > (*blocks)[b].size;
+  });
+
+  auto overlap = [](const ArenaBlock& a, const ArenaBlock& b) -> bool {
+    return a.first_use <= b.last_use && b.first_use <= a.last_use;
+  };
+
+  size_t arena_size = 0;
+  std::vector<size_t> placed;
+  std::vector<const ArenaBlock*> alive;
+  for (auto idx : order) {
+    auto& block = (*blocks)[idx];
+    size_t size = AlignTo(block.size, alignment);
+    // Collect the placed blocks whose lifetime overlaps with the current one.
+    alive.clear();
+    for (auto other : placed) {
+      if (overlap(block, (*blocks)[other])) {
+        alive.push_back(&(*blocks)[other]);
+      }
+    }
+    std::sort(alive.begin(),
+              alive.end(),
+              [](const ArenaBlock* a, const ArenaBlock* b) {
+                return a->offset < b->offset;
+              });
+    // Find the smallest gap which is large enough, or append to the end.
+    size_t best_offset = std::numeric_limits<size_t>::max();
+    size_t best_gap = std::numeric_limits<size_t>::max();
+    size_t prev_end = 0;
+    for (auto* other : alive) {
+      if (other->offset > prev_end) {
+        size_t gap = other->offset - prev_end;
+        if (gap >= size && gap < best_gap) {
+          best_gap = gap;
+          best_offset = prev_end;
+        }
+      }
+      prev_end =
+          (std::max)(prev_end, other->offset + AlignTo(other->size, alignment));
+    }
+    if (best_offset == std::numeric_limits<size_t>::max()) {
+      best_offset = prev_end;
+    }
+    block.offset = best_offset;
+    arena_size = (std::max)(arena_size, best_offset + size);
+    placed.push_back(idx);
+  }
+  return arena_size;
+}
+
+void MemoryArena::Bind(std::vector<ArenaBlock>&& blocks) {
+  blocks_ = std::move(blocks);
+  size_t arena_size = PlanArenaOffsets(&blocks_);
+  // Drop the old arena only after all of the tensors are bound to the new one.
+  std::unique_ptr<Buffer> buffer(new Buffer());
+  if (arena_size > 0) {
+    buffer->ResetLazy(target_, arena_size);
+  }
+  size_t total_size = 0;
+  for (auto& block : blocks_) {
+    CHECK(block.tensor);
+    CHECK_EQ(block.tensor->offset(), 0u)
+        << "Only the tensors with zero offset can be bound to the arena.";
+    auto slice = std::make_shared<Buffer>(
+        static_cast<char*>(buffer->data()) + block.offset, target_, block.size);
+    slice->set_detachable(true);
+    block.tensor->ResetBuffer(slice, block.size);
+    total_size += block.size;
+  }
+  buffer_ = std::move(buffer);
+  VLOG(4) << "Bind " << blocks_.size() << " tensors(" << total_size
+          << " bytes) to the arena of " << TargetToStr(target_) << " with "
+          << arena_size << " bytes";
+}
+
+bool MemoryArena::IsValid() const {
+  if (!buffer_) return blocks_.empty();
+  for (auto& block : blocks_) {
+    if (block.tensor->raw_data() !=
+        static_cast<const char*>(buffer_->data()) + block.offset) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void MemoryArena::Release() {
+  if (buffer_) {
+    for (auto& block : blocks_) {
+      if (block.tensor->raw_data() ==
+          static_cast<const char*>(buffer_->data()) + block.offset) {
+        block.tensor->clear();
+      }
+    }
+  }
+  blocks_.clear();
+  buffer_.reset();
+}
+
+char* SliceArena::Reserve(size_t size) {
+  if (!buffer_ || buffer_->space() < size) {
+    std::unique_ptr<Buffer> buffer(new Buffer());
+    buffer->ResetLazy(target_, size);
+    retired_ = std::move(buffer_);
+    buffer_ = std::move(buffer);
+    slices_.clear();
+  }
+  return static_cast<char*>(buffer_->data());
+}
+
+bool SliceArena::InPlace(const Tensor& tensor, size_t offset) const {
+  return buffer_ && tensor.raw_data() ==
+                        static_cast<const char*>(buffer_->data()) + offset;
+}
+
+bool SliceArena::Bind(Tensor* tensor, size_t offset, size_t size) {
+  CHECK(buffer_);
+  CHECK_LE(offset + size, buffer_->space());
+  auto it = slices_.find(tensor);
+  if (it != slices_.end() && it->second == std::make_pair(offset, size) &&
+      InPlace(*tensor, offset)) {
+    return true;
+  }
+  if (tensor->offset() != 0 || tensor->memory_size() > size) {
+    slices_.erase(tensor);
+    return false;
+  }
+  auto slice = std::make_shared<Buffer>(
+      static_cast<char*>(buffer_->data()) + offset, target_, size);
+  slice->set_detachable(true);
+  tensor->ResetBuffer(slice, size);
+  slices_[tensor] = std::make_pair(offset, size);
+  return true;
+}
+
+bool SliceArena::InChunk(const Tensor& tensor) const {
+  if (!buffer_ || !tensor.IsInitialized()) return false;
+  auto* begin = static_cast<const char*>(buffer_->data());
+  auto* data = static_cast<const char*>(tensor.raw_data());
+  return data >= begin && data < begin + buffer_->space();
+}
+
+void SliceArena::Unbind(Tensor* tensor) {
+  slices_.erase(tensor);
+  if (InChunk(*tensor)) {
+    tensor->clear();
+  }
+}
+
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,216 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "lite/core/memory.h"
+#include "lite/core/tensor.h"
+
+namespace paddle {
+namespace lite {
+
+// Offsets in the arena are aligned as TargetMalloc does for the host.
+static const size_t kArenaAlignment = 64;
+
+// A tensor to be placed in the arena, `first_use` and `last_use` are the
+// indices of the instructions which produce and last consume it.
+struct ArenaBlock {
+  Tensor* tensor{nullptr};
+  size_t size{0};
+  int first_use{0};
+  int last_use{0};
+  // Assigned by PlanArenaOffsets.
+  size_t offset{0};
+};
+
+// Assign an offset to each block so that the blocks alive at the same time
+// never overlap, and return the size of the arena. The blocks are placed from
+// the largest to the smallest, each one into the best-fit gap left by the
+// blocks already placed.
+size_t PlanArenaOffsets(std::vector<ArenaBlock>* blocks,
+                        size_t alignment = kArenaAlignment);
+
+/*
+ * MemoryArena pre-allocates one chunk of memory for a target and binds the
+ * tensors to their planned slices of it through TensorLite::ResetBuffer. A
+ * tensor which outgrows its slice falls back to a private allocation, which
+ * can be detected with IsValid() to make a new plan.
+ */
+class MemoryArena {
+ public:
+  explicit MemoryArena(TargetType target) : target_(target) {}
+
+  // Plan the offsets of the blocks and bind each tensor to its slice.
+  void Bind(std::vector<ArenaBlock>&& blocks);
+
+  // Whether all of the bound tensors still live in the arena.
+  bool IsValid() const;
+
+  // Unbind the tensors which still live in the arena and free it, these
+  // tensors will allocate private memory when they are used again.
+  void Release();
+
+  TargetType target() const { return target_; }
+  size_t space() const { return buffer_ ? buffer_->space() : 0; }
+  const std::vector<ArenaBlock>& blocks() const { return blocks_; }
+
+ private:
+  TargetType target_;
+  std::unique_ptr<Buffer> buffer_;
+  std::vector<ArenaBlock> blocks_;
+};
+
+/*
+ * SliceArena keeps a tensor and its consecutive parts in one chunk of memory,
+ * so that concat reads its inputs and split writes its outputs in place: the
+ * whole tensor is bound to the chunk and every part to its slice right after
+ * the parts before it. As in MemoryArena, a tensor which outgrows its slice
+ * falls back to a private allocation, and it is copied and bound again by the
+ * next Concat or Split.
+ */
+class SliceArena {
+ public:
+  explicit SliceArena(TargetType target) : target_(target) {}
+
+  // Concat the inputs into `out` along the outermost axis, the inputs which
+  // already live in their slices are not copied.
+  template <typename T>
+  void Concat(const std::vector<Tensor*>& inputs, Tensor* out);
+
+  // Split `x` into the outputs along the outermost axis, nothing is copied if
+  // `x` already lives in the chunk.
+  template <typename T>
+  void Split(Tensor* x, const std::vector<Tensor*>& outputs);
+
+  // Make the chunk hold at least `size` bytes. The old chunk is kept until
+  // the next reallocation, so the tensors still bound to it can be copied.
+  char* Reserve(size_t size);
+
+  // Whether the tensor lives at `offset` of the chunk.
+  bool InPlace(const Tensor& tensor, size_t offset) const;
+
+  // Whether the data of the tensor lives anywhere in the chunk.
+  bool InChunk(const Tensor& tensor) const;
+
+  // Bind the tensor to the slice of `size` bytes at `offset` of the chunk,
+  // returns false if the tensor has an offset or holds more bytes.
+  bool Bind(Tensor* tensor, size_t offset, size_t size);
+
+  // Move the tensor out of the chunk if it lives there, it allocates private
+  // memory when it is used again.
+  void Unbind(Tensor* tensor);
+
+  size_t space() const { return buffer_ ? buffer_->space() : 0; }
+
+ private:
+  TargetType target_;
+  std::unique_ptr<Buffer> buffer_;
+  std::unique_ptr<Buffer> retired_;
+  // Holds the inputs of Concat which have to leave their old slices.
+  Buffer staging_;
+  // The offset and the size of the slices bound to the current chunk.
+  std::map<const Tensor*, std::pair<size_t, size_t>> slices_;
+};
+
+template <typename T>
+void SliceArena::Concat(const std::vector<Tensor*>& inputs, Tensor* out) {
+  size_t size = out->numel() * sizeof(T);
+  char* data = Reserve((std::max)(size, out->memory_size()));
+  // The inputs which live in the chunk but not in their new slices, e.g. after
+  // the shapes change, are staged first, or copying the inputs before them
+  // would overwrite them.
+  std::vector<const void*> sources(inputs.size());
+  size_t offset = 0;
+  size_t staged = 0;
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    size_t bytes = inputs[i]->numel() * sizeof(T);
+    CHECK_LE(offset + bytes, size) << "The inputs overflow the output.";
+    if (InPlace(*inputs[i], offset)) {
+      sources[i] = nullptr;
+    } else {
+      sources[i] = inputs[i]->raw_data();
+      if (InChunk(*inputs[i])) staged += bytes;
+    }
+    offset += bytes;
+  }
+  if (staged > 0) {
+    staging_.ResetLazy(target_, staged);
+    char* stage = static_cast<char*>(staging_.data());
+    for (size_t i = 0; i < inputs.size(); ++i) {
+      if (sources[i] && InChunk(*inputs[i])) {
+        size_t bytes = inputs[i]->numel() * sizeof(T);
+        TargetCopy(target_, stage, sources[i], bytes);
+        sources[i] = stage;
+        stage += bytes;
+      }
+    }
+  }
+  // Now every source is either in its own slice or out of the chunk.
+  offset = 0;
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    size_t bytes = inputs[i]->numel() * sizeof(T);
+    if (sources[i]) {
+      TargetCopy(target_, data + offset, sources[i], bytes);
+    }
+    offset += bytes;
+  }
+  if (Bind(out, 0, space())) {
+    out->template mutable_data<T>();
+  } else {
+    TargetCopy(target_, out->template mutable_data<T>(), data, size);
+  }
+  offset = 0;
+  for (auto* in : inputs) {
+    size_t bytes = in->numel() * sizeof(T);
+    if (in->memory_size() == bytes && !in->persistable()) {
+      Bind(in, offset, bytes);
+    }
+    offset += bytes;
+  }
+}
+
+template <typename T>
+void SliceArena::Split(Tensor* x, const std::vector<Tensor*>& outputs) {
+  size_t size = x->numel() * sizeof(T);
+  if (!InPlace(*x, 0)) {
+    char* data = Reserve((std::max)(size, x->memory_size()));
+    TargetCopy(target_, data, x->raw_data(), size);
+    if (!x->persistable()) {
+      Bind(x, 0, space());
+    }
+  }
+  const char* data = static_cast<const char*>(buffer_->data());
+  size_t offset = 0;
+  for (auto* out : outputs) {
+    size_t bytes = out->numel() * sizeof(T);
+    CHECK_LE(offset + bytes, size) << "The outputs overflow the input.";
+    if (Bind(out, offset, bytes)) {
+      out->template mutable_data<T>();
+      offset += bytes;
+      continue;
+    }
+    // Leave the chunk, or the other outputs would be overwritten.
+    Unbind(out);
+    TargetCopy(target_, out->template mutable_data<T>(), data + offset, bytes);
+    offset += bytes;
+  }
+}
+
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,174 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/memory_arena.h"
+#include <gtest/gtest.h>
+#include <utility>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+
+TEST(memory_arena, plan) {
+  // size, first_use, last_use
+  const std::vector<std::vector<int>> infos = {
+      {1000, 0, 1}, {10, 1, 3}, {500, 1, 2}, {480, 2, 3}, {64, 3, 4}};
+  std::vector<ArenaBlock> blocks;
+  size_t total_size = 0;
+  for (auto& info : infos) {
+    ArenaBlock block;
+    block.size = info[0];
+    block.first_use = info[1];
+    block.last_use = info[2];
+    blocks.push_back(block);
+    total_size += block.size;
+  }
+  size_t arena_size = PlanArenaOffsets(&blocks, 16);
+  EXPECT_LT(arena_size, total_size);
+  for (size_t i = 0; i < blocks.size(); i++) {
+    auto& a = blocks[i];
+    EXPECT_EQ(a.offset % 16, 0u);
+    EXPECT_LE(a.offset + a.size, arena_size);
+    for (size_t j = i + 1; j < blocks.size(); j++) {
+      auto& b = blocks[j];
+      bool alive = a.first_use <= b.last_use && b.first_use <= a.last_use;
+      bool overlap =
+          a.offset < b.offset + b.size && b.offset < a.offset + a.size;
+      EXPECT_FALSE(alive && overlap) << "block " << i << " and " << j;
+    }
+  }
+}
+
+TEST(memory_arena, bind) {
+  std::vector<Tensor> tensors(3);
+  std::vector<ArenaBlock> blocks;
+  for (size_t i = 0; i < tensors.size(); i++) {
+    tensors[i].Resize({static_cast<int64_t>(16 * (i + 1))});
+    tensors[i].mutable_data<float>();
+    ArenaBlock block;
+    block.tensor = &tensors[i];
+    block.size = tensors[i].memory_size();
+    block.first_use = i;
+    block.last_use = i + 1;
+    blocks.push_back(block);
+  }
+  MemoryArena arena(TARGET(kHost));
+  arena.Bind(std::move(blocks));
+  ASSERT_TRUE(arena.IsValid());
+  // tensors[0] and tensors[2] are never alive at the same time.
+  EXPECT_EQ(tensors[0].raw_data(), tensors[2].raw_data());
+  EXPECT_NE(tensors[1].raw_data(), tensors[2].raw_data());
+
+  // The tensor falls back to a private allocation once it outgrows its slice.
+  tensors[1].Resize({1024});
+  auto* data = tensors[1].mutable_data<float>();
+  data[1023] = 1.f;
+  EXPECT_FALSE(arena.IsValid());
+
+  arena.Release();
+  EXPECT_EQ(arena.space(), 0u);
+  EXPECT_FALSE(tensors[0].IsInitialized());
+  EXPECT_TRUE(tensors[1].IsInitialized());
+}
+
+TEST(slice_arena, concat_split) {
+  // Concat {2, 4} and {3, 4} into {5, 4}.
+  std::vector<Tensor> inputs(2);
+  std::vector<Tensor*> input_ptrs;
+  for (int i = 0; i < 2; i++) {
+    inputs[i].Resize({i + 2, 4});
+    auto* data = inputs[i].mutable_data<float>();
+    for (int j = 0; j < inputs[i].numel(); j++) {
+      data[j] = i * 100 + j;
+    }
+    input_ptrs.push_back(&inputs[i]);
+  }
+  Tensor out;
+  out.Resize({5, 4});
+  SliceArena concat_slices(TARGET(kHost));
+  concat_slices.Concat<float>(input_ptrs, &out);
+  EXPECT_EQ(out.data<float>()[0], 0.f);
+  EXPECT_EQ(out.data<float>()[8], 100.f);
+  EXPECT_EQ(out.data<float>()[19], 111.f);
+  // The inputs are bound to their slices, so the next writes are in place.
+  EXPECT_EQ(inputs[0].raw_data(), out.raw_data());
+  EXPECT_EQ(inputs[1].data<float>(), out.data<float>() + 8);
+  inputs[1].mutable_data<float>()[0] = -1.f;
+  concat_slices.Concat<float>(input_ptrs, &out);
+  EXPECT_EQ(out.data<float>()[8], -1.f);
+
+  // An input which outgrows its slice is copied and bound again.
+  inputs[1].Resize({7, 4});
+  out.Resize({9, 4});
+  inputs[1].mutable_data<float>()[27] = 7.f;
+  EXPECT_NE(inputs[1].data<float>(), out.data<float>() + 8);
+  concat_slices.Concat<float>(input_ptrs, &out);
+  EXPECT_EQ(out.data<float>()[0], 0.f);
+  EXPECT_EQ(out.data<float>()[35], 7.f);
+  EXPECT_EQ(inputs[1].data<float>(), out.data<float>() + 8);
+
+  // Split {9, 4} into {4, 4} and {5, 4}, the outputs are the views of x.
+  std::vector<Tensor> outputs(2);
+  std::vector<Tensor*> output_ptrs;
+  for (int i = 0; i < 2; i++) {
+    outputs[i].Resize({i + 4, 4});
+    output_ptrs.push_back(&outputs[i]);
+  }
+  SliceArena split_slices(TARGET(kHost));
+  split_slices.Split<float>(&out, output_ptrs);
+  EXPECT_EQ(outputs[0].data<float>()[0], 0.f);
+  EXPECT_EQ(outputs[1].data<float>()[19], 7.f);
+  out.mutable_data<float>()[16] = 3.f;
+  split_slices.Split<float>(&out, output_ptrs);
+  EXPECT_EQ(outputs[1].data<float>()[0], 3.f);
+  EXPECT_EQ(outputs[1].data<float>(), out.data<float>() + 16);
+}
+
+TEST(slice_arena, concat_shrink_and_grow) {
+  // Concat the uneven parts whose old slices overlap with the new ones.
+  std::vector<std::vector<int64_t>> sizes{
+      {100, 100, 100}, {90, 130, 50}, {100, 100, 100}, {30, 20, 250}};
+  std::vector<Tensor> inputs(3);
+  std::vector<Tensor*> input_ptrs;
+  for (auto& in : inputs) {
+    input_ptrs.push_back(&in);
+  }
+  Tensor out;
+  SliceArena slices(TARGET(kHost));
+  for (size_t step = 0; step < sizes.size(); step++) {
+    int64_t total = 0;
+    for (int i = 0; i < 3; i++) {
+      inputs[i].Resize({sizes[step][i]});
+      auto* data = inputs[i].mutable_data<int8_t>();
+      for (int j = 0; j < sizes[step][i]; j++) {
+        data[j] = static_cast<int8_t>((step * 3 + i) * 7 + j);
+      }
+      total += sizes[step][i];
+    }
+    out.Resize({total});
+    slices.Concat<int8_t>(input_ptrs, &out);
+    const int8_t* data = out.data<int8_t>();
+    for (int i = 0; i < 3; i++) {
+      for (int j = 0; j < sizes[step][i]; j++) {
+        ASSERT_EQ(data[j], static_cast<int8_t>((step * 3 + i) * 7 + j))
+            << "step " << step << ", input " << i << ", index " << j;
+      }
+      ASSERT_EQ(inputs[i].data<int8_t>(), data);
+      data += sizes[step][i];
+    }
+  }
+}
+
+}  // namespace lite
+}  // namespace paddle
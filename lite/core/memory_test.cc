@@ -36,5 +36,39 @@ TEST(memory, test) {
 #endif
 }
 
+TEST(memory, stats) {
+  auto& stats = MemoryStats::Global();
+  stats.ResetPeak();
+  auto before = stats.Get(TARGET(kHost));
+  auto weights_before = stats.Get(TARGET(kHost), MemoryKind::kWeight);
+  {
+    Buffer weight;
+    {
+      MemoryKindGuard guard(MemoryKind::kWeight);
+      weight.ResetLazy(TARGET(kX86), 100);
+    }
+    Buffer other;
+    other.ResetLazy(TARGET(kARM), 50);
+    // Growing frees the old data first.
+    other.ResizeLazy(80);
+
+    auto total = stats.Get(TARGET(kHost));
+    EXPECT_EQ(total.current_bytes, before.current_bytes + 180);
+    EXPECT_EQ(total.num_allocs, before.num_allocs + 3);
+    EXPECT_GE(total.peak_bytes, before.current_bytes + 180);
+    auto weights = stats.Get(TARGET(kX86), MemoryKind::kWeight);
+    EXPECT_EQ(weights.current_bytes, weights_before.current_bytes + 100);
+
+    // The unowned data is not counted.
+    char data[16];
+    Buffer shared(data, TARGET(kHost), sizeof(data));
+  }
+  auto after = stats.Get(TARGET(kHost));
+  EXPECT_EQ(after.current_bytes, before.current_bytes);
+  EXPECT_GE(after.peak_bytes, before.current_bytes + 180);
+  stats.ResetPeak();
+  EXPECT_EQ(stats.Get(TARGET(kHost)).peak_bytes, after.current_bytes);
+}
+
 }  // namespace lite
 }  // namespace paddle
@@ -0,0 +1,125 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+#include "lite/core/mir/pass.h"
+#include "lite/core/mir/pass_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+/*
+ * ConcatSplitInplacePass sets the 'inplace' attr of concat and split, whose
+ * kernels then keep the inputs of concat or the outputs of split as the
+ * slices of one chunk of memory, so that the producers write the inputs of
+ * concat and the consumers read the outputs of split in place, see
+ * SliceArena.
+ *
+ * The bound vars are rebound by the kernels in every run, so each of them
+ * must be written only by one op which runs in every run, and be bound by
+ * only one concat or split.
+ */
+class ConcatSplitInplacePass : public StmtPass {
+ public:
+  void Apply(const std::unique_ptr<SSAGraph>& graph) override {
+    // The ops write the vars out of every run, or share them with the
+    // sub-blocks, the subgraph engines or the users.
+    const std::set<std::string> invalid_op_types = {"feed",
+                                                    "fetch",
+                                                    "io_copy_once",
+                                                    "layout_once",
+                                                    "while",
+                                                    "conditional_block",
+                                                    "conditional_block_infer",
+                                                    "subgraph"};
+    auto is_inplace = [](Node* op_node) -> bool {
+      auto* op_info = op_node->stmt()->op_info();
+      return op_info->HasAttr("inplace") && op_info->GetAttr<bool>("inplace");
+    };
+    auto is_valid = [&](Node* var_node) -> bool {
+      auto& arg = var_node->AsArg();
+      if (arg.is_weight || arg.is_persist || var_node->inlinks.size() != 1) {
+        return false;
+      }
+      // The views and the slices are bound to the other vars.
+      auto* producer = var_node->inlinks.front();
+      if (invalid_op_types.count(producer->stmt()->op_type()) ||
+          is_inplace(producer)) {
+        return false;
+      }
+      for (auto* consumer : var_node->outlinks) {
+        if (invalid_op_types.count(consumer->stmt()->op_type())) return false;
+      }
+      return true;
+    };
+
+    std::set<std::string> bound_var_names;
+    for (auto* op_node : graph->StmtTopologicalOrder()) {
+      if (!op_node->IsStmt()) continue;
+      auto& stmt = op_node->AsStmt();
+      auto op_type = stmt.op_type();
+      auto target = stmt.place().target;
+      bool supported =
+          (op_type == "concat" &&
+           (target == TARGET(kX86) || target == TARGET(kARM))) ||
+          (op_type == "split" && target == TARGET(kARM));
+      if (!supported) continue;
+      auto* op_info = stmt.mutable_op_info();
+      // The single input of concat is shared with the output on x86 already.
+      std::vector<std::string> var_names = op_info->Input("X");
+      const auto& out_names = op_info->Output("Out");
+      var_names.insert(var_names.end(), out_names.begin(), out_names.end());
+      if (var_names.size() < 3) continue;
+
+      std::set<std::string> names(var_names.begin(), var_names.end());
+      bool valid = names.size() == var_names.size();
+      std::vector<Node*> var_nodes(op_node->inlinks.begin(),
+                                   op_node->inlinks.end());
+      var_nodes.insert(
+          var_nodes.end(), op_node->outlinks.begin(), op_node->outlinks.end());
+      for (auto* var_node : var_nodes) {
+        if (!valid) break;
+        auto& name = var_node->AsArg().name;
+        if (!names.count(name)) continue;
+        valid = !bound_var_names.count(name) && is_valid(var_node);
+        names.erase(name);
+      }
+      if (!valid || !names.empty()) continue;
+      bound_var_names.insert(var_names.begin(), var_names.end());
+
+      VLOG(4) << "Bind the vars of " << op_type << " in place";
+      op_info->SetAttr<bool>("inplace", true);
+      auto original_selected_kernel = std::move(stmt.kernels().front());
+      auto updated_op_info = *stmt.mutable_op_info();
+      stmt.ResetOp(updated_op_info, graph->valid_places());
+      stmt.kernels().clear();
+      stmt.kernels().emplace_back(std::move(original_selected_kernel));
+      for (auto& kernel : stmt.kernels()) {
+        stmt.op()->AttachKernel(kernel.get());
+      }
+    }
+  }
+};
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_MIR_PASS(concat_split_inplace_pass,
+                  paddle::lite::mir::ConcatSplitInplacePass)
+    .BindTargets({TARGET(kARM), TARGET(kX86)});
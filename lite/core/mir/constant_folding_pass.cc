@@ -0,0 +1,265 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/mir/constant_folding_pass.h"
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+#include "lite/core/context.h"
+#include "lite/core/mir/pass_registry.h"
+#include "lite/core/mir/pattern_matcher.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+const std::set<std::string> ConstantFoldingPass::unfoldable_ops{
+    "feed",
+    "fetch",
+    "while",
+    "conditional_block",
+    "subgraph",
+    "io_copy",
+    "io_copy_once",
+    "calib",
+    "calib_once",
+    "layout",
+    "layout_once",
+    "uniform_random",
+    "gaussian_random",
+    "sampling_id",
+    "increment",
+    "print",
+    "write_to_array",
+    "read_from_array",
+    "lod_array_length",
+    "tensor_array_to_tensor",
+    "beam_search",
+    "beam_search_decode"};
+
+// The folded outputs are saved into the model, e.g. an expand of a scalar
+// is kept unless the outputs are no larger than the inputs or this size.
+static constexpr size_t kMaxFoldedBytes = 1 << 20;
+
+// Whether the real kernels of the target are compiled in. The kernels of the
+// other targets, and all of the kernels of the opt tool, are the fakes made by
+// create_fake_kernel_registry.py, which compute nothing.
+static bool HasRealHostKernels(TargetType target) {
+  switch (target) {
+    case TARGET(kHost):
+      return true;
+#ifdef LITE_WITH_X86
+    case TARGET(kX86):
+      return true;
+#endif
+#ifdef LITE_WITH_ARM
+    case TARGET(kARM):
+      return true;
+#endif
+    default:
+      return false;
+  }
+}
+
+static bool DeclTypeMatches(const Type* type, const Tensor& tensor) {
+  return type->IsTensor() &&
+         (type->precision() == PRECISION(kAny) ||
+          type->precision() == tensor.precision()) &&
+         (type->layout() == DATALAYOUT(kAny) ||
+          type->layout() == DATALAYOUT(kNCHW));
+}
+
+bool ConstantFoldingPass::IsFoldable(Node* node) const {
+  auto& stmt = node->AsStmt();
+  const auto& op_type = stmt.op_type();
+  if (unfoldable_ops.count(op_type) ||
+      op_type.find("quant") != std::string::npos ||
+      stmt.op_info()->HasAttr("sub_block")) {
+    return false;
+  }
+  for (auto* in : node->inlinks) {
+    if (!in->arg()->is_weight) return false;
+  }
+  for (auto* out : node->outlinks) {
+    if (out->arg()->is_weight) return false;
+  }
+  return true;
+}
+
+void ConstantFoldingPass::SetAllGraphs(
+    std::vector<std::unique_ptr<mir::SSAGraph>>* graphs) {
+  CHECK(graphs && !graphs->empty());
+  graphs_ = graphs;
+}
+
+KernelBase* ConstantFoldingPass::PickHostKernel(Node* node) const {
+  auto& stmt = node->AsStmt();
+  auto* op_info = stmt.op_info();
+  auto* scope = stmt.op()->scope();
+  for (auto& kernel : stmt.kernels()) {
+    if (!HasRealHostKernels(kernel->target())) continue;
+    bool matched = true;
+    for (auto* in : node->inlinks) {
+      const auto& name = in->arg()->name;
+      std::string arg_name;
+      auto* var = scope->FindVar(name);
+      if (!var || !var->IsType<Tensor>() ||
+          !op_info->GetInputArgname(name, &arg_name) ||
+          !DeclTypeMatches(kernel->GetInputDeclType(arg_name),
+                           var->Get<Tensor>())) {
+        matched = false;
+        break;
+      }
+    }
+    for (auto* out : node->outlinks) {
+      std::string arg_name;
+      if (!matched || !op_info->GetOutputArgname(out->arg()->name, &arg_name) ||
+          !kernel->GetOutputDeclType(arg_name)->IsTensor()) {
+        matched = false;
+        break;
+      }
+    }
+    if (matched) return kernel.get();
+  }
+  return nullptr;
+}
+
+size_t ConstantFoldingPass::OutputsSize(Node* node,
+                                        const KernelBase& kernel) const {
+  auto& stmt = node->AsStmt();
+  auto* scope = stmt.op()->scope();
+  size_t size = 0;
+  for (auto* out : node->outlinks) {
+    const auto& name = out->arg()->name;
+    std::string arg_name;
+    CHECK(stmt.op_info()->GetOutputArgname(name, &arg_name));
+    // The precision of a kAny output is known after the launch only, so the
+    // widest one is assumed.
+    size_t type_size =
+        PrecisionTypeLength(kernel.GetOutputDeclType(arg_name)->precision());
+    if (type_size == 0) type_size = sizeof(int64_t);
+    auto* var = scope->FindVar(name);
+    CHECK(var);
+    size += var->Get<Tensor>().dims().production() * type_size;
+  }
+  return size;
+}
+
+void ConstantFoldingPass::Apply(const std::unique_ptr<SSAGraph>& graph) {
+#ifdef LITE_ON_MODEL_OPTIMIZE_TOOL
+  VLOG(3) << "Skip constant folding, the kernels of the opt tool are fakes";
+  return;
+#endif
+  // A var which is written more than once, or read before written, e.g. the
+  // loop-carried vars, is not constant.
+  std::map<std::string, int> var_nodes;
+  for (auto& node : graph->mutable_nodes()) {
+    if (node.IsArg()) var_nodes[node.arg()->name]++;
+  }
+  // Neither is a var written by the other blocks, e.g. a loop counter which
+  // is initialized here and increased in the sub-block of a while.
+  std::set<std::string> written_by_other_blocks;
+  if (graphs_) {
+    for (auto& other : *graphs_) {
+      if (other.get() == graph.get()) continue;
+      for (auto& node : other->mutable_nodes()) {
+        if (!node.IsStmt()) continue;
+        for (auto* out : node.outlinks) {
+          written_by_other_blocks.insert(out->arg()->name);
+        }
+      }
+    }
+  }
+  auto is_constant = [&](const Node* var) {
+    return !written_by_other_blocks.count(var->arg()->name);
+  };
+
+  std::set<const Node*> folded_ops;
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    if (!IsFoldable(node)) continue;
+    bool single = std::all_of(
+        node->outlinks.begin(), node->outlinks.end(), [&](const Node* out) {
+          return var_nodes[out->arg()->name] == 1 && is_constant(out);
+        });
+    if (!single ||
+        !std::all_of(node->inlinks.begin(), node->inlinks.end(), is_constant)) {
+      continue;
+    }
+    auto* kernel = PickHostKernel(node);
+    if (!kernel) continue;
+    auto& stmt = node->AsStmt();
+    auto* op = stmt.op().get();
+    if (!op->CheckShape()) continue;
+    op->InferShape();
+
+    // Check the size before the launch, so that the kernel of an op which is
+    // not folded is left as it is.
+    auto* scope = op->scope();
+    size_t inputs_size = 0;
+    for (auto* in : node->inlinks) {
+      inputs_size +=
+          scope->FindVar(in->arg()->name)->Get<Tensor>().memory_size();
+    }
+    size_t outputs_size = OutputsSize(node, *kernel);
+    if (outputs_size > (std::max)(inputs_size, kMaxFoldedBytes)) {
+      VLOG(3) << "Skip folding " << stmt.op_type() << ", the " << outputs_size
+              << " bytes outputs are too large";
+      continue;
+    }
+
+    VLOG(3) << "Fold " << stmt.op_type() << " with " << kernel->summary();
+    kernel->SetContext(
+        ContextScheduler::Global().NewContext(kernel->target()));
+    kernel->Launch();
+    for (auto* out : node->outlinks) {
+      auto* tensor = scope->FindVar(out->arg()->name)->GetMutable<Tensor>();
+      tensor->set_persistable(true);
+      out->arg()->is_weight = true;
+      out->arg()->is_persist = true;
+    }
+    folded_ops.insert(node);
+  }
+  if (folded_ops.empty()) return;
+
+  // Remove the folded ops, the outputs read by the folded ops only, and the
+  // weights which are read by the folded ops only.
+  std::set<const Node*> nodes_to_remove(folded_ops);
+  auto only_read_by_folded_ops = [&](const Node* var) {
+    return std::all_of(
+        var->outlinks.begin(), var->outlinks.end(), [&](const Node* op) {
+          return folded_ops.count(op) > 0;
+        });
+  };
+  for (auto* op : folded_ops) {
+    for (auto* in : op->inlinks) {
+      if (only_read_by_folded_ops(in)) nodes_to_remove.insert(in);
+    }
+    for (auto* out : op->outlinks) {
+      if (only_read_by_folded_ops(out)) nodes_to_remove.insert(out);
+    }
+  }
+  GraphSafeRemoveNodes(graph.get(), nodes_to_remove);
+  VLOG(4) << "Folded " << folded_ops.size() << " constant ops";
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_MIR_PASS(constant_folding_pass,
+                  paddle::lite::mir::ConstantFoldingPass)
+    .BindTargets({TARGET(kAny)});
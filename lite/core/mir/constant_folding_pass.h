@@ -0,0 +1,63 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+#include "lite/core/kernel.h"
+#include "lite/core/mir/pass.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+/*
+ * ConstantFoldingPass pre-computes the ops whose inputs are all weights, e.g.
+ * the shape, fill_constant, cast and transpose chains of the models converted
+ * from TF/ONNX. Such an op is run once with its host kernel, then it is
+ * removed and its outputs become weights, which are saved into the optimized
+ * model. The weights which are only read by the folded ops are removed too.
+ *
+ * With all of the graphs set by SetAllGraphs, the vars written by the other
+ * blocks are not folded.
+ *
+ * Only the kernels of the targets compiled in are run. The opt tool has no
+ * real kernels, so nothing is folded there, and the models are folded when
+ * they are saved by a full build, e.g. CxxConfig and SaveOptimizedModel.
+ */
+class ConstantFoldingPass : public ProgramPass {
+ public:
+  void Apply(const std::unique_ptr<SSAGraph>& graph) override;
+  void SetAllGraphs(std::vector<std::unique_ptr<mir::SSAGraph>>* graphs);
+
+ private:
+  bool IsFoldable(Node* node) const;
+  // The host kernel which can run the op, nullptr if there is none.
+  KernelBase* PickHostKernel(Node* node) const;
+  // The bytes of the outputs whose shapes are inferred, before the launch.
+  size_t OutputsSize(Node* node, const KernelBase& kernel) const;
+
+  // The ops which have side effects, random outputs or sub-blocks, and the
+  // ops which are handled by the quantization passes.
+  static const std::set<std::string> unfoldable_ops;
+
+  std::vector<std::unique_ptr<mir::SSAGraph>>* graphs_{nullptr};
+};
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,294 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "lite/core/mir/constant_folding_pass.h"
+#include <gtest/gtest.h>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/api/cxx_api.h"
+#include "lite/api/light_api.h"
+#include "lite/api/paddle_use_kernels.h"
+#include "lite/api/paddle_use_ops.h"
+#include "lite/api/paddle_use_passes.h"
+#include "lite/model_parser/cpp_desc.h"
+#include "lite/model_parser/model_parser.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+static void AddVarDesc(cpp::BlockDesc* block_desc,
+                       const std::string& name,
+                       VarDataType type,
+                       VarDataType data_type = VarDataType::FP32,
+                       const std::vector<int64_t>& shape = {}) {
+  auto* var_desc = block_desc->AddVar<cpp::VarDesc>();
+  var_desc->SetName(name);
+  var_desc->SetType(type);
+  var_desc->SetPersistable(type == VarDataType::FEED_MINIBATCH ||
+                           type == VarDataType::FETCH_LIST);
+  if (type == VarDataType::LOD_TENSOR) {
+    var_desc->SetDataType(data_type);
+    var_desc->SetShape(shape);
+  }
+}
+
+static cpp::OpDesc* AddOpDesc(
+    cpp::BlockDesc* block_desc,
+    const std::string& type,
+    const std::map<std::string, std::vector<std::string>>& inputs,
+    const std::map<std::string, std::vector<std::string>>& outputs) {
+  auto* op_desc = block_desc->AddOp<cpp::OpDesc>();
+  op_desc->SetType(type);
+  for (auto& input : inputs) {
+    op_desc->SetInput(input.first, input.second);
+  }
+  for (auto& output : outputs) {
+    op_desc->SetOutput(output.first, output.second);
+  }
+  return op_desc;
+}
+
+static void AddFillConstantDesc(cpp::BlockDesc* block_desc,
+                                const std::string& out,
+                                float value,
+                                const std::vector<int64_t>& shape,
+                                const std::string& shape_tensor = "") {
+  std::map<std::string, std::vector<std::string>> inputs;
+  if (!shape_tensor.empty()) inputs["ShapeTensor"] = {shape_tensor};
+  auto* op_desc =
+      AddOpDesc(block_desc, "fill_constant", inputs, {{"Out", {out}}});
+  op_desc->SetAttr<int>("dtype", static_cast<int>(VarDataType::FP32));
+  op_desc->SetAttr<std::vector<int64_t>>("shape", shape);
+  op_desc->SetAttr<float>("value", value);
+  op_desc->SetAttr<bool>("force_cpu", false);
+}
+
+static void AddScaleDesc(cpp::BlockDesc* block_desc,
+                         const std::string& x,
+                         const std::string& out,
+                         float scale = 2.f,
+                         float bias = 0.f) {
+  auto* op_desc =
+      AddOpDesc(block_desc, "scale", {{"X", {x}}}, {{"Out", {out}}});
+  op_desc->SetAttr<float>("scale", scale);
+  op_desc->SetAttr<float>("bias", bias);
+  op_desc->SetAttr<bool>("bias_after_scale", true);
+}
+
+static void AddLessThanDesc(cpp::BlockDesc* block_desc) {
+  auto* op_desc = AddOpDesc(block_desc,
+                            "less_than",
+                            {{"X", {"i"}}, {"Y", {"n"}}},
+                            {{"Out", {"cond"}}});
+  op_desc->SetAttr<int>("axis", -1);
+  op_desc->SetAttr<bool>("force_cpu", false);
+}
+
+static std::shared_ptr<cpp::ProgramDesc> NewProgramDesc(int num_blocks) {
+  auto program_desc = std::make_shared<cpp::ProgramDesc>();
+  for (int i = 0; i < num_blocks; i++) {
+    auto* block = program_desc->AddBlock<cpp::BlockDesc>();
+    block->SetIdx(i);
+    block->SetParentIdx(i - 1);
+  }
+  auto* main_block = program_desc->GetBlock<cpp::BlockDesc>(0);
+  AddVarDesc(main_block, "feed", VarDataType::FEED_MINIBATCH);
+  AddVarDesc(main_block, "fetch", VarDataType::FETCH_LIST);
+  return program_desc;
+}
+
+static void AddFeedFetchDesc(cpp::BlockDesc* block_desc,
+                             const std::string& x,
+                             const std::string& out) {
+  auto* feed = AddOpDesc(block_desc, "feed", {{"X", {"feed"}}}, {{"Out", {x}}});
+  feed->SetAttr<int>("col", 0);
+  auto* fetch =
+      AddOpDesc(block_desc, "fetch", {{"X", {out}}}, {{"Out", {"fetch"}}});
+  fetch->SetAttr<int>("col", 0);
+}
+
+static int CountInstructions(const RuntimeProgram& program,
+                             const std::string& op_type) {
+  int count = 0;
+  for (auto& inst : program.instructions(kRootBlockIdx)) {
+    if (inst.op()->op_info()->Type() == op_type) count++;
+  }
+  return count;
+}
+
+static void RunAndCheck(Predictor* predictor, float factor, float bias) {
+  auto* x = predictor->GetInput(0);
+  x->Resize({2, 3});
+  auto* x_data = x->mutable_data<float>();
+  for (int i = 0; i < 6; i++) {
+    x_data[i] = i;
+  }
+  predictor->Run();
+  auto* out = predictor->GetOutput(0);
+  ASSERT_EQ(out->numel(), 6);
+  for (int i = 0; i < 6; i++) {
+    EXPECT_FLOAT_EQ(out->data<float>()[i], factor * i + bias);
+  }
+}
+
+/*
+ * fill_constant(1) -> f -> shape -> s -> fill_constant(2) -> g
+ * x + g -> out
+ */
+static std::shared_ptr<cpp::ProgramDesc> BuildShapeFillConstantProgram() {
+  auto program_desc = NewProgramDesc(1);
+  auto* main_block = program_desc->GetBlock<cpp::BlockDesc>(0);
+  for (auto& name : {"x", "f", "g", "out"}) {
+    AddVarDesc(
+        main_block, name, VarDataType::LOD_TENSOR, VarDataType::FP32, {2, 3});
+  }
+  AddVarDesc(
+      main_block, "s", VarDataType::LOD_TENSOR, VarDataType::INT32, {2});
+  AddFillConstantDesc(main_block, "f", 1.f, {2, 3});
+  AddOpDesc(main_block, "shape", {{"Input", {"f"}}}, {{"Out", {"s"}}});
+  AddFillConstantDesc(main_block, "g", 2.f, {}, "s");
+  AddOpDesc(main_block,
+            "elementwise_add",
+            {{"X", {"x"}}, {"Y", {"g"}}},
+            {{"Out", {"out"}}})
+      ->SetAttr<int>("axis", -1);
+  AddFeedFetchDesc(main_block, "x", "out");
+  return program_desc;
+}
+
+TEST(constant_folding_pass, shape_fill_constant) {
+  std::vector<Place> valid_places{Place{TARGET(kX86), PRECISION(kFloat)},
+                                  Place{TARGET(kHost), PRECISION(kFloat)}};
+  Predictor predictor;
+  predictor.Build(BuildShapeFillConstantProgram(), valid_places);
+  predictor.GenRuntimeProgram();
+  const auto& program = predictor.runtime_program();
+  EXPECT_EQ(CountInstructions(program, "fill_constant"), 0);
+  EXPECT_EQ(CountInstructions(program, "shape"), 0);
+  EXPECT_EQ(CountInstructions(program, "elementwise_add"), 1);
+
+  // g is a weight now, it is saved into the optimized model.
+  auto* g = predictor.GetTensor("g");
+  ASSERT_TRUE(g);
+  EXPECT_TRUE(g->persistable());
+  ASSERT_EQ(g->dims(), DDim(std::vector<int64_t>({2, 3})));
+  for (int i = 0; i < 6; i++) {
+    EXPECT_FLOAT_EQ(g->data<float>()[i], 2.f);
+  }
+  RunAndCheck(&predictor, 1.f, 2.f);
+}
+
+// The folded model is saved as the naive buffer and run by LightPredictor,
+// which has no folded op to compute g again.
+TEST(constant_folding_pass, save_naive_buffer) {
+  std::vector<Place> valid_places{Place{TARGET(kX86), PRECISION(kFloat)},
+                                  Place{TARGET(kHost), PRECISION(kFloat)}};
+  Predictor predictor;
+  predictor.Build(BuildShapeFillConstantProgram(), valid_places);
+  const std::string model_file = "constant_folding_pass_test_model";
+  predictor.SaveModel(model_file, lite_api::LiteModelType::kNaiveBuffer);
+
+  Scope scope;
+  cpp::ProgramDesc saved_desc;
+  LoadModelNaiveFromFile(model_file + ".nb", &scope, &saved_desc);
+  auto* saved_block = saved_desc.GetBlock<cpp::BlockDesc>(kRootBlockIdx);
+  for (size_t i = 0; i < saved_block->OpsSize(); i++) {
+    const auto& op_type = saved_block->GetOp<cpp::OpDesc>(i)->Type();
+    EXPECT_NE(op_type, "fill_constant");
+    EXPECT_NE(op_type, "shape");
+  }
+  auto* g_var = scope.FindVar("g");
+  ASSERT_TRUE(g_var);
+  const auto& g = g_var->Get<Tensor>();
+  ASSERT_EQ(g.numel(), 6);
+  for (int i = 0; i < 6; i++) {
+    EXPECT_FLOAT_EQ(g.data<float>()[i], 2.f);
+  }
+
+  LightPredictor light_predictor(model_file + ".nb", false);
+  auto* x = light_predictor.GetInput(0);
+  x->Resize({2, 3});
+  auto* x_data = x->mutable_data<float>();
+  for (int i = 0; i < 6; i++) {
+    x_data[i] = i;
+  }
+  light_predictor.Run();
+  auto* out = light_predictor.GetOutput(0);
+  ASSERT_EQ(out->numel(), 6);
+  for (int i = 0; i < 6; i++) {
+    EXPECT_FLOAT_EQ(out->data<float>()[i], i + 2.f);
+  }
+}
+
+/*
+ * The counter i is initialized by a fill_constant in the main block and
+ * increased in the sub-block of the while, which does not list it as an
+ * output, so only the fill_constant of n is folded.
+ *
+ * x -> while(x *= 2 for n - i times) -> out
+ */
+TEST(constant_folding_pass, while_counter) {
+  auto program_desc = NewProgramDesc(2);
+  auto* main_block = program_desc->GetBlock<cpp::BlockDesc>(0);
+  auto* sub_block = program_desc->GetBlock<cpp::BlockDesc>(1);
+  for (auto& name : {"x", "out"}) {
+    AddVarDesc(
+        main_block, name, VarDataType::LOD_TENSOR, VarDataType::FP32, {2, 3});
+  }
+  for (auto& name : {"i", "n"}) {
+    AddVarDesc(
+        main_block, name, VarDataType::LOD_TENSOR, VarDataType::FP32, {1});
+  }
+  AddVarDesc(
+      main_block, "cond", VarDataType::LOD_TENSOR, VarDataType::BOOL, {1});
+  AddVarDesc(main_block, "step_scopes", VarDataType::STEP_SCOPES);
+
+  AddFillConstantDesc(main_block, "i", 0.f, {1});
+  AddFillConstantDesc(main_block, "n", 3.f, {1});
+  AddLessThanDesc(main_block);
+  auto* while_op = AddOpDesc(main_block,
+                             "while",
+                             {{"X", {"x", "i", "n"}}, {"Condition", {"cond"}}},
+                             {{"Out", {"x", "cond"}},
+                              {"StepScopes", {"step_scopes"}}});
+  while_op->SetAttr<int32_t>("sub_block", 1);
+  while_op->SetAttr<bool>("is_test", true);
+  AddScaleDesc(main_block, "x", "out", 1.f);
+  AddFeedFetchDesc(main_block, "x", "out");
+
+  AddScaleDesc(sub_block, "x", "x");
+  AddScaleDesc(sub_block, "i", "i", 1.f, 1.f);
+  AddLessThanDesc(sub_block);
+
+  std::vector<Place> valid_places{Place{TARGET(kX86), PRECISION(kFloat)},
+                                  Place{TARGET(kHost), PRECISION(kFloat)}};
+  Predictor predictor;
+  predictor.Build(program_desc, valid_places);
+  predictor.GenRuntimeProgram();
+  EXPECT_EQ(CountInstructions(predictor.runtime_program(), "fill_constant"),
+            1);
+  auto* n = predictor.GetTensor("n");
+  ASSERT_TRUE(n);
+  EXPECT_TRUE(n->persistable());
+
+  // The counter is reset by every run.
+  RunAndCheck(&predictor, 8.f, 0.f);
+  RunAndCheck(&predictor, 8.f, 0.f);
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,141 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/mir/embedding_quant_pass.h"
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/core/mir/pass_registry.h"
+#include "lite/utils/float16.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+const std::vector<std::string> EmbeddingQuantPass::quant_ops{
+    "lookup_table", "lookup_table_v2"};
+
+// Quantize every row of the table by its abs max, returns the scales.
+static std::vector<float> QuantizeTableInt8(Tensor* table) {
+  const int64_t height = table->dims()[0];
+  const int64_t width = table->numel() / height;
+  const float* data = table->data<float>();
+  Tensor quantized;
+  quantized.Resize(table->dims());
+  int8_t* quantized_data = quantized.mutable_data<int8_t>();
+  std::vector<float> scales(height);
+  for (int64_t i = 0; i < height; i++) {
+    const float* row = data + i * width;
+    int8_t* quantized_row = quantized_data + i * width;
+    float abs_max = 0.f;
+    for (int64_t j = 0; j < width; j++) {
+      abs_max = (std::max)(abs_max, std::fabs(row[j]));
+    }
+    scales[i] = abs_max / 127.f;
+    float inv_scale = abs_max > 0.f ? 127.f / abs_max : 0.f;
+    for (int64_t j = 0; j < width; j++) {
+      float x = std::round(row[j] * inv_scale);
+      x = (std::max)(-127.f, (std::min)(x, 127.f));
+      quantized_row[j] = static_cast<int8_t>(x);
+    }
+  }
+  // The fp32 table is released here, so the peak memory is 1.25x of it.
+  bool persistable = table->persistable();
+  table->ShareDataWith(quantized);
+  table->set_persistable(persistable);
+  return scales;
+}
+
+static void QuantizeTableFP16(Tensor* table) {
+  const float* data = table->data<float>();
+  Tensor quantized;
+  quantized.Resize(table->dims());
+  float16* quantized_data = quantized.mutable_data<float16>();
+  for (int64_t i = 0; i < table->numel(); i++) {
+    quantized_data[i] = float16(data[i]);
+  }
+  quantized.set_precision(PRECISION(kFP16));
+  bool persistable = table->persistable();
+  table->ShareDataWith(quantized);
+  table->set_persistable(persistable);
+}
+
+void EmbeddingQuantPass::Apply(const std::unique_ptr<SSAGraph>& graph) {
+  if (quant_type_ == lite_api::EmbeddingQuantType::NONE) return;
+  auto is_quant_op = [](const Node* node) {
+    return node->IsStmt() &&
+           std::find(quant_ops.begin(),
+                     quant_ops.end(),
+                     node->stmt()->op_type()) != quant_ops.end();
+  };
+
+  // The scales of the quantized tables, a table may be shared by the ops.
+  std::map<std::string, std::vector<float>> quantized_tables;
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    if (!is_quant_op(node)) continue;
+    OpInfo* op_info = node->stmt()->mutable_op_info();
+    std::string table_name = op_info->Input("W").front();
+    if (!quantized_tables.count(table_name)) {
+      Node* table_node = nullptr;
+      for (auto* in_node : node->inlinks) {
+        if (in_node->arg()->name == table_name) table_node = in_node;
+      }
+      CHECK(table_node);
+      // The table must be read by the lookup ops only, e.g. the tables tied
+      // to the output projection are kept.
+      bool only_lookup = std::all_of(
+          table_node->outlinks.begin(),
+          table_node->outlinks.end(),
+          [&](const Node* op_node) {
+            return is_quant_op(op_node) &&
+                   op_node->stmt()->op_info()->Input("W").front() ==
+                       table_name;
+          });
+      auto* scope = node->stmt()->op()->scope();
+      auto* table = scope->FindVar(table_name)->GetMutable<Tensor>();
+      if (!table_node->arg()->is_weight || !only_lookup ||
+          table->precision() != PRECISION(kFloat) || table->numel() == 0) {
+        VLOG(3) << "Skip quantizing the embedding table " << table_name;
+        continue;
+      }
+      std::vector<float> scales;
+      if (quant_type_ == lite_api::EmbeddingQuantType::QUANT_INT8) {
+        scales = QuantizeTableInt8(table);
+      } else if (quant_type_ == lite_api::EmbeddingQuantType::QUANT_FP16) {
+        QuantizeTableFP16(table);
+      } else {
+        LOG(FATAL) << "Not support embedding quant type:"
+                   << static_cast<int>(quant_type_);
+      }
+      quantized_tables[table_name] = scales;
+    }
+    auto& scales = quantized_tables.at(table_name);
+    if (!scales.empty()) {
+      op_info->SetAttr(table_name + "_quant_scale", scales);
+    }
+    // Recreate the kernels with the scales.
+    node->stmt()->ResetOp(*op_info, graph->valid_places());
+  }
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+// Only the lookup kernels of x86 read the compressed tables.
+REGISTER_MIR_PASS(embedding_quant_pass, paddle::lite::mir::EmbeddingQuantPass)
+    .BindTargets({TARGET(kX86)});
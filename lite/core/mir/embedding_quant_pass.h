@@ -0,0 +1,51 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/api/paddle_place.h"
+#include "lite/core/mir/pass.h"
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+/*
+ * Compress the embedding tables of lookup_table(_v2) in the optimization
+ * stage, which are the largest weights of the recommendation models.
+ * QUANT_INT8 quantizes every row by its own abs max, and the scales are saved
+ * in the attribute `<W>_quant_scale` of the op. QUANT_FP16 stores the table
+ * as fp16. Unlike post_quant_dynamic_pass, the tables are not dequantized
+ * when the model is loaded, the lookup kernels dequantize the rows they read,
+ * so the tables stay compressed in the memory.
+ */
+class EmbeddingQuantPass : public ProgramPass {
+ public:
+  void Apply(const std::unique_ptr<SSAGraph>& graph) override;
+
+  void SetQuantType(lite_api::EmbeddingQuantType quant_type) {
+    quant_type_ = quant_type;
+  }
+
+ private:
+  lite_api::EmbeddingQuantType quant_type_{
+      lite_api::EmbeddingQuantType::QUANT_INT8};
+  static const std::vector<std::string> quant_ops;
+};
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
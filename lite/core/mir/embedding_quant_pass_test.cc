@@ -0,0 +1,234 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/mir/embedding_quant_pass.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/api/cxx_api.h"
+#include "lite/api/light_api.h"
+#include "lite/api/paddle_use_kernels.h"
+#include "lite/api/paddle_use_ops.h"
+#include "lite/api/paddle_use_passes.h"
+#include "lite/core/mir/pass_manager.h"
+#include "lite/model_parser/cpp_desc.h"
+#include "lite/model_parser/model_parser.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+static const int64_t kTableHeight = 10;
+static const int64_t kTableWidth = 8;
+static const std::vector<int64_t> kIds{3, 0, 9, 3, 5};
+
+static void AddVarDesc(cpp::BlockDesc* block_desc,
+                       const std::string& name,
+                       VarDataType type,
+                       VarDataType data_type = VarDataType::FP32,
+                       const std::vector<int64_t>& shape = {},
+                       bool persistable = false) {
+  auto* var_desc = block_desc->AddVar<cpp::VarDesc>();
+  var_desc->SetName(name);
+  var_desc->SetType(type);
+  var_desc->SetPersistable(persistable || type == VarDataType::FEED_MINIBATCH ||
+                           type == VarDataType::FETCH_LIST);
+  if (type == VarDataType::LOD_TENSOR) {
+    var_desc->SetDataType(data_type);
+    var_desc->SetShape(shape);
+  }
+}
+
+static cpp::OpDesc* AddOpDesc(
+    cpp::BlockDesc* block_desc,
+    const std::string& type,
+    const std::map<std::string, std::vector<std::string>>& inputs,
+    const std::map<std::string, std::vector<std::string>>& outputs) {
+  auto* op_desc = block_desc->AddOp<cpp::OpDesc>();
+  op_desc->SetType(type);
+  for (auto& input : inputs) {
+    op_desc->SetInput(input.first, input.second);
+  }
+  for (auto& output : outputs) {
+    op_desc->SetOutput(output.first, output.second);
+  }
+  return op_desc;
+}
+
+/*
+ * feed(ids) -> lookup_table_v2(emb) -> fetch(out)
+ */
+static std::shared_ptr<cpp::ProgramDesc> BuildLookupProgram() {
+  auto program_desc = std::make_shared<cpp::ProgramDesc>();
+  auto* block = program_desc->AddBlock<cpp::BlockDesc>();
+  block->SetIdx(0);
+  block->SetParentIdx(-1);
+  AddVarDesc(block, "feed", VarDataType::FEED_MINIBATCH);
+  AddVarDesc(block, "fetch", VarDataType::FETCH_LIST);
+  const int64_t num_ids = kIds.size();
+  AddVarDesc(
+      block, "ids", VarDataType::LOD_TENSOR, VarDataType::INT64, {num_ids});
+  AddVarDesc(block,
+             "emb",
+             VarDataType::LOD_TENSOR,
+             VarDataType::FP32,
+             {kTableHeight, kTableWidth},
+             true);
+  AddVarDesc(block,
+             "out",
+             VarDataType::LOD_TENSOR,
+             VarDataType::FP32,
+             {num_ids, kTableWidth});
+
+  auto* feed = AddOpDesc(block, "feed", {{"X", {"feed"}}}, {{"Out", {"ids"}}});
+  feed->SetAttr<int>("col", 0);
+  auto* lookup = AddOpDesc(block,
+                           "lookup_table_v2",
+                           {{"W", {"emb"}}, {"Ids", {"ids"}}},
+                           {{"Out", {"out"}}});
+  lookup->SetAttr<int64_t>("padding_idx", -1);
+  auto* fetch =
+      AddOpDesc(block, "fetch", {{"X", {"out"}}}, {{"Out", {"fetch"}}});
+  fetch->SetAttr<int>("col", 0);
+  return program_desc;
+}
+
+// The rows of the table have different abs max, so that a shared scale would
+// fail the int8 check.
+static float TableValue(int64_t row, int64_t col) {
+  return (col - 3.5f) * (row + 1) * 0.37f;
+}
+
+static std::shared_ptr<Scope> NewTableScope() {
+  auto scope = std::make_shared<Scope>();
+  auto* emb = scope->Var("emb")->GetMutable<Tensor>();
+  emb->Resize({kTableHeight, kTableWidth});
+  auto* emb_data = emb->mutable_data<float>();
+  for (int64_t i = 0; i < kTableHeight; i++) {
+    for (int64_t j = 0; j < kTableWidth; j++) {
+      emb_data[i * kTableWidth + j] = TableValue(i, j);
+    }
+  }
+  emb->set_persistable(true);
+  return scope;
+}
+
+// The int8 rows are off by half of the scale of the row at most, and the fp16
+// rows by the relative error of fp16.
+template <typename PredictorT>
+static void RunAndCheck(PredictorT* predictor,
+                        lite_api::EmbeddingQuantType quant_type) {
+  auto* ids = predictor->GetInput(0);
+  ids->Resize({static_cast<int64_t>(kIds.size())});
+  auto* ids_data = ids->template mutable_data<int64_t>();
+  for (size_t i = 0; i < kIds.size(); i++) {
+    ids_data[i] = kIds[i];
+  }
+  predictor->Run();
+
+  auto* out = predictor->GetOutput(0);
+  ASSERT_EQ(out->numel(), static_cast<int64_t>(kIds.size()) * kTableWidth);
+  const float* out_data = out->template data<float>();
+  for (size_t i = 0; i < kIds.size(); i++) {
+    const int64_t row = kIds[i];
+    const float abs_max = 3.5f * (row + 1) * 0.37f;
+    for (int64_t j = 0; j < kTableWidth; j++) {
+      const float expected = TableValue(row, j);
+      const float tolerance =
+          quant_type == lite_api::EmbeddingQuantType::QUANT_INT8
+              ? abs_max / 127.f / 2.f + 1e-6f
+              : std::fabs(expected) * 1e-3f + 1e-6f;
+      EXPECT_NEAR(out_data[i * kTableWidth + j], expected, tolerance)
+          << "row " << row << ", col " << j;
+    }
+  }
+}
+
+static void TestEmbeddingQuant(lite_api::EmbeddingQuantType quant_type,
+                               PrecisionType table_precision,
+                               const std::string& model_file) {
+  auto* pass = PassManager::Global().LookUp<EmbeddingQuantPass>(
+      "embedding_quant_pass");
+  ASSERT_TRUE(pass);
+  pass->SetQuantType(quant_type);
+  std::vector<Place> valid_places{Place{TARGET(kX86), PRECISION(kFloat)},
+                                  Place{TARGET(kHost), PRECISION(kFloat)}};
+  Predictor predictor(NewTableScope());
+  predictor.Build(
+      BuildLookupProgram(), valid_places, {"embedding_quant_pass"});
+  pass->SetQuantType(lite_api::EmbeddingQuantType::NONE);
+
+  // The table stays compressed in the memory.
+  auto* emb = predictor.GetTensor("emb");
+  ASSERT_TRUE(emb);
+  EXPECT_EQ(emb->precision(), table_precision);
+  EXPECT_TRUE(emb->persistable());
+  RunAndCheck(&predictor, quant_type);
+
+  predictor.SaveModel(model_file, lite_api::LiteModelType::kNaiveBuffer);
+  Scope scope;
+  cpp::ProgramDesc saved_desc;
+  LoadModelNaiveFromFile(model_file + ".nb", &scope, &saved_desc);
+  auto* saved_emb = scope.FindVar("emb");
+  ASSERT_TRUE(saved_emb);
+  EXPECT_EQ(saved_emb->Get<Tensor>().precision(), table_precision);
+  EXPECT_EQ(saved_emb->Get<Tensor>().numel(), kTableHeight * kTableWidth);
+  auto* saved_block = saved_desc.GetBlock<cpp::BlockDesc>(kRootBlockIdx);
+  const cpp::OpDesc* saved_lookup = nullptr;
+  for (size_t i = 0; i < saved_block->OpsSize(); i++) {
+    auto* op_desc = saved_block->GetOp<cpp::OpDesc>(i);
+    if (op_desc->Type() == "lookup_table_v2") saved_lookup = op_desc;
+  }
+  ASSERT_TRUE(saved_lookup);
+  if (quant_type == lite_api::EmbeddingQuantType::QUANT_INT8) {
+    ASSERT_TRUE(saved_lookup->HasAttr("emb_quant_scale"));
+    auto scales =
+        saved_lookup->GetAttr<std::vector<float>>("emb_quant_scale");
+    ASSERT_EQ(scales.size(), static_cast<size_t>(kTableHeight));
+    for (int64_t i = 0; i < kTableHeight; i++) {
+      EXPECT_FLOAT_EQ(scales[i], 3.5f * (i + 1) * 0.37f / 127.f);
+    }
+  } else {
+    EXPECT_FALSE(saved_lookup->HasAttr("emb_quant_scale"));
+  }
+
+  // The lookup kernels read the compressed tables of the loaded model, and
+  // the mapped ones.
+  for (bool use_mmap : {false, true}) {
+    LightPredictor light_predictor(model_file + ".nb", false, use_mmap);
+    auto* loaded_emb = light_predictor.GetTensor("emb");
+    ASSERT_TRUE(loaded_emb);
+    EXPECT_EQ(loaded_emb->precision(), table_precision);
+    RunAndCheck(&light_predictor, quant_type);
+  }
+}
+
+TEST(embedding_quant_pass, int8) {
+  TestEmbeddingQuant(lite_api::EmbeddingQuantType::QUANT_INT8,
+                     PRECISION(kInt8),
+                     "embedding_quant_pass_test_int8");
+}
+
+TEST(embedding_quant_pass, fp16) {
+  TestEmbeddingQuant(lite_api::EmbeddingQuantType::QUANT_FP16,
+                     PRECISION(kFP16),
+                     "embedding_quant_pass_test_fp16");
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
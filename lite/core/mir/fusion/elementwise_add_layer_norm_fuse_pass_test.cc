@@ -0,0 +1,222 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/mir/fusion/elementwise_add_layer_norm_fuse_pass.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/api/cxx_api.h"
+#include "lite/api/paddle_use_kernels.h"
+#include "lite/api/paddle_use_ops.h"
+#include "lite/api/paddle_use_passes.h"
+#include "lite/model_parser/cpp_desc.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+namespace fusion {
+
+static const int64_t kBatch = 2;
+static const int64_t kSeqLen = 3;
+static const int64_t kHidden = 4;
+
+static void AddVarDesc(cpp::BlockDesc* block_desc,
+                       const std::string& name,
+                       VarDataType type,
+                       const std::vector<int64_t>& shape = {},
+                       bool persistable = false) {
+  auto* var_desc = block_desc->AddVar<cpp::VarDesc>();
+  var_desc->SetName(name);
+  var_desc->SetType(type);
+  var_desc->SetPersistable(persistable || type == VarDataType::FEED_MINIBATCH ||
+                           type == VarDataType::FETCH_LIST);
+  if (type == VarDataType::LOD_TENSOR) {
+    var_desc->SetDataType(VarDataType::FP32);
+    var_desc->SetShape(shape);
+  }
+}
+
+static cpp::OpDesc* AddOpDesc(
+    cpp::BlockDesc* block_desc,
+    const std::string& type,
+    const std::map<std::string, std::vector<std::string>>& inputs,
+    const std::map<std::string, std::vector<std::string>>& outputs) {
+  auto* op_desc = block_desc->AddOp<cpp::OpDesc>();
+  op_desc->SetType(type);
+  for (auto& input : inputs) {
+    op_desc->SetInput(input.first, input.second);
+  }
+  for (auto& output : outputs) {
+    op_desc->SetOutput(output.first, output.second);
+  }
+  return op_desc;
+}
+
+/*
+ * feed(x), feed(y) -> x + y -> layer_norm(scale, bias) -> fetch(out)
+ */
+static std::shared_ptr<cpp::ProgramDesc> BuildAddLayerNormProgram(
+    const std::vector<int64_t>& y_shape) {
+  auto program_desc = std::make_shared<cpp::ProgramDesc>();
+  auto* block = program_desc->AddBlock<cpp::BlockDesc>();
+  block->SetIdx(0);
+  block->SetParentIdx(-1);
+  AddVarDesc(block, "feed", VarDataType::FEED_MINIBATCH);
+  AddVarDesc(block, "fetch", VarDataType::FETCH_LIST);
+  const std::vector<int64_t> x_shape{kBatch, kSeqLen, kHidden};
+  for (auto& name : {"x", "add_out", "out"}) {
+    AddVarDesc(block, name, VarDataType::LOD_TENSOR, x_shape);
+  }
+  AddVarDesc(block, "y", VarDataType::LOD_TENSOR, y_shape);
+  for (auto& name : {"mean", "variance"}) {
+    AddVarDesc(block, name, VarDataType::LOD_TENSOR, {kBatch * kSeqLen});
+  }
+  for (auto& name : {"scale", "bias"}) {
+    AddVarDesc(block, name, VarDataType::LOD_TENSOR, {kHidden}, true);
+  }
+
+  int col = 0;
+  for (auto& name : {"x", "y"}) {
+    auto* feed = AddOpDesc(block, "feed", {{"X", {"feed"}}}, {{"Out", {name}}});
+    feed->SetAttr<int>("col", col++);
+  }
+  AddOpDesc(block,
+            "elementwise_add",
+            {{"X", {"x"}}, {"Y", {"y"}}},
+            {{"Out", {"add_out"}}})
+      ->SetAttr<int>("axis", -1);
+  auto* layer_norm = AddOpDesc(
+      block,
+      "layer_norm",
+      {{"X", {"add_out"}}, {"Scale", {"scale"}}, {"Bias", {"bias"}}},
+      {{"Y", {"out"}}, {"Mean", {"mean"}}, {"Variance", {"variance"}}});
+  layer_norm->SetAttr<int>("begin_norm_axis", 2);
+  layer_norm->SetAttr<float>("epsilon", 1e-5f);
+  auto* fetch =
+      AddOpDesc(block, "fetch", {{"X", {"out"}}}, {{"Out", {"fetch"}}});
+  fetch->SetAttr<int>("col", 0);
+  return program_desc;
+}
+
+static std::shared_ptr<Scope> NewWeightScope() {
+  auto scope = std::make_shared<Scope>();
+  auto* scale = scope->Var("scale")->GetMutable<Tensor>();
+  auto* bias = scope->Var("bias")->GetMutable<Tensor>();
+  scale->Resize({kHidden});
+  bias->Resize({kHidden});
+  auto* scale_data = scale->mutable_data<float>();
+  auto* bias_data = bias->mutable_data<float>();
+  for (int64_t i = 0; i < kHidden; i++) {
+    scale_data[i] = 1.f + 0.1f * i;
+    bias_data[i] = 0.1f * i;
+  }
+  return scope;
+}
+
+static int CountInstructions(const RuntimeProgram& program,
+                             const std::string& op_type) {
+  int count = 0;
+  for (auto& inst : program.instructions(kRootBlockIdx)) {
+    if (inst.op()->op_info()->Type() == op_type) count++;
+  }
+  return count;
+}
+
+// Run the predictor and check the output against layer_norm(x + y), y is
+// broadcasted from the trailing dims.
+static void RunAndCheck(Predictor* predictor,
+                        const std::vector<int64_t>& y_shape) {
+  std::vector<int64_t> y_dims(3 - y_shape.size(), 1);
+  y_dims.insert(y_dims.end(), y_shape.begin(), y_shape.end());
+  auto* x = predictor->GetInput(0);
+  x->Resize({kBatch, kSeqLen, kHidden});
+  auto* x_data = x->mutable_data<float>();
+  for (int64_t i = 0; i < x->numel(); i++) {
+    x_data[i] = 0.1f * i;
+  }
+  auto* y = predictor->GetInput(1);
+  y->Resize(y_shape);
+  auto* y_data = y->mutable_data<float>();
+  for (int64_t i = 0; i < y->numel(); i++) {
+    y_data[i] = 0.5f * ((i * 7) % 5);
+  }
+  predictor->Run();
+
+  auto* out = predictor->GetOutput(0);
+  ASSERT_EQ(out->numel(), kBatch * kSeqLen * kHidden);
+  const float* out_data = out->data<float>();
+  std::vector<float> row(kHidden);
+  for (int64_t b = 0; b < kBatch; b++) {
+    for (int64_t s = 0; s < kSeqLen; s++) {
+      float mean = 0.f;
+      for (int64_t h = 0; h < kHidden; h++) {
+        int64_t y_index = ((y_dims[0] == 1 ? 0 : b) * y_dims[1] +
+                           (y_dims[1] == 1 ? 0 : s)) *
+                              y_dims[2] +
+                          h;
+        row[h] = x_data[(b * kSeqLen + s) * kHidden + h] + y_data[y_index];
+        mean += row[h];
+      }
+      mean /= kHidden;
+      float variance = 0.f;
+      for (int64_t h = 0; h < kHidden; h++) {
+        variance += (row[h] - mean) * (row[h] - mean);
+      }
+      variance /= kHidden;
+      for (int64_t h = 0; h < kHidden; h++) {
+        float expected = (row[h] - mean) / std::sqrt(variance + 1e-5f) *
+                             (1.f + 0.1f * h) +
+                         0.1f * h;
+        EXPECT_NEAR(
+            out_data[(b * kSeqLen + s) * kHidden + h], expected, 1e-4f);
+      }
+    }
+  }
+}
+
+TEST(elementwise_add_layer_norm_fuse_pass, leading_broadcast) {
+  const std::vector<int64_t> y_shape{kSeqLen, kHidden};
+  std::vector<Place> valid_places{Place{TARGET(kX86), PRECISION(kFloat)},
+                                  Place{TARGET(kHost), PRECISION(kFloat)}};
+  Predictor predictor(NewWeightScope());
+  predictor.Build(BuildAddLayerNormProgram(y_shape), valid_places);
+  predictor.GenRuntimeProgram();
+  const auto& program = predictor.runtime_program();
+  EXPECT_EQ(CountInstructions(program, "fused_elementwise_add_layer_norm"), 1);
+  EXPECT_EQ(CountInstructions(program, "layer_norm"), 0);
+  RunAndCheck(&predictor, y_shape);
+}
+
+// The fused kernel does not broadcast y along the middle dims, so the ops are
+// left unfused.
+TEST(elementwise_add_layer_norm_fuse_pass, middle_broadcast) {
+  const std::vector<int64_t> y_shape{kBatch, 1, kHidden};
+  std::vector<Place> valid_places{Place{TARGET(kX86), PRECISION(kFloat)},
+                                  Place{TARGET(kHost), PRECISION(kFloat)}};
+  Predictor predictor(NewWeightScope());
+  predictor.Build(BuildAddLayerNormProgram(y_shape), valid_places);
+  predictor.GenRuntimeProgram();
+  const auto& program = predictor.runtime_program();
+  EXPECT_EQ(CountInstructions(program, "fused_elementwise_add_layer_norm"), 0);
+  EXPECT_EQ(CountInstructions(program, "layer_norm"), 1);
+  RunAndCheck(&predictor, y_shape);
+}
+
+}  // namespace fusion
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,154 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/mir/fusion/elementwise_add_layer_norm_fuser.h"
+#include <memory>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+namespace mir {
+namespace fusion {
+
+// Whether Y of the elementwise_add before the layer_norm is broadcasted along
+// the leading dims of X only, as the fused kernel requires. The other
+// broadcasts, e.g. Y of [B, 1, H] for X of [B, S, H], are left unfused. The
+// dims are from the var descs, the unknown dims of X and Y, e.g. the batch
+// size of -1, are taken as equal.
+static bool IsLeadingBroadcast(const Node* layer_norm) {
+  auto* op_info = layer_norm->stmt()->op_info();
+  const Node* add = nullptr;
+  for (auto* in : layer_norm->inlinks) {
+    if (in->arg()->name == op_info->Input("X").front() &&
+        in->inlinks.size() == 1) {
+      add = in->inlinks.front();
+    }
+  }
+  if (!add || !add->IsStmt()) return false;
+  auto* add_info = add->stmt()->op_info();
+  auto* scope = layer_norm->stmt()->op()->scope();
+  auto* x = scope->FindVar(add_info->Input("X").front());
+  auto* y = scope->FindVar(add_info->Input("Y").front());
+  if (!x || !y || !x->IsType<Tensor>() || !y->IsType<Tensor>()) return false;
+  const auto& x_dims = x->Get<Tensor>().dims();
+  const auto& y_dims = y->Get<Tensor>().dims();
+  int begin_norm_axis = op_info->GetAttr<int>("begin_norm_axis");
+  if (x_dims.empty() || begin_norm_axis < 0 ||
+      begin_norm_axis >= static_cast<int>(x_dims.size())) {
+    return false;
+  }
+  // Every normalized row of X has a whole row of Y.
+  if (y_dims.size() > x_dims.size() ||
+      y_dims.size() < x_dims.size() - begin_norm_axis) {
+    return false;
+  }
+  for (size_t i = 1; i <= y_dims.size(); i++) {
+    if (y_dims[y_dims.size() - i] != x_dims[x_dims.size() - i]) return false;
+  }
+  return true;
+}
+
+void ElementwiseAddLayerNormFuser::BuildPattern() {
+  // create input nodes.
+  // Only the residual add is fused, the bias add of fc or mul is excluded by
+  // its persistable Y.
+  auto is_activation = [](const Node* node) {
+    return node && node->IsArg() && !node->arg()->is_weight &&
+           !node->arg()->is_persist;
+  };
+  auto* x = VarNode("x")
+                ->assert_is_op_input("elementwise_add", "X")
+                ->assert_node_satisfied(is_activation)
+                ->AsInput();
+  auto* y = VarNode("y")
+                ->assert_is_op_input("elementwise_add", "Y")
+                ->assert_node_satisfied(is_activation)
+                ->AsInput();
+  auto* scale =
+      VarNode("scale")->assert_is_op_input("layer_norm", "Scale")->AsInput();
+  auto* bias =
+      VarNode("bias")->assert_is_op_input("layer_norm", "Bias")->AsInput();
+
+  // create op nodes
+  auto* add = OpNode("add", "elementwise_add")
+                  ->assert_op_attr<int>("axis", -1)
+                  ->AsIntermediate();
+  auto* layer_norm = OpNode("layer_norm", "layer_norm")
+                         ->assert_node_satisfied(IsLeadingBroadcast)
+                         ->AsIntermediate();
+
+  // create intermediate nodes
+  auto* add_out = VarNode("add_out")
+                      ->assert_is_op_output("elementwise_add", "Out")
+                      ->assert_is_op_input("layer_norm", "X")
+                      ->AsIntermediate();
+  auto* mean = VarNode("mean")
+                   ->assert_is_op_output("layer_norm", "Mean")
+                   ->AsIntermediate();
+  auto* variance = VarNode("variance")
+                       ->assert_is_op_output("layer_norm", "Variance")
+                       ->AsIntermediate();
+
+  // create output node
+  auto* out =
+      VarNode("out")->assert_is_op_output("layer_norm", "Y")->AsOutput();
+
+  // create topology.
+  std::vector<PMNode*> add_inputs{x, y};
+  std::vector<PMNode*> layer_norm_inputs{add_out, scale, bias};
+  add_inputs >> *add >> *add_out;
+  layer_norm_inputs >> *layer_norm >> *out;
+  *layer_norm >> *mean;
+  *layer_norm >> *variance;
+}
+
+void ElementwiseAddLayerNormFuser::InsertNewNode(SSAGraph* graph,
+                                                 const key2nodes_t& matched) {
+  auto op_desc = GenOpDesc(matched);
+  auto fuse_op =
+      LiteOpRegistry::Global().Create("fused_elementwise_add_layer_norm");
+  auto layer_norm = matched.at("layer_norm")->stmt()->op();
+  auto* scope = layer_norm->scope();
+  auto& valid_places = layer_norm->valid_places();
+  fuse_op->Attach(op_desc, scope);
+
+  auto* new_op_node = graph->GraphCreateInstructNode(fuse_op, valid_places);
+
+  IR_NODE_LINK_TO(matched.at("x"), new_op_node);
+  IR_NODE_LINK_TO(matched.at("y"), new_op_node);
+  IR_NODE_LINK_TO(matched.at("scale"), new_op_node);
+  IR_NODE_LINK_TO(matched.at("bias"), new_op_node);
+  IR_NODE_LINK_TO(new_op_node, matched.at("out"));
+}
+
+cpp::OpDesc ElementwiseAddLayerNormFuser::GenOpDesc(
+    const key2nodes_t& matched) {
+  auto* layer_norm_info = matched.at("layer_norm")->stmt()->op_info();
+  cpp::OpDesc op_desc;
+  op_desc.SetType("fused_elementwise_add_layer_norm");
+  op_desc.SetInput("X", {matched.at("x")->arg()->name});
+  op_desc.SetInput("Y", {matched.at("y")->arg()->name});
+  op_desc.SetInput("Scale", {matched.at("scale")->arg()->name});
+  op_desc.SetInput("Bias", {matched.at("bias")->arg()->name});
+  op_desc.SetOutput("Out", {matched.at("out")->arg()->name});
+  op_desc.SetAttr<int>("begin_norm_axis",
+                       layer_norm_info->GetAttr<int>("begin_norm_axis"));
+  op_desc.SetAttr<float>("epsilon", layer_norm_info->GetAttr<float>("epsilon"));
+  return op_desc;
+}
+
+}  // namespace fusion
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
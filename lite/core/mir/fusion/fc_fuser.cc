@@ -41,14 +41,14 @@ void FcFuser::BuildPattern() {
   mul->AsIntermediate();
   add->AsIntermediate();
 
-  if (with_relu_) {
+  if (with_act_) {
     auto* add_out = VarNode("add_out");
-    auto* relu = OpNode("relu", "relu");
-    std::vector<PMNode*> relu_inputs{add_out};
+    auto* act = OpNode("act", act_type_);
+    std::vector<PMNode*> act_inputs{add_out};
     add_inputs >> *add >> *add_out;
-    relu_inputs >> *relu >> *Out;
+    act_inputs >> *act >> *Out;
     add_out->AsIntermediate();
-    relu->AsIntermediate();
+    act->AsIntermediate();
   } else {
     add_inputs >> *add >> *Out;
   }
@@ -95,8 +95,8 @@ cpp::OpDesc FcFuser::GenOpDesc(const key2nodes_t& matched) {
   op_desc.SetAttr(
       "in_num_col_dims",
       matched.at("mul")->stmt()->op_info()->GetAttr<int>("x_num_col_dims"));
-  if (with_relu_) {
-    op_desc.SetAttr("activation_type", std::string{"relu"});
+  if (with_act_) {
+    op_desc.SetAttr("activation_type", act_type_);
   }
 
   // Set the input scale into fc
@@ -25,13 +25,17 @@ namespace fusion {
 
 class FcFuser : public FuseBase {
  public:
-  explicit FcFuser(bool with_relu) : with_relu_(with_relu) {}
+  // Fuse the activation of `act_type` after the elementwise_add if `with_act`,
+  // relu or gelu.
+  explicit FcFuser(bool with_act, const std::string& act_type = "relu")
+      : with_act_(with_act), act_type_(act_type) {}
   void BuildPattern() override;
   void InsertNewNode(SSAGraph* graph, const key2nodes_t& matched) override;
 
  private:
   cpp::OpDesc GenOpDesc(const key2nodes_t& matched) override;
-  bool with_relu_;
+  bool with_act_;
+  std::string act_type_;
 };
 
 }  // namespace fusion
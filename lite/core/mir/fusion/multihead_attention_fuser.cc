@@ -0,0 +1,315 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/mir/fusion/multihead_attention_fuser.h"
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+namespace mir {
+namespace fusion {
+
+static bool IsHeadTranspose(const std::vector<int>& axis) {
+  return axis == std::vector<int>({0, 2, 1, 3});
+}
+
+// Whether the mask can be broadcasted to the scores by the fused kernel, i.e.
+// every dim of the mask is 1 or the dim of the scores, except the keys which
+// are not broadcasted. The dims are from the var descs, the unknown dims of
+// the mask and the scores, e.g. the sequence length of -1, are taken as
+// equal.
+static bool IsSupportedMask(const Node* qk_add) {
+  auto* op_info = qk_add->stmt()->op_info();
+  auto* scope = qk_add->stmt()->op()->scope();
+  auto* scores = scope->FindVar(op_info->Input("X").front());
+  auto* mask = scope->FindVar(op_info->Input("Y").front());
+  if (!scores || !mask || !scores->IsType<Tensor>() ||
+      !mask->IsType<Tensor>()) {
+    return false;
+  }
+  const auto& scores_dims = scores->Get<Tensor>().dims();
+  const auto& mask_dims = mask->Get<Tensor>().dims();
+  if (scores_dims.size() != 4 || mask_dims.empty() || mask_dims.size() > 4 ||
+      mask_dims[mask_dims.size() - 1] != scores_dims[3]) {
+    return false;
+  }
+  for (size_t i = 2; i <= mask_dims.size(); i++) {
+    auto dim = mask_dims[mask_dims.size() - i];
+    if (dim != 1 && dim != scores_dims[4 - i]) return false;
+  }
+  return true;
+}
+
+PMNode* MultiheadAttentionFuser::BuildProjection(const std::string& prefix,
+                                                 PMNode* input) {
+  auto* mul_y = VarNode(prefix + "_mul_y")
+                    ->assert_is_op_input("mul", "Y")
+                    ->assert_is_persistable_var()
+                    ->AsInput();
+  auto* mul = OpNode(prefix + "_mul", "mul")
+                  ->assert_op_attr<int>("x_num_col_dims", 2)
+                  ->AsIntermediate();
+  auto* mul_out = VarNode(prefix + "_mul_out")
+                      ->assert_is_op_output("mul", "Out")
+                      ->assert_is_op_input("elementwise_add", "X")
+                      ->AsIntermediate();
+  auto* add_y = VarNode(prefix + "_add_y")
+                    ->assert_is_op_input("elementwise_add", "Y")
+                    ->assert_is_persistable_var()
+                    ->AsInput();
+  auto* add = OpNode(prefix + "_add", "elementwise_add")->AsIntermediate();
+  auto* add_out = VarNode(prefix + "_add_out")
+                      ->assert_is_op_output("elementwise_add", "Out")
+                      ->assert_is_op_input("reshape2", "X")
+                      ->AsIntermediate();
+  auto* reshape2 =
+      OpNode(prefix + "_reshape2", "reshape2")
+          ->assert_op_attr_satisfied<std::vector<int>>(
+              "shape",
+              [](const std::vector<int>& shape) {
+                return shape.size() == 4 && shape[2] > 0 && shape[3] > 0;
+              })
+          ->AsIntermediate();
+  auto* reshape2_out = VarNode(prefix + "_reshape2_out")
+                           ->assert_is_op_output("reshape2", "Out")
+                           ->assert_is_op_input("transpose2", "X")
+                           ->AsIntermediate();
+  auto* reshape2_xshape = VarNode(prefix + "_reshape2_xshape")
+                              ->assert_is_op_output("reshape2", "XShape")
+                              ->AsIntermediate();
+  auto* transpose2 = OpNode(prefix + "_transpose2", "transpose2")
+                         ->assert_op_attr_satisfied<std::vector<int>>(
+                             "axis", IsHeadTranspose)
+                         ->AsIntermediate();
+  auto* transpose2_out = VarNode(prefix + "_transpose2_out")
+                             ->assert_is_op_output("transpose2", "Out")
+                             ->AsIntermediate();
+  auto* transpose2_xshape = VarNode(prefix + "_transpose2_xshape")
+                                ->assert_is_op_output("transpose2", "XShape")
+                                ->AsIntermediate();
+
+  *input >> *mul >> *mul_out >> *add >> *add_out >> *reshape2 >>
+      *reshape2_out >> *transpose2 >> *transpose2_out;
+  *mul_y >> *mul;
+  *add_y >> *add;
+  *reshape2 >> *reshape2_xshape;
+  *transpose2 >> *transpose2_xshape;
+  return transpose2_out;
+}
+
+void MultiheadAttentionFuser::BuildPattern() {
+  auto* input = VarNode("input")->assert_is_op_input("mul", "X")->AsInput();
+
+  auto* q = BuildProjection("q", input);
+  auto* k = BuildProjection("k", input);
+  auto* v = BuildProjection("v", input);
+  if (with_scale_) {
+    auto* q_scale = OpNode("q_scale", "scale")
+                        ->assert_op_attr<float>("bias", 0.f)
+                        ->AsIntermediate();
+    auto* q_scale_out = VarNode("q_scale_out")
+                            ->assert_is_op_output("scale", "Out")
+                            ->AsIntermediate();
+    *q >> *q_scale >> *q_scale_out;
+    q = q_scale_out;
+  }
+  q->assert_is_op_input("matmul", "X");
+  k->assert_is_op_input("matmul", "Y");
+  v->assert_is_op_input("matmul", "Y");
+
+  // scores = softmax(alpha * q * k^T + mask)
+  auto* qk_matmul = OpNode("qk_matmul", "matmul")
+                        ->assert_op_attr<bool>("transpose_X", false)
+                        ->assert_op_attr<bool>("transpose_Y", true)
+                        ->AsIntermediate();
+  auto* qk_matmul_out = VarNode("qk_matmul_out")
+                            ->assert_is_op_output("matmul", "Out")
+                            ->AsIntermediate();
+  auto* qk_softmax = OpNode("qk_softmax", "softmax")
+                         ->assert_op_attr_satisfied<int>(
+                             "axis",
+                             [](const int& axis) {
+                               return axis == -1 || axis == 3;
+                             })
+                         ->AsIntermediate();
+  auto* qk_softmax_out = VarNode("qk_softmax_out")
+                             ->assert_is_op_output("softmax", "Out")
+                             ->assert_is_op_input("matmul", "X")
+                             ->AsIntermediate();
+  *q >> *qk_matmul;
+  *k >> *qk_matmul >> *qk_matmul_out;
+  if (with_mask_) {
+    qk_matmul_out->assert_is_op_input("elementwise_add", "X");
+    auto* qk_mask = VarNode("qk_mask")
+                        ->assert_is_op_input("elementwise_add", "Y")
+                        ->AsInput();
+    auto* qk_add = OpNode("qk_add", "elementwise_add")
+                       ->assert_op_attr<int>("axis", -1)
+                       ->assert_node_satisfied(IsSupportedMask)
+                       ->AsIntermediate();
+    auto* qk_add_out = VarNode("qk_add_out")
+                           ->assert_is_op_output("elementwise_add", "Out")
+                           ->assert_is_op_input("softmax", "X")
+                           ->AsIntermediate();
+    *qk_matmul_out >> *qk_add >> *qk_add_out >> *qk_softmax;
+    *qk_mask >> *qk_add;
+  } else {
+    qk_matmul_out->assert_is_op_input("softmax", "X");
+    *qk_matmul_out >> *qk_softmax;
+  }
+  *qk_softmax >> *qk_softmax_out;
+
+  // out = reshape(transpose(scores * v))
+  auto* qkv_matmul = OpNode("qkv_matmul", "matmul")
+                         ->assert_op_attr<bool>("transpose_X", false)
+                         ->assert_op_attr<bool>("transpose_Y", false)
+                         ->assert_op_attr<float>("alpha", 1.f)
+                         ->AsIntermediate();
+  auto* qkv_matmul_out = VarNode("qkv_matmul_out")
+                             ->assert_is_op_output("matmul", "Out")
+                             ->assert_is_op_input("transpose2", "X")
+                             ->AsIntermediate();
+  auto* qkv_transpose2 = OpNode("qkv_transpose2", "transpose2")
+                             ->assert_op_attr_satisfied<std::vector<int>>(
+                                 "axis", IsHeadTranspose)
+                             ->AsIntermediate();
+  auto* qkv_transpose2_out = VarNode("qkv_transpose2_out")
+                                 ->assert_is_op_output("transpose2", "Out")
+                                 ->assert_is_op_input("reshape2", "X")
+                                 ->AsIntermediate();
+  auto* qkv_transpose2_xshape =
+      VarNode("qkv_transpose2_xshape")
+          ->assert_is_op_output("transpose2", "XShape")
+          ->AsIntermediate();
+  auto* qkv_reshape2 =
+      OpNode("qkv_reshape2", "reshape2")
+          ->assert_op_attr_satisfied<std::vector<int>>(
+              "shape",
+              [](const std::vector<int>& shape) { return shape.size() == 3; })
+          ->AsIntermediate();
+  auto* qkv_reshape2_out = VarNode("qkv_reshape2_out")
+                               ->assert_is_op_output("reshape2", "Out")
+                               ->AsOutput();
+  auto* qkv_reshape2_xshape = VarNode("qkv_reshape2_xshape")
+                                  ->assert_is_op_output("reshape2", "XShape")
+                                  ->AsIntermediate();
+  *qk_softmax_out >> *qkv_matmul;
+  *v >> *qkv_matmul >> *qkv_matmul_out >> *qkv_transpose2 >>
+      *qkv_transpose2_out >> *qkv_reshape2 >> *qkv_reshape2_out;
+  *qkv_transpose2 >> *qkv_transpose2_xshape;
+  *qkv_reshape2 >> *qkv_reshape2_xshape;
+}
+
+void MultiheadAttentionFuser::InsertNewNode(SSAGraph* graph,
+                                            const key2nodes_t& matched) {
+  auto q_mul = matched.at("q_mul")->stmt()->op();
+  auto* scope = q_mul->scope();
+  auto& valid_places = q_mul->valid_places();
+
+  // Concatenate the weights of q, k and v along the columns, and the biases.
+  auto op_desc = GenOpDesc(matched);
+  const std::string qkv_w_name = op_desc.Input("QKVW").front();
+  const std::string qkv_bias_name = op_desc.Input("QKVBias").front();
+  std::vector<const Tensor*> ws;
+  std::vector<const Tensor*> biases;
+  for (auto prefix : {"q", "k", "v"}) {
+    auto w_name = matched.at(std::string(prefix) + "_mul_y")->arg()->name;
+    auto bias_name = matched.at(std::string(prefix) + "_add_y")->arg()->name;
+    ws.push_back(scope->FindVar(w_name)->GetMutable<lite::Tensor>());
+    biases.push_back(scope->FindVar(bias_name)->GetMutable<lite::Tensor>());
+  }
+  const auto& w_dims = ws[0]->dims();
+  CHECK_EQ(w_dims.size(), 2UL);
+  const int64_t hidden = w_dims[0];
+  for (int i = 0; i < 3; i++) {
+    CHECK(ws[i]->dims() == DDim({hidden, hidden}))
+        << "The weight of q, k or v should be square, but got "
+        << ws[i]->dims();
+    CHECK_EQ(biases[i]->numel(), hidden);
+  }
+
+  auto* qkv_w = scope->NewTensor(qkv_w_name);
+  qkv_w->Resize({hidden, 3 * hidden});
+  qkv_w->set_persistable(true);
+  float* qkv_w_data = qkv_w->mutable_data<float>();
+  auto* qkv_bias = scope->NewTensor(qkv_bias_name);
+  qkv_bias->Resize({3 * hidden});
+  qkv_bias->set_persistable(true);
+  float* qkv_bias_data = qkv_bias->mutable_data<float>();
+  for (int i = 0; i < 3; i++) {
+    const float* w = ws[i]->data<float>();
+    for (int64_t row = 0; row < hidden; row++) {
+      std::memcpy(qkv_w_data + row * 3 * hidden + i * hidden,
+                  w + row * hidden,
+                  hidden * sizeof(float));
+    }
+    std::memcpy(qkv_bias_data + i * hidden,
+                biases[i]->data<float>(),
+                hidden * sizeof(float));
+  }
+
+  auto* qkv_w_node = graph->NewArgumentNode(qkv_w_name);
+  qkv_w_node->arg()->is_weight = true;
+  qkv_w_node->arg()->is_persist = true;
+  qkv_w_node->arg()->type = LiteType::GetTensorTy(
+      TARGET(kHost), PRECISION(kFloat), DATALAYOUT(kNCHW));
+  auto* qkv_bias_node = graph->NewArgumentNode(qkv_bias_name);
+  qkv_bias_node->arg()->is_weight = true;
+  qkv_bias_node->arg()->is_persist = true;
+  qkv_bias_node->arg()->type = LiteType::GetTensorTy(
+      TARGET(kHost), PRECISION(kFloat), DATALAYOUT(kNCHW));
+
+  auto fuse_op = LiteOpRegistry::Global().Create("fused_multihead_attention");
+  fuse_op->Attach(op_desc, scope);
+  auto* new_op_node = graph->GraphCreateInstructNode(fuse_op, valid_places);
+
+  IR_NODE_LINK_TO(matched.at("input"), new_op_node);
+  IR_NODE_LINK_TO(qkv_w_node, new_op_node);
+  IR_NODE_LINK_TO(qkv_bias_node, new_op_node);
+  if (with_mask_) {
+    IR_NODE_LINK_TO(matched.at("qk_mask"), new_op_node);
+  }
+  IR_NODE_LINK_TO(new_op_node, matched.at("qkv_reshape2_out"));
+}
+
+cpp::OpDesc MultiheadAttentionFuser::GenOpDesc(const key2nodes_t& matched) {
+  cpp::OpDesc op_desc;
+  op_desc.SetType("fused_multihead_attention");
+  op_desc.SetInput("Input", {matched.at("input")->arg()->name});
+  op_desc.SetInput("QKVW", {matched.at("q_mul_y")->arg()->name + "_qkv"});
+  op_desc.SetInput("QKVBias", {matched.at("q_add_y")->arg()->name + "_qkv"});
+  if (with_mask_) {
+    op_desc.SetInput("Mask", {matched.at("qk_mask")->arg()->name});
+  }
+  op_desc.SetOutput("Out", {matched.at("qkv_reshape2_out")->arg()->name});
+
+  auto* reshape_op_info = matched.at("q_reshape2")->stmt()->op_info();
+  auto reshape_dims = reshape_op_info->GetAttr<std::vector<int>>("shape");
+  op_desc.SetAttr<int>("head_number", reshape_dims[2]);
+  // The scale of q is folded into the alpha of q * k^T.
+  float alpha =
+      matched.at("qk_matmul")->stmt()->op_info()->GetAttr<float>("alpha");
+  if (with_scale_) {
+    alpha *= matched.at("q_scale")->stmt()->op_info()->GetAttr<float>("scale");
+  }
+  op_desc.SetAttr<float>("alpha", alpha);
+  return op_desc;
+}
+
+}  // namespace fusion
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
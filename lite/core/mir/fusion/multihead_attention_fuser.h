@@ -0,0 +1,54 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include "lite/core/mir/pattern_matcher_high_api.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+namespace fusion {
+
+// Fuse the multi-head attention of the transformer encoder
+//   q/k/v: mul -> elementwise_add -> reshape2 -> transpose2, q -> [scale]
+//   matmul(q, k^T) -> [elementwise_add(mask)] -> softmax -> matmul(v)
+//   -> transpose2 -> reshape2
+// into fused_multihead_attention. The weights and the biases of q, k and v
+// are concatenated into one weight of [hidden, 3 * hidden] and one bias of
+// [3 * hidden], so they are computed by one GEMM.
+class MultiheadAttentionFuser : public FuseBase {
+ public:
+  MultiheadAttentionFuser(bool with_scale, bool with_mask)
+      : with_scale_(with_scale), with_mask_(with_mask) {}
+
+  void BuildPattern() override;
+  void InsertNewNode(SSAGraph* graph, const key2nodes_t& matched) override;
+
+ private:
+  // Build mul -> elementwise_add -> reshape2 -> transpose2 of q, k or v, and
+  // returns the output of transpose2.
+  PMNode* BuildProjection(const std::string& prefix, PMNode* input);
+  cpp::OpDesc GenOpDesc(const key2nodes_t& matched) override;
+
+  bool with_scale_;
+  bool with_mask_;
+};
+
+}  // namespace fusion
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
@@ -24,11 +24,25 @@ namespace mir {
 
 void ReshapeFusePass::Apply(const std::unique_ptr<SSAGraph>& graph) {
   std::vector<std::string> reshape_type_cases{"reshape", "reshape2"};
+  // Only the host kernels of the other ops keep their outputs as the views.
+  std::vector<std::string> view_type_cases{"flatten",
+                                           "flatten2",
+                                           "flatten_contiguous_range",
+                                           "squeeze",
+                                           "squeeze2",
+                                           "unsqueeze",
+                                           "unsqueeze2"};
   for (auto type_ : reshape_type_cases) {
     fusion::ReshapeFuser reshape_fuser(type_);
     reshape_fuser(graph.get());
   }
+  for (auto type_ : view_type_cases) {
+    fusion::ReshapeFuser reshape_fuser(type_, true);
+    reshape_fuser(graph.get());
+  }
 
+  reshape_type_cases.insert(
+      reshape_type_cases.end(), view_type_cases.begin(), view_type_cases.end());
   for (auto type_ : reshape_type_cases) {
     fusion::Reshape2OutFuser reshape2Out_fuser(type_);
     reshape2Out_fuser(graph.get());
@@ -31,6 +31,11 @@ void ReshapeFuser::BuildPattern() {
 }
 
 void ReshapeFuser::InsertNewNode(SSAGraph* graph, const key2nodes_t& matched) {
+  auto target = matched.at("reshape")->stmt()->place().target;
+  if (host_only_ && target != TARGET(kHost) && target != TARGET(kX86) &&
+      target != TARGET(kARM)) {
+    return;
+  }
   auto op_desc = const_cast<OpInfo*>(matched.at("reshape")->stmt()->op_info());
   op_desc->SetAttr<bool>("inplace", true);
 }
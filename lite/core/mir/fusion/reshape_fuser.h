@@ -25,13 +25,16 @@ namespace fusion {
 
 class ReshapeFuser : public FuseBase {
  public:
-  explicit ReshapeFuser(const std::string& type) : type_(type) {}
+  explicit ReshapeFuser(const std::string& type, bool host_only = false)
+      : type_(type), host_only_(host_only) {}
 
   void BuildPattern() override;
   void InsertNewNode(SSAGraph* graph, const key2nodes_t& matched) override;
 
  private:
   std::string type_;
+  // Skip the ops whose kernels are not on the host.
+  bool host_only_{false};
 };
 
 class Reshape2OutFuser : public FuseBase {
@@ -28,12 +28,79 @@ typedef struct {
   std::string name;
   int cluster;
   std::pair<int, int> lifetime;
+  size_t size;
   std::set<std::string> adj;
 } MemNode;
 
+// The ops which run the sub-block of the attr "sub_block".
+static const std::set<std::string> kControlFlowOpTypes = {
+    "while", "conditional_block", "conditional_block_infer"};
+
+static int SubBlockIndex(const OpInfo* op_info) {
+  if (!kControlFlowOpTypes.count(op_info->Type()) ||
+      !op_info->HasAttr("sub_block")) {
+    return -1;
+  }
+  return op_info->GetAttr<int32_t>("sub_block");
+}
+
+void MemoryOptimizePass::SetAllGraphs(
+    std::vector<std::unique_ptr<mir::SSAGraph>>* graphs) {
+  CHECK(graphs && !graphs->empty());
+  graphs_ = graphs;
+}
+
+int MemoryOptimizePass::BlockIndex(const SSAGraph* graph) const {
+  if (!graphs_) return kRootBlockIdx;
+  for (size_t i = 0; i < graphs_->size(); i++) {
+    if ((*graphs_)[i].get() == graph) return static_cast<int>(i);
+  }
+  return kRootBlockIdx;
+}
+
+void MemoryOptimizePass::CollectBlockVarNames(
+    int block_idx, std::set<std::string>* names) const {
+  if (!graphs_ || block_idx < 0 ||
+      block_idx >= static_cast<int>(graphs_->size())) {
+    return;
+  }
+  for (auto& node : (*graphs_)[block_idx]->nodes()) {
+    if (node.IsArg()) {
+      names->insert(node.arg()->name);
+    } else if (node.IsStmt()) {
+      int sub_block_idx = SubBlockIndex(node.stmt()->op_info());
+      if (sub_block_idx > block_idx) {
+        CollectBlockVarNames(sub_block_idx, names);
+      }
+    }
+  }
+}
+
+size_t MemoryOptimizePass::EstimateVarSize(Scope* scope,
+                                           const std::string& var_name,
+                                           const Type* type) {
+  if (!scope) return 0;
+  auto* var = scope->FindVar(var_name);
+  if (!var || !var->IsType<Tensor>()) return 0;
+  // The shape comes from the var desc, the unknown dims such as the batch size
+  // are -1, take them as 1 since only the relative sizes matter.
+  const auto& dims = var->Get<Tensor>().dims();
+  if (dims.empty()) return 0;
+  size_t numel = 1;
+  for (size_t i = 0; i < dims.size(); i++) {
+    numel *= dims[i] > 0 ? static_cast<size_t>(dims[i]) : 1;
+  }
+  size_t type_size = PrecisionTypeLength(type->precision());
+  return numel * (type_size > 0 ? type_size : sizeof(float));
+}
+
 void MemoryOptimizePass::CollectLifeCycleByDevice(
-    std::map<std::string, lifecycle_map_t>* lifecycles, SSAGraph* graph) {
+    std::map<std::string, lifecycle_map_t>* lifecycles,
+    SSAGraph* graph,
+    int block_idx) {
   max_lifecycle_ = 0;
+  var_sizes_.clear();
+  pinned_var_names_.clear();
 
   auto is_host = [](TargetType x) -> bool {
     return x == TARGET(kHost) || x == TARGET(kX86) || x == TARGET(kARM);
@@ -58,11 +125,10 @@ void MemoryOptimizePass::CollectLifeCycleByDevice(
     return has_x86 && has_opencl;
   };
 
-  // The all of input and output variables of the Ops will not be reused.
-  std::set<std::string> invalid_op_nodes = {"while",
-                                            "conditional_block",
-                                            "conditional_block_infer",
-                                            "merge_lod_tensor_infer",
+  // The all of input and output variables of the Ops will not be reused. The
+  // control flow ops are handled with their sub-blocks if all of the graphs
+  // are set.
+  std::set<std::string> invalid_op_nodes = {"merge_lod_tensor_infer",
                                             "merge_lod_tensor",
                                             "equal",
                                             "lod_reset",
@@ -70,6 +136,10 @@ void MemoryOptimizePass::CollectLifeCycleByDevice(
                                             "subgraph",
                                             "feed",
                                             "fetch"};
+  if (!graphs_) {
+    invalid_op_nodes.insert(kControlFlowOpTypes.begin(),
+                            kControlFlowOpTypes.end());
+  }
 
   auto insert_invalid_op_nodes_for_specific_target = [&](
       std::set<std::string> op_node_set, TargetType specific_target) {
@@ -118,11 +188,20 @@ void MemoryOptimizePass::CollectLifeCycleByDevice(
     }
     // The specified input and output variables of the Ops whose 'inplace' attr
     // is true will not be reused, such as reshape/reshape2's X and Out
-    // variables
+    // variables, and the slices of concat/split.
     std::map<std::string,
              std::pair<std::set<std::string>, std::set<std::string>>>
         inplace_op_nodes = {{"reshape", {{"X"}, {"Out"}}},
-                            {"reshape2", {{"X"}, {"Out"}}}};
+                            {"reshape2", {{"X"}, {"Out"}}},
+                            {"flatten", {{"X"}, {"Out"}}},
+                            {"flatten2", {{"X"}, {"Out"}}},
+                            {"flatten_contiguous_range", {{"X"}, {"Out"}}},
+                            {"squeeze", {{"X"}, {"Out"}}},
+                            {"squeeze2", {{"X"}, {"Out"}}},
+                            {"unsqueeze", {{"X"}, {"Out"}}},
+                            {"unsqueeze2", {{"X"}, {"Out"}}},
+                            {"concat", {{"X"}, {"Out"}}},
+                            {"split", {{"X"}, {"Out"}}}};
     auto inplace_op_node = inplace_op_nodes.find(op_type);
     if (inplace_op_node != inplace_op_nodes.end()) {
       bool inplace = false;
@@ -140,6 +219,14 @@ void MemoryOptimizePass::CollectLifeCycleByDevice(
         }
       }
     }
+    // The concat of a single input shares the data with it on x86.
+    if (op_type == "concat" && op_info->Input("X").size() == 1 &&
+        op_node->AsStmt().place().target == TARGET(kX86)) {
+      const auto& in_arg_names = op_info->Input("X");
+      const auto& out_arg_names = op_info->Output("Out");
+      invalid_var_names.insert(in_arg_names.begin(), in_arg_names.end());
+      invalid_var_names.insert(out_arg_names.begin(), out_arg_names.end());
+    }
   }
 
   // non-tensor(like tensor_array) variables will not be reused
@@ -150,6 +237,59 @@ void MemoryOptimizePass::CollectLifeCycleByDevice(
     }
   }
 
+  // The vars of the other blocks.
+  std::set<std::string> other_block_var_names;
+  if (graphs_) {
+    for (size_t i = 0; i < graphs_->size(); i++) {
+      if (static_cast<int>(i) == block_idx) continue;
+      for (auto& node : (*graphs_)[i]->nodes()) {
+        if (node.IsArg()) other_block_var_names.insert(node.arg()->name);
+      }
+    }
+  }
+  // The vars referred by the sub-block of every control flow op.
+  std::map<Node*, std::set<std::string>> sub_block_var_names;
+  std::set<std::string> written_var_names;
+  for (auto& op_node : graph->StmtTopologicalOrder()) {
+    if (!op_node->IsStmt()) continue;
+    auto* op_info = op_node->AsStmt().op_info();
+    // The vars read before written are set by the other blocks or carried
+    // from the previous iteration of a loop.
+    for (auto* in_var_node : op_node->inlinks) {
+      if (!written_var_names.count(in_var_node->AsArg().name)) {
+        invalid_var_names.insert(in_var_node->AsArg().name);
+      }
+    }
+    for (auto* out_var_node : op_node->outlinks) {
+      written_var_names.insert(out_var_node->AsArg().name);
+    }
+    int sub_block_idx = SubBlockIndex(op_info);
+    if (!graphs_ || sub_block_idx < 0) continue;
+    auto& names = sub_block_var_names[op_node];
+    CollectBlockVarNames(sub_block_idx, &names);
+    // Such as the step scopes of while, which are not tensors.
+    for (auto* var_node : op_node->inlinks) {
+      if (!names.count(var_node->AsArg().name)) {
+        invalid_var_names.insert(var_node->AsArg().name);
+      }
+    }
+    for (auto* var_node : op_node->outlinks) {
+      if (!names.count(var_node->AsArg().name)) {
+        invalid_var_names.insert(var_node->AsArg().name);
+      }
+    }
+  }
+  if (block_idx == kRootBlockIdx) {
+    pinned_var_names_ = other_block_var_names;
+  } else {
+    // The lifetimes of the vars shared with the other blocks are unknown in
+    // this block.
+    invalid_var_names.insert(other_block_var_names.begin(),
+                             other_block_var_names.end());
+  }
+
+  // The lifecycle of every control flow op and the vars of its sub-block.
+  std::vector<std::pair<int, const std::set<std::string>*>> control_flow_ops;
   for (auto& op_node : graph->StmtTopologicalOrder()) {
     if (op_node->IsStmt()) {
       std::vector<Node*> var_nodes(op_node->inlinks.begin(),
@@ -164,6 +304,10 @@ void MemoryOptimizePass::CollectLifeCycleByDevice(
         if (invalid_var_names.count(var_name)) continue;
         TargetType target_type = arg.type->target();
         if (is_host(target_type)) target_type = TARGET(kHost);
+        if (!var_sizes_.count(var_name)) {
+          var_sizes_[var_name] = EstimateVarSize(
+              op_node->AsStmt().op()->scope(), var_name, arg.type);
+        }
 
         if (!(*lifecycles)[TargetToStr(target_type)].count(var_name)) {
           (*lifecycles)[TargetToStr(target_type)].emplace(
@@ -175,9 +319,24 @@ void MemoryOptimizePass::CollectLifeCycleByDevice(
               (std::max)(max_lifecycle_, cur_life);
         }
       }
+      if (sub_block_var_names.count(op_node)) {
+        control_flow_ops.emplace_back(max_lifecycle_,
+                                      &sub_block_var_names[op_node]);
+      }
       ++max_lifecycle_;
     }
   }
+  // The vars referred by a sub-block are alive while the control flow op
+  // runs, even if they are not its inputs or outputs.
+  for (auto& op : control_flow_ops) {
+    for (auto& device_lifecycles : *lifecycles) {
+      for (auto& lifecycle : device_lifecycles.second) {
+        if (!op.second->count(lifecycle.first)) continue;
+        lifecycle.second.first = (std::min)(lifecycle.second.first, op.first);
+        lifecycle.second.second = (std::max)(lifecycle.second.second, op.first);
+      }
+    }
+  }
   LOG(INFO) << "There are " << (*lifecycles).size() << " types device var.";
 }
 
@@ -191,8 +350,18 @@ void MemoryOptimizePass::MakeReusePlan(
     temp_node.name = data.first;
     temp_node.cluster = -1;
     temp_node.lifetime = data.second;
+    temp_node.size =
+        var_sizes_.count(data.first) ? var_sizes_.at(data.first) : 0;
     mem_nodes.push_back(temp_node);
   }
+  // Visit the vars from the largest to the smallest, so that each cluster is
+  // led by its largest var and the small vars are clustered together instead
+  // of occupying the clusters of the large ones.
+  std::stable_sort(mem_nodes.begin(),
+                   mem_nodes.end(),
+                   [](const MemNode& a, const MemNode& b) {
+                     return a.size > b.size;
+                   });
   auto overlap = [](std::pair<int, int> a, std::pair<int, int> b) -> bool {
     return b.second >= a.first && a.second >= b.first;
   };
@@ -216,8 +385,10 @@ void MemoryOptimizePass::MakeReusePlan(
     cluster.push_back(mem_nodes[i].name);
     std::set<std::string> cluster_adj = mem_nodes[i].adj;
     for (size_t j = i + 1; j < mem_nodes.size(); j++) {
+      // The pinned vars only lead their own clusters as they are not renamed.
       if (mem_nodes[j].cluster < 0 &&
-          (cluster_adj.find(mem_nodes[j].name) == cluster_adj.end())) {
+          (cluster_adj.find(mem_nodes[j].name) == cluster_adj.end()) &&
+          !pinned_var_names_.count(mem_nodes[j].name)) {
         (*node2cluster)[mem_nodes[j].name] = mem_nodes[i].name;
         mem_nodes[j].cluster = cluster_index;
         for (auto& n : mem_nodes[j].adj) {
@@ -319,7 +490,7 @@ void MemoryOptimizePass::Apply(const std::unique_ptr<SSAGraph>& graph) {
   // 3. Perform reuse plan: Replace all var's name in the model according to the
   // mapping table.
   std::map<std::string, lifecycle_map_t> lifecycles;
-  CollectLifeCycleByDevice(&lifecycles, graph.get());
+  CollectLifeCycleByDevice(&lifecycles, graph.get(), BlockIndex(graph.get()));
   for (auto& ele : lifecycles) {
     std::map<std::string, std::string> node2cluster;
     MakeReusePlan(ele.second, &node2cluster);
@@ -332,8 +503,9 @@ void MemoryOptimizePass::Apply(const std::unique_ptr<SSAGraph>& graph) {
 }  // namespace paddle
 
 REGISTER_MIR_PASS(memory_optimize_pass, paddle::lite::mir::MemoryOptimizePass)
-    .BindTargets({TARGET(kARM), TARGET(kOpenCL)})
-    .ExcludeTargets({TARGET(kNPU),
+    .BindTargets({TARGET(kARM), TARGET(kOpenCL), TARGET(kX86)})
+    .ExcludeTargets({TARGET(kCUDA),
+                     TARGET(kNPU),
                      TARGET(kXPU),
                      TARGET(kBM),
                      TARGET(kRKNPU),
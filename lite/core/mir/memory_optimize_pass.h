@@ -32,24 +32,50 @@ namespace lite {
 namespace mir {
 
 /*
- * MemoryOptimizePass will
+ * MemoryOptimizePass will reuse the memory of the activations whose lifetimes
+ * do not overlap by renaming them to the same var.
+ *
+ * With all of the graphs set by SetAllGraphs, the sub-blocks of the control
+ * flow ops are planned too:
+ * - The vars of a sub-block which are referred by the other blocks, or are
+ *   read before written in the block, such as the ones carried to the next
+ *   iteration of a while, are not reused. The others live only within an
+ *   iteration, so their lifetimes are the same as in the main block.
+ * - The vars of the main block which are referred by the sub-blocks are never
+ *   renamed, and live until the control flow ops of the sub-blocks, but the
+ *   other vars may reuse their memory.
  */
 class MemoryOptimizePass : public ProgramPass {
  public:
   using lifecycle_t = std::pair<int, int>;
   using lifecycle_map_t = std::map<std::string, lifecycle_t>;
   void Apply(const std::unique_ptr<SSAGraph>& graph) override;
+  void SetAllGraphs(std::vector<std::unique_ptr<mir::SSAGraph>>* graphs);
 
  private:
+  // The index of the block of the graph, 0 if the graphs are not set.
+  int BlockIndex(const SSAGraph* graph) const;
+  // Collect the names of the vars of the block and its sub-blocks.
+  void CollectBlockVarNames(int block_idx, std::set<std::string>* names) const;
   void CollectLifeCycleByDevice(
-      std::map<std::string, lifecycle_map_t>* lifecycles, SSAGraph*);
+      std::map<std::string, lifecycle_map_t>* lifecycles,
+      SSAGraph*,
+      int block_idx);
   void MakeReusePlan(const lifecycle_map_t& lifecycles,
                      std::map<std::string, std::string>* node2cluster);
   void PerformReusePlan(SSAGraph* graph,
                         const std::map<std::string, std::string>& reuse_table);
+  // Estimate the memory size of a var from the shape in its var desc.
+  size_t EstimateVarSize(Scope* scope,
+                         const std::string& var_name,
+                         const Type* type);
 
  private:
   int max_lifecycle_{-1};
+  std::map<std::string, size_t> var_sizes_;
+  // The vars which are referred by the sub-blocks, they are not renamed.
+  std::set<std::string> pinned_var_names_;
+  std::vector<std::unique_ptr<mir::SSAGraph>>* graphs_{nullptr};
 };
 
 }  // namespace mir
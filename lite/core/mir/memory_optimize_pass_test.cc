@@ -0,0 +1,218 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/mir/memory_optimize_pass.h"
+#include <gtest/gtest.h>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/api/cxx_api.h"
+#include "lite/api/paddle_use_kernels.h"
+#include "lite/api/paddle_use_ops.h"
+#include "lite/api/paddle_use_passes.h"
+#include "lite/model_parser/cpp_desc.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+static void AddVarDesc(cpp::BlockDesc* block_desc,
+                       const std::string& name,
+                       VarDataType type,
+                       VarDataType data_type = VarDataType::FP32,
+                       const std::vector<int64_t>& shape = {}) {
+  auto* var_desc = block_desc->AddVar<cpp::VarDesc>();
+  var_desc->SetName(name);
+  var_desc->SetType(type);
+  var_desc->SetPersistable(type == VarDataType::FEED_MINIBATCH ||
+                           type == VarDataType::FETCH_LIST);
+  if (type == VarDataType::LOD_TENSOR) {
+    var_desc->SetDataType(data_type);
+    var_desc->SetShape(shape);
+  }
+}
+
+static cpp::OpDesc* AddOpDesc(
+    cpp::BlockDesc* block_desc,
+    const std::string& type,
+    const std::map<std::string, std::vector<std::string>>& inputs,
+    const std::map<std::string, std::vector<std::string>>& outputs) {
+  auto* op_desc = block_desc->AddOp<cpp::OpDesc>();
+  op_desc->SetType(type);
+  for (auto& input : inputs) {
+    op_desc->SetInput(input.first, input.second);
+  }
+  for (auto& output : outputs) {
+    op_desc->SetOutput(output.first, output.second);
+  }
+  return op_desc;
+}
+
+static void AddScaleDesc(cpp::BlockDesc* block_desc,
+                         const std::string& x,
+                         const std::string& out,
+                         float scale = 2.f,
+                         float bias = 0.f) {
+  auto* op_desc =
+      AddOpDesc(block_desc, "scale", {{"X", {x}}}, {{"Out", {out}}});
+  op_desc->SetAttr<float>("scale", scale);
+  op_desc->SetAttr<float>("bias", bias);
+  op_desc->SetAttr<bool>("bias_after_scale", true);
+}
+
+static void AddLessThanDesc(cpp::BlockDesc* block_desc) {
+  auto* op_desc = AddOpDesc(block_desc,
+                            "less_than",
+                            {{"X", {"i"}}, {"Y", {"n"}}},
+                            {{"Out", {"cond"}}});
+  op_desc->SetAttr<int>("axis", -1);
+  op_desc->SetAttr<bool>("force_cpu", false);
+}
+
+/*
+ * x -> a -> b -> c -> while(c *= 16 for n - i times) -> d -> e
+ *
+ * The loop body is c -> t1 -> t2 -> t3 -> c, and i is increased by 1.
+ */
+static std::shared_ptr<cpp::ProgramDesc> BuildWhileProgram() {
+  auto program_desc = std::make_shared<cpp::ProgramDesc>();
+  auto* main_block = program_desc->AddBlock<cpp::BlockDesc>();
+  main_block->SetIdx(0);
+  main_block->SetParentIdx(-1);
+  auto* sub_block = program_desc->AddBlock<cpp::BlockDesc>();
+  sub_block->SetIdx(1);
+  sub_block->SetParentIdx(0);
+
+  AddVarDesc(main_block, "feed", VarDataType::FEED_MINIBATCH);
+  AddVarDesc(main_block, "fetch", VarDataType::FETCH_LIST);
+  for (auto& name : {"x", "a", "b", "c", "d", "e"}) {
+    AddVarDesc(
+        main_block, name, VarDataType::LOD_TENSOR, VarDataType::FP32, {4});
+  }
+  for (auto& name : {"i", "n"}) {
+    AddVarDesc(
+        main_block, name, VarDataType::LOD_TENSOR, VarDataType::FP32, {1});
+  }
+  AddVarDesc(
+      main_block, "cond", VarDataType::LOD_TENSOR, VarDataType::BOOL, {1});
+  AddVarDesc(main_block, "step_scopes", VarDataType::STEP_SCOPES);
+  for (auto& name : {"t1", "t2", "t3"}) {
+    AddVarDesc(
+        sub_block, name, VarDataType::LOD_TENSOR, VarDataType::FP32, {4});
+  }
+
+  int col = 0;
+  for (auto& name : {"x", "i", "n"}) {
+    auto* feed =
+        AddOpDesc(main_block, "feed", {{"X", {"feed"}}}, {{"Out", {name}}});
+    feed->SetAttr<int>("col", col++);
+  }
+  AddScaleDesc(main_block, "x", "a");
+  AddScaleDesc(main_block, "a", "b");
+  AddScaleDesc(main_block, "b", "c");
+  AddLessThanDesc(main_block);
+  auto* while_op = AddOpDesc(main_block,
+                             "while",
+                             {{"X", {"c", "i", "n"}}, {"Condition", {"cond"}}},
+                             {{"Out", {"c", "i", "cond"}},
+                              {"StepScopes", {"step_scopes"}}});
+  while_op->SetAttr<int32_t>("sub_block", 1);
+  while_op->SetAttr<bool>("is_test", true);
+  AddScaleDesc(main_block, "c", "d");
+  AddScaleDesc(main_block, "d", "e");
+  auto* fetch =
+      AddOpDesc(main_block, "fetch", {{"X", {"e"}}}, {{"Out", {"fetch"}}});
+  fetch->SetAttr<int>("col", 0);
+
+  AddScaleDesc(sub_block, "c", "t1");
+  AddScaleDesc(sub_block, "t1", "t2");
+  AddScaleDesc(sub_block, "t2", "t3");
+  AddScaleDesc(sub_block, "t3", "c");
+  AddScaleDesc(sub_block, "i", "i", 1.f, 1.f);
+  AddLessThanDesc(sub_block);
+  return program_desc;
+}
+
+// The input of the instruction whose output is `out`.
+static std::string FindInputOf(const RuntimeProgram& program,
+                               int block_idx,
+                               const std::string& out) {
+  for (auto& inst : program.instructions(block_idx)) {
+    auto* op_info = inst.op()->op_info();
+    if (op_info->Type() == "scale" && op_info->Output("Out").front() == out) {
+      return op_info->Input("X").front();
+    }
+  }
+  return "";
+}
+
+static void RunWhileProgram(Predictor* predictor, float iterations) {
+  auto* x = predictor->GetInput(0);
+  x->Resize({4});
+  auto* x_data = x->mutable_data<float>();
+  for (int i = 0; i < 4; i++) {
+    x_data[i] = i + 1;
+  }
+  auto* i = predictor->GetInput(1);
+  i->Resize({1});
+  i->mutable_data<float>()[0] = 0.f;
+  auto* n = predictor->GetInput(2);
+  n->Resize({1});
+  n->mutable_data<float>()[0] = iterations;
+  predictor->Run();
+
+  // e = 2 * 2 * (16 ^ iterations) * 8 * x
+  float factor = 32.f;
+  for (int k = 0; k < iterations; k++) {
+    factor *= 16.f;
+  }
+  auto* out = predictor->GetOutput(0);
+  ASSERT_EQ(out->numel(), 4);
+  for (int k = 0; k < 4; k++) {
+    EXPECT_FLOAT_EQ(out->data<float>()[k], factor * (k + 1));
+  }
+}
+
+TEST(memory_optimize_pass, x86_while) {
+  std::vector<Place> valid_places{Place{TARGET(kX86), PRECISION(kFloat)},
+                                  Place{TARGET(kHost), PRECISION(kFloat)}};
+  Predictor predictor;
+  predictor.Build(BuildWhileProgram(), valid_places);
+  predictor.GenRuntimeProgram();
+  const auto& program = predictor.runtime_program();
+
+  // The vars of the x86 kernels are reused in the main block: d takes the
+  // memory of a, while c is referred by the sub-block and keeps its name.
+  EXPECT_EQ(FindInputOf(program, 0, "c"), "b");
+  EXPECT_EQ(FindInputOf(program, 0, "e"), "a");
+  // In the sub-block, t3 takes the memory of t1, while the loop-carried c
+  // and the vars shared with the main block are not renamed.
+  EXPECT_EQ(FindInputOf(program, 1, "t1"), "c");
+  EXPECT_EQ(FindInputOf(program, 1, "t2"), "t1");
+  EXPECT_EQ(FindInputOf(program, 1, "c"), "t1");
+  EXPECT_EQ(FindInputOf(program, 1, "i"), "i");
+
+  // The control flow op runs the renamed sub-block from the program desc.
+  RunWhileProgram(&predictor, 3);
+  RunWhileProgram(&predictor, 1);
+
+  // The optimized program desc can be saved again, e.g. for a clone.
+  auto cloned = predictor.Clone();
+  RunWhileProgram(cloned.get(), 2);
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
@@ -68,6 +68,11 @@ void StaticKernelPickPass::Apply(const std::unique_ptr<SSAGraph>& graph) {
                                        << instruct.op_type();
     VLOG(4) << "instruct.kernels().size():" << instruct.kernels().size();
     for (auto&& kernel : instruct.kernels()) {
+      if (!kernel->IsParamSupported()) {
+        VLOG(4) << "kernel->summary():" << kernel->summary()
+                << " doesn't support the param";
+        continue;
+      }
       float score = KernelGrade(instruct,
                                 *kernel,
                                 graph->valid_places(),
@@ -79,6 +84,8 @@ void StaticKernelPickPass::Apply(const std::unique_ptr<SSAGraph>& graph) {
               << " score:" << score;
       scored.emplace_back(score, std::move(kernel));
     }
+    CHECK(!scored.empty()) << "No kernels support the param of "
+                           << instruct.op_type();
     std::stable_sort(scored.begin(), scored.end(), KernelScoreCmp);
     instruct.kernels().clear();
 
@@ -132,6 +139,7 @@ void StaticKernelPickPass::Apply(const std::unique_ptr<SSAGraph>& graph) {
         instruct.ResetOp(update_desc, graph->valid_places());
         scored.clear();
         for (auto&& kernel : instruct.kernels()) {
+          if (!kernel->IsParamSupported()) continue;
           float score = KernelGrade(instruct,
                                     *kernel,
                                     graph->valid_places(),
@@ -115,11 +115,15 @@ void TypeLayoutTransformPass::AddLayoutInst(
 
   CHECK(in->IsArg());
   // auto node_id = [&] { return graph->nodes().size(); };
+  // The blocked tensors are reordered into NCHW for the kernels taking any
+  // layout.
+  auto to_layout = to.layout() == DATALAYOUT(kAny) ? DATALAYOUT(kNCHW)
+                                                   : to.layout();
   auto layout_output_name =
       string_format("%s/layout_trans", in->AsArg().name.c_str());
   auto* layout_output_arg = graph->NewArgumentNode(layout_output_name);
   layout_output_arg->AsArg().type =
-      LiteType::GetTensorTy(from.target(), from.precision(), to.layout());
+      LiteType::GetTensorTy(from.target(), from.precision(), to_layout);
 
   auto* layout_inst = graph->NewInstructNode();
 
@@ -155,10 +159,10 @@ void TypeLayoutTransformPass::AddLayoutInst(
         (TargetCompatibleTo(*in_arg_ty, from) &&
          /* skip precision check: PrecisionCompatibleTo(*in_arg_ty, from) &&*/
          DeviceCompatibleTo(*in_arg_ty, from) &&
-         out_arg_ty->layout() == to.layout())) {
+         out_arg_ty->layout() == to_layout)) {
       is_found = true;
     } else if (TypeCompatible(*in_arg_ty, from) &&
-               out_arg_ty->layout() == to.layout()) {
+               out_arg_ty->layout() == to_layout) {
       is_found = true;
     }
     if (is_found) {
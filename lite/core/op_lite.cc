@@ -13,11 +13,13 @@
 // limitations under the License.
 
 #include "lite/core/op_lite.h"
+#include <algorithm>
 #include <list>
 #include <set>
 #include <utility>
 #include <vector>
 #include "lite/core/op_registry.h"
+#include "lite/utils/hash.h"
 #include "lite/utils/string.h"
 
 namespace paddle {
@@ -33,48 +35,78 @@ bool OpLite::InferShape() {
     return this->InferShapeImpl();
   }
 }
-bool OpLite::InferShapeWithCache() {
-  // 1. Get vector of current input tensors
-  auto *current_inputs = op_param_->input_tensor_ptrs();
-  // 2. Get hash value of current inputs shape and lod
-  bool use_cache = true;
-  if (last_input_shapes.size() == current_inputs->size()) {
-    for (size_t i = 0; i < current_inputs->size(); i++) {
-      if (last_input_shapes[i] != current_inputs->at(i)->dims() ||
-          last_input_lods[i] != current_inputs->at(i)->lod()) {
-        use_cache = false;
-        break;
+
+// The 64-bit hash of the dims and lods of the tensors, two different inputs
+// are assumed never to share the same signature.
+static uint64_t InputsSignature(const std::vector<const Tensor *> &inputs) {
+  uint64_t signature = inputs.size();
+  for (auto *input : inputs) {
+    const auto &dims = input->dims();
+    CombineHash64(dims.size(), &signature);
+    for (size_t i = 0; i < dims.size(); i++) {
+      CombineHash64(dims[i], &signature);
+    }
+    const auto &lod = input->lod();
+    CombineHash64(lod.size(), &signature);
+    for (const auto &level : lod) {
+      CombineHash64(level.size(), &signature);
+      for (auto offset : level) {
+        CombineHash64(offset, &signature);
       }
     }
-  } else {
-    use_cache = false;
   }
+  return signature;
+}
 
-  // 3. infer shapes of output tensors
-  if (use_cache) {
-    // if current hash value is consistent with io_shape_lod_hash_,
-    // previous outputs shape and lod are reused.
-    auto *current_outputs = op_param_->output_tensor_ptrs();
-    for (size_t i = 0; i < current_outputs->size(); i++) {
-      current_outputs->at(i)->Resize(last_output_shapes[i]);
-      current_outputs->at(i)->set_lod(last_output_lods[i]);
-    }
-  } else {
-    // otherwise, current hash value is changed, InferShapeImpl will apply.
-    this->InferShapeImpl();
-    auto *current_outputs = op_param_->output_tensor_ptrs();
-    last_output_shapes.clear();
-    last_output_lods.clear();
+constexpr size_t OpLite::kInferShapeCacheSize;
+
+void OpLite::set_infer_shape_cache_size(size_t size) {
+  infer_shape_cache_size_ = (std::max)(size, kInferShapeCacheSize);
+  if (infer_shape_cache_.size() > infer_shape_cache_size_) {
+    infer_shape_cache_.resize(infer_shape_cache_size_);
+  }
+}
+
+bool OpLite::InferShapeWithCache() {
+  // 1. Get the signature of the shapes and lods of current input tensors
+  uint64_t signature = InputsSignature(*op_param_->input_tensor_ptrs());
+  auto *current_outputs = op_param_->output_tensor_ptrs();
+
+  // 2. If the signature is cached, previous outputs shape and lod are reused.
+  auto it = std::find_if(
+      infer_shape_cache_.begin(),
+      infer_shape_cache_.end(),
+      [&](const InferShapeCacheEntry &entry) {
+        return entry.signature == signature;
+      });
+  if (it != infer_shape_cache_.end() &&
+      (it == infer_shape_cache_.begin() || !InferShapeUpdatesParam())) {
+    std::rotate(infer_shape_cache_.begin(), it, it + 1);
+    const auto &entry = infer_shape_cache_.front();
     for (size_t i = 0; i < current_outputs->size(); i++) {
-      last_output_shapes.push_back(current_outputs->at(i)->dims());
-      last_output_lods.push_back(current_outputs->at(i)->lod());
+      current_outputs->at(i)->Resize(entry.output_shapes[i]);
+      current_outputs->at(i)->set_lod(entry.output_lods[i]);
     }
-    last_input_shapes.clear();
-    last_input_lods.clear();
-    for (size_t i = 0; i < current_inputs->size(); i++) {
-      last_input_shapes.push_back(current_inputs->at(i)->dims());
-      last_input_lods.push_back(current_inputs->at(i)->lod());
+    return true;
+  }
+
+  // 3. Otherwise, InferShapeImpl will apply, and its outputs shape and lod
+  // replace the least recently used entry.
+  this->InferShapeImpl();
+  if (it == infer_shape_cache_.end()) {
+    if (infer_shape_cache_.size() < infer_shape_cache_size_) {
+      infer_shape_cache_.emplace_back();
     }
+    it = infer_shape_cache_.end() - 1;
+  }
+  std::rotate(infer_shape_cache_.begin(), it, it + 1);
+  auto &entry = infer_shape_cache_.front();
+  entry.signature = signature;
+  entry.output_shapes.resize(current_outputs->size());
+  entry.output_lods.resize(current_outputs->size());
+  for (size_t i = 0; i < current_outputs->size(); i++) {
+    entry.output_shapes[i] = current_outputs->at(i)->dims();
+    entry.output_lods[i] = current_outputs->at(i)->lod();
   }
   return true;
 }
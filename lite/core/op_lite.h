@@ -68,6 +68,14 @@ class OpLite : public Registry {
   // Inference the outputs' shape.
   virtual bool InferShapeImpl() const { return true; }
   virtual bool InferShape();
+  // Whether InferShapeImpl also updates the param by the input shapes, e.g.
+  // the paddings of the SAME padding algorithm. If so, only the output shapes
+  // of the last inferred inputs can be reused.
+  virtual bool InferShapeUpdatesParam() const { return false; }
+  // The number of the latest input signatures whose output shapes are kept,
+  // it is raised to the number of the shape buckets of the predictor.
+  void set_infer_shape_cache_size(size_t size);
+  size_t infer_shape_cache_size() const { return infer_shape_cache_size_; }
   // Run this operator.
   virtual bool Run();
   // Indicate whether the Op runs only once or not
@@ -175,19 +183,29 @@ class OpLite : public Registry {
   std::vector<Place> valid_places_;
   Place kernel_place_{TARGET(kHost), PRECISION(kFloat)};
   std::unique_ptr<OpInfo> op_info_;
-  // todo: it's prefered to combine last_input_shapes and
-  // last_input_lods into a single hash value to decrease
-  // memory usage.
-  std::vector<DDimLite> last_input_shapes{};
-  std::vector<std::vector<std::vector<uint64_t>>> last_input_lods{};
-  std::vector<DDimLite> last_output_shapes{};
-  std::vector<std::vector<std::vector<uint64_t>>> last_output_lods{};
   mutable operators::ParamBase *op_param_{nullptr};
 
  private:
-  // Infer Shape according to memory, if current input shapes are consistent
-  // with that of previous inputs, output shapes of last time will be reused.
+  // The output shapes and lods inferred from the inputs whose shapes and lods
+  // have the signature.
+  struct InferShapeCacheEntry {
+    uint64_t signature{0};
+    std::vector<DDimLite> output_shapes;
+    std::vector<LoD> output_lods;
+  };
+  // The default number of the latest input signatures whose output shapes
+  // are kept, so alternating between a few input shapes never runs
+  // InferShapeImpl.
+  static constexpr size_t kInferShapeCacheSize = 4;
+
+  // Infer Shape according to memory, if the signature of the current input
+  // shapes and lods is one of the latest ones, the output shapes inferred
+  // for it will be reused.
   bool InferShapeWithCache();
+
+  // The most recently used entry is the first.
+  std::vector<InferShapeCacheEntry> infer_shape_cache_;
+  size_t infer_shape_cache_size_{kInferShapeCacheSize};
 };
 
 /*
@@ -14,11 +14,120 @@
 
 #include "lite/core/op_lite.h"
 #include <gtest/gtest.h>
+#include <string>
+#include <vector>
 
 namespace paddle {
 namespace lite {
 
 TEST(OpLite, test) {}
 
+struct FakeParam : operators::ParamBase {
+  const Tensor* x{};
+  Tensor* out{};
+  const std::vector<const Tensor*>* input_tensor_ptrs() override {
+    if (!input_tensor_ptrs_cache_) {
+      input_tensor_ptrs_cache_.reset(new std::vector<const Tensor*>({x}));
+    }
+    return input_tensor_ptrs_cache_.get();
+  }
+  std::vector<Tensor*>* output_tensor_ptrs() override {
+    if (!output_tensor_ptrs_cache_) {
+      output_tensor_ptrs_cache_.reset(new std::vector<Tensor*>({out}));
+    }
+    return output_tensor_ptrs_cache_.get();
+  }
+};
+
+// out = x[:, :-1] and counts the calls of InferShapeImpl.
+class FakeOp : public OpLite {
+ public:
+  FakeOp(FakeParam* param, bool updates_param)
+      : OpLite("fake"), updates_param_(updates_param) {
+    AttachParam(param);
+    param_ = param;
+  }
+
+  bool InferShapeImpl() const override {
+    num_infer_shape_++;
+    auto dims = param_->x->dims().Vectorize();
+    dims.back() -= 1;
+    param_->out->Resize(dims);
+    param_->out->set_lod(param_->x->lod());
+    return true;
+  }
+
+  bool InferShapeUpdatesParam() const override { return updates_param_; }
+
+  bool AttachImpl(const cpp::OpDesc& opdesc, lite::Scope* scope) override {
+    return true;
+  }
+  void AttachKernel(KernelBase* kernel) override {}
+  std::string DebugString() const override { return "fake"; }
+
+  int num_infer_shape() const { return num_infer_shape_; }
+
+ private:
+  FakeParam* param_{};
+  bool updates_param_{false};
+  mutable int num_infer_shape_{0};
+};
+
+TEST(OpLite, infer_shape_with_cache) {
+  Tensor x, out;
+  FakeParam param;
+  param.x = &x;
+  param.out = &out;
+  FakeOp op(&param, false);
+
+  // Alternate among 4 input shapes and lods, InferShapeImpl runs only once
+  // for each of them.
+  std::vector<std::vector<int64_t>> shapes{{1, 3, 8}, {1, 3, 9}, {2, 8}, {5}};
+  for (int round = 0; round < 3; round++) {
+    for (size_t i = 0; i < shapes.size(); i++) {
+      x.Resize(shapes[i]);
+      x.set_lod(i == 2 ? LoD({{0, 1, 2}}) : LoD());
+      op.InferShape();
+      auto expected = shapes[i];
+      expected.back() -= 1;
+      EXPECT_EQ(out.dims().Vectorize(), expected);
+      EXPECT_EQ(out.lod(), x.lod());
+    }
+  }
+  EXPECT_EQ(op.num_infer_shape(), 4);
+
+  // The same dims with another lod is not a hit.
+  x.Resize(shapes[2]);
+  x.set_lod(LoD({{0, 2}}));
+  op.InferShape();
+  EXPECT_EQ(op.num_infer_shape(), 5);
+  EXPECT_EQ(out.lod(), x.lod());
+
+  // The least recently used shape {1, 3, 8} has been dropped.
+  x.Resize(shapes[0]);
+  x.set_lod(LoD());
+  op.InferShape();
+  EXPECT_EQ(op.num_infer_shape(), 6);
+  EXPECT_EQ(out.dims().Vectorize(), std::vector<int64_t>({1, 3, 7}));
+}
+
+TEST(OpLite, infer_shape_with_cache_updating_param) {
+  Tensor x, out;
+  FakeParam param;
+  param.x = &x;
+  param.out = &out;
+  FakeOp op(&param, true);
+
+  // Only the last inferred input shape is reused.
+  for (int round = 0; round < 2; round++) {
+    for (int64_t size : {4, 4, 6, 6}) {
+      x.Resize({size});
+      op.InferShape();
+      EXPECT_EQ(out.dims()[0], size - 1);
+    }
+  }
+  EXPECT_EQ(op.num_infer_shape(), 4);
+}
+
 }  // namespace lite
 }  // namespace paddle
@@ -19,8 +19,10 @@
 #include <string>
 #include <utility>
 #include <vector>
+#include "lite/core/mir/constant_folding_pass.h"
 #include "lite/core/mir/elimination/control_flow_op_unused_inputs_and_outputs_eliminate_pass.h"
 #include "lite/core/mir/generate_program_pass.h"
+#include "lite/core/mir/memory_optimize_pass.h"
 #include "lite/core/mir/pass_manager.h"
 #include "lite/core/mir/pass_utils.h"
 #include "lite/core/mir/post_quant_dynamic_pass.h"
@@ -40,7 +42,7 @@ namespace lite {
  */
 // TODO(hong1986032) Support the following passes for the subblocks
 const std::set<std::string> kSubblockUnsupportedPasses(
-    {"memory_optimize_pass"});
+    {"constant_folding_pass", "concat_split_inplace_pass"});
 class Optimizer {
  public:
   Optimizer() {}
@@ -79,6 +81,8 @@ class Optimizer {
     SpecifyKernelPickTactic(kernel_pick_factor);
     InitTargetTypeTransformPass();
     InitControlFlowOpUnusedInputsAndOutputsEliminatePass();
+    InitMemoryOptimizePass();
+    InitConstantFoldingPass();
 
     std::vector<std::string> passes_local{
         {"lite_quant_dequant_fuse_pass",         //
@@ -99,6 +103,7 @@ class Optimizer {
          "identity_scale_eliminate_pass",               //
          "lite_scales_fuse_pass",                       //
          "lite_sequence_reverse_embedding_fuse_pass",   //
+         "lite_embedding_seq_pool_fuse_pass",           //
          "elementwise_mul_constant_eliminate_pass",     //
          "lite_sequence_pool_concat_fuse_pass",         //
          "lite_scale_activation_fuse_pass",             //
@@ -107,6 +112,9 @@ class Optimizer {
          "lite_elementwise_activation_fuse_pass",  //
 #endif
          "identity_dropout_eliminate_pass",
+         "lite_multihead_attention_fuse_pass",         // transformer encoder
+         "lite_fc_gelu_fuse_pass",                     //
+         "lite_elementwise_add_layer_norm_fuse_pass",  //
          "__xpu__resnet_fuse_pass",
          "__xpu__resnet_d_fuse_pass",
          "__xpu__resnet_cbam_fuse_pass",
@@ -124,6 +132,7 @@ class Optimizer {
                                                     // fix the attribute
                                                     // 'enable_int8' for all
                                                     // of the quantized ops.
+         "constant_folding_pass",  // pre-compute the ops of the weights
          "npu_subgraph_pass",
          "huawei_ascend_npu_subgraph_pass",
          "imagination_nna_subgraph_pass",
@@ -171,6 +180,7 @@ class Optimizer {
          "runtime_context_assign_pass",
          "argument_type_display_pass",
          "lite_reshape_fuse_pass",
+         "concat_split_inplace_pass",
 #if !(defined(LITE_WITH_FPGA) || defined(LITE_WITH_PRECISION_PROFILE))
          "memory_optimize_pass"
 #endif
@@ -178,11 +188,12 @@ class Optimizer {
 
     // multi_stream_analysis_pass must be in the front of
     // runtime_context_assign_pass
-    // post_quant_dynamic_pass must be in the behind of
-    // lite_quant_dequant_fuse_pass
+    // post_quant_dynamic_pass and embedding_quant_pass must be in the behind
+    // of lite_quant_dequant_fuse_pass
     const std::string msa_pass{"multi_stream_analysis_pass"};
     const std::string msa_depend_pass{"runtime_context_assign_pass"};
     const std::string pqd_pass{"post_quant_dynamic_pass"};
+    const std::string eq_pass{"embedding_quant_pass"};
     const std::string pqd_depend_pass{"lite_quant_dequant_fuse_pass"};
     for (const std::string& pass : passes) {
       if (pass == msa_pass) {
@@ -190,11 +201,11 @@ class Optimizer {
             passes_local.begin(), passes_local.end(), msa_depend_pass);
         CHECK(iter != passes_local.end()) << "No find " << msa_depend_pass;
         passes_local.insert(iter, msa_pass);
-      } else if (pass == pqd_pass) {
+      } else if (pass == pqd_pass || pass == eq_pass) {
         auto iter = std::find(
             passes_local.begin(), passes_local.end(), pqd_depend_pass);
         CHECK(iter != passes_local.end()) << "No find " << pqd_depend_pass;
-        passes_local.insert(iter + 1, pqd_pass);
+        passes_local.insert(iter + 1, pass);
       } else {
         passes_local.push_back(pass);
       }
@@ -239,6 +250,22 @@ class Optimizer {
     pass->SetAllGraphs(&graphs_);
   }
 
+  void InitMemoryOptimizePass() {
+    auto* pass = mir::PassManager::Global().LookUp<mir::MemoryOptimizePass>(
+        "memory_optimize_pass");
+    CHECK(pass);
+    CHECK(!graphs_.empty());
+    pass->SetAllGraphs(&graphs_);
+  }
+
+  void InitConstantFoldingPass() {
+    auto* pass = mir::PassManager::Global().LookUp<mir::ConstantFoldingPass>(
+        "constant_folding_pass");
+    CHECK(pass);
+    CHECK(!graphs_.empty());
+    pass->SetAllGraphs(&graphs_);
+  }
+
   // Generate C++ code which combines the inference program, model and weights.
   void GenCode(const std::string& code_dir);
 
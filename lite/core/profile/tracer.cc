@@ -0,0 +1,162 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/profile/tracer.h"
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include "lite/utils/macros.h"
+
+namespace paddle {
+namespace lite {
+namespace profile {
+
+void TraceEvent::SetStr(char* dst, size_t size, const std::string& src) {
+  size_t len = (std::min)(size - 1, src.size());
+  std::memcpy(dst, src.data(), len);
+  dst[len] = '\0';
+}
+
+void Tracer::Enable(double sample_rate, size_t capacity) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  sample_rate_ = (std::max)(0.0, (std::min)(sample_rate, 1.0));
+  capacity = (std::max)(capacity, static_cast<size_t>(1));
+  Ring* ring = ring_.load();
+  if (!ring || ring->size != capacity) {
+    rings_.emplace_back(new Ring(capacity));
+    ring_.store(rings_.back().get());
+  }
+  enabled_.store(true);
+}
+
+void Tracer::Disable() {
+  enabled_.store(false);
+  sampled_.store(false);
+}
+
+bool Tracer::BeginRun() {
+  bool sampled = false;
+  if (enabled()) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    sampled = sample_rate_ >= 1.0 ||
+              std::uniform_real_distribution<double>(0, 1)(engine_) <
+                  sample_rate_;
+  }
+  if (sampled) {
+    run_id_.fetch_add(1, std::memory_order_relaxed);
+  }
+  sampled_.store(sampled, std::memory_order_relaxed);
+  return sampled;
+}
+
+void Tracer::Record(const TraceEvent& event) {
+  Ring* ring = ring_.load(std::memory_order_acquire);
+  if (!ring) return;
+  uint64_t index = ring->next.fetch_add(1, std::memory_order_relaxed);
+  Slot& slot = ring->slots[index % ring->size];
+  slot.seq.store(2 * index + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  slot.event = event;
+  slot.seq.store(2 * (index + 1), std::memory_order_release);
+}
+
+std::vector<TraceEvent> Tracer::Events() const {
+  std::vector<TraceEvent> events;
+  Ring* ring = ring_.load(std::memory_order_acquire);
+  if (!ring) return events;
+  uint64_t end = ring->next.load(std::memory_order_acquire);
+  uint64_t begin = (std::max)(ring->begin.load(std::memory_order_relaxed),
+                              end > ring->size ? end - ring->size : 0);
+  for (uint64_t index = begin; index < end; index++) {
+    const Slot& slot = ring->slots[index % ring->size];
+    // The slot is skipped if it is being written or is overwritten while it
+    // is copied.
+    uint64_t seq = slot.seq.load(std::memory_order_acquire);
+    if (seq != 2 * (index + 1)) continue;
+    TraceEvent event = slot.event;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.seq.load(std::memory_order_relaxed) != seq) continue;
+    events.push_back(event);
+  }
+  return events;
+}
+
+void Tracer::Clear() {
+  Ring* ring = ring_.load(std::memory_order_acquire);
+  if (ring) {
+    ring->begin.store(ring->next.load());
+  }
+}
+
+static std::string EscapeJson(const char* str) {
+  std::string escaped;
+  for (const char* c = str; *c; c++) {
+    if (*c == '"' || *c == '\\') {
+      escaped += '\\';
+      escaped += *c;
+    } else if (static_cast<unsigned char>(*c) < 0x20) {
+      escaped += ' ';
+    } else {
+      escaped += *c;
+    }
+  }
+  return escaped;
+}
+
+std::string Tracer::ExportChromeTrace() const {
+  auto events = Events();
+  std::sort(events.begin(),
+            events.end(),
+            [](const TraceEvent& a, const TraceEvent& b) {
+              return a.begin_ns < b.begin_ns;
+            });
+  std::ostringstream os;
+  os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  char time[64];
+  for (size_t i = 0; i < events.size(); i++) {
+    const auto& e = events[i];
+    // The timestamps are in microseconds.
+    snprintf(time,
+             sizeof(time),
+             "\"ts\":%.3f,\"dur\":%.3f",
+             e.begin_ns / 1000.0,
+             (e.end_ns - e.begin_ns) / 1000.0);
+    os << (i ? ",\n" : "\n") << "{\"name\":\"" << EscapeJson(e.op_type)
+       << "\",\"cat\":\"op\",\"ph\":\"X\"," << time
+       << ",\"pid\":0,\"tid\":" << e.thread_id << ",\"args\":{\"kernel\":\""
+       << EscapeJson(e.kernel) << "\",\"shapes\":\"" << EscapeJson(e.shapes)
+       << "\",\"macs\":" << e.macs << ",\"output_bytes\":" << e.output_bytes
+       << ",\"run\":" << e.run_id << "}}";
+  }
+  os << "\n]}\n";
+  return os.str();
+}
+
+int64_t Tracer::NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+uint32_t Tracer::ThreadId() {
+  static std::atomic<uint32_t> next_id{0};
+  static LITE_THREAD_LOCAL uint32_t id = next_id.fetch_add(1);
+  return id;
+}
+
+}  // namespace profile
+}  // namespace lite
+}  // namespace paddle
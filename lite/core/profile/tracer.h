@@ -0,0 +1,121 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <random>
+#include <string>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+namespace profile {
+
+// The run of an instruction. It is a POD with fixed size strings, so it is
+// copied in and out of the ring buffer without locks.
+struct TraceEvent {
+  int64_t begin_ns{0};
+  int64_t end_ns{0};
+  uint32_t thread_id{0};
+  uint32_t run_id{0};
+  int64_t macs{0};
+  int64_t output_bytes{0};
+  char op_type[32];
+  char kernel[64];
+  char shapes[128];
+
+  static void SetStr(char* dst, size_t size, const std::string& src);
+};
+
+/*
+ * Tracer records the timelines of the sampled runs of a program, and exports
+ * them in the Chrome trace event format, which is loaded by chrome://tracing
+ * and Perfetto.
+ *
+ * It is always compiled, unlike profile::Profiler. When disabled, an
+ * instruction only loads an atomic flag. When enabled, a run is sampled with
+ * the probability `sample_rate`, and the events of the sampled runs are
+ * written to a lock-free ring buffer of the latest `capacity` events, so the
+ * instructions run by the inter-op threads record concurrently.
+ */
+class Tracer {
+ public:
+  Tracer() = default;
+
+  // The ring buffer is allocated by the first Enable, or again if the
+  // capacity is changed.
+  void Enable(double sample_rate, size_t capacity);
+  void Disable();
+  bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+  // Called at the beginning of a run, returns whether it is sampled.
+  bool BeginRun();
+  // Whether the current run is sampled, it is cheap to check per instruction.
+  bool sampled() const { return sampled_.load(std::memory_order_relaxed); }
+  uint32_t run_id() const { return run_id_.load(std::memory_order_relaxed); }
+
+  void Record(const TraceEvent& event);
+  // The recorded events from the oldest to the latest, the events being
+  // written are skipped.
+  std::vector<TraceEvent> Events() const;
+  // Drop the recorded events.
+  void Clear();
+
+  // The events in the Chrome trace event format.
+  std::string ExportChromeTrace() const;
+
+  // The nanoseconds of a monotonic clock.
+  static int64_t NowNs();
+  // A small id of the calling thread. It is the same for all of the threads
+  // where the thread local storage is unsupported, see LITE_THREAD_LOCAL.
+  static uint32_t ThreadId();
+
+ private:
+  struct Slot {
+    // Odd while the event is being written, 2 * (index + 1) once written.
+    std::atomic<uint64_t> seq{0};
+    TraceEvent event;
+  };
+  struct Ring {
+    explicit Ring(size_t capacity)
+        : slots(new Slot[capacity]), size(capacity) {}
+    std::unique_ptr<Slot[]> slots;
+    const size_t size;
+    std::atomic<uint64_t> next{0};
+    // The events before it are dropped by Clear.
+    std::atomic<uint64_t> begin{0};
+  };
+
+  Tracer(const Tracer&) = delete;
+  Tracer& operator=(const Tracer&) = delete;
+
+  std::atomic<bool> enabled_{false};
+  std::atomic<bool> sampled_{false};
+  std::atomic<uint32_t> run_id_{0};
+  std::atomic<Ring*> ring_{nullptr};
+  double sample_rate_{1.0};
+  std::mt19937 engine_{2020};
+  std::mutex mutex_;
+  // The rings replaced by Enable are kept, the concurrent writers may still
+  // hold them.
+  std::vector<std::unique_ptr<Ring>> rings_;
+};
+
+}  // namespace profile
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,97 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/profile/tracer.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+namespace paddle {
+namespace lite {
+namespace profile {
+
+static TraceEvent MakeEvent(int64_t begin, const std::string& op_type) {
+  TraceEvent event;
+  event.begin_ns = begin;
+  event.end_ns = begin + 1500;
+  event.thread_id = Tracer::ThreadId();
+  event.macs = 8;
+  TraceEvent::SetStr(event.op_type, sizeof(event.op_type), op_type);
+  TraceEvent::SetStr(event.kernel, sizeof(event.kernel), "kernel");
+  TraceEvent::SetStr(event.shapes, sizeof(event.shapes), "X=1x\"2\"");
+  return event;
+}
+
+TEST(tracer, sample_and_export) {
+  Tracer tracer;
+  EXPECT_FALSE(tracer.BeginRun());
+  EXPECT_TRUE(tracer.Events().empty());
+
+  tracer.Enable(1.0, 16);
+  ASSERT_TRUE(tracer.BeginRun());
+  EXPECT_TRUE(tracer.sampled());
+  tracer.Record(MakeEvent(3000, "fc"));
+  tracer.Record(MakeEvent(1000, "conv2d"));
+  ASSERT_EQ(tracer.Events().size(), 2u);
+
+  auto json = tracer.ExportChromeTrace();
+  EXPECT_EQ(json.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["), 0u);
+  // The events are sorted by the beginning, in microseconds.
+  auto conv = json.find("\"name\":\"conv2d\"");
+  auto fc = json.find("\"name\":\"fc\"");
+  ASSERT_NE(conv, std::string::npos);
+  ASSERT_NE(fc, std::string::npos);
+  EXPECT_LT(conv, fc);
+  EXPECT_NE(json.find("\"ts\":1.000,\"dur\":1.500"), std::string::npos);
+  EXPECT_NE(json.find("\"shapes\":\"X=1x\\\"2\\\"\""), std::string::npos);
+
+  tracer.Clear();
+  EXPECT_TRUE(tracer.Events().empty());
+
+  // No run is sampled with the rate 0, and none after Disable.
+  tracer.Enable(0.0, 16);
+  EXPECT_FALSE(tracer.BeginRun());
+  tracer.Enable(1.0, 16);
+  tracer.Disable();
+  EXPECT_FALSE(tracer.BeginRun());
+  EXPECT_FALSE(tracer.sampled());
+}
+
+TEST(tracer, ring_keeps_latest) {
+  Tracer tracer;
+  tracer.Enable(1.0, 8);
+  const int threads = 4;
+  const int events_per_thread = 100;
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; t++) {
+    workers.emplace_back([&tracer, t] {
+      for (int i = 0; i < events_per_thread; i++) {
+        tracer.Record(MakeEvent(t * events_per_thread + i, "relu"));
+      }
+    });
+  }
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  auto events = tracer.Events();
+  EXPECT_EQ(events.size(), 8u);
+  for (auto& event : events) {
+    EXPECT_EQ(std::string(event.op_type), "relu");
+  }
+}
+
+}  // namespace profile
+}  // namespace lite
+}  // namespace paddle
@@ -14,8 +14,10 @@
 
 #include "lite/core/program.h"
 #include <algorithm>
+#include <cstring>
 #include <map>
 #include <set>
+#include "lite/model_parser/base/traits.h"
 #include "lite/model_parser/cpp_desc.h"
 #include "lite/operators/conditional_block_op.h"
 #include "lite/operators/subgraph_op.h"
@@ -33,10 +35,27 @@ void RuntimeProgram::SaveToProgram(
   auto block_size = program_desc->BlocksSize();
   CHECK_GT(block_size, 0) << "No block found!";
   // TODD(hong19860320) Only support updating the block desc which already
-  // exists in the origin program desc
-  CHECK_LE(block_size, instructions_.size())
-      << "Invalid block size, expected (0," << instructions_.size()
-      << "] but got " << block_size;
+  // exists in the origin program desc. The blocks after them can only be the
+  // sub-blocks appended for the new subgraph ops by the previous calls, e.g.
+  // in GenRuntimeProgram and then in SaveModel, which are left as they are.
+  if (block_size > instructions_.size()) {
+    std::set<int32_t> subgraph_block_idxs;
+    for (auto& insts : instructions_) {
+      for (auto& inst : insts) {
+        auto* op_info = inst.op()->op_info();
+        if (op_info->Type() == "subgraph") {
+          subgraph_block_idxs.insert(op_info->GetAttr<int32_t>("sub_block"));
+        }
+      }
+    }
+    for (size_t block_idx = instructions_.size(); block_idx < block_size;
+         ++block_idx) {
+      CHECK(subgraph_block_idxs.count(static_cast<int32_t>(block_idx)))
+          << "Invalid block size, expected (0," << instructions_.size()
+          << "] but got " << block_size;
+    }
+    block_size = instructions_.size();
+  }
   for (size_t block_idx = 0; block_idx < block_size; ++block_idx) {
     auto block_desc = program_desc->GetBlock<cpp::BlockDesc>(block_idx);
     // Record all of the origin vars in the origin block
@@ -78,6 +97,15 @@ void RuntimeProgram::SaveToProgram(
             v->SetShape(it->second.GetShape());
             v->SetDataType(it->second.GetDataType());
           }
+          // The vars may become persistable in the passes, e.g. the outputs
+          // of the ops folded by constant_folding_pass.
+          auto* var = scope->FindVar(var_name);
+          if (!it->second.Persistable() &&
+              it->second.GetType() == cpp::VarDesc::Type::LOD_TENSOR && var &&
+              var->IsType<Tensor>() && var->Get<Tensor>().persistable()) {
+            v->SetPersistable(true);
+            v->SetShape(var->Get<Tensor>().dims().data());
+          }
         } else {
           std::string arg_name;
           const Type* decl_type;
@@ -95,10 +123,10 @@ void RuntimeProgram::SaveToProgram(
               v->SetShape(tensor->dims().data());
               auto precision = tensor->precision();
               switch (precision) {
-#define SET_DATATYPE(precision__, data_type)           \
-  case PrecisionType::precision__:                     \
-    v->SetDataType(data_type);                         \
-    LOG(INFO) << "Update var " << var_name << " done"; \
+#define SET_DATATYPE(precision__, data_type)          \
+  case PrecisionType::precision__:                    \
+    v->SetDataType(data_type);                        \
+    VLOG(4) << "Update var " << var_name << " done"; \
     break
                 SET_DATATYPE(kBool, VarDescAPI::VarDataType::BOOL);
                 SET_DATATYPE(kFloat, VarDescAPI::VarDataType::FP32);
@@ -258,6 +286,11 @@ RuntimeProgram::RuntimeProgram(
 }
 
 void RuntimeProgram::Run() {
+  tracer_.BeginRun();
+  if (inter_op_executor_) {
+    inter_op_executor_->Run();
+    return;
+  }
 #ifdef LITE_WITH_PRECISION_PROFILE
   auto inst_precision_profiler = paddle::lite::profile::PrecisionProfiler();
   std::string precision_profiler_summary =
@@ -307,6 +340,205 @@ void RuntimeProgram::Run() {
             << precision_profiler_summary
             << inst_precision_profiler.GetSummaryTail();
 #endif
+  if (memory_arena_enabled_) {
+    bool valid = memory_arena_planned_;
+    for (auto& arena : memory_arenas_) {
+      valid = valid && arena->IsValid();
+    }
+    if (!valid) {
+      PlanMemoryArena();
+    }
+  }
+}
+
+void RuntimeProgram::set_inter_op_threads(int threads) {
+  inter_op_threads_ = threads;
+  inter_op_executor_.reset();
+  if (threads <= 1) return;
+#if defined(LITE_WITH_PROFILE) || defined(LITE_WITH_PRECISION_PROFILE) || \
+    defined(LITE_WITH_NVTX)
+  LOG(WARNING) << "The inter-op parallelism is disabled by the profilers.";
+  return;
+#endif
+  if (memory_arena_enabled_) {
+    LOG(WARNING) << "The inter-op parallelism is disabled by the memory arena.";
+    return;
+  }
+  auto& insts = instructions_[kRootBlockIdx];
+  if (!InterOpExecutor::IsSupported(insts)) {
+    LOG(WARNING) << "The inter-op parallelism only supports the host kernels, "
+                    "fall back to the serial run.";
+    return;
+  }
+  inter_op_executor_.reset(new InterOpExecutor(&insts, threads));
+  if (inter_op_executor_->max_parallelism() <= 1) {
+    VLOG(3) << "There are no independent instructions to run concurrently.";
+    inter_op_executor_.reset();
+  }
+}
+
+void RuntimeProgram::PrepareShapeBuckets(
+    const cpp::ProgramDesc& program_desc,
+    const std::vector<std::string>& input_names,
+    const std::vector<lite_api::InputShapeBucket>& buckets) {
+  if (buckets.empty()) return;
+  CHECK(exec_scope_) << "The exec scope should be set before running.";
+  std::map<std::string, PrecisionType> var_precisions;
+  auto* main_block = program_desc.GetBlock<cpp::BlockDesc>(kRootBlockIdx);
+  for (size_t i = 0; i < main_block->VarsSize(); i++) {
+    auto* var_desc = main_block->GetVar<cpp::VarDesc>(i);
+    if (var_desc->GetType() != VarDescAPI::Type::LOD_TENSOR) continue;
+    switch (var_desc->GetDataType()) {
+      case VarDescAPI::Type::INT8:
+      case VarDescAPI::Type::INT16:
+      case VarDescAPI::Type::INT32:
+      case VarDescAPI::Type::INT64:
+      case VarDescAPI::Type::FP16:
+      case VarDescAPI::Type::FP32:
+        var_precisions[var_desc->Name()] =
+            ConvertPrecisionType(var_desc->GetDataType());
+        break;
+      default:
+        break;
+    }
+  }
+
+  for (auto& block : instructions_) {
+    for (auto& inst : block) {
+      inst.mutable_op()->set_infer_shape_cache_size(buckets.size());
+    }
+  }
+  // The arena is planned once with the sizes of all of the buckets.
+  bool memory_arena_enabled = memory_arena_enabled_;
+  memory_arena_enabled_ = false;
+  for (size_t i = 0; i < buckets.size(); i++) {
+    const auto& bucket = buckets[i];
+    CHECK_EQ(bucket.shapes.size(), input_names.size())
+        << "The shape bucket " << i << " should have the shapes of all of "
+        << "the inputs.";
+    for (size_t j = 0; j < input_names.size(); j++) {
+      auto* var = exec_scope_->FindVar(input_names[j]);
+      CHECK(var) << "no feed variable " << input_names[j] << " in exec_scope";
+      auto* input = var->GetMutable<Tensor>();
+      auto it = var_precisions.find(input_names[j]);
+      auto precision =
+          it != var_precisions.end() ? it->second : PRECISION(kFloat);
+      input->Resize(bucket.shapes[j]);
+      input->set_lod(j < bucket.lods.size() ? bucket.lods[j] : LoD());
+      size_t size = input->numel() * lite_api::PrecisionTypeLength(precision);
+      std::memset(input->mutable_data(TARGET(kHost), size), 0, size);
+      input->set_precision(precision);
+    }
+    Run();
+    for (auto& name : exec_scope_->LocalVarNames()) {
+      auto* var = exec_scope_->FindLocalVar(name);
+      if (!var || !var->IsType<Tensor>()) continue;
+      auto& size = reserved_memory_sizes_[name];
+      size = (std::max)(size, var->Get<Tensor>().memory_size());
+    }
+  }
+  memory_arena_enabled_ = memory_arena_enabled;
+  if (memory_arena_enabled_) {
+    PlanMemoryArena();
+  }
+}
+
+void RuntimeProgram::PlanMemoryArena() {
+#ifndef LITE_WITH_FPGA
+  CHECK(exec_scope_) << "The exec scope should be set before planning memory.";
+  MemoryKindGuard guard(MemoryKind::kActivation);
+  // The vars of these ops are shared with the sub-blocks, the subgraph engines
+  // or the users, so they are never moved into the arena.
+  const std::set<std::string> invalid_op_types = {"while",
+                                                  "conditional_block",
+                                                  "conditional_block_infer",
+                                                  "subgraph",
+                                                  "feed",
+                                                  "fetch"};
+  auto is_host = [](TargetType x) -> bool {
+    return x == TARGET(kHost) || x == TARGET(kX86) || x == TARGET(kARM);
+  };
+
+  // 1. Collect the lifetime of the vars which are produced in this block.
+  auto& insts = instructions_[kRootBlockIdx];
+  std::map<std::string, std::pair<int, int>> lifetimes;
+  std::vector<std::string> var_names;
+  std::set<std::string> invalid_var_names;
+  for (int idx = 0; idx < static_cast<int>(insts.size()); ++idx) {
+    const auto* op = insts[idx].op();
+    const auto* op_info = op->op_info();
+    auto in_names = op_info->input_names();
+    auto out_names = op_info->output_names();
+    // The outputs of the ops which run only once must survive across runs,
+    // and the views and the slices of the in-place ops are bound by them.
+    bool inplace =
+        op_info->HasAttr("inplace") && op_info->GetAttr<bool>("inplace");
+    if (invalid_op_types.count(op_info->Type()) || op->run_once() || inplace) {
+      invalid_var_names.insert(in_names.begin(), in_names.end());
+      invalid_var_names.insert(out_names.begin(), out_names.end());
+      continue;
+    }
+    for (auto& name : in_names) {
+      auto it = lifetimes.find(name);
+      if (it != lifetimes.end()) {
+        it->second.second = idx;
+      } else {
+        // Inputs of the program and vars updated across runs
+        invalid_var_names.insert(name);
+      }
+    }
+    for (auto& name : out_names) {
+      auto it = lifetimes.find(name);
+      if (it != lifetimes.end()) {
+        it->second.second = idx;
+      } else {
+        lifetimes.emplace(name, std::make_pair(idx, idx));
+        var_names.push_back(name);
+      }
+    }
+  }
+
+  // 2. Group the tensors by target, the weights are not in the exec scope and
+  // the tensors sharing buffers with others are skipped.
+  std::map<TargetType, std::vector<ArenaBlock>> target_blocks;
+  for (auto& name : var_names) {
+    if (invalid_var_names.count(name)) continue;
+    auto* var = exec_scope_->FindLocalVar(name);
+    if (!var || !var->IsType<Tensor>()) continue;
+    auto* tensor = var->GetMutable<Tensor>();
+    if (!tensor->IsInitialized() || tensor->memory_size() == 0 ||
+        tensor->offset() != 0 || tensor->persistable() ||
+        tensor->IsBufferShared() || !is_host(tensor->target())) {
+      continue;
+    }
+    ArenaBlock block;
+    block.tensor = tensor;
+    block.size = tensor->memory_size();
+    auto reserved = reserved_memory_sizes_.find(name);
+    if (reserved != reserved_memory_sizes_.end()) {
+      block.size = (std::max)(block.size, reserved->second);
+    }
+    block.first_use = lifetimes[name].first;
+    block.last_use = lifetimes[name].second;
+    target_blocks[tensor->target()].push_back(block);
+  }
+
+  // 3. Release the old arenas, make the new plan and bind the tensors to their
+  // slices.
+  for (auto& arena : memory_arenas_) {
+    arena->Release();
+  }
+  memory_arenas_.clear();
+  for (auto& item : target_blocks) {
+    std::unique_ptr<MemoryArena> arena(new MemoryArena(item.first));
+    arena->Bind(std::move(item.second));
+    VLOG(3) << "The memory arena of " << TargetToStr(item.first) << " holds "
+            << arena->blocks().size() << " tensors with " << arena->space()
+            << " bytes";
+    memory_arenas_.emplace_back(std::move(arena));
+  }
+#endif
+  memory_arena_planned_ = true;
 }
 
 void Program::Build(const std::shared_ptr<cpp::ProgramDesc>& program_desc) {
@@ -448,8 +680,13 @@ void Instruction::Run() {
     return;
   }
 
+  MemoryKindGuard guard(MemoryKind::kActivation);
   op_->InferShape();
-  kernel_->Launch();
+  if (tracer_ && tracer_->sampled()) {
+    LaunchTraced();
+  } else {
+    kernel_->Launch();
+  }
   has_run_ = true;
 
 #ifdef LITE_WITH_PROFILE
@@ -461,6 +698,86 @@ void Instruction::Run() {
 #endif
 }
 
+// The multiply-accumulates of the compute bound ops, 0 for the others.
+static int64_t EstimateMacs(const OpInfo& op_info, Scope* scope) {
+  auto dims = [&](const std::string& arg) -> DDim {
+    if (!op_info.HasInput(arg) && !op_info.HasOutput(arg)) return DDim();
+    auto names =
+        op_info.HasInput(arg) ? op_info.Input(arg) : op_info.Output(arg);
+    auto* var = names.empty() ? nullptr : scope->FindVar(names.front());
+    if (!var || !var->IsType<Tensor>()) return DDim();
+    return var->Get<Tensor>().dims();
+  };
+  const auto& type = op_info.Type();
+  if (type == "conv2d" || type == "depthwise_conv2d") {
+    auto filter = dims("Filter");
+    if (filter.size() != 4) return 0;
+    int64_t k = filter.count(1, 4);
+    return dims("Output").production() * k;
+  } else if (type == "fc") {
+    auto w = dims("W");
+    if (w.size() != 2) return 0;
+    return dims("Out").production() * w[0];
+  } else if (type == "mul") {
+    auto x = dims("X");
+    int x_num_col_dims = op_info.GetAttr<int>("x_num_col_dims");
+    if (x.size() <= static_cast<size_t>(x_num_col_dims)) return 0;
+    int64_t k = x.count(x_num_col_dims, static_cast<int>(x.size()));
+    return dims("Out").production() * k;
+  } else if (type == "matmul" || type == "matmul_v2") {
+    auto x = dims("X");
+    const char* trans = type == "matmul" ? "transpose_X" : "trans_x";
+    bool trans_x = op_info.HasAttr(trans) && op_info.GetAttr<bool>(trans);
+    if (x.size() < 2) return 0;
+    return dims("Out").production() * x[x.size() - (trans_x ? 2 : 1)];
+  }
+  return 0;
+}
+
+void Instruction::LaunchTraced() {
+  profile::TraceEvent event;
+  event.begin_ns = profile::Tracer::NowNs();
+  kernel_->Launch();
+  event.end_ns = profile::Tracer::NowNs();
+  event.thread_id = profile::Tracer::ThreadId();
+  event.run_id = tracer_->run_id();
+
+  // The shapes are formatted as "Input=1x3x224x224 Filter=..., Out=...".
+  const auto* op_info = op_->op_info();
+  auto* scope = op_->scope();
+  std::string shapes;
+  auto append_shapes = [&](
+      const std::map<std::string, std::vector<std::string>>& args,
+      bool output) {
+    for (auto& arg : args) {
+      for (auto& name : arg.second) {
+        auto* var = scope->FindVar(name);
+        if (!var || !var->IsType<Tensor>()) continue;
+        const auto& tensor = var->Get<Tensor>();
+        if (output) {
+          event.output_bytes += tensor.memory_size();
+        }
+        std::string dims;
+        for (auto d : tensor.dims().Vectorize()) {
+          dims += (dims.empty() ? "" : "x") + std::to_string(d);
+        }
+        shapes += (shapes.empty() ? "" : " ") + arg.first + "=" + dims;
+      }
+    }
+  };
+  append_shapes(op_info->inputs(), false);
+  shapes += ",";
+  append_shapes(op_info->outputs(), true);
+  event.macs = EstimateMacs(*op_info, scope);
+
+  profile::TraceEvent::SetStr(
+      event.op_type, sizeof(event.op_type), op_info->Type());
+  profile::TraceEvent::SetStr(
+      event.kernel, sizeof(event.kernel), kernel_->name());
+  profile::TraceEvent::SetStr(event.shapes, sizeof(event.shapes), shapes);
+  tracer_->Record(event);
+}
+
 STL::ostream& operator<<(STL::ostream& os, const Instruction& other) {
   os << other.kernel_->summary() << "\t(" << other.kernel_->doc() << ")";
   return os;
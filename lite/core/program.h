@@ -19,9 +19,13 @@
 #include <string>
 #include <utility>
 #include <vector>
+#include "lite/api/paddle_api.h"
+#include "lite/core/inter_op_executor.h"
 #include "lite/core/kernel.h"
+#include "lite/core/memory_arena.h"
 #include "lite/core/op_lite.h"
 #include "lite/core/op_registry.h"
+#include "lite/core/profile/tracer.h"
 #include "lite/model_parser/cpp_desc.h"
 #ifdef LITE_WITH_PROFILE
 #include "lite/core/profile/profiler.h"
@@ -119,11 +123,15 @@ struct Instruction {
   friend STL::ostream& operator<<(STL::ostream& os, const Instruction& other);
 
   const OpLite* op() const { return op_.get(); }
+  OpLite* mutable_op() { return op_.get(); }
   const KernelBase* kernel() const { return kernel_.get(); }
   KernelBase* mutable_kernel() { return kernel_.get(); }
 
   bool is_feed_fetch_op() const { return is_feed_fetch_op_; }
 
+  // The runs are recorded to `tracer` while its current run is sampled.
+  void set_tracer(profile::Tracer* tracer) { tracer_ = tracer; }
+
 #ifdef LITE_WITH_CUDA
   bool need_sync() const {
     if (kernel_->target() == TargetType::kCUDA) {
@@ -164,11 +172,15 @@ struct Instruction {
 #endif
 
  private:
+  // Launch the kernel and record the event to tracer_.
+  void LaunchTraced();
+
   std::shared_ptr<OpLite> op_;
   std::unique_ptr<KernelBase> kernel_;
   bool is_feed_fetch_op_{false};
   bool first_epoch_{true};
   bool has_run_{false};
+  profile::Tracer* tracer_{nullptr};
 
 #ifdef LITE_WITH_PROFILE
   profile::Profiler* profiler_;
@@ -201,6 +213,9 @@ class LITE_API RuntimeProgram {
     if (instructions_.empty()) {
       LOG(FATAL) << "no instructions";
     }
+    for (auto& inst : instructions_[kRootBlockIdx]) {
+      inst.set_tracer(&tracer_);
+    }
 #ifdef LITE_WITH_PROFILE
     set_profiler();
 #endif
@@ -217,9 +232,38 @@ class LITE_API RuntimeProgram {
 
   void Run();
 
+  // Pack the activations of the main block into one pre-allocated arena per
+  // target. The plan is made with the real tensor sizes after the first run,
+  // and is made again once any tensor outgrows its slice.
+  void set_memory_arena(bool x) { memory_arena_enabled_ = x; }
+  bool memory_arena() const { return memory_arena_enabled_; }
+
+  // Run the program once per shape bucket with the inputs filled with zeros
+  // of their data types in `program_desc`. Afterwards the output shapes of
+  // all of the buckets are kept by the ops, and the activations are
+  // allocated, or planned in the memory arena, for the largest bucket, so
+  // switching between the buckets neither infers shapes nor allocates.
+  // NOTE: A kernel keeps the state of the last shape it ran with, so it is
+  // still re-initialized by ReInitWhenNeeded on a switch, and so is an op
+  // whose InferShape updates its param, e.g. with the SAME paddings.
+  void PrepareShapeBuckets(
+      const cpp::ProgramDesc& program_desc,
+      const std::vector<std::string>& input_names,
+      const std::vector<lite_api::InputShapeBucket>& buckets);
+
+  // Run the independent instructions of the main block concurrently with at
+  // most `threads` workers, see InterOpExecutor. It falls back to the serial
+  // run if `threads` <= 1 or the instructions are not supported.
+  void set_inter_op_threads(int threads);
+  int inter_op_threads() const { return inter_op_threads_; }
+
   void set_exec_scope(Scope* x) { exec_scope_ = x; }
   Scope* exec_scope() { return exec_scope_; }
 
+  // The tracer of the instructions of the main block, it is disabled by
+  // default.
+  profile::Tracer* tracer() { return &tracer_; }
+
   const std::vector<Instruction>& instructions(
       int block_idx = kRootBlockIdx) const {
     return instructions_[block_idx];
@@ -238,8 +282,20 @@ class LITE_API RuntimeProgram {
 
  private:
   RuntimeProgram(const RuntimeProgram&) = delete;
+  // Collect the lifetime and size of the activations, and bind them to the
+  // memory arenas.
+  void PlanMemoryArena();
+
   std::vector<std::vector<Instruction>> instructions_;
   Scope* exec_scope_{};
+  bool memory_arena_enabled_{false};
+  bool memory_arena_planned_{false};
+  std::vector<std::unique_ptr<MemoryArena>> memory_arenas_;
+  // The largest memory size of the activations over the shape buckets.
+  std::map<std::string, size_t> reserved_memory_sizes_;
+  int inter_op_threads_{1};
+  std::unique_ptr<InterOpExecutor> inter_op_executor_;
+  profile::Tracer tracer_;
 
 #ifdef LITE_WITH_PROFILE
   profile::Profiler profiler_;
@@ -0,0 +1,162 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "lite/core/program.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+
+struct AddOneParam : operators::ParamBase {
+  const Tensor* x{};
+  Tensor* out{};
+  const std::vector<const Tensor*>* input_tensor_ptrs() override {
+    if (!input_tensor_ptrs_cache_) {
+      input_tensor_ptrs_cache_.reset(new std::vector<const Tensor*>({x}));
+    }
+    return input_tensor_ptrs_cache_.get();
+  }
+  std::vector<Tensor*>* output_tensor_ptrs() override {
+    if (!output_tensor_ptrs_cache_) {
+      output_tensor_ptrs_cache_.reset(new std::vector<Tensor*>({out}));
+    }
+    return output_tensor_ptrs_cache_.get();
+  }
+};
+
+// out = x + 1, and counts the calls of InferShapeImpl.
+class AddOneOp : public OpLite {
+ public:
+  explicit AddOneOp(AddOneParam* param) : OpLite("add_one"), param_(param) {
+    AttachParam(param);
+  }
+
+  bool InferShapeImpl() const override {
+    num_infer_shape_++;
+    param_->out->Resize(param_->x->dims());
+    return true;
+  }
+  bool AttachImpl(const cpp::OpDesc& opdesc, lite::Scope* scope) override {
+    return true;
+  }
+  void AttachKernel(KernelBase* kernel) override { kernel->SetParam(*param_); }
+  std::string DebugString() const override { return "add_one"; }
+
+  int num_infer_shape() const { return num_infer_shape_; }
+
+ private:
+  AddOneParam* param_{};
+  mutable int num_infer_shape_{0};
+};
+
+// Keeps the state of the last shape, as the kernels re-packing their weights
+// or re-tuning in ReInitWhenNeeded do.
+class AddOneCompute : public KernelLite<TARGET(kHost), PRECISION(kFloat)> {
+ public:
+  void ReInitWhenNeeded() override {
+    auto& param = Param<AddOneParam>();
+    if (param.x->dims() != last_dims_) {
+      last_dims_ = param.x->dims();
+      num_reinit_++;
+    }
+  }
+
+  void Run() override {
+    auto& param = Param<AddOneParam>();
+    const float* x = param.x->data<float>();
+    float* out = param.out->mutable_data<float>();
+    for (int64_t i = 0; i < param.x->numel(); i++) {
+      out[i] = x[i] + 1.f;
+    }
+  }
+
+  int num_reinit() const { return num_reinit_; }
+
+ private:
+  DDim last_dims_;
+  int num_reinit_{0};
+};
+
+TEST(RuntimeProgram, shape_buckets) {
+  Scope scope;
+  auto* x = scope.Var("x")->GetMutable<Tensor>();
+  auto* y = scope.Var("y")->GetMutable<Tensor>();
+  auto* z = scope.Var("z")->GetMutable<Tensor>();
+  AddOneParam params[2];
+  params[0].x = x;
+  params[0].out = y;
+  params[1].x = y;
+  params[1].out = z;
+
+  std::vector<std::vector<Instruction>> insts(1);
+  std::vector<AddOneOp*> ops;
+  std::vector<AddOneCompute*> kernels;
+  for (auto& param : params) {
+    std::shared_ptr<AddOneOp> op(new AddOneOp(&param));
+    std::unique_ptr<AddOneCompute> kernel(new AddOneCompute());
+    op->AttachKernel(kernel.get());
+    ops.push_back(op.get());
+    kernels.push_back(kernel.get());
+    insts[0].emplace_back(op, std::move(kernel));
+  }
+  RuntimeProgram program(std::move(insts));
+  program.set_exec_scope(&scope);
+
+  cpp::ProgramDesc program_desc;
+  auto* block = program_desc.AddBlock<cpp::BlockDesc>();
+  auto* var = block->AddVar<cpp::VarDesc>();
+  var->SetName("x");
+  var->SetType(VarDescAPI::Type::LOD_TENSOR);
+  var->SetDataType(VarDescAPI::Type::FP32);
+  std::vector<lite_api::InputShapeBucket> buckets(2);
+  buckets[0].shapes = {{1, 4}};
+  buckets[1].shapes = {{3, 4}};
+  program.PrepareShapeBuckets(program_desc, {"x"}, buckets);
+  for (int i = 0; i < 2; i++) {
+    EXPECT_EQ(ops[i]->num_infer_shape(), 2);
+    EXPECT_EQ(kernels[i]->num_reinit(), 2);
+  }
+
+  const void* z_data = z->raw_data();
+  int num_switches = 0;
+  int64_t last_batch = 3;
+  for (int64_t batch : {1, 3, 3, 1}) {
+    x->Resize({batch, 4});
+    float* x_data = x->mutable_data<float>();
+    for (int64_t i = 0; i < x->numel(); i++) {
+      x_data[i] = i;
+    }
+    program.Run();
+    if (batch != last_batch) num_switches++;
+    last_batch = batch;
+
+    ASSERT_EQ(z->dims(), DDim({batch, 4}));
+    for (int64_t i = 0; i < z->numel(); i++) {
+      EXPECT_EQ(z->data<float>()[i], i + 2.f);
+    }
+    // Switching between the buckets neither infers the shapes nor allocates,
+    // while the kernels keep the state of one shape and are re-initialized.
+    EXPECT_EQ(z->raw_data(), z_data);
+    for (int i = 0; i < 2; i++) {
+      EXPECT_EQ(ops[i]->num_infer_shape(), 2);
+      EXPECT_EQ(kernels[i]->num_reinit(), 2 + num_switches);
+    }
+  }
+}
+
+}  // namespace lite
+}  // namespace paddle
@@ -28,6 +28,7 @@
 #include <vector>
 #include "lite/core/memory.h"
 #include "lite/utils/replace_stl/stream.h"
+#include "lite/utils/small_vector.h"
 
 namespace paddle {
 namespace lite {
@@ -41,6 +42,9 @@ using Tensor = lite::TensorLite;
 class DDimLite {
  public:
   using value_type = int64_t;
+  // The dims of up to 8 dimensions are stored inline, so the shapes can be
+  // copied and resized without allocating on the heap.
+  using data_type = SmallVector<value_type, 8>;
 
   DDimLite() = default;
 
@@ -48,7 +52,9 @@ class DDimLite {
   // DDimLite(std::initializer_list<value_type> init_list) :
   // DDimLite(std::vector<value_type>(init_list)) {}
 
-  void ConstructFrom(const std::vector<value_type> &x) { data_ = x; }
+  void ConstructFrom(const std::vector<value_type> &x) {
+    data_.assign(x.begin(), x.end());
+  }
 
   value_type operator[](int offset) const { return data_[offset]; }
   value_type &operator[](int offset) { return data_[offset]; }
@@ -59,14 +65,17 @@ class DDimLite {
 
   value_type production() const;
 
-  const std::vector<value_type> &data() const { return data_; }
+  const data_type &data() const { return data_; }
   value_type count(int start, int end) const;
 
   DDimLite Slice(int start, int end) const;
 
   DDimLite Flatten2D(int col) const {
-    return DDimLite(std::vector<value_type>(
-        {Slice(0, col).production(), Slice(col, size()).production()}));
+    DDimLite res;
+    res.data_.resize(2);
+    res.data_[0] = count(0, col);
+    res.data_[1] = count(col, size());
+    return res;
   }
 
   std::string repr() const;
@@ -93,7 +102,7 @@ class DDimLite {
   }
 
  private:
-  std::vector<value_type> data_;
+  data_type data_;
 };
 
 using LoD = std::vector<std::vector<uint64_t>>;
@@ -196,6 +205,9 @@ class TensorLite {
 
   bool IsInitialized() const { return buffer_->data(); }
 
+  // Whether the buffer is also referred by other tensors.
+  bool IsBufferShared() const { return buffer_.use_count() > 1; }
+
   // Other share data to this.
   void ShareDataWith(const TensorLite &other);
 
@@ -0,0 +1,95 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/thread_pool.h"
+#include <utility>
+#include "lite/utils/cp_logging.h"
+
+namespace paddle {
+namespace lite {
+
+ThreadPool::ThreadPool(int num_threads) {
+  CHECK_GT(num_threads, 0);
+  for (int i = 0; i < num_threads; i++) {
+    queues_.emplace_back(new TaskQueue);
+  }
+  for (int i = 0; i < num_threads; i++) {
+    workers_.emplace_back(&ThreadPool::WorkerLoop, this, i);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cond_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+void ThreadPool::Submit(Task task, int worker_id) {
+  if (worker_id < 0 || worker_id >= size()) {
+    worker_id = next_queue_.fetch_add(1) % queues_.size();
+  }
+  {
+    auto& queue = queues_[worker_id];
+    std::lock_guard<std::mutex> lock(queue->mutex);
+    queue->tasks.emplace_back(std::move(task));
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++num_pending_;
+  }
+  cond_.notify_one();
+}
+
+bool ThreadPool::Pop(int worker_id, Task* task) {
+  int num_queues = size();
+  for (int i = 0; i < num_queues; i++) {
+    auto& queue = queues_[(worker_id + i) % num_queues];
+    std::lock_guard<std::mutex> lock(queue->mutex);
+    if (queue->tasks.empty()) continue;
+    if (i == 0) {
+      *task = std::move(queue->tasks.back());
+      queue->tasks.pop_back();
+    } else {
+      *task = std::move(queue->tasks.front());
+      queue->tasks.pop_front();
+    }
+    return true;
+  }
+  return false;
+}
+
+void ThreadPool::WorkerLoop(int worker_id) {
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cond_.wait(lock, [this] { return stop_ || num_pending_ > 0; });
+      if (stop_ && num_pending_ == 0) return;
+      // Reserve one task, it's pushed to a queue before being counted.
+      --num_pending_;
+    }
+    Task task;
+    while (!Pop(worker_id, &task)) {
+      std::this_thread::yield();
+    }
+    task(worker_id);
+  }
+}
+
+}  // namespace lite
+}  // namespace paddle
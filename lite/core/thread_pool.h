@@ -0,0 +1,73 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+
+namespace paddle {
+namespace lite {
+
+/*
+ * ThreadPool keeps one task queue per worker. A worker runs the tasks of its
+ * own queue in LIFO order, and steals the oldest tasks from the queues of the
+ * other workers when its own queue is empty, so that a task submitted by a
+ * worker is preferably run by the same worker while its data is still hot.
+ */
+class ThreadPool {
+ public:
+  // The argument of the task is the id of the worker which runs it.
+  using Task = std::function<void(int)>;
+
+  explicit ThreadPool(int num_threads);
+  ~ThreadPool();
+
+  // Push the task to the queue of the worker `worker_id`, the queues are
+  // picked in round-robin if the id is negative.
+  void Submit(Task task, int worker_id = -1);
+
+  int size() const { return static_cast<int>(workers_.size()); }
+
+ private:
+  struct TaskQueue {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  void WorkerLoop(int worker_id);
+  // Pop a task from the own queue, or steal one from the others.
+  bool Pop(int worker_id, Task* task);
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  std::vector<std::unique_ptr<TaskQueue>> queues_;
+  std::vector<std::thread> workers_;
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  // The number of tasks which are submitted but not reserved by a worker.
+  int num_pending_{0};
+  std::atomic<unsigned> next_queue_{0};
+  bool stop_{false};
+};
+
+}  // namespace lite
+}  // namespace paddle
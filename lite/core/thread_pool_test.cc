@@ -0,0 +1,61 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/thread_pool.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <mutex>               // NOLINT
+
+namespace paddle {
+namespace lite {
+
+TEST(thread_pool, submit) {
+  const int num_tasks = 1000;
+  std::atomic<int> sum{0};
+  std::atomic<int> num_finished{0};
+  std::mutex mutex;
+  std::condition_variable cond;
+  ThreadPool pool(4);
+  ASSERT_EQ(pool.size(), 4);
+  for (int i = 0; i < num_tasks; i++) {
+    // Half of the tasks submit a child task to the same worker.
+    pool.Submit([&, i](int worker_id) {
+      EXPECT_GE(worker_id, 0);
+      EXPECT_LT(worker_id, 4);
+      sum += i;
+      if (i % 2 == 0) {
+        pool.Submit(
+            [&](int) {
+              sum += 1;
+              if (++num_finished == num_tasks * 3 / 2) {
+                std::lock_guard<std::mutex> lock(mutex);
+                cond.notify_all();
+              }
+            },
+            worker_id);
+      }
+      if (++num_finished == num_tasks * 3 / 2) {
+        std::lock_guard<std::mutex> lock(mutex);
+        cond.notify_all();
+      }
+    });
+  }
+  std::unique_lock<std::mutex> lock(mutex);
+  cond.wait(lock, [&] { return num_finished == num_tasks * 3 / 2; });
+  EXPECT_EQ(sum, num_tasks * (num_tasks - 1) / 2 + num_tasks / 2);
+}
+
+}  // namespace lite
+}  // namespace paddle
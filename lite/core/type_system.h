@@ -188,12 +188,25 @@ static bool TargetCompatibleTo(const Type& a, const Type& b) {
   return true;
 }
 
+// The kernels taking any layout assume the plain order of the elements, so
+// the blocked layouts are only compatible with themselves.
+static bool IsBlockedLayout(DataLayoutType x) {
+  return x == DATALAYOUT(kNCHWc8) || x == DATALAYOUT(kNCHWc16);
+}
 static bool DataLayoutCompatibleTo(const Type& a, const Type& b) {
+  if (!a.IsVoid() && (IsBlockedLayout(a.layout()) ||
+                      IsBlockedLayout(b.layout()))) {
+    return a.layout() == b.layout();
+  }
   return a.IsVoid() ||                  //
          ((a.layout() == b.layout() ||  //
            b.layout() == DATALAYOUT(kAny)));
 }
 static bool DataLayoutCompatible(const Type& a, const Type& b) {
+  if (!a.IsVoid() && !b.IsVoid() &&
+      (IsBlockedLayout(a.layout()) || IsBlockedLayout(b.layout()))) {
+    return a.layout() == b.layout();
+  }
   return a.IsVoid() || b.IsVoid() ||    //
          ((a.layout() == b.layout() ||  //
            b.layout() == DATALAYOUT(kAny) ||
@@ -43,6 +43,7 @@ class WorkSpace {
 
   // Allocate a memory buffer.
   core::byte_t* Alloc(size_t size) {
+    MemoryKindGuard guard(MemoryKind::kWorkspace);
     buffer_.ResetLazy(target_, cursor_ + size);
     auto* data = static_cast<core::byte_t*>(buffer_.data()) + cursor_;
     cursor_ += size;
@@ -34,10 +34,17 @@ std::vector<size_t> stride_numel(const DDim& ddim) {
   return strides;
 }
 
+// Concat through `slices` if it is not null, the inputs are bound to their
+// slices of the output.
 template <typename T>
 void ConcatFunc(const std::vector<lite::Tensor*> inputs,
                 int axis,
-                lite::Tensor* out) {
+                lite::Tensor* out,
+                SliceArena* slices) {
+  if (slices) {
+    slices->Concat<T>(inputs, out);
+    return;
+  }
   // Sometimes direct copies will be faster, this maybe need deeply analysis.
   if (axis == 0 && inputs.size() < 10) {
     size_t output_offset = 0;
@@ -83,15 +90,25 @@ void ConcatCompute::Run() {
     }
   }
 
+  // The inputs are the consecutive slices of the output if the dims before
+  // the axis are all 1, their producers write there in place.
+  SliceArena* slices = nullptr;
+  if (param.inplace && inputs[0]->dims().count(0, axis) == 1 &&
+      out->numel() > 0) {
+    slices = &slices_;
+  } else {
+    // The inputs may live in the chunk of the output.
+    slices_.Unbind(out);
+  }
   switch (type) {
     case PRECISION(kFloat):
-      ConcatFunc<float>(inputs, axis, out);
+      ConcatFunc<float>(inputs, axis, out, slices);
       break;
     case PRECISION(kInt32):
-      ConcatFunc<int32_t>(inputs, axis, out);
+      ConcatFunc<int32_t>(inputs, axis, out, slices);
       break;
     case PRECISION(kInt64):
-      ConcatFunc<int64_t>(inputs, axis, out);
+      ConcatFunc<int64_t>(inputs, axis, out, slices);
       break;
     default:
       LOG(FATAL) << "Concat does not implement for the "
@@ -15,6 +15,7 @@
 #pragma once
 #include <algorithm>
 #include "lite/core/kernel.h"
+#include "lite/core/memory_arena.h"
 #include "lite/operators/concat_op.h"
 
 namespace paddle {
@@ -29,6 +30,9 @@ class ConcatCompute : public KernelLite<TARGET(kARM), PRECISION(kAny)> {
   void Run() override;
 
   virtual ~ConcatCompute() = default;
+
+ private:
+  SliceArena slices_{TARGET(kARM)};
 };
 
 }  // namespace arm
@@ -13,7 +13,10 @@
 // limitations under the License.
 
 #include "lite/kernels/arm/conv_compute.h"
+#include <sstream>
 #include <utility>
+#include <vector>
+#include "lite/core/kernel_tuner.h"
 #include "lite/core/op_registry.h"
 #include "lite/core/type_system.h"
 #include "lite/kernels/arm/conv_depthwise.h"
@@ -26,6 +29,74 @@ namespace lite {
 namespace kernels {
 namespace arm {
 
+enum class ConvImplType { kDepthwise, kWinograd, kDirect, kGemmLike };
+
+template <PrecisionType Ptype, PrecisionType OutType>
+static KernelLite<TARGET(kARM), Ptype>* NewConvImpl(ConvImplType type) {
+  switch (type) {
+    case ConvImplType::kDepthwise:
+      return new DepthwiseConv<Ptype, OutType>;
+    case ConvImplType::kWinograd:
+      return new WinogradConv<Ptype, OutType>;
+    case ConvImplType::kDirect:
+      return new DirectConv<Ptype, OutType>;
+    default:
+      return new GemmLikeConv<Ptype, OutType>;
+  }
+}
+
+// Create and prepare the impl of the conv. The first of the eligible impls
+// `candidates` is the pick of the heuristics, they are all timed instead if
+// the kernel tuning is enabled. Every impl is prepared on its own copy of the
+// param, as PrepareForRun of the int8 impls rescales the param in place, e.g.
+// the relu6 clip by the output scale.
+template <PrecisionType Ptype, PrecisionType OutType>
+static KernelLite<TARGET(kARM), Ptype>* PrepareConvImpl(
+    const operators::ConvParam& param,
+    const std::vector<ConvImplType>& candidates,
+    std::unique_ptr<KernelContext>* ctx) {
+  using impl_t = KernelLite<TARGET(kARM), Ptype>;
+  int index = 0;
+  std::vector<std::unique_ptr<impl_t>> impls(candidates.size());
+  auto& tuner = KernelTuner::Global();
+  if (candidates.size() > 1 && tuner.enabled()) {
+    const auto& x_dims = param.x->dims();
+    const auto& w_dims = param.filter->dims();
+    const auto& paddings = *param.paddings;
+    const auto& dilations = *param.dilations;
+    std::ostringstream key;
+    key << "arm_conv_" << PrecisionToStr(Ptype) << "_"
+        << PrecisionToStr(OutType) << "|t"
+        << (*ctx)->As<ARMContext>().threads() << "|" << x_dims[0] << ","
+        << x_dims[1] << "," << x_dims[2] << "," << x_dims[3] << ","
+        << w_dims[0] << "," << w_dims[2] << "," << w_dims[3] << ","
+        << param.strides[0] << "," << param.strides[1] << "," << paddings[0]
+        << "," << paddings[1] << "," << paddings[2] << "," << paddings[3]
+        << "," << dilations[0] << "," << dilations[1] << "," << param.groups;
+    index = tuner.Select(key.str(), candidates.size(), [&](int i) {
+      if (!impls[i]) {
+        operators::ConvParam impl_param = param;
+        impls[i].reset(NewConvImpl<Ptype, OutType>(candidates[i]));
+        impls[i]->SetContext(
+            ContextScheduler::Global().NewContext(TARGET(kARM)));
+        impls[i]->SetParam(impl_param);
+        impls[i]->PrepareForRun();
+      }
+      impls[i]->ReInitWhenNeeded();
+      impls[i]->Run();
+    });
+  }
+  if (impls[index]) {
+    return impls[index].release();
+  }
+  operators::ConvParam impl_param = param;
+  impl_t* impl = NewConvImpl<Ptype, OutType>(candidates[index]);
+  impl->SetContext(std::move(*ctx));
+  impl->SetParam(impl_param);
+  impl->PrepareForRun();
+  return impl;
+}
+
 template <>
 void ConvCompute<PRECISION(kFloat), PRECISION(kFloat)>::PrepareForRun() {
   auto& param = this->Param<param_t>();
@@ -62,24 +133,28 @@ void ConvCompute<PRECISION(kFloat), PRECISION(kFloat)>::PrepareForRun() {
   bool flag_dw = flag_dw_3x3 || flag_dw_5x5;
 
   /// select conv impl
+  std::vector<ConvImplType> candidates;
   if (param.groups == ic && ic == oc && ks_equal && no_dilation && flag_dw) {
-    impl_ = new DepthwiseConv<PRECISION(kFloat), PRECISION(kFloat)>;
-    // VLOG(3) << "invoking dw conv";
+    candidates.push_back(ConvImplType::kDepthwise);
   } else if (param.groups == 1 && kw == 3 && stride == 1 && ks_equal &&
              no_dilation) {
-    impl_ = new WinogradConv<PRECISION(kFloat), PRECISION(kFloat)>;
-    // VLOG(3) << "invoking winograd conv";
-  } else if (param.groups == 1 && kw == 3 && stride == 2 &&
-             chin * chout < 4 * hin * win && ks_equal && no_dilation) {
-    impl_ = new DirectConv<PRECISION(kFloat), PRECISION(kFloat)>;
-    // VLOG(3) << "invoking direct conv";
-  } else {
-    impl_ = new GemmLikeConv<PRECISION(kFloat), PRECISION(kFloat)>;
-    // VLOG(3) << "invoking gemm like conv";
+    candidates.push_back(ConvImplType::kWinograd);
+  } else if (param.groups == 1 && kw == 3 && stride == 2 && ks_equal &&
+             no_dilation) {
+    // The direct conv is picked for the small channels by the heuristics,
+    // and is measured anyway by the tuning.
+    if (chin * chout < 4 * hin * win) {
+      candidates.push_back(ConvImplType::kDirect);
+    } else {
+      candidates.push_back(ConvImplType::kGemmLike);
+      candidates.push_back(ConvImplType::kDirect);
+    }
+  }
+  if (candidates.empty() || candidates[0] != ConvImplType::kGemmLike) {
+    candidates.push_back(ConvImplType::kGemmLike);
   }
-  impl_->SetContext(std::move(this->ctx_));
-  impl_->SetParam(param);
-  impl_->PrepareForRun();
+  impl_ = PrepareConvImpl<PRECISION(kFloat), PRECISION(kFloat)>(
+      param, candidates, &this->ctx_);
   is_first_epoch_ = false;
 }
 
@@ -111,25 +186,20 @@ void ConvCompute<PRECISION(kInt8), PRECISION(kFloat)>::PrepareForRun() {
   bool flag_dw_3x3 = (kw == 3 && kh == 3 && (sw == 1 || sw == 2));
   bool flag_dw_5x5 = pads_all_equal && (kw == 5 && (sw == 1 || sw == 2));
   bool flag_dw = flag_dw_3x3 || flag_dw_5x5;
+  std::vector<ConvImplType> candidates;
   if (param.groups == ic && ic == oc && kps_equal && pads_equal &&
       no_dilation && flag_dw) {
-    impl_ = new DepthwiseConv<PRECISION(kInt8), PRECISION(kFloat)>;
-    // VLOG(3) << "Run DepthwiseConv Int8";
+    candidates.push_back(ConvImplType::kDepthwise);
   } else if (param.groups == 1 && kw == 3 && sw == 2 && no_dilation &&
              pads_equal) {
-    impl_ = new DirectConv<PRECISION(kInt8), PRECISION(kFloat)>;
-    // VLOG(3) << "Run DirectConv Int8";
+    candidates.push_back(ConvImplType::kDirect);
   } else if (param.groups == 1 && kw == 3 && sw == 1 && no_dilation &&
              pads_equal) {
-    impl_ = new WinogradConv<PRECISION(kInt8), PRECISION(kFloat)>;
-    // VLOG(3) << "Run WinogradConv Int8";
-  } else {
-    impl_ = new GemmLikeConv<PRECISION(kInt8), PRECISION(kFloat)>;
-    // VLOG(3) << "Run GemmLikeConvInt8";
+    candidates.push_back(ConvImplType::kWinograd);
   }
-  impl_->SetContext(std::move(this->ctx_));
-  impl_->SetParam(param);
-  impl_->PrepareForRun();
+  candidates.push_back(ConvImplType::kGemmLike);
+  impl_ = PrepareConvImpl<PRECISION(kInt8), PRECISION(kFloat)>(
+      param, candidates, &this->ctx_);
   is_first_epoch_ = false;
 }
 
@@ -162,25 +232,20 @@ void ConvCompute<PRECISION(kInt8), PRECISION(kInt8)>::PrepareForRun() {
   bool flag_dw_5x5 = pads_all_equal && (kw == 5 && (sw == 1 || sw == 2));
   bool flag_dw = flag_dw_3x3 || flag_dw_5x5;
 
+  std::vector<ConvImplType> candidates;
   if (param.groups == ic && ic == oc && kps_equal && pads_equal &&
       no_dilation && flag_dw) {
-    impl_ = new DepthwiseConv<PRECISION(kInt8), PRECISION(kInt8)>;
-    // VLOG(3) << "Run DepthwiseConv Int8";
+    candidates.push_back(ConvImplType::kDepthwise);
   } else if (param.groups == 1 && kw == 3 && sw == 2 && no_dilation &&
              pads_equal) {
-    impl_ = new DirectConv<PRECISION(kInt8), PRECISION(kInt8)>;
-    // VLOG(3) << "Run DirectConv Int8";
+    candidates.push_back(ConvImplType::kDirect);
   } else if (param.groups == 1 && kw == 3 && sw == 1 && no_dilation &&
              pads_equal) {
-    impl_ = new WinogradConv<PRECISION(kInt8), PRECISION(kInt8)>;
-    // VLOG(3) << "Run WinogradConv Int8";
-  } else {
-    impl_ = new GemmLikeConv<PRECISION(kInt8), PRECISION(kInt8)>;
-    // VLOG(3) << "Run GemmLikeConvInt8";
+    candidates.push_back(ConvImplType::kWinograd);
   }
-  impl_->SetContext(std::move(this->ctx_));
-  impl_->SetParam(param);
-  impl_->PrepareForRun();
+  candidates.push_back(ConvImplType::kGemmLike);
+  impl_ = PrepareConvImpl<PRECISION(kInt8), PRECISION(kInt8)>(
+      param, candidates, &this->ctx_);
   is_first_epoch_ = false;
 }
 
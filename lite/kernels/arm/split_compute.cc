@@ -24,17 +24,34 @@ namespace arm {
 template <typename T, PrecisionType PType>
 void SplitCompute<T, PType>::Run() {
   auto& param = this->template Param<operators::SplitParam>();
-  const T* din = param.x->template data<T>();
   auto& dout = param.output;
   auto in_dim = param.x->dims();
+  for (auto out : dout) {
+    out->set_lod(param.x->lod());
+  }
+  int axis = param.axis;
+  if (param.axis_tensor != nullptr) {
+    axis = param.axis_tensor->template data<int>()[0];
+  }
+  if (axis < 0) {
+    axis += in_dim.size();
+  }
+  // The outputs are the consecutive slices of the input if the dims before
+  // the axis are all 1, their consumers read there in place.
+  if (param.inplace && in_dim.count(0, axis) == 1 && in_dim.production() > 0) {
+    slices_.template Split<T>(param.x, dout);
+    return;
+  }
+  for (auto out : dout) {
+    // The input may live in the chunk of the outputs.
+    slices_.Unbind(out);
+  }
+  const T* din = param.x->template data<T>();
   std::vector<int> in_strides(in_dim.size());
   in_strides[in_dim.size() - 1] = in_dim[in_dim.size() - 1];
   for (int i = in_dim.size() - 2; i >= 0; --i) {
     in_strides[i] = in_strides[i + 1] * in_dim[i];
   }
-  for (auto out : dout) {
-    out->set_lod(param.x->lod());
-  }
   lite::arm::math::split(din, dout, param.axis, in_strides);
 }
 
@@ -15,6 +15,7 @@
 #pragma once
 #include <algorithm>
 #include "lite/core/kernel.h"
+#include "lite/core/memory_arena.h"
 #include "lite/core/op_registry.h"
 
 namespace paddle {
@@ -28,6 +29,9 @@ class SplitCompute : public KernelLite<TARGET(kARM), PType> {
   void Run() override;
 
   virtual ~SplitCompute() = default;
+
+ private:
+  SliceArena slices_{TARGET(kARM)};
 };
 
 }  // namespace arm
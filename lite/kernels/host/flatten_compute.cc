@@ -26,7 +26,11 @@ void FlattenContiguousRangeCompute::Run() {
   auto out = param.out;
   auto out_dims = out->dims();
   auto out_lod = out->lod();
-  out->CopyDataFrom(*x);
+  if (param.inplace) {
+    out->ShareDataWith(*x);
+  } else {
+    out->CopyDataFrom(*x);
+  }
   out->Resize(out_dims);
   out->set_lod(out_lod);
 }
@@ -17,59 +17,13 @@
 #include <map>
 #include <utility>
 #include <vector>
+#include "lite/backends/host/math/nms.h"
 
 namespace paddle {
 namespace lite {
 namespace kernels {
 namespace host {
 
-template <class T>
-static T BBoxArea(const T* box, const bool normalized) {
-  if (box[2] < box[0] || box[3] < box[1]) {
-    // If coordinate values are is invalid
-    // (e.g. xmax < xmin or ymax < ymin), return 0.
-    return static_cast<T>(0.);
-  } else {
-    const T w = box[2] - box[0];
-    const T h = box[3] - box[1];
-    if (normalized) {
-      return w * h;
-    } else {
-      // If coordinate values are not within range [0, 1].
-      return (w + 1) * (h + 1);
-    }
-  }
-}
-
-template <class T>
-static T JaccardOverlap(const T* box1, const T* box2, const bool normalized) {
-  if (box2[0] > box1[2] || box2[2] < box1[0] || box2[1] > box1[3] ||
-      box2[3] < box1[1]) {
-    return static_cast<T>(0.);
-  } else {
-    const T inter_xmin = (std::max)(box1[0], box2[0]);
-    const T inter_ymin = (std::max)(box1[1], box2[1]);
-    const T inter_xmax = (std::min)(box1[2], box2[2]);
-    const T inter_ymax = (std::min)(box1[3], box2[3]);
-    T norm = normalized ? static_cast<T>(0.) : static_cast<T>(1.);
-    T inter_w = inter_xmax - inter_xmin + norm;
-    T inter_h = inter_ymax - inter_ymin + norm;
-    const T inter_area = inter_w * inter_h;
-    const T bbox1_area = BBoxArea<T>(box1, normalized);
-    const T bbox2_area = BBoxArea<T>(box2, normalized);
-    return inter_area / (bbox1_area + bbox2_area - inter_area);
-  }
-}
-
-template <class T>
-T PolyIoU(const T* box1,
-          const T* box2,
-          const size_t box_size,
-          const bool normalized) {
-  LOG(FATAL) << "PolyIoU not implement.";
-  return *box1;
-}
-
 template <typename T, bool gaussian>
 struct decay_score;
 
@@ -87,162 +41,112 @@ struct decay_score<T, false> {
   }
 };
 
-template <typename T, bool gaussian>
-void NMSMatrix(const Tensor& bbox,
-               const Tensor& scores,
-               const T score_threshold,
-               const T post_threshold,
+template <bool gaussian>
+void NMSMatrix(const float* bboxes,
+               const int64_t box_size,
+               const float* scores,
+               const int64_t num_boxes,
+               const float score_threshold,
+               const float post_threshold,
                const float sigma,
                const int64_t top_k,
                const bool normalized,
                std::vector<int>* selected_indices,
-               std::vector<T>* decayed_scores) {
-  int64_t num_boxes = bbox.dims()[0];
-  int64_t box_size = bbox.dims()[1];
-
-  auto score_ptr = scores.data<T>();
-  auto bbox_ptr = bbox.data<T>();
-
-  std::vector<int32_t> perm(num_boxes);
-  std::iota(perm.begin(), perm.end(), 0);
-  auto end = std::remove_if(
-      perm.begin(), perm.end(), [&score_ptr, score_threshold](int32_t idx) {
-        return score_ptr[idx] <= score_threshold;
-      });
-  auto sort_fn = [&score_ptr](int32_t lhs, int32_t rhs) {
-    return score_ptr[lhs] > score_ptr[rhs];
-  };
-
-  int64_t num_pre = std::distance(perm.begin(), end);
+               std::vector<float>* decayed_scores) {
+  std::vector<std::pair<float, int>> sorted_indices;
+  lite::host::math::GetTopKScoreIndex(
+      scores, num_boxes, 1, score_threshold, top_k, &sorted_indices);
+  int64_t num_pre = sorted_indices.size();
   if (num_pre <= 0) {
     return;
   }
-  if (top_k > -1 && num_pre > top_k) {
-    num_pre = top_k;
-  }
-  std::partial_sort(perm.begin(), perm.begin() + num_pre, end, sort_fn);
 
-  std::vector<T> iou_matrix((num_pre * (num_pre - 1)) >> 1);
-  std::vector<T> iou_max(num_pre);
+  // The IoUs of the i-th box against the boxes before it are one row of the
+  // lower triangular matrix.
+  lite::host::math::BoxesSoA sorted_boxes;
+  sorted_boxes.Reserve(num_pre);
+  for (auto& pair : sorted_indices) {
+    const float* box = bboxes + pair.second * box_size;
+    sorted_boxes.Push(box, lite::host::math::BBoxArea(box, normalized));
+  }
+  std::vector<float> iou_matrix((num_pre * (num_pre - 1)) >> 1);
+  std::vector<float> iou_max(num_pre);
 
   iou_max[0] = 0.;
   for (int64_t i = 1; i < num_pre; i++) {
-    T max_iou = 0.;
-    auto idx_a = perm[i];
+    float* ious = iou_matrix.data() + i * (i - 1) / 2;
+    lite::host::math::BatchJaccardOverlap(
+        bboxes + sorted_indices[i].second * box_size,
+        sorted_boxes.area[i],
+        sorted_boxes,
+        0,
+        i,
+        normalized,
+        ious);
+    float max_iou = 0.;
     for (int64_t j = 0; j < i; j++) {
-      auto idx_b = perm[j];
-      auto iou = JaccardOverlap<T>(
-          bbox_ptr + idx_a * box_size, bbox_ptr + idx_b * box_size, normalized);
-      max_iou = (std::max)(max_iou, iou);
-      iou_matrix[i * (i - 1) / 2 + j] = iou;
+      max_iou = (std::max)(max_iou, ious[j]);
     }
     iou_max[i] = max_iou;
   }
 
-  if (score_ptr[perm[0]] > post_threshold) {
-    selected_indices->push_back(perm[0]);
-    decayed_scores->push_back(score_ptr[perm[0]]);
+  if (sorted_indices[0].first > post_threshold) {
+    selected_indices->push_back(sorted_indices[0].second);
+    decayed_scores->push_back(sorted_indices[0].first);
   }
 
-  decay_score<T, gaussian> decay_fn;
+  decay_score<float, gaussian> decay_fn;
   for (int64_t i = 1; i < num_pre; i++) {
-    T min_decay = 1.;
+    float min_decay = 1.;
     for (int64_t j = 0; j < i; j++) {
       auto max_iou = iou_max[j];
       auto iou = iou_matrix[i * (i - 1) / 2 + j];
       auto decay = decay_fn(iou, max_iou, sigma);
       min_decay = (std::min)(min_decay, decay);
     }
-    auto ds = min_decay * score_ptr[perm[i]];
+    auto ds = min_decay * sorted_indices[i].first;
     if (ds <= post_threshold) continue;
-    selected_indices->push_back(perm[i]);
+    selected_indices->push_back(sorted_indices[i].second);
     decayed_scores->push_back(ds);
   }
 }
 
-template <typename T>
-size_t MultiClassMatrixNMS(const Tensor& scores,
-                           const Tensor& bboxes,
-                           std::vector<T>* out,
+// Gather the detections of the classes of one image, and keep the top k of
+// them.
+size_t MultiClassMatrixNMS(const float* bboxes,
+                           const int64_t box_size,
+                           const std::vector<int>* class_indices,
+                           const std::vector<float>* class_scores,
+                           const int64_t class_num,
+                           std::vector<float>* out,
                            std::vector<int>* indices,
                            int start,
-                           int64_t background_label,
-                           int64_t nms_top_k,
-                           int64_t keep_top_k,
-                           bool normalized,
-                           T score_threshold,
-                           T post_threshold,
-                           bool use_gaussian,
-                           float gaussian_sigma) {
-  std::vector<int> all_indices;
-  std::vector<T> all_scores;
-  std::vector<T> all_classes;
-  all_indices.reserve(scores.numel());
-  all_scores.reserve(scores.numel());
-  all_classes.reserve(scores.numel());
-
-  size_t num_det = 0;
-  auto class_num = scores.dims()[0];
-  Tensor score_slice;
+                           int64_t keep_top_k) {
+  std::vector<std::pair<float, int>> score_index_pairs;
+  std::vector<std::pair<int, int>> class_index_pairs;
   for (int64_t c = 0; c < class_num; ++c) {
-    if (c == background_label) continue;
-    score_slice = scores.Slice<float>(c, c + 1);
-    if (use_gaussian) {
-      NMSMatrix<T, true>(bboxes,
-                         score_slice,
-                         score_threshold,
-                         post_threshold,
-                         gaussian_sigma,
-                         nms_top_k,
-                         normalized,
-                         &all_indices,
-                         &all_scores);
-    } else {
-      NMSMatrix<T, false>(bboxes,
-                          score_slice,
-                          score_threshold,
-                          post_threshold,
-                          gaussian_sigma,
-                          nms_top_k,
-                          normalized,
-                          &all_indices,
-                          &all_scores);
-    }
-    for (size_t i = 0; i < all_indices.size() - num_det; i++) {
-      all_classes.push_back(static_cast<T>(c));
+    for (size_t i = 0; i < class_indices[c].size(); ++i) {
+      score_index_pairs.emplace_back(class_scores[c][i],
+                                     class_index_pairs.size());
+      class_index_pairs.emplace_back(c, class_indices[c][i]);
     }
-    num_det = all_indices.size();
   }
-
+  size_t num_det = score_index_pairs.size();
   if (num_det <= 0) {
     return num_det;
   }
 
-  if (keep_top_k > -1) {
-    auto k = static_cast<size_t>(keep_top_k);
-    if (num_det > k) num_det = k;
-  }
-
-  std::vector<int32_t> perm(all_indices.size());
-  std::iota(perm.begin(), perm.end(), 0);
-
-  std::partial_sort(perm.begin(),
-                    perm.begin() + num_det,
-                    perm.end(),
-                    [&all_scores](int lhs, int rhs) {
-                      return all_scores[lhs] > all_scores[rhs];
-                    });
+  lite::host::math::SortScoreIndexPairs(keep_top_k, &score_index_pairs);
+  num_det = score_index_pairs.size();
 
-  for (size_t i = 0; i < num_det; i++) {
-    auto p = perm[i];
-    auto idx = all_indices[p];
-    auto cls = all_classes[p];
-    auto score = all_scores[p];
-    auto bbox = bboxes.data<T>() + idx * bboxes.dims()[1];
+  for (auto& pair : score_index_pairs) {
+    auto cls = class_index_pairs[pair.second].first;
+    auto idx = class_index_pairs[pair.second].second;
+    auto bbox = bboxes + idx * box_size;
     (*indices).push_back(start + idx);
-    (*out).push_back(cls);
-    (*out).push_back(score);
-    for (int j = 0; j < bboxes.dims()[1]; j++) {
+    (*out).push_back(static_cast<float>(cls));
+    (*out).push_back(pair.first);
+    for (int j = 0; j < box_size; j++) {
       (*out).push_back(bbox[j]);
     }
   }
@@ -268,11 +172,49 @@ void MatrixNmsCompute::Run() {
 
   auto score_dims = scores->dims();
   auto batch_size = score_dims[0];
+  auto class_num = score_dims[1];
   auto num_boxes = score_dims[2];
   auto box_dim = boxes->dims()[2];
   auto out_dim = box_dim + 2;
+  const float* boxes_data = boxes->data<float>();
+  const float* scores_data = scores->data<float>();
+
+  // The classes of all the images are independent.
+  std::vector<std::vector<int>> class_indices(batch_size * class_num);
+  std::vector<std::vector<float>> class_scores(batch_size * class_num);
+  lite::host::math::ParallelFor(batch_size * class_num, [&](int64_t task) {
+    int64_t i = task / class_num;
+    int64_t c = task % class_num;
+    if (c == background_label) return;
+    const float* bboxes = boxes_data + i * num_boxes * box_dim;
+    const float* class_score = scores_data + task * num_boxes;
+    if (use_gaussian) {
+      NMSMatrix<true>(bboxes,
+                      box_dim,
+                      class_score,
+                      num_boxes,
+                      score_threshold,
+                      post_threshold,
+                      gaussian_sigma,
+                      nms_top_k,
+                      normalized,
+                      &class_indices[task],
+                      &class_scores[task]);
+    } else {
+      NMSMatrix<false>(bboxes,
+                       box_dim,
+                       class_score,
+                       num_boxes,
+                       score_threshold,
+                       post_threshold,
+                       gaussian_sigma,
+                       nms_top_k,
+                       normalized,
+                       &class_indices[task],
+                       &class_scores[task]);
+    }
+  });
 
-  Tensor boxes_slice, scores_slice;
   int64_t num_out = 0;
   std::vector<int64_t> offsets = {0};
   std::vector<float> detections;
@@ -280,24 +222,16 @@ void MatrixNmsCompute::Run() {
   detections.reserve(out_dim * num_boxes * batch_size);
   indices.reserve(num_boxes * batch_size);
   for (int i = 0; i < batch_size; ++i) {
-    scores_slice = scores->Slice<float>(i, i + 1);
-    scores_slice.Resize({score_dims[1], score_dims[2]});
-    boxes_slice = boxes->Slice<float>(i, i + 1);
-    boxes_slice.Resize({score_dims[2], box_dim});
-    int start = i * score_dims[2];
-    num_out = MultiClassMatrixNMS(scores_slice,
-                                  boxes_slice,
+    int start = i * num_boxes;
+    num_out = MultiClassMatrixNMS(boxes_data + i * num_boxes * box_dim,
+                                  box_dim,
+                                  class_indices.data() + i * class_num,
+                                  class_scores.data() + i * class_num,
+                                  class_num,
                                   &detections,
                                   &indices,
                                   start,
-                                  background_label,
-                                  nms_top_k,
-                                  keep_top_k,
-                                  normalized,
-                                  score_threshold,
-                                  post_threshold,
-                                  use_gaussian,
-                                  gaussian_sigma);
+                                  keep_top_k);
     offsets.push_back(offsets.back() + num_out);
   }
 
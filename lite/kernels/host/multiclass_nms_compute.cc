@@ -13,89 +13,18 @@
 // limitations under the License.
 
 #include "lite/kernels/host/multiclass_nms_compute.h"
+#include <algorithm>
 #include <map>
 #include <utility>
 #include <vector>
+#include "lite/backends/host/math/nms.h"
 
 namespace paddle {
 namespace lite {
 namespace kernels {
 namespace host {
 
-template <class T>
-bool SortScorePairDescend(const std::pair<float, T>& pair1,
-                          const std::pair<float, T>& pair2) {
-  return pair1.first > pair2.first;
-}
-
-template <class T>
-static void GetMaxScoreIndex(const std::vector<T>& scores,
-                             const T threshold,
-                             int top_k,
-                             std::vector<std::pair<T, int>>* sorted_indices) {
-  for (size_t i = 0; i < scores.size(); ++i) {
-    if (scores[i] > threshold) {
-      sorted_indices->push_back(std::make_pair(scores[i], i));
-    }
-  }
-  // Sort the score pair according to the scores in descending order
-  std::stable_sort(sorted_indices->begin(),
-                   sorted_indices->end(),
-                   SortScorePairDescend<int>);
-  // Keep top_k scores if needed.
-  if (top_k > -1 && top_k < static_cast<int>(sorted_indices->size())) {
-    sorted_indices->resize(top_k);
-  }
-}
-
-template <class T>
-static T BBoxArea(const T* box, const bool normalized) {
-  if (box[2] < box[0] || box[3] < box[1]) {
-    // If coordinate values are is invalid
-    // (e.g. xmax < xmin or ymax < ymin), return 0.
-    return static_cast<T>(0.);
-  } else {
-    const T w = box[2] - box[0];
-    const T h = box[3] - box[1];
-    if (normalized) {
-      return w * h;
-    } else {
-      // If coordinate values are not within range [0, 1].
-      return (w + 1) * (h + 1);
-    }
-  }
-}
-
-template <class T>
-static T JaccardOverlap(const T* box1, const T* box2, const bool normalized) {
-  if (box2[0] > box1[2] || box2[2] < box1[0] || box2[1] > box1[3] ||
-      box2[3] < box1[1]) {
-    return static_cast<T>(0.);
-  } else {
-    const T inter_xmin = (std::max)(box1[0], box2[0]);
-    const T inter_ymin = (std::max)(box1[1], box2[1]);
-    const T inter_xmax = (std::min)(box1[2], box2[2]);
-    const T inter_ymax = (std::min)(box1[3], box2[3]);
-    T norm = normalized ? static_cast<T>(0.) : static_cast<T>(1.);
-    T inter_w = inter_xmax - inter_xmin + norm;
-    T inter_h = inter_ymax - inter_ymin + norm;
-    const T inter_area = inter_w * inter_h;
-    const T bbox1_area = BBoxArea<T>(box1, normalized);
-    const T bbox2_area = BBoxArea<T>(box2, normalized);
-    return inter_area / (bbox1_area + bbox2_area - inter_area);
-  }
-}
-
-template <class T>
-T PolyIoU(const T* box1,
-          const T* box2,
-          const size_t box_size,
-          const bool normalized) {
-  LOG(FATAL) << "PolyIoU not implement.";
-  return *box1;
-}
-
-template <class T>
+template <typename T>
 void SliceOneClass(const Tensor& items,
                    const int class_id,
                    Tensor* one_class_item) {
@@ -117,149 +46,151 @@ void SliceOneClass(const Tensor& items,
   }
 }
 
-template <typename T>
-void NMSFast(const Tensor& bbox,
-             const Tensor& scores,
-             const T score_threshold,
-             const T nms_threshold,
-             const T eta,
+// NMS of one class, the score and the box of the i-th candidate are
+// scores[i * score_stride] and bboxes + i * box_stride.
+void NMSFast(const float* bboxes,
+             const int64_t box_size,
+             const int64_t box_stride,
+             const float* scores,
+             const int64_t score_stride,
+             const int64_t num_boxes,
+             const float score_threshold,
+             const float nms_threshold,
+             const float eta,
              const int64_t top_k,
              std::vector<int>* selected_indices,
              const bool normalized) {
-  // The total boxes for each instance.
-  int64_t num_boxes = bbox.dims()[0];
+  std::vector<std::pair<float, int>> sorted_indices;
+  lite::host::math::GetTopKScoreIndex(scores,
+                                      num_boxes,
+                                      score_stride,
+                                      score_threshold,
+                                      top_k,
+                                      &sorted_indices);
   // 4: [xmin ymin xmax ymax]
+  if (box_size == 4) {
+    lite::host::math::NMSFast(bboxes,
+                              box_stride,
+                              sorted_indices,
+                              nms_threshold,
+                              eta,
+                              normalized,
+                              selected_indices);
+    return;
+  }
   // 8: [x1 y1 x2 y2 x3 y3 x4 y4]
   // 16, 24, or 32: [x1 y1 x2 y2 ...  xn yn], n = 8, 12 or 16
-  int64_t box_size = bbox.dims()[1];
+  // The IoU of the polygons is not implemented, it is only needed once two
+  // candidates are left.
+  if ((box_size == 8 || box_size == 16 || box_size == 24 || box_size == 32) &&
+      sorted_indices.size() > 1) {
+    LOG(FATAL) << "PolyIoU not implemented, box_size: " << box_size;
+  }
+  // The boxes of the other sizes are not suppressed.
+  selected_indices->clear();
+  for (auto& pair : sorted_indices) {
+    selected_indices->push_back(pair.second);
+  }
+}
 
-  std::vector<T> scores_data(num_boxes);
-  std::copy_n(scores.data<T>(), num_boxes, scores_data.begin());
-  std::vector<std::pair<T, int>> sorted_indices;
-  GetMaxScoreIndex(scores_data, score_threshold, top_k, &sorted_indices);
+// The scores of the class c of the i-th box are at
+// scores + c * class_offset + i * score_stride, and the box is at
+// bboxes + c * box_class_offset + i * box_stride.
+struct ClassLayout {
+  ClassLayout(const Tensor& scores, const Tensor& bboxes, int scores_size) {
+    bool batched = scores_size == 3;
+    class_num = batched ? scores.dims()[0] : scores.dims()[1];
+    num_boxes = batched ? scores.dims()[1] : scores.dims()[0];
+    box_size = bboxes.dims()[bboxes.dims().size() - 1];
+    class_offset = batched ? num_boxes : 1;
+    score_stride = batched ? 1 : class_num;
+    box_class_offset = batched ? 0 : box_size;
+    box_stride = batched ? box_size : class_num * box_size;
+  }
 
-  selected_indices->clear();
-  T adaptive_threshold = nms_threshold;
-  const T* bbox_data = bbox.data<T>();
+  int64_t class_num;
+  int64_t num_boxes;
+  int64_t box_size;
+  int64_t class_offset;
+  int64_t score_stride;
+  int64_t box_class_offset;
+  int64_t box_stride;
+};
 
-  while (sorted_indices.size() != 0) {
-    const int idx = sorted_indices.front().second;
-    bool keep = true;
-    for (size_t k = 0; k < selected_indices->size(); ++k) {
-      if (keep) {
-        const int kept_idx = (*selected_indices)[k];
-        T overlap = T(0.);
-        // 4: [xmin ymin xmax ymax]
-        if (box_size == 4) {
-          overlap = JaccardOverlap<T>(bbox_data + idx * box_size,
-                                      bbox_data + kept_idx * box_size,
-                                      normalized);
-        }
-        // 8: [x1 y1 x2 y2 x3 y3 x4 y4] or 16, 24, 32
-        if (box_size == 8 || box_size == 16 || box_size == 24 ||
-            box_size == 32) {
-          overlap = PolyIoU<T>(bbox_data + idx * box_size,
-                               bbox_data + kept_idx * box_size,
-                               box_size,
-                               normalized);
-        }
-        keep = overlap <= adaptive_threshold;
-      } else {
-        break;
-      }
-    }
-    if (keep) {
-      selected_indices->push_back(idx);
-    }
-    sorted_indices.erase(sorted_indices.begin());
-    if (keep && eta < 1 && adaptive_threshold > 0.5) {
-      adaptive_threshold *= eta;
-    }
+void ClassNMS(const operators::MulticlassNmsParam& param,
+              const Tensor& scores,
+              const Tensor& bboxes,
+              const int scores_size,
+              const int64_t class_id,
+              std::vector<int>* selected_indices) {
+  ClassLayout layout(scores, bboxes, scores_size);
+  NMSFast(bboxes.data<float>() + class_id * layout.box_class_offset,
+          layout.box_size,
+          layout.box_stride,
+          scores.data<float>() + class_id * layout.class_offset,
+          layout.score_stride,
+          layout.num_boxes,
+          param.score_threshold,
+          param.nms_threshold,
+          param.nms_eta,
+          param.nms_top_k,
+          selected_indices,
+          param.normalized);
+  if (scores_size == 2) {
+    std::sort(selected_indices->begin(), selected_indices->end());
   }
 }
 
-template <typename T>
+// Gather the results of ClassNMS of one image, and keep the top k of them.
 void MultiClassNMS(const operators::MulticlassNmsParam& param,
                    const Tensor& scores,
                    const Tensor& bboxes,
                    const int scores_size,
+                   std::vector<int>* class_indices,
                    std::map<int, std::vector<int>>* indices,
                    int* num_nmsed_out) {
   int64_t background_label = param.background_label;
-  int64_t nms_top_k = param.nms_top_k;
   int64_t keep_top_k = param.keep_top_k;
-  bool normalized = param.normalized;
-  T nms_threshold = static_cast<T>(param.nms_threshold);
-  T nms_eta = static_cast<T>(param.nms_eta);
-  T score_threshold = static_cast<T>(param.score_threshold);
+  ClassLayout layout(scores, bboxes, scores_size);
 
   int num_det = 0;
-
-  int64_t class_num = scores_size == 3 ? scores.dims()[0] : scores.dims()[1];
-  Tensor bbox_slice, score_slice;
-  for (int64_t c = 0; c < class_num; ++c) {
+  for (int64_t c = 0; c < layout.class_num; ++c) {
     if (c == background_label) continue;
-    if (scores_size == 3) {
-      score_slice = scores.Slice<T>(c, c + 1);
-      bbox_slice = bboxes;
-    } else {
-      score_slice.Resize({scores.dims()[0], 1});
-      bbox_slice.Resize({scores.dims()[0], 4});
-      SliceOneClass<T>(scores, c, &score_slice);
-      SliceOneClass<T>(bboxes, c, &bbox_slice);
-    }
-    NMSFast(bbox_slice,
-            score_slice,
-            score_threshold,
-            nms_threshold,
-            nms_eta,
-            nms_top_k,
-            &((*indices)[c]),
-            normalized);
-    if (scores_size == 2) {
-      std::stable_sort((*indices)[c].begin(), (*indices)[c].end());
-    }
-    num_det += (*indices)[c].size();
+    num_det += class_indices[c].size();
+    (*indices)[c].swap(class_indices[c]);
   }
 
   *num_nmsed_out = num_det;
-  const T* scores_data = scores.data<T>();
+  const float* scores_data = scores.data<float>();
   if (keep_top_k > -1 && num_det > keep_top_k) {
-    const T* sdata;
-    std::vector<std::pair<float, std::pair<int, int>>> score_index_pairs;
+    // The pairs of (score, order), so the ties are kept in the order of the
+    // labels and the indices.
+    std::vector<std::pair<float, int>> score_index_pairs;
+    std::vector<std::pair<int, int>> label_index_pairs;
+    score_index_pairs.reserve(num_det);
+    label_index_pairs.reserve(num_det);
     for (const auto& it : *indices) {
       int label = it.first;
-      if (scores_size == 3) {
-        sdata = scores_data + label * scores.dims()[1];
-      } else {
-        score_slice.Resize({scores.dims()[0], 1});
-        SliceOneClass<T>(scores, label, &score_slice);
-        sdata = score_slice.data<T>();
-      }
-      const std::vector<int>& label_indices = it.second;
-      for (size_t j = 0; j < label_indices.size(); ++j) {
-        int idx = label_indices[j];
-        score_index_pairs.push_back(
-            std::make_pair(sdata[idx], std::make_pair(label, idx)));
+      const float* sdata = scores_data + label * layout.class_offset;
+      for (int idx : it.second) {
+        score_index_pairs.emplace_back(sdata[idx * layout.score_stride],
+                                       label_index_pairs.size());
+        label_index_pairs.emplace_back(label, idx);
       }
     }
     // Keep top k results per image.
-    std::stable_sort(score_index_pairs.begin(),
-                     score_index_pairs.end(),
-                     SortScorePairDescend<std::pair<int, int>>);
-    score_index_pairs.resize(keep_top_k);
+    lite::host::math::SortScoreIndexPairs(keep_top_k, &score_index_pairs);
 
     // Store the new indices.
     std::map<int, std::vector<int>> new_indices;
-    for (size_t j = 0; j < score_index_pairs.size(); ++j) {
-      int label = score_index_pairs[j].second.first;
-      int idx = score_index_pairs[j].second.second;
+    for (auto& pair : score_index_pairs) {
+      int label = label_index_pairs[pair.second].first;
+      int idx = label_index_pairs[pair.second].second;
       new_indices[label].push_back(idx);
     }
     if (scores_size == 2) {
-      for (const auto& it : new_indices) {
-        int label = it.first;
-        std::stable_sort(new_indices[label].begin(), new_indices[label].end());
+      for (auto& it : new_indices) {
+        std::sort(it.second.begin(), it.second.end());
       }
     }
     new_indices.swap(*indices);
@@ -339,20 +270,45 @@ void MulticlassNmsCompute::Run() {
   int num_nmsed_out = 0;
   Tensor boxes_slice, scores_slice;
   int n = score_size == 3 ? batch_size : boxes->lod().back().size() - 1;
+  std::vector<Tensor> all_scores(n);
+  std::vector<Tensor> all_boxes(n);
   for (int i = 0; i < n; ++i) {
     if (score_size == 3) {
-      scores_slice = scores->Slice<float>(i, i + 1);
-      scores_slice.Resize({score_dims[1], score_dims[2]});
-      boxes_slice = boxes->Slice<float>(i, i + 1);
-      boxes_slice.Resize({score_dims[2], box_dim});
+      all_scores[i] = scores->Slice<float>(i, i + 1);
+      all_scores[i].Resize({score_dims[1], score_dims[2]});
+      all_boxes[i] = boxes->Slice<float>(i, i + 1);
+      all_boxes[i].Resize({score_dims[2], box_dim});
     } else {
       auto boxes_lod = boxes->lod().back();
-      scores_slice = scores->Slice<float>(boxes_lod[i], boxes_lod[i + 1]);
-      boxes_slice = boxes->Slice<float>(boxes_lod[i], boxes_lod[i + 1]);
+      all_scores[i] = scores->Slice<float>(boxes_lod[i], boxes_lod[i + 1]);
+      all_boxes[i] = boxes->Slice<float>(boxes_lod[i], boxes_lod[i + 1]);
     }
+  }
+
+  // The classes of all the images are independent.
+  int64_t class_num = score_dims[1];
+  std::vector<std::vector<int>> class_indices(n * class_num);
+  lite::host::math::ParallelFor(n * class_num, [&](int64_t task) {
+    int64_t i = task / class_num;
+    int64_t c = task % class_num;
+    if (c == param.background_label) return;
+    ClassNMS(param,
+             all_scores[i],
+             all_boxes[i],
+             score_size,
+             c,
+             &class_indices[task]);
+  });
+
+  for (int i = 0; i < n; ++i) {
     std::map<int, std::vector<int>> indices;
-    MultiClassNMS<float>(
-        param, scores_slice, boxes_slice, score_size, &indices, &num_nmsed_out);
+    MultiClassNMS(param,
+                  all_scores[i],
+                  all_boxes[i],
+                  score_size,
+                  class_indices.data() + i * class_num,
+                  &indices,
+                  &num_nmsed_out);
     all_indices.push_back(indices);
     batch_starts.push_back(batch_starts.back() + num_nmsed_out);
   }
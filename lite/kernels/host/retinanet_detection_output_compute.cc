@@ -13,10 +13,12 @@
 // limitations under the License.
 
 #include "lite/kernels/host/retinanet_detection_output_compute.h"
+#include <algorithm>
 #include <cmath>
 #include <map>
 #include <utility>
 #include <vector>
+#include "lite/backends/host/math/nms.h"
 #include "lite/operators/retinanet_detection_output_op.h"
 
 namespace paddle {
@@ -24,117 +26,29 @@ namespace lite {
 namespace kernels {
 namespace host {
 
-template <class T>
-bool SortScorePairDescend(const std::pair<float, T>& pair1,
-                          const std::pair<float, T>& pair2) {
-  return pair1.first > pair2.first;
-}
-
-template <class T>
-bool SortScoreTwoPairDescend(const std::pair<float, std::pair<T, T>>& pair1,
-                             const std::pair<float, std::pair<T, T>>& pair2) {
-  return pair1.first > pair2.first;
-}
-
-template <class T>
-static inline void GetMaxScoreIndex(
-    const std::vector<T>& scores,
-    const T threshold,
-    int top_k,
-    std::vector<std::pair<T, int>>* sorted_indices) {
-  for (size_t i = 0; i < scores.size(); ++i) {
-    if (scores[i] > threshold) {
-      sorted_indices->push_back(std::make_pair(scores[i], i));
-    }
-  }
-  // Sort the score pair according to the scores in descending order
-  std::stable_sort(sorted_indices->begin(),
-                   sorted_indices->end(),
-                   SortScorePairDescend<int>);
-  // Keep top_k scores if needed.
-  if (top_k > -1 && top_k < static_cast<int>(sorted_indices->size())) {
-    sorted_indices->resize(top_k);
-  }
-}
-
-template <class T>
-static inline T BBoxArea(const std::vector<T>& box, const bool normalized) {
-  if (box[2] < box[0] || box[3] < box[1]) {
-    // If coordinate values are is invalid
-    // (e.g. xmax < xmin or ymax < ymin), return 0.
-    return static_cast<T>(0.);
-  } else {
-    const T w = box[2] - box[0];
-    const T h = box[3] - box[1];
-    if (normalized) {
-      return w * h;
-    } else {
-      // If coordinate values are not within range [0, 1].
-      return (w + 1) * (h + 1);
-    }
-  }
-}
-
-template <class T>
-static inline T JaccardOverlap(const std::vector<T>& box1,
-                               const std::vector<T>& box2,
-                               const bool normalized) {
-  if (box2[0] > box1[2] || box2[2] < box1[0] || box2[1] > box1[3] ||
-      box2[3] < box1[1]) {
-    return static_cast<T>(0.);
-  } else {
-    const T inter_xmin = (std::max)(box1[0], box2[0]);
-    const T inter_ymin = (std::max)(box1[1], box2[1]);
-    const T inter_xmax = (std::min)(box1[2], box2[2]);
-    const T inter_ymax = (std::min)(box1[3], box2[3]);
-    T norm = normalized ? static_cast<T>(0.) : static_cast<T>(1.);
-    T inter_w = inter_xmax - inter_xmin + norm;
-    T inter_h = inter_ymax - inter_ymin + norm;
-    const T inter_area = inter_w * inter_h;
-    const T bbox1_area = BBoxArea<T>(box1, normalized);
-    const T bbox2_area = BBoxArea<T>(box2, normalized);
-    return inter_area / (bbox1_area + bbox2_area - inter_area);
-  }
-}
-
+// The detections of one class are [xmin, ymin, xmax, ymax, score].
 template <class T>
 void NMSFast(const std::vector<std::vector<T>>& cls_dets,
              const T nms_threshold,
              const T eta,
              std::vector<int>* selected_indices) {
   int64_t num_boxes = cls_dets.size();
-  std::vector<std::pair<T, int>> sorted_indices;
+  std::vector<float> boxes(num_boxes * 5);
+  std::vector<std::pair<float, int>> sorted_indices;
+  sorted_indices.reserve(num_boxes);
   for (int64_t i = 0; i < num_boxes; ++i) {
+    std::copy_n(cls_dets[i].begin(), 5, boxes.begin() + i * 5);
     sorted_indices.push_back(std::make_pair(cls_dets[i][4], i));
   }
   // Sort the score pair according to the scores in descending order
-  std::stable_sort(
-      sorted_indices.begin(), sorted_indices.end(), SortScorePairDescend<int>);
-  selected_indices->clear();
-  T adaptive_threshold = nms_threshold;
-
-  while (sorted_indices.size() != 0) {
-    const int idx = sorted_indices.front().second;
-    bool keep = true;
-    for (size_t k = 0; k < selected_indices->size(); ++k) {
-      if (keep) {
-        const int kept_idx = (*selected_indices)[k];
-        T overlap = T(0.);
-
-        overlap = JaccardOverlap<T>(cls_dets[idx], cls_dets[kept_idx], false);
-        keep = overlap <= adaptive_threshold;
-      } else {
-        break;
-      }
-    }
-    if (keep) {
-      selected_indices->push_back(idx);
-    }
-    sorted_indices.erase(sorted_indices.begin());
-    if (keep && eta < 1 && adaptive_threshold > 0.5) {
-      adaptive_threshold *= eta;
-    }
-  }
+  lite::host::math::SortScoreIndexPairs(-1, &sorted_indices);
+  lite::host::math::NMSFast(boxes.data(),
+                            5,
+                            sorted_indices,
+                            nms_threshold,
+                            eta,
+                            false,
+                            selected_indices);
 }
 
 template <class T>
@@ -207,39 +121,38 @@ void MultiClassNMS(const std::map<int, std::vector<std::vector<T>>>& preds,
                    const T nms_eta,
                    std::vector<std::vector<T>>* nmsed_out,
                    int* num_nmsed_out) {
-  std::map<int, std::vector<int>> indices;
-  int num_det = 0;
+  std::vector<int> labels;
   for (int c = 0; c < class_num; ++c) {
     if (static_cast<bool>(preds.count(c))) {
-      const std::vector<std::vector<T>> cls_dets = preds.at(c);
-      NMSFast(cls_dets, nms_threshold, nms_eta, &(indices[c]));
-      num_det += indices[c].size();
+      labels.push_back(c);
     }
   }
-
-  std::vector<std::pair<float, std::pair<int, int>>> score_index_pairs;
-  for (const auto& it : indices) {
-    int label = it.first;
-    const std::vector<int>& label_indices = it.second;
-    for (size_t j = 0; j < label_indices.size(); ++j) {
-      int idx = label_indices[j];
-      score_index_pairs.push_back(
-          std::make_pair(preds.at(label)[idx][4], std::make_pair(label, idx)));
+  // The classes are independent.
+  std::vector<std::vector<int>> label_indices(labels.size());
+  lite::host::math::ParallelFor(labels.size(), [&](int64_t i) {
+    NMSFast(preds.at(labels[i]), nms_threshold, nms_eta, &label_indices[i]);
+  });
+
+  // The pairs of (score, order), so the ties are kept in the order of the
+  // labels and the indices.
+  std::vector<std::pair<float, int>> score_index_pairs;
+  std::vector<std::pair<int, int>> label_index_pairs;
+  for (size_t i = 0; i < labels.size(); ++i) {
+    int label = labels[i];
+    for (int idx : label_indices[i]) {
+      score_index_pairs.push_back(std::make_pair(preds.at(label)[idx][4],
+                                                 label_index_pairs.size()));
+      label_index_pairs.push_back(std::make_pair(label, idx));
     }
   }
   // Keep top k results per image.
-  std::stable_sort(score_index_pairs.begin(),
-                   score_index_pairs.end(),
-                   SortScoreTwoPairDescend<int>);
-  if (num_det > keep_top_k) {
-    score_index_pairs.resize(keep_top_k);
-  }
+  lite::host::math::SortScoreIndexPairs(keep_top_k, &score_index_pairs);
 
   // Store the new indices.
   std::map<int, std::vector<int>> new_indices;
   for (const auto& it : score_index_pairs) {
-    int label = it.second.first;
-    int idx = it.second.second;
+    int label = label_index_pairs[it.second].first;
+    int idx = label_index_pairs[it.second].second;
     std::vector<T> one_pred;
     one_pred.push_back(label);
     one_pred.push_back(preds.at(label)[idx][4]);
@@ -250,7 +163,7 @@ void MultiClassNMS(const std::map<int, std::vector<std::vector<T>>>& preds,
     nmsed_out->push_back(one_pred);
   }
 
-  *num_nmsed_out = (num_det > keep_top_k ? keep_top_k : num_det);
+  *num_nmsed_out = score_index_pairs.size();
 }
 
 template <class T>
@@ -280,17 +193,20 @@ void RetinanetDetectionOutput(
 
     int64_t scores_num = scores_per_level.numel();
     int64_t bboxes_num = bboxes_per_level.numel();
-    std::vector<T> scores_data(scores_num);
     std::vector<T> bboxes_data(bboxes_num);
     std::vector<T> anchors_data(bboxes_num);
-    std::copy_n(scores_per_level.data<T>(), scores_num, scores_data.begin());
     std::copy_n(bboxes_per_level.data<T>(), bboxes_num, bboxes_data.begin());
     std::copy_n(anchors_per_level.data<T>(), bboxes_num, anchors_data.begin());
-    std::vector<std::pair<T, int>> sorted_indices;
+    std::vector<std::pair<float, int>> sorted_indices;
 
     // For the highest level, we take the threshold 0.0
     T threshold = (l < (scores.size() - 1) ? score_threshold : 0.0);
-    GetMaxScoreIndex(scores_data, threshold, nms_top_k, &sorted_indices);
+    lite::host::math::GetTopKScoreIndex(scores_per_level.data<T>(),
+                                        scores_num,
+                                        1,
+                                        threshold,
+                                        nms_top_k,
+                                        &sorted_indices);
     auto* im_info_data = im_info.data<T>();
     auto im_height = im_info_data[0];
     auto im_width = im_info_data[1];
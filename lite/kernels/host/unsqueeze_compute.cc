@@ -26,7 +26,11 @@ void UnsqueezeCompute::Run() {
   auto x = param.X;
   auto output = param.Out;
   auto output_dims = output->dims();
-  output->CopyDataFrom(*x);
+  if (param.inplace) {
+    output->ShareDataWith(*x);
+  } else {
+    output->CopyDataFrom(*x);
+  }
   output->Resize(output_dims);
 }
 
@@ -35,7 +39,11 @@ void Unsqueeze2Compute::Run() {
   auto x = param.X;
   auto output = param.Out;
   auto output_dims = output->dims();
-  output->CopyDataFrom(*x);
+  if (param.inplace) {
+    output->ShareDataWith(*x);
+  } else {
+    output->CopyDataFrom(*x);
+  }
   output->Resize(output_dims);
 }
 
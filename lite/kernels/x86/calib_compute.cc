@@ -0,0 +1,100 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/calib_compute.h"
+#include <algorithm>
+#include <cmath>
+#include "lite/backends/x86/parallel.h"
+#include "lite/core/op_registry.h"
+#include "lite/core/type_system.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+void CalibComputeFp32ToInt8::Run() {
+  auto& param = this->Param<operators::CalibParam>();
+  const float* din = param.input->data<float>();
+  int8_t* dout = param.output->mutable_data<int8_t>();
+  const float inv_scale = 1.f / param.scale;
+  lite::x86::RunParallelFor(
+      0, param.input->numel(), [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; i++) {
+          float v = std::round(din[i] * inv_scale);
+          v = (std::min)(127.f, (std::max)(-127.f, v));
+          dout[i] = static_cast<int8_t>(v);
+        }
+      });
+}
+
+void CalibComputeInt8ToFp32::Run() {
+  auto& param = this->Param<operators::CalibParam>();
+  const int8_t* din = param.input->data<int8_t>();
+  float* dout = param.output->mutable_data<float>();
+  const float scale = param.scale;
+  lite::x86::RunParallelFor(
+      0, param.input->numel(), [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; i++) {
+          dout[i] = din[i] * scale;
+        }
+      });
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_LITE_KERNEL(calib,
+                     kX86,
+                     kInt8,
+                     kNCHW,
+                     paddle::lite::kernels::x86::CalibComputeFp32ToInt8,
+                     fp32_to_int8)
+    .BindInput("Input",
+               {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kFloat))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt8))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(calib,
+                     kX86,
+                     kInt8,
+                     kNCHW,
+                     paddle::lite::kernels::x86::CalibComputeInt8ToFp32,
+                     int8_to_fp32)
+    .BindInput("Input", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt8))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kFloat))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(calib_once,
+                     kX86,
+                     kInt8,
+                     kNCHW,
+                     paddle::lite::kernels::x86::CalibComputeFp32ToInt8,
+                     fp32_to_int8)
+    .BindInput("Input",
+               {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kFloat))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt8))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(calib_once,
+                     kX86,
+                     kInt8,
+                     kNCHW,
+                     paddle::lite::kernels::x86::CalibComputeInt8ToFp32,
+                     int8_to_fp32)
+    .BindInput("Input", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt8))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kFloat))})
+    .Finalize();
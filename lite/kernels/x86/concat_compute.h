@@ -16,6 +16,7 @@
 #include <Eigen/Core>
 #include <vector>
 #include "lite/core/kernel.h"
+#include "lite/core/memory_arena.h"
 #include "lite/core/op_registry.h"
 #include "lite/core/types.h"
 
@@ -52,7 +53,18 @@ class ConcatCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
     }
 
     const auto& x_dims = param.x[0]->dims();
+    if (axis < 0) {
+      axis += x_dims.size();
+    }
     auto* out = param.output;
+    // The inputs are the consecutive slices of the output if the dims before
+    // the axis are all 1, their producers write there in place.
+    if (param.inplace && count(0, axis, x_dims) == 1 && out->numel() > 0) {
+      slices_.Concat<T>(param.x, out);
+      return;
+    }
+    // The inputs may live in the chunk of the output.
+    slices_.Unbind(out);
     T* output_data = param.output->template mutable_data<T>();
 
     int offset_concat_axis = 0;
@@ -73,6 +85,9 @@ class ConcatCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
     }
   }
   virtual ~ConcatCompute() = default;
+
+ private:
+  SliceArena slices_{TARGET(kX86)};
 };
 
 }  // namespace x86
@@ -13,7 +13,10 @@
 // limitations under the License.
 
 #include "lite/kernels/x86/conv_compute.h"
+#include <sstream>
 #include <utility>
+#include "lite/backends/x86/parallel.h"
+#include "lite/core/kernel_tuner.h"
 #include "lite/kernels/x86/conv_depthwise.h"
 
 namespace paddle {
@@ -48,6 +51,18 @@ void Conv2dCompute<float>::PrepareForRun() {
     }
   }
 
+  if (impl_ && KernelTuner::Global().enabled()) {
+    // The depthwise conv is measured against the im2col and gemm of Run in
+    // ReInitWhenNeeded, for every shape of the input.
+    depthwise_.reset(impl_);
+    impl_ = nullptr;
+    depthwise_->SetContext(ContextScheduler::Global().NewContext(TARGET(kX86)));
+    depthwise_->SetParam(param);
+    depthwise_->PrepareForRun();
+    is_first_epoch_ = false;
+    return;
+  }
+
   if (impl_) {
     impl_->SetContext(std::move(this->ctx_));
     impl_->SetParam(param);
@@ -57,6 +72,43 @@ void Conv2dCompute<float>::PrepareForRun() {
 #endif
 }
 
+template <>
+void Conv2dCompute<float>::ReInitWhenNeeded() {
+  if (!depthwise_) {
+    if (impl_) {
+      impl_->ReInitWhenNeeded();
+    }
+    return;
+  }
+  auto& param = this->Param<param_t>();
+  const auto& x_dims = param.x->dims();
+  if (last_shape_ == x_dims) {
+    return;
+  }
+  last_shape_ = x_dims;
+
+  const auto& filter_dims = param.filter->dims();
+  const auto& paddings = *param.paddings;
+  std::ostringstream key;
+  key << "x86_conv_fp32|t" << lite::x86::GetMaxThreads() << "|" << x_dims[0]
+      << "," << x_dims[1] << "," << x_dims[2] << "," << x_dims[3] << ","
+      << filter_dims[2] << "," << filter_dims[3] << "," << param.strides[0]
+      << "," << param.strides[1] << "," << paddings[0] << "," << paddings[2];
+  // Run falls back to the im2col and gemm while impl_ is null.
+  impl_ = nullptr;
+  depthwise_->ReInitWhenNeeded();
+  int index = KernelTuner::Global().Select(key.str(), 2, [&](int i) {
+    if (i == 0) {
+      depthwise_->Run();
+    } else {
+      Run();
+    }
+  });
+  if (index == 0) {
+    impl_ = depthwise_.get();
+  }
+}
+
 }  // namespace x86
 }  // namespace kernels
 }  // namespace lite
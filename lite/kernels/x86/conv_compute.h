@@ -14,6 +14,7 @@
 #pragma once
 
 #include <Eigen/Core>
+#include <memory>
 #include <string>
 #include <vector>
 #include "lite/backends/x86/math/blas.h"
@@ -49,11 +50,7 @@ class Conv2dCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
  public:
   virtual void PrepareForRun();
 
-  virtual void ReInitWhenNeeded() {
-    if (impl_) {
-      impl_->ReInitWhenNeeded();
-    }
-  }
+  virtual void ReInitWhenNeeded();
 
   virtual void Run() {
     if (impl_) {
@@ -203,7 +200,8 @@ class Conv2dCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
 #endif
 
   ~Conv2dCompute() {
-    if (impl_ != nullptr) {
+    // impl_ is borrowed from depthwise_ if it is tuned.
+    if (impl_ != nullptr && impl_ != depthwise_.get()) {
       delete impl_;
     }
   }
@@ -211,6 +209,10 @@ class Conv2dCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
  private:
   using param_t = operators::ConvParam;
   KernelLite<TARGET(kX86), PRECISION(kFloat)>* impl_{nullptr};
+  // The depthwise conv tuned against the im2col and gemm of Run, it is tuned
+  // again whenever the shape of the input changes.
+  std::unique_ptr<KernelLite<TARGET(kX86), PRECISION(kFloat)>> depthwise_;
+  DDim last_shape_;
 };
 
 }  // namespace x86
@@ -14,10 +14,15 @@
 
 #include <gtest/gtest.h>
 
+#include <cstdio>
 #include <memory>
+#include <sstream>
+#include <string>
 #include <utility>
 #include <vector>
 
+#include "lite/backends/x86/parallel.h"
+#include "lite/core/kernel_tuner.h"
 #include "lite/core/op_registry.h"
 #include "lite/kernels/x86/conv_compute.h"
 
@@ -92,6 +97,88 @@ TEST(conv2d_x86, run_test) {
   }
 }
 
+#ifdef LITE_WITH_AVX
+// The depthwise conv is tuned against the im2col and gemm again for every new
+// shape of the input, and the results match the naive conv.
+TEST(conv2d_x86, tune_by_shape) {
+  const std::string tuning_file = "conv2d_x86_tuning.txt";
+  std::remove(tuning_file.c_str());
+  KernelTuner::Global().Enable(tuning_file);
+
+  const int channel = 8;
+  lite::Tensor x, filter, b, out;
+  filter.Resize({channel, 1, 3, 3});
+  b.Resize({channel});
+  auto filter_data = filter.mutable_data<float>();
+  auto b_data = b.mutable_data<float>();
+  for (int64_t i = 0; i < filter.dims().production(); i++) {
+    filter_data[i] = 0.1f * (i % 7) - 0.3f;
+  }
+  for (int i = 0; i < channel; i++) {
+    b_data[i] = 0.5f * i;
+  }
+
+  operators::ConvParam param;
+  param.x = &x;
+  param.filter = &filter;
+  param.bias = &b;
+  param.output = &out;
+  param.strides = {1, 1};
+  param.groups = channel;
+  param.paddings = std::make_shared<std::vector<int>>(4, 1);
+  param.dilations = std::make_shared<std::vector<int>>(2, 1);
+  Conv2dCompute<float> conv2d;
+  std::unique_ptr<KernelContext> ctx(new KernelContext);
+  ctx->As<X86Context>();
+  conv2d.SetContext(std::move(ctx));
+  conv2d.SetParam(param);
+
+  const std::vector<std::pair<int, int>> shapes{{7, 7}, {12, 9}, {7, 7}};
+  for (size_t s = 0; s < shapes.size(); s++) {
+    const int h = shapes[s].first;
+    const int w = shapes[s].second;
+    x.Resize({1, channel, h, w});
+    out.Resize({1, channel, h, w});
+    auto x_data = x.mutable_data<float>();
+    for (int64_t i = 0; i < x.dims().production(); i++) {
+      x_data[i] = 0.01f * (i % 13) * (s + 1);
+    }
+    if (s == 0) {
+      conv2d.PrepareForRun();
+    }
+    conv2d.ReInitWhenNeeded();
+    conv2d.Run();
+
+    std::ostringstream key;
+    key << "x86_conv_fp32|t" << lite::x86::GetMaxThreads() << "|1," << channel
+        << "," << h << "," << w << ",3,3,1,1,1,1";
+    EXPECT_GE(KernelTuner::Global().Lookup(key.str()), 0) << key.str();
+
+    const float* out_data = out.data<float>();
+    for (int c = 0; c < channel; c++) {
+      for (int oh = 0; oh < h; oh++) {
+        for (int ow = 0; ow < w; ow++) {
+          float expected = b_data[c];
+          for (int kh = 0; kh < 3; kh++) {
+            for (int kw = 0; kw < 3; kw++) {
+              int ih = oh + kh - 1;
+              int iw = ow + kw - 1;
+              if (ih < 0 || ih >= h || iw < 0 || iw >= w) continue;
+              expected += x_data[(c * h + ih) * w + iw] *
+                          filter_data[c * 9 + kh * 3 + kw];
+            }
+          }
+          EXPECT_NEAR(out_data[(c * h + oh) * w + ow], expected, 1e-4f);
+        }
+      }
+    }
+  }
+
+  KernelTuner::Global().Disable();
+  std::remove(tuning_file.c_str());
+}
+#endif
+
 }  // namespace x86
 }  // namespace kernels
 }  // namespace lite
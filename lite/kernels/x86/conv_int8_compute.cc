@@ -0,0 +1,330 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/conv_int8_compute.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include "lite/backends/x86/math/gemm_s8u8.h"
+#include "lite/backends/x86/parallel.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+template <typename T>
+inline T RequantizeConv(float v);
+
+template <>
+inline float RequantizeConv<float>(float v) {
+  return v;
+}
+
+template <>
+inline int8_t RequantizeConv<int8_t>(float v) {
+  int32_t q = static_cast<int32_t>(std::round(v));
+  return static_cast<int8_t>((std::min)(127, (std::max)(-127, q)));
+}
+
+// col[c * kh * kw + i * kw + j][oh * ow], the paddings are filled with 0.
+static void Im2ColInt8(const int8_t* in,
+                       int channels,
+                       int height,
+                       int width,
+                       int kernel_h,
+                       int kernel_w,
+                       const std::vector<int>& strides,
+                       const std::vector<int>& paddings,
+                       const std::vector<int>& dilations,
+                       int out_h,
+                       int out_w,
+                       int8_t* col) {
+  const int rows = channels * kernel_h * kernel_w;
+  lite::x86::RunParallelFor(0, rows, [&](int64_t begin, int64_t end) {
+    for (int64_t r = begin; r < end; r++) {
+      int c = static_cast<int>(r / (kernel_h * kernel_w));
+      int ki = static_cast<int>(r / kernel_w % kernel_h);
+      int kj = static_cast<int>(r % kernel_w);
+      const int8_t* in_c = in + c * height * width;
+      int8_t* dst = col + r * out_h * out_w;
+      for (int oh = 0; oh < out_h; oh++) {
+        int ih = oh * strides[0] - paddings[0] + ki * dilations[0];
+        if (ih < 0 || ih >= height) {
+          memset(dst, 0, out_w);
+          dst += out_w;
+          continue;
+        }
+        for (int ow = 0; ow < out_w; ow++) {
+          int iw = ow * strides[1] - paddings[2] + kj * dilations[1];
+          *dst++ = (iw < 0 || iw >= width) ? 0 : in_c[ih * width + iw];
+        }
+      }
+    }
+  });
+}
+
+template <PrecisionType OutType>
+void Conv2dInt8Compute<OutType>::PrepareForRun() {
+  auto& param = this->template Param<param_t>();
+  const auto& w_dims = param.filter->dims();
+  const int out_c = static_cast<int>(w_dims[0]);
+  const int in_c = static_cast<int>(param.x->dims()[1]);
+  const int groups = param.groups;
+  CHECK_GT(param.weight_scale.size(), 0u)
+      << "The int8 conv needs the scales of the filter";
+  CHECK(param.weight_scale.size() == 1u ||
+        static_cast<int>(param.weight_scale.size()) == out_c);
+
+  float out_scale =
+      OutType == PRECISION(kInt8) ? param.output_scale : 1.f;
+  // The activations fused by conv_activation_fuse_pass are applied to the
+  // scaled outputs before the rounding.
+  act_ = lite::x86::math::GemmS8u8Act();
+  auto& act_param = param.activation_param;
+  if (act_param.has_active) {
+    switch (act_param.active_type) {
+      case lite_api::ActivationType::kRelu:
+        act_.type = lite::x86::math::GemmS8u8Act::kRelu;
+        break;
+      case lite_api::ActivationType::kRelu6:
+        act_.type = lite::x86::math::GemmS8u8Act::kRelu6;
+        act_.threshold = act_param.Relu_clipped_coef / out_scale;
+        break;
+      case lite_api::ActivationType::kLeakyRelu:
+        act_.type = lite::x86::math::GemmS8u8Act::kLeakyRelu;
+        act_.alpha = act_param.Leaky_relu_alpha;
+        break;
+      default:
+        LOG(FATAL) << "[X86] The int8 conv does not support the activation "
+                   << static_cast<int>(act_param.active_type);
+    }
+  }
+  scale_.resize(out_c);
+  for (int i = 0; i < out_c; i++) {
+    float w_scale = param.weight_scale.size() == 1u ? param.weight_scale[0]
+                                                    : param.weight_scale[i];
+    scale_[i] = param.input_scale * w_scale / out_scale;
+  }
+  bias_.clear();
+  if (param.bias) {
+    CHECK_EQ(param.bias->numel(), out_c);
+    const float* bias = param.bias->template data<float>();
+    for (int i = 0; i < out_c; i++) {
+      bias_.push_back(bias[i] / out_scale);
+    }
+  }
+
+  depthwise_ = groups > 1 && groups == in_c && groups == out_c;
+  if (depthwise_) {
+    return;
+  }
+  const int m = out_c / groups;
+  const int k = static_cast<int>(w_dims.production() / out_c);
+  packed_group_size_ = lite::x86::math::GemmS8u8PackedASize(m, k);
+  packed_filter_.Resize(
+      {static_cast<int64_t>(packed_group_size_ * groups)});
+  int8_t* packed = packed_filter_.mutable_data<int8_t>();
+  const int8_t* filter = param.filter->template data<int8_t>();
+  for (int g = 0; g < groups; g++) {
+    lite::x86::math::GemmS8u8PackA(false,
+                                   m,
+                                   k,
+                                   filter + g * m * k,
+                                   k,
+                                   packed + g * packed_group_size_);
+  }
+}
+
+template <PrecisionType OutType>
+void Conv2dInt8Compute<OutType>::RunDepthwise() {
+  auto& param = this->template Param<param_t>();
+  const auto& x_dims = param.x->dims();
+  const auto& w_dims = param.filter->dims();
+  const auto& out_dims = param.output->dims();
+  const int batch = static_cast<int>(x_dims[0]);
+  const int channels = static_cast<int>(x_dims[1]);
+  const int height = static_cast<int>(x_dims[2]);
+  const int width = static_cast<int>(x_dims[3]);
+  const int kernel_h = static_cast<int>(w_dims[2]);
+  const int kernel_w = static_cast<int>(w_dims[3]);
+  const int out_h = static_cast<int>(out_dims[2]);
+  const int out_w = static_cast<int>(out_dims[3]);
+  const auto& strides = param.strides;
+  const auto& paddings = *param.paddings;
+  const auto& dilations = *param.dilations;
+  const int8_t* input = param.x->template data<int8_t>();
+  const int8_t* filter = param.filter->template data<int8_t>();
+  out_t* output = param.output->template mutable_data<out_t>();
+
+  lite::x86::RunParallelFor(
+      0, batch * channels, [&](int64_t begin, int64_t end) {
+        for (int64_t bc = begin; bc < end; bc++) {
+          int c = static_cast<int>(bc % channels);
+          const int8_t* in = input + bc * height * width;
+          const int8_t* w = filter + c * kernel_h * kernel_w;
+          out_t* out = output + bc * out_h * out_w;
+          float scale = scale_[c];
+          float bias = bias_.empty() ? 0.f : bias_[c];
+          for (int oh = 0; oh < out_h; oh++) {
+            for (int ow = 0; ow < out_w; ow++) {
+              int32_t acc = 0;
+              for (int i = 0; i < kernel_h; i++) {
+                int ih = oh * strides[0] - paddings[0] + i * dilations[0];
+                if (ih < 0 || ih >= height) continue;
+                for (int j = 0; j < kernel_w; j++) {
+                  int iw = ow * strides[1] - paddings[2] + j * dilations[1];
+                  if (iw < 0 || iw >= width) continue;
+                  acc += static_cast<int32_t>(in[ih * width + iw]) *
+                         w[i * kernel_w + j];
+                }
+              }
+              float v = acc * scale + bias;
+              v = act_(v);
+              out[oh * out_w + ow] = RequantizeConv<out_t>(v);
+            }
+          }
+        }
+      });
+}
+
+template <PrecisionType OutType>
+void Conv2dInt8Compute<OutType>::Run() {
+  if (depthwise_) {
+    RunDepthwise();
+    return;
+  }
+  auto& param = this->template Param<param_t>();
+  const auto& x_dims = param.x->dims();
+  const auto& w_dims = param.filter->dims();
+  const auto& out_dims = param.output->dims();
+  const int batch = static_cast<int>(x_dims[0]);
+  const int in_c = static_cast<int>(x_dims[1]);
+  const int height = static_cast<int>(x_dims[2]);
+  const int width = static_cast<int>(x_dims[3]);
+  const int out_c = static_cast<int>(out_dims[1]);
+  const int out_h = static_cast<int>(out_dims[2]);
+  const int out_w = static_cast<int>(out_dims[3]);
+  const int kernel_h = static_cast<int>(w_dims[2]);
+  const int kernel_w = static_cast<int>(w_dims[3]);
+  const int groups = param.groups;
+  const auto& strides = param.strides;
+  const auto& paddings = *param.paddings;
+  const auto& dilations = *param.dilations;
+
+  const int group_in_c = in_c / groups;
+  const int m = out_c / groups;
+  const int k = group_in_c * kernel_h * kernel_w;
+  const int n = out_h * out_w;
+  bool is_1x1 = kernel_h == 1 && kernel_w == 1 && strides[0] == 1 &&
+                strides[1] == 1 && paddings[0] == 0 && paddings[1] == 0 &&
+                paddings[2] == 0 && paddings[3] == 0;
+  if (!is_1x1) {
+    col_.Resize({static_cast<int64_t>(k) * n});
+  }
+
+  const int8_t* input = param.x->template data<int8_t>();
+  const int8_t* packed = packed_filter_.data<int8_t>();
+  out_t* output = param.output->template mutable_data<out_t>();
+  for (int b = 0; b < batch; b++) {
+    for (int g = 0; g < groups; g++) {
+      const int8_t* in =
+          input + (static_cast<int64_t>(b) * in_c + g * group_in_c) * height *
+                      width;
+      const int8_t* col = in;
+      if (!is_1x1) {
+        int8_t* col_data = col_.mutable_data<int8_t>();
+        Im2ColInt8(in,
+                   group_in_c,
+                   height,
+                   width,
+                   kernel_h,
+                   kernel_w,
+                   strides,
+                   paddings,
+                   dilations,
+                   out_h,
+                   out_w,
+                   col_data);
+        col = col_data;
+      }
+      out_t* out = output + (static_cast<int64_t>(b) * out_c + g * m) * n;
+      lite::x86::math::GemmS8u8<out_t>(
+          m,
+          n,
+          k,
+          packed + g * packed_group_size_,
+          false,
+          col,
+          n,
+          scale_.data() + g * m,
+          bias_.empty() ? nullptr : bias_.data() + g * m,
+          act_,
+          false,
+          out,
+          n);
+    }
+  }
+}
+
+template class Conv2dInt8Compute<PRECISION(kInt8)>;
+template class Conv2dInt8Compute<PRECISION(kFloat)>;
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+typedef paddle::lite::kernels::x86::Conv2dInt8Compute<PRECISION(kInt8)>
+    ConvInt8_Int8;
+typedef paddle::lite::kernels::x86::Conv2dInt8Compute<PRECISION(kFloat)>
+    ConvInt8_Fp32;
+
+REGISTER_LITE_KERNEL(conv2d, kX86, kInt8, kNCHW, ConvInt8_Int8, int8_out)
+    .BindInput("Input", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt8))})
+    .BindInput("Bias", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kFloat))})
+    .BindInput("Filter",
+               {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt8))})
+    .BindOutput("Output",
+                {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt8))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(conv2d, kX86, kInt8, kNCHW, ConvInt8_Fp32, fp32_out)
+    .BindInput("Input", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt8))})
+    .BindInput("Bias", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kFloat))})
+    .BindInput("Filter",
+               {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt8))})
+    .BindOutput("Output",
+                {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kFloat))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(
+    depthwise_conv2d, kX86, kInt8, kNCHW, ConvInt8_Int8, int8_out)
+    .BindInput("Input", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt8))})
+    .BindInput("Bias", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kFloat))})
+    .BindInput("Filter",
+               {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt8))})
+    .BindOutput("Output",
+                {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt8))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(
+    depthwise_conv2d, kX86, kInt8, kNCHW, ConvInt8_Fp32, fp32_out)
+    .BindInput("Input", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt8))})
+    .BindInput("Bias", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kFloat))})
+    .BindInput("Filter",
+               {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt8))})
+    .BindOutput("Output",
+                {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kFloat))})
+    .Finalize();
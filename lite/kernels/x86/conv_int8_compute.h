@@ -0,0 +1,67 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <type_traits>
+#include <vector>
+#include "lite/backends/x86/math/gemm_s8u8.h"
+#include "lite/core/kernel.h"
+#include "lite/core/op_registry.h"
+#include "lite/operators/conv_op.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+/*
+ * The int8 conv2d and depthwise_conv2d with the int8 or fp32 output.
+ *
+ * The filter is packed once for GemmS8u8, and the input is expanded by
+ * im2col if needed. The per-channel scales of the filter, the bias and relu
+ * are fused into the requantization of the outputs of the gemm. The depthwise
+ * conv is computed directly.
+ */
+template <PrecisionType OutType>
+class Conv2dInt8Compute : public KernelLite<TARGET(kX86), PRECISION(kInt8)> {
+ public:
+  using param_t = operators::ConvParam;
+  using out_t = typename std::
+      conditional<OutType == PRECISION(kInt8), int8_t, float>::type;
+
+  void PrepareForRun() override;
+
+  void Run() override;
+
+  virtual ~Conv2dInt8Compute() = default;
+
+ private:
+  void RunDepthwise();
+
+  bool depthwise_{false};
+  lite::x86::math::GemmS8u8Act act_;
+  // The packed filter of every group.
+  Tensor packed_filter_;
+  size_t packed_group_size_{0};
+  // The requantization scales and the bias of the output channels.
+  std::vector<float> scale_;
+  std::vector<float> bias_;
+  Tensor col_;
+};
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
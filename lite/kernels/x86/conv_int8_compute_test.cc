@@ -0,0 +1,220 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/conv_int8_compute.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+// The fp32 conv on the dequantized input and filter.
+static void conv_ref(const std::vector<int8_t>& x,
+                     const std::vector<int8_t>& w,
+                     const std::vector<float>& bias,
+                     int batch,
+                     int in_c,
+                     int h,
+                     int w_in,
+                     int out_c,
+                     int k,
+                     int stride,
+                     int pad,
+                     int dilation,
+                     int groups,
+                     float x_scale,
+                     const std::vector<float>& w_scale,
+                     lite_api::ActivationType act,
+                     int out_h,
+                     int out_w,
+                     std::vector<float>* out) {
+  int gin = in_c / groups;
+  int gout = out_c / groups;
+  out->resize(batch * out_c * out_h * out_w);
+  for (int b = 0; b < batch; b++) {
+    for (int oc = 0; oc < out_c; oc++) {
+      int g = oc / gout;
+      for (int oh = 0; oh < out_h; oh++) {
+        for (int ow = 0; ow < out_w; ow++) {
+          int32_t acc = 0;
+          for (int ic = 0; ic < gin; ic++) {
+            for (int i = 0; i < k; i++) {
+              for (int j = 0; j < k; j++) {
+                int ih = oh * stride - pad + i * dilation;
+                int iw = ow * stride - pad + j * dilation;
+                if (ih < 0 || ih >= h || iw < 0 || iw >= w_in) continue;
+                acc += x[((b * in_c + g * gin + ic) * h + ih) * w_in + iw] *
+                       w[((oc * gin + ic) * k + i) * k + j];
+              }
+            }
+          }
+          float v = acc * x_scale * w_scale[oc] + bias[oc];
+          if (act == lite_api::ActivationType::kRelu) {
+            v = (std::max)(v, 0.f);
+          } else if (act == lite_api::ActivationType::kRelu6) {
+            v = (std::min)((std::max)(v, 0.f), 6.f);
+          } else if (act == lite_api::ActivationType::kLeakyRelu) {
+            v = v < 0.f ? v * 0.1f : v;
+          }
+          (*out)[((b * out_c + oc) * out_h + oh) * out_w + ow] = v;
+        }
+      }
+    }
+  }
+}
+
+template <PrecisionType OutType>
+static void test_conv_int8(int batch,
+                           int in_c,
+                           int h,
+                           int out_c,
+                           int k,
+                           int stride,
+                           int pad,
+                           int dilation,
+                           int groups,
+                           lite_api::ActivationType act) {
+  using out_t = typename Conv2dInt8Compute<OutType>::out_t;
+  int out_h = (h + 2 * pad - (dilation * (k - 1) + 1)) / stride + 1;
+  lite::Tensor x, filter, bias, out;
+  x.Resize({batch, in_c, h, h});
+  filter.Resize({out_c, in_c / groups, k, k});
+  bias.Resize({out_c});
+  out.Resize({batch, out_c, out_h, out_h});
+
+  std::vector<int8_t> x_data(x.numel());
+  std::vector<int8_t> w_data(filter.numel());
+  std::vector<float> b_data(out_c);
+  std::vector<float> w_scale(out_c);
+  for (size_t i = 0; i < x_data.size(); i++) {
+    x_data[i] = static_cast<int8_t>((i * 37 + 11) % 255 - 127);
+  }
+  for (size_t i = 0; i < w_data.size(); i++) {
+    w_data[i] = static_cast<int8_t>((i * 53 + 7) % 255 - 127);
+  }
+  for (int i = 0; i < out_c; i++) {
+    b_data[i] = 0.1f * (i % 7) - 0.3f;
+    w_scale[i] = 0.001f * (i % 5 + 1);
+  }
+  std::copy(x_data.begin(), x_data.end(), x.mutable_data<int8_t>());
+  std::copy(w_data.begin(), w_data.end(), filter.mutable_data<int8_t>());
+  std::copy(b_data.begin(), b_data.end(), bias.mutable_data<float>());
+
+  operators::ConvParam param;
+  param.x = &x;
+  param.filter = &filter;
+  param.bias = &bias;
+  param.output = &out;
+  param.strides = {stride, stride};
+  param.paddings = std::make_shared<std::vector<int>>(
+      std::vector<int>{pad, pad, pad, pad});
+  param.dilations =
+      std::make_shared<std::vector<int>>(std::vector<int>{dilation, dilation});
+  param.groups = groups;
+  param.activation_param.has_active =
+      act != lite_api::ActivationType::kIndentity;
+  param.activation_param.active_type = act;
+  param.activation_param.Relu_clipped_coef = 6.f;
+  param.activation_param.Leaky_relu_alpha = 0.1f;
+  param.enable_int8 = true;
+  param.input_scale = 0.02f;
+  param.weight_scale = w_scale;
+  param.output_scale = 0.05f;
+
+  Conv2dInt8Compute<OutType> conv;
+  std::unique_ptr<KernelContext> ctx(new KernelContext);
+  ctx->As<X86Context>();
+  conv.SetContext(std::move(ctx));
+  conv.SetParam(param);
+  conv.PrepareForRun();
+  conv.Run();
+
+  std::vector<float> ref;
+  conv_ref(x_data,
+           w_data,
+           b_data,
+           batch,
+           in_c,
+           h,
+           h,
+           out_c,
+           k,
+           stride,
+           pad,
+           dilation,
+           groups,
+           param.input_scale,
+           w_scale,
+           act,
+           out_h,
+           out_h,
+           &ref);
+  const out_t* out_data = out.data<out_t>();
+  for (size_t i = 0; i < ref.size(); i++) {
+    if (OutType == PRECISION(kInt8)) {
+      float q = std::round(ref[i] / param.output_scale);
+      q = (std::min)(127.f, (std::max)(-127.f, q));
+      EXPECT_NEAR(out_data[i], q, 1);
+    } else {
+      EXPECT_NEAR(out_data[i], ref[i], 1e-3 * (1 + std::fabs(ref[i])));
+    }
+  }
+}
+
+TEST(conv_int8_x86, retrive_op) {
+  auto conv = KernelRegistry::Global().Create("conv2d");
+  ASSERT_FALSE(conv.empty());
+  ASSERT_TRUE(conv.front());
+}
+
+TEST(conv_int8_x86, init) {
+  Conv2dInt8Compute<PRECISION(kFloat)> conv;
+  ASSERT_EQ(conv.precision(), PRECISION(kInt8));
+  ASSERT_EQ(conv.target(), TARGET(kX86));
+}
+
+TEST(conv_int8_x86, run_test) {
+  for (auto act : {lite_api::ActivationType::kIndentity,
+                   lite_api::ActivationType::kRelu,
+                   lite_api::ActivationType::kRelu6,
+                   lite_api::ActivationType::kLeakyRelu}) {
+    // 1x1
+    test_conv_int8<PRECISION(kFloat)>(2, 16, 7, 24, 1, 1, 0, 1, 1, act);
+    test_conv_int8<PRECISION(kInt8)>(2, 16, 7, 24, 1, 1, 0, 1, 1, act);
+    // 3x3 with paddings and strides
+    test_conv_int8<PRECISION(kFloat)>(1, 5, 9, 13, 3, 2, 1, 1, 1, act);
+    test_conv_int8<PRECISION(kInt8)>(1, 5, 9, 13, 3, 1, 1, 2, 1, act);
+    // groups
+    test_conv_int8<PRECISION(kFloat)>(1, 8, 6, 12, 3, 1, 1, 1, 4, act);
+    // depthwise
+    test_conv_int8<PRECISION(kFloat)>(2, 8, 10, 8, 3, 1, 1, 1, 8, act);
+    test_conv_int8<PRECISION(kInt8)>(1, 8, 10, 8, 5, 2, 2, 1, 8, act);
+  }
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_KERNEL(conv2d, kX86, kInt8, kNCHW, int8_out);
+USE_LITE_KERNEL(conv2d, kX86, kInt8, kNCHW, fp32_out);
+USE_LITE_KERNEL(depthwise_conv2d, kX86, kInt8, kNCHW, int8_out);
@@ -14,11 +14,16 @@
 
 #pragma once
 
+#include <cmath>
+#include <type_traits>
 #include <vector>
 #include "lite/backends/x86/jit/helper.h"
 #include "lite/backends/x86/jit/kernel_base.h"
 #include "lite/backends/x86/jit/kernels.h"
 #include "lite/backends/x86/math/blas.h"
+#ifndef PADDLE_WITH_MKLML
+#include "lite/backends/x86/math/sgemm.h"
+#endif
 #include "lite/backends/x86/parallel.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_lite.h"
@@ -31,6 +36,16 @@ namespace lite {
 namespace kernels {
 namespace x86 {
 
+// gelu(x) = 0.5 * x * (1 + erf(x / sqrt(2))), the same as the gelu kernel, on
+// a row of the output while it is in the cache.
+template <typename T>
+inline void GeluInplace(T* x, int n) {
+  for (int i = 0; i < n; i++) {
+    x[i] = static_cast<T>(0.5) * x[i] *
+           (static_cast<T>(1) + std::erf(x[i] * static_cast<T>(M_SQRT1_2)));
+  }
+}
+
 template <lite::TargetType Target, typename T>
 class FCFunctor {
  public:
@@ -43,7 +58,8 @@ class FCFunctor {
                   T* Y,
                   const T* B = nullptr,
                   bool relu = false,
-                  bool padding_weights = false) {
+                  bool padding_weights = false,
+                  bool gelu = false) {
     auto blas = lite::x86::math::GetBlas<lite::TargetType::kX86, T>(context);
     T* Y1_data = nullptr;
 
@@ -58,6 +74,9 @@ class FCFunctor {
         T* dst = Y + i * N;
         T* src = Y1_data ? Y1_data + i * (N + 4) : dst;
         compute(B, src, dst, N);
+        if (gelu) {
+          GeluInplace(dst, N);
+        }
       }
     };
 
@@ -125,6 +144,28 @@ class FcCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
  public:
   using param_t = operators::FcParam;
 
+#ifndef PADDLE_WITH_MKLML
+  // The weights are constant, so they are packed once for the in-tree sgemm.
+  void PrepareForRun() override {
+    auto& param = *param_.get_mutable<param_t>();
+    if (param.padding_weights || !std::is_same<T, float>::value) {
+      return;
+    }
+    const auto& w_dims = param.w->dims();
+    int K = static_cast<int>(w_dims[0]);
+    int N = static_cast<int>(w_dims[1]);
+    packed_w_.Resize(std::vector<int64_t>(
+        {static_cast<int64_t>(lite::x86::math::SgemmPackedBSize(N, K))}));
+    lite::x86::math::SgemmPackB(false,
+                                N,
+                                K,
+                                param.w->template data<float>(),
+                                N,
+                                packed_w_.mutable_data<float>());
+    use_packed_w_ = true;
+  }
+#endif
+
   void Run() override {
     auto& param = *param_.get_mutable<param_t>();
     auto* input = param.input;
@@ -132,6 +173,9 @@ class FcCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
     auto* bias = param.bias;
     auto* output = param.output;
     bool with_relu = (param.activation_type == "relu") ? true : false;
+    // fc + gelu is fused by lite_fc_gelu_fuse_pass with the bias.
+    bool with_gelu = param.activation_type == "gelu";
+    CHECK(!with_gelu || bias) << "fc + gelu requires the bias";
 
     bool padding_weights = param.padding_weights;
     const auto& w_dims = w->dims();
@@ -144,6 +188,13 @@ class FcCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
     const T* w_data = w->template data<T>();
     T* output_data = output->template mutable_data<T>();
 
+#ifndef PADDLE_WITH_MKLML
+    if (use_packed_w_) {
+      RunWithPackedWeights(M, w_dims1, w_dims0, with_relu, with_gelu);
+      return;
+    }
+#endif
+
     auto& context = ctx_->As<X86Context>();
     FCFunctor<lite::TargetType::kX86, T> fc;
     fc(context,
@@ -155,10 +206,56 @@ class FcCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
        output_data,
        bias ? bias->template data<T>() : NULL,
        with_relu,
-       padding_weights);
+       padding_weights,
+       with_gelu);
   }
 
   virtual ~FcCompute() = default;
+
+#ifndef PADDLE_WITH_MKLML
+
+ private:
+  void RunWithPackedWeights(
+      int M, int N, int K, bool with_relu, bool with_gelu) {
+    auto& param = *param_.get_mutable<param_t>();
+    const float* input_data = param.input->template data<float>();
+    float* output_data = param.output->template mutable_data<float>();
+    lite::x86::math::SgemmWithPackedB(false,
+                                      M,
+                                      N,
+                                      K,
+                                      1.f,
+                                      input_data,
+                                      K,
+                                      packed_w_.data<float>(),
+                                      0.f,
+                                      output_data,
+                                      N);
+    if (!param.bias) {
+      return;
+    }
+    const float* bias_data = param.bias->template data<float>();
+    auto compute =
+        with_relu
+            ? jit::KernelFuncs<jit::VAddReluTuple<float>,
+                               fluid::CPUPlace>::Cache()
+                  .At(N)
+            : jit::KernelFuncs<jit::VAddTuple<float>, fluid::CPUPlace>::Cache()
+                  .At(N);
+    lite::x86::RunParallelFor(0, M, [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; i++) {
+        float* dst = output_data + i * N;
+        compute(bias_data, dst, dst, N);
+        if (with_gelu) {
+          GeluInplace(dst, N);
+        }
+      }
+    });
+  }
+
+  Tensor packed_w_;
+  bool use_packed_w_{false};
+#endif
 };
 
 }  // namespace x86
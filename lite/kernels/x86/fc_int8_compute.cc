@@ -0,0 +1,176 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/fc_int8_compute.h"
+#include "lite/backends/x86/math/gemm_s8u8.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+void PackedInt8Weights::Init(const int8_t* w,
+                             int k,
+                             int n,
+                             int ldw,
+                             float input_scale,
+                             const std::vector<float>& weight_scale,
+                             float output_scale,
+                             const float* bias) {
+  CHECK_GT(weight_scale.size(), 0u)
+      << "The int8 kernel needs the scales of the weights";
+  CHECK(weight_scale.size() == 1u ||
+        static_cast<int>(weight_scale.size()) == n);
+  k_ = k;
+  n_ = n;
+  scale_.resize(n);
+  for (int i = 0; i < n; i++) {
+    float w_scale =
+        weight_scale.size() == 1u ? weight_scale[0] : weight_scale[i];
+    scale_[i] = input_scale * w_scale / output_scale;
+  }
+  bias_.clear();
+  if (bias) {
+    for (int i = 0; i < n; i++) {
+      bias_.push_back(bias[i] / output_scale);
+    }
+  }
+  packed_.Resize(
+      {static_cast<int64_t>(lite::x86::math::GemmS8u8PackedASize(n, k))});
+  lite::x86::math::GemmS8u8PackA(
+      true, n, k, w, ldw, packed_.mutable_data<int8_t>());
+}
+
+template <typename T>
+void PackedInt8Weights::Compute(const int8_t* x,
+                                int m,
+                                bool relu,
+                                T* y) const {
+  lite::x86::math::GemmS8u8<T>(n_,
+                               m,
+                               k_,
+                               packed_.data<int8_t>(),
+                               true,
+                               x,
+                               k_,
+                               scale_.data(),
+                               bias_.empty() ? nullptr : bias_.data(),
+                               lite::x86::math::GemmS8u8Act(relu),
+                               true,
+                               y,
+                               n_);
+}
+
+template <PrecisionType OutType>
+void FcInt8Compute<OutType>::PrepareForRun() {
+  auto& param = this->template Param<param_t>();
+  const auto& w_dims = param.w->dims();
+  int k = static_cast<int>(w_dims[0]);
+  int ldw = static_cast<int>(w_dims[1]);
+  int n = param.padding_weights ? ldw - 4 : ldw;
+  if (!param.activation_type.empty()) {
+    CHECK_EQ(param.activation_type, "relu")
+        << "[X86] The int8 fc only supports relu";
+    relu_ = true;
+  }
+  float out_scale = OutType == PRECISION(kInt8) ? param.output_scale : 1.f;
+  weights_.Init(param.w->template data<int8_t>(),
+                k,
+                n,
+                ldw,
+                param.input_scale,
+                param.weight_scale,
+                out_scale,
+                param.bias ? param.bias->template data<float>() : nullptr);
+}
+
+template <PrecisionType OutType>
+void FcInt8Compute<OutType>::Run() {
+  auto& param = this->template Param<param_t>();
+  auto in_mat_dims = param.input->dims().Flatten2D(param.in_num_col_dims);
+  weights_.Compute(param.input->template data<int8_t>(),
+                   static_cast<int>(in_mat_dims[0]),
+                   relu_,
+                   param.output->template mutable_data<out_t>());
+}
+
+template <PrecisionType OutType>
+void MulInt8Compute<OutType>::PrepareForRun() {
+  auto& param = this->template Param<param_t>();
+  auto y_mat_dims = param.y->dims().Flatten2D(param.y_num_col_dims);
+  float out_scale = OutType == PRECISION(kInt8) ? param.output_scale : 1.f;
+  weights_.Init(param.y->template data<int8_t>(),
+                static_cast<int>(y_mat_dims[0]),
+                static_cast<int>(y_mat_dims[1]),
+                static_cast<int>(y_mat_dims[1]),
+                param.input_scale,
+                param.weight_scale,
+                out_scale,
+                nullptr);
+}
+
+template <PrecisionType OutType>
+void MulInt8Compute<OutType>::Run() {
+  auto& param = this->template Param<param_t>();
+  auto x_mat_dims = param.x->dims().Flatten2D(param.x_num_col_dims);
+  weights_.Compute(param.x->template data<int8_t>(),
+                   static_cast<int>(x_mat_dims[0]),
+                   false,
+                   param.output->template mutable_data<out_t>());
+}
+
+template class FcInt8Compute<PRECISION(kInt8)>;
+template class FcInt8Compute<PRECISION(kFloat)>;
+template class MulInt8Compute<PRECISION(kInt8)>;
+template class MulInt8Compute<PRECISION(kFloat)>;
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+typedef paddle::lite::kernels::x86::FcInt8Compute<PRECISION(kInt8)>
+    FcInt8_Int8;
+typedef paddle::lite::kernels::x86::FcInt8Compute<PRECISION(kFloat)>
+    FcInt8_Fp32;
+typedef paddle::lite::kernels::x86::MulInt8Compute<PRECISION(kInt8)>
+    MulInt8_Int8;
+typedef paddle::lite::kernels::x86::MulInt8Compute<PRECISION(kFloat)>
+    MulInt8_Fp32;
+
+REGISTER_LITE_KERNEL(fc, kX86, kInt8, kNCHW, FcInt8_Int8, int8out)
+    .BindInput("Input", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt8))})
+    .BindInput("Bias", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kFloat))})
+    .BindInput("W", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt8))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt8))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(fc, kX86, kInt8, kNCHW, FcInt8_Fp32, fp32out)
+    .BindInput("Input", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt8))})
+    .BindInput("Bias", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kFloat))})
+    .BindInput("W", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt8))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kFloat))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(mul, kX86, kInt8, kNCHW, MulInt8_Int8, int8out)
+    .BindInput("X", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt8))})
+    .BindInput("Y", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt8))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt8))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(mul, kX86, kInt8, kNCHW, MulInt8_Fp32, fp32out)
+    .BindInput("X", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt8))})
+    .BindInput("Y", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt8))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kFloat))})
+    .Finalize();
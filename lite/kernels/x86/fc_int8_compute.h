@@ -0,0 +1,95 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <type_traits>
+#include <vector>
+#include "lite/core/kernel.h"
+#include "lite/core/op_registry.h"
+#include "lite/operators/fc_op.h"
+#include "lite/operators/mul_op.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+/*
+ * The weights of the int8 fc and mul, which are packed once as the A of
+ * GemmS8u8, so Y^T = W^T * X^T is computed with the per-feature scales.
+ */
+class PackedInt8Weights {
+ public:
+  // w is k x n with the leading dimension ldw.
+  void Init(const int8_t* w,
+            int k,
+            int n,
+            int ldw,
+            float input_scale,
+            const std::vector<float>& weight_scale,
+            float output_scale,
+            const float* bias);
+
+  // y(m x n) = requantize(x(m x k) * w).
+  template <typename T>
+  void Compute(const int8_t* x, int m, bool relu, T* y) const;
+
+ private:
+  int k_{0};
+  int n_{0};
+  Tensor packed_;
+  std::vector<float> scale_;
+  std::vector<float> bias_;
+};
+
+template <PrecisionType OutType>
+class FcInt8Compute : public KernelLite<TARGET(kX86), PRECISION(kInt8)> {
+ public:
+  using param_t = operators::FcParam;
+  using out_t = typename std::
+      conditional<OutType == PRECISION(kInt8), int8_t, float>::type;
+
+  void PrepareForRun() override;
+
+  void Run() override;
+
+  virtual ~FcInt8Compute() = default;
+
+ private:
+  PackedInt8Weights weights_;
+  bool relu_{false};
+};
+
+template <PrecisionType OutType>
+class MulInt8Compute : public KernelLite<TARGET(kX86), PRECISION(kInt8)> {
+ public:
+  using param_t = operators::MulParam;
+  using out_t = typename std::
+      conditional<OutType == PRECISION(kInt8), int8_t, float>::type;
+
+  void PrepareForRun() override;
+
+  void Run() override;
+
+  virtual ~MulInt8Compute() = default;
+
+ private:
+  PackedInt8Weights weights_;
+};
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
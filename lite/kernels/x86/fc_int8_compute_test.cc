@@ -0,0 +1,203 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/fc_int8_compute.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+static void fill_int8(lite::Tensor* t, int seed) {
+  int8_t* data = t->mutable_data<int8_t>();
+  for (int64_t i = 0; i < t->numel(); i++) {
+    data[i] = static_cast<int8_t>((i * 31 + seed) % 255 - 127);
+  }
+}
+
+// out[m][n] = relu(x[m][k] * w[k][n] * scale[n] + bias[n])
+static std::vector<float> matmul_ref(const int8_t* x,
+                                     const int8_t* w,
+                                     int m,
+                                     int n,
+                                     int k,
+                                     int ldw,
+                                     const std::vector<float>& scale,
+                                     const float* bias,
+                                     bool relu) {
+  std::vector<float> out(m * n);
+  for (int i = 0; i < m; i++) {
+    for (int j = 0; j < n; j++) {
+      int32_t acc = 0;
+      for (int p = 0; p < k; p++) {
+        acc += x[i * k + p] * w[p * ldw + j];
+      }
+      float v = acc * scale[j] + (bias ? bias[j] : 0.f);
+      if (relu) v = (std::max)(v, 0.f);
+      out[i * n + j] = v;
+    }
+  }
+  return out;
+}
+
+template <typename T>
+static void check_result(const T* out,
+                         const std::vector<float>& ref,
+                         float out_scale) {
+  for (size_t i = 0; i < ref.size(); i++) {
+    if (std::is_same<T, int8_t>::value) {
+      float q = std::round(ref[i] / out_scale);
+      q = (std::min)(127.f, (std::max)(-127.f, q));
+      EXPECT_NEAR(out[i], q, 1);
+    } else {
+      EXPECT_NEAR(out[i], ref[i], 1e-3 * (1 + std::fabs(ref[i])));
+    }
+  }
+}
+
+template <PrecisionType OutType>
+static void test_fc_int8(int m, int k, int n, bool padding, bool relu) {
+  using out_t = typename FcInt8Compute<OutType>::out_t;
+  int ldw = padding ? n + 4 : n;
+  lite::Tensor x, w, bias, out;
+  x.Resize({m, k});
+  w.Resize({k, ldw});
+  bias.Resize({n});
+  out.Resize({m, n});
+  fill_int8(&x, 3);
+  fill_int8(&w, 5);
+  float* bias_data = bias.mutable_data<float>();
+  std::vector<float> w_scale(n);
+  std::vector<float> scale(n);
+  for (int i = 0; i < n; i++) {
+    bias_data[i] = 0.05f * (i % 9) - 0.2f;
+    w_scale[i] = 0.002f * (i % 3 + 1);
+    scale[i] = 0.01f * w_scale[i];
+  }
+
+  operators::FcParam param;
+  param.input = &x;
+  param.w = &w;
+  param.bias = &bias;
+  param.output = &out;
+  param.in_num_col_dims = 1;
+  param.padding_weights = padding;
+  param.activation_type = relu ? "relu" : "";
+  param.enable_int8 = true;
+  param.input_scale = 0.01f;
+  param.weight_scale = w_scale;
+  param.output_scale = 0.02f;
+
+  FcInt8Compute<OutType> fc;
+  std::unique_ptr<KernelContext> ctx(new KernelContext);
+  ctx->As<X86Context>();
+  fc.SetContext(std::move(ctx));
+  fc.SetParam(param);
+  fc.PrepareForRun();
+  fc.Run();
+
+  auto ref = matmul_ref(x.data<int8_t>(),
+                        w.data<int8_t>(),
+                        m,
+                        n,
+                        k,
+                        ldw,
+                        scale,
+                        bias_data,
+                        relu);
+  check_result(out.data<out_t>(), ref, param.output_scale);
+}
+
+template <PrecisionType OutType>
+static void test_mul_int8(int m, int k, int n) {
+  using out_t = typename MulInt8Compute<OutType>::out_t;
+  lite::Tensor x, y, out;
+  x.Resize({m, 2, k / 2});
+  y.Resize({k, n});
+  out.Resize({m, n});
+  fill_int8(&x, 1);
+  fill_int8(&y, 9);
+
+  operators::MulParam param;
+  param.x = &x;
+  param.y = &y;
+  param.output = &out;
+  param.x_num_col_dims = 1;
+  param.y_num_col_dims = 1;
+  param.enable_int8 = true;
+  param.input_scale = 0.01f;
+  param.weight_scale = {0.003f};
+  param.output_scale = 0.02f;
+
+  MulInt8Compute<OutType> mul;
+  std::unique_ptr<KernelContext> ctx(new KernelContext);
+  ctx->As<X86Context>();
+  mul.SetContext(std::move(ctx));
+  mul.SetParam(param);
+  mul.PrepareForRun();
+  mul.Run();
+
+  std::vector<float> scale(n, 0.01f * 0.003f);
+  auto ref = matmul_ref(x.data<int8_t>(),
+                        y.data<int8_t>(),
+                        m,
+                        n,
+                        k,
+                        n,
+                        scale,
+                        nullptr,
+                        false);
+  check_result(out.data<out_t>(), ref, param.output_scale);
+}
+
+TEST(fc_int8_x86, init) {
+  FcInt8Compute<PRECISION(kInt8)> fc;
+  ASSERT_EQ(fc.precision(), PRECISION(kInt8));
+  ASSERT_EQ(fc.target(), TARGET(kX86));
+}
+
+TEST(fc_int8_x86, run_test) {
+  for (int m : {1, 3, 17}) {
+    for (bool relu : {false, true}) {
+      test_fc_int8<PRECISION(kFloat)>(m, 70, 45, false, relu);
+      test_fc_int8<PRECISION(kInt8)>(m, 64, 33, false, relu);
+      test_fc_int8<PRECISION(kFloat)>(m, 36, 20, true, relu);
+    }
+  }
+}
+
+TEST(mul_int8_x86, run_test) {
+  for (int m : {1, 5, 32}) {
+    test_mul_int8<PRECISION(kFloat)>(m, 50, 19);
+    test_mul_int8<PRECISION(kInt8)>(m, 128, 64);
+  }
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_KERNEL(fc, kX86, kInt8, kNCHW, int8out);
+USE_LITE_KERNEL(fc, kX86, kInt8, kNCHW, fp32out);
+USE_LITE_KERNEL(mul, kX86, kInt8, kNCHW, int8out);
+USE_LITE_KERNEL(mul, kX86, kInt8, kNCHW, fp32out);
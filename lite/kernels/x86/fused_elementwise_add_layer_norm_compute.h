@@ -0,0 +1,84 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <vector>
+#include "lite/backends/x86/jit/helper.h"
+#include "lite/backends/x86/jit/kernel_base.h"
+#include "lite/backends/x86/jit/kernels.h"
+#include "lite/backends/x86/parallel.h"
+#include "lite/core/kernel.h"
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+// out = layer_norm(x + y), y is repeated along the leading dims of x. The sum
+// of a row is normalized while it is in the cache, and neither the sum nor the
+// mean and variance are written out.
+template <typename T>
+class FusedElementwiseAddLayerNormCompute
+    : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
+ public:
+  using param_t = operators::FusedElementwiseAddLayerNormParam;
+
+  void Run() override {
+    auto& param = *param_.get_mutable<param_t>();
+    auto matrix_dim = param.X->dims().Flatten2D(param.begin_norm_axis);
+    const int64_t left = matrix_dim[0];
+    const int right = static_cast<int>(matrix_dim[1]);
+    const T* x = param.X->template data<T>();
+    const T* y = param.Y->template data<T>();
+    const int64_t y_rows = param.Y->numel() / right;
+    const T* scale = param.Scale->template data<T>();
+    const T* bias = param.Bias->template data<T>();
+    const float epsilon = param.epsilon;
+    T* out = param.Out->template mutable_data<T>();
+
+    auto add = jit::KernelFuncs<jit::VAddTuple<T>, fluid::CPUPlace>::Cache().At(
+        right);
+    auto layer_norm =
+        jit::KernelFuncs<jit::LayerNormTuple<T>, fluid::CPUPlace>::Cache().At(
+            right);
+    lite::x86::RunParallelFor(0, left, [&](int64_t begin, int64_t end) {
+      // The layer_norm kernel can not run in place.
+      std::vector<T> sum(right);
+      for (int64_t i = begin; i < end; i++) {
+        T mean;
+        T var;
+        add(x + i * right, y + (i % y_rows) * right, sum.data(), right);
+        layer_norm(sum.data(),
+                   out + i * right,
+                   &mean,
+                   &var,
+                   scale,
+                   bias,
+                   1,
+                   epsilon,
+                   right);
+      }
+    });
+  }
+
+  virtual ~FusedElementwiseAddLayerNormCompute() = default;
+};
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,106 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/fused_elementwise_add_layer_norm_compute.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+TEST(fused_elementwise_add_layer_norm_x86, retrive_op) {
+  auto kernels =
+      KernelRegistry::Global().Create("fused_elementwise_add_layer_norm");
+  ASSERT_FALSE(kernels.empty());
+  ASSERT_TRUE(kernels.front());
+}
+
+TEST(fused_elementwise_add_layer_norm_x86, compute) {
+  const int rows = 6;
+  const float epsilon = 1e-5f;
+  // The widths of the vectorized kernel with and without the tail, and y of
+  // the same shape or broadcasted along the batch.
+  for (int width : {32, 13}) {
+    for (bool broadcast : {false, true}) {
+      lite::Tensor x, y, scale, bias, out;
+      x.Resize({2, rows / 2, width});
+      if (broadcast) {
+        y.Resize({rows / 2, width});
+      } else {
+        y.Resize({2, rows / 2, width});
+      }
+      scale.Resize({width});
+      bias.Resize({width});
+      out.Resize({2, rows / 2, width});
+      auto* x_data = x.mutable_data<float>();
+      auto* y_data = y.mutable_data<float>();
+      for (int i = 0; i < x.numel(); i++) {
+        x_data[i] = static_cast<float>(i % 7) - 3.f;
+      }
+      for (int i = 0; i < y.numel(); i++) {
+        y_data[i] = static_cast<float>(i % 5) * 0.5f;
+      }
+      auto* scale_data = scale.mutable_data<float>();
+      auto* bias_data = bias.mutable_data<float>();
+      for (int i = 0; i < width; i++) {
+        scale_data[i] = 1.f + static_cast<float>(i % 3) * 0.25f;
+        bias_data[i] = static_cast<float>(i % 4) * 0.1f;
+      }
+
+      FusedElementwiseAddLayerNormCompute<float> kernel;
+      operators::FusedElementwiseAddLayerNormParam param;
+      param.X = &x;
+      param.Y = &y;
+      param.Scale = &scale;
+      param.Bias = &bias;
+      param.Out = &out;
+      param.begin_norm_axis = 2;
+      param.epsilon = epsilon;
+      kernel.SetParam(param);
+      kernel.Run();
+
+      auto* out_data = out.data<float>();
+      const int y_rows = y.numel() / width;
+      for (int i = 0; i < rows; i++) {
+        std::vector<float> sum(width);
+        float mean = 0.f;
+        for (int j = 0; j < width; j++) {
+          sum[j] = x_data[i * width + j] + y_data[(i % y_rows) * width + j];
+          mean += sum[j] / width;
+        }
+        float var = 0.f;
+        for (int j = 0; j < width; j++) {
+          var += (sum[j] - mean) * (sum[j] - mean) / width;
+        }
+        for (int j = 0; j < width; j++) {
+          float ref = (sum[j] - mean) / std::sqrt(var + epsilon) *
+                          scale_data[j] +
+                      bias_data[j];
+          EXPECT_NEAR(out_data[i * width + j], ref, 1e-4);
+        }
+      }
+    }
+  }
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_KERNEL(fused_elementwise_add_layer_norm, kX86, kFloat, kNCHW, def);
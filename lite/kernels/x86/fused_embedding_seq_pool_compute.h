@@ -0,0 +1,115 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstring>
+#include <vector>
+#include "lite/backends/x86/jit/helper.h"
+#include "lite/backends/x86/jit/kernel_base.h"
+#include "lite/backends/x86/jit/kernels.h"
+#include "lite/backends/x86/math/embedding.h"
+#include "lite/backends/x86/parallel.h"
+#include "lite/core/kernel.h"
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+// Sums the embeddings of every sequence of the ids, the same as
+// lookup_table(_v2) followed by sequence_pool(SUM) without gathering the
+// embeddings of all the ids. The sequences are pooled in parallel and every
+// sequence is pooled by the EmbSeqPool jit kernel, or the rows are
+// accumulated one by one for the padding ids and the compressed tables.
+template <typename T>
+class FusedEmbeddingSeqPoolCompute
+    : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
+ public:
+  using param_t = operators::FusedEmbeddingSeqPoolParam;
+
+  void Run() override {
+    auto& param = *param_.get_mutable<param_t>();
+    auto* ids_t = param.Ids;
+    auto* table_t = param.W;
+    auto* out_t = param.Out;
+    const int64_t* ids = ids_t->template data<int64_t>();
+    T* out = out_t->template mutable_data<T>();
+
+    const auto& lod = ids_t->lod()[0];
+    const int64_t table_height = table_t->dims()[0];
+    const int64_t table_width = table_t->dims()[1];
+    const int64_t ids_numel = ids_t->numel();
+    const int64_t index_width =
+        ids_t->dims()[0] > 0 ? ids_numel / ids_t->dims()[0] : 1;
+    const int64_t out_width = table_width * index_width;
+    const int64_t num_seqs = static_cast<int64_t>(lod.size()) - 1;
+    const int64_t padding_idx = param.padding_idx;
+    const bool compressed = lite::x86::math::IsCompressedEmbedding(*table_t);
+    const T* table = compressed ? nullptr : table_t->template data<T>();
+    lite::x86::math::EmbeddingTable rows(*table_t, param.weight_scale);
+    CHECK_EQ(static_cast<int64_t>(lod.back()) * index_width, ids_numel);
+
+    // The jit kernel does not check the ids.
+    for (int64_t i = 0; i < ids_numel; i++) {
+      if (ids[i] == padding_idx) continue;
+      CHECK_GE(ids[i], 0);
+      CHECK_LT(ids[i], table_height);
+    }
+
+    jit::emb_seq_pool_attr_t attr(table_height,
+                                  table_width,
+                                  1,
+                                  index_width,
+                                  out_width,
+                                  jit::SeqPoolType::kSum);
+    auto emb_seq_pool =
+        jit::KernelFuncs<jit::EmbSeqPoolTuple<T>, fluid::CPUPlace>::Cache().At(
+            attr);
+
+    lite::x86::RunParallelFor(
+        0, num_seqs, [&](int64_t begin, int64_t end) {
+          for (int64_t i = begin; i < end; i++) {
+            const int64_t* seq_ids = ids + lod[i] * index_width;
+            T* seq_out = out + i * out_width;
+            int64_t seq_len = lod[i + 1] - lod[i];
+            if (padding_idx != -1 || compressed) {
+              // The padding ids contribute zeros, so they are skipped.
+              memset(seq_out, 0, out_width * sizeof(T));
+              for (int64_t h = 0; h < seq_len; h++) {
+                for (int64_t w = 0; w < index_width; w++) {
+                  int64_t id = seq_ids[h * index_width + w];
+                  if (id == padding_idx) continue;
+                  rows.AddRow(id, seq_out + w * table_width);
+                }
+              }
+            } else if (seq_len == 0) {
+              memset(seq_out, 0, out_width * sizeof(T));
+            } else {
+              jit::emb_seq_pool_attr_t seq_attr = attr;
+              seq_attr.index_height = seq_len;
+              emb_seq_pool(table, seq_ids, seq_out, &seq_attr);
+            }
+          }
+        });
+  }
+
+  virtual ~FusedEmbeddingSeqPoolCompute() = default;
+};
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,106 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/fused_embedding_seq_pool_compute.h"
+#include <gtest/gtest.h>
+#include <vector>
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+// lookup_table followed by sequence_pool(SUM).
+static void EmbeddingSeqPoolRef(const lite::Tensor& w,
+                                const lite::Tensor& ids,
+                                int64_t padding_idx,
+                                std::vector<float>* out) {
+  int64_t width = w.dims()[1];
+  int64_t index_width = ids.numel() / ids.dims()[0];
+  auto& lod = ids.lod()[0];
+  const float* w_data = w.data<float>();
+  const int64_t* ids_data = ids.data<int64_t>();
+  out->assign((lod.size() - 1) * index_width * width, 0.f);
+  for (size_t i = 0; i + 1 < lod.size(); i++) {
+    for (uint64_t h = lod[i]; h < lod[i + 1]; h++) {
+      for (int64_t k = 0; k < index_width; k++) {
+        int64_t id = ids_data[h * index_width + k];
+        if (id == padding_idx) continue;
+        for (int64_t j = 0; j < width; j++) {
+          (*out)[(i * index_width + k) * width + j] += w_data[id * width + j];
+        }
+      }
+    }
+  }
+}
+
+TEST(fused_embedding_seq_pool_x86, retrive_op) {
+  auto kernels = KernelRegistry::Global().Create("fused_embedding_seq_pool");
+  ASSERT_FALSE(kernels.empty());
+  ASSERT_TRUE(kernels.front());
+}
+
+TEST(fused_embedding_seq_pool_x86, compute) {
+  const int vocab_size = 50;
+  // The widths of the jit kernel and the fallback of the others.
+  for (int emb_size : {16, 64, 13}) {
+    for (int index_width : {1, 3}) {
+      for (int64_t padding_idx : {-1, 7}) {
+        FusedEmbeddingSeqPoolCompute<float> kernel;
+        operators::FusedEmbeddingSeqPoolParam param;
+        lite::Tensor w, ids, out;
+        // An empty sequence is included.
+        LoD lod{{0, 4, 4, 11, 12, 20}};
+        int num_ids = lod[0].back();
+        int num_seqs = lod[0].size() - 1;
+
+        w.Resize({vocab_size, emb_size});
+        auto* w_data = w.mutable_data<float>();
+        for (int i = 0; i < w.numel(); i++) {
+          w_data[i] = static_cast<float>(i % 17) / 17.f - 0.5f;
+        }
+        ids.Resize({num_ids, index_width});
+        ids.set_lod(lod);
+        auto* ids_data = ids.mutable_data<int64_t>();
+        for (int i = 0; i < ids.numel(); i++) {
+          ids_data[i] = (i * 7 + 3) % vocab_size;
+        }
+        out.Resize({num_seqs, index_width * emb_size});
+
+        param.W = &w;
+        param.Ids = &ids;
+        param.Out = &out;
+        param.padding_idx = padding_idx;
+        kernel.SetParam(param);
+        kernel.Run();
+
+        std::vector<float> ref;
+        EmbeddingSeqPoolRef(w, ids, padding_idx, &ref);
+        ASSERT_EQ(out.numel(), static_cast<int64_t>(ref.size()));
+        auto* out_data = out.data<float>();
+        for (size_t i = 0; i < ref.size(); i++) {
+          EXPECT_NEAR(out_data[i], ref[i], 1e-5);
+        }
+      }
+    }
+  }
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_KERNEL(fused_embedding_seq_pool, kX86, kFloat, kNCHW, def);
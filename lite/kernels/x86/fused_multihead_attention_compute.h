@@ -0,0 +1,231 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <vector>
+#include "lite/backends/x86/jit/helper.h"
+#include "lite/backends/x86/jit/kernel_base.h"
+#include "lite/backends/x86/jit/kernels.h"
+#include "lite/backends/x86/math/blas.h"
+#ifndef PADDLE_WITH_MKLML
+#include "lite/backends/x86/math/sgemm.h"
+#endif
+#include "lite/backends/x86/parallel.h"
+#include "lite/core/kernel.h"
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+// The multi-head attention of the transformer encoder:
+//   q, k, v = split(input * QKVW + QKVBias), for every head
+//   out = softmax(alpha * q * k^T + mask) * v
+// q, k and v are computed by one GEMM. The attention of every head is split
+// into the tiles of kBlockRows queries, the scores of a tile stay in the cache
+// until its context is computed, and the tiles run in parallel. The context
+// is written to the output in [batch, seq_len, hidden] directly, so neither
+// the scores of the whole sequence nor the transposes are materialized.
+template <typename T>
+class FusedMultiheadAttentionCompute
+    : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
+ public:
+  using param_t = operators::FusedMultiheadAttentionParam;
+
+  static constexpr int kBlockRows = 32;
+
+#ifndef PADDLE_WITH_MKLML
+  // The weights are constant, so they are packed once for the in-tree sgemm.
+  void PrepareForRun() override {
+    auto& param = *param_.get_mutable<param_t>();
+    const auto& w_dims = param.QKVW->dims();
+    int K = static_cast<int>(w_dims[0]);
+    int N = static_cast<int>(w_dims[1]);
+    packed_w_.Resize(std::vector<int64_t>(
+        {static_cast<int64_t>(lite::x86::math::SgemmPackedBSize(N, K))}));
+    lite::x86::math::SgemmPackB(false,
+                                N,
+                                K,
+                                param.QKVW->template data<float>(),
+                                N,
+                                packed_w_.mutable_data<float>());
+  }
+#endif
+
+  void Run() override {
+    auto& param = *param_.get_mutable<param_t>();
+    auto& context = ctx_->As<X86Context>();
+    auto blas = lite::x86::math::GetBlas<lite::TargetType::kX86, T>(context);
+    const auto& input_dims = param.Input->dims();
+    const int batch = static_cast<int>(input_dims[0]);
+    const int seq_len = static_cast<int>(input_dims[1]);
+    const int hidden = static_cast<int>(input_dims[2]);
+    const int head_number = param.head_number;
+    const int head_size = hidden / head_number;
+    const int qkv_width = 3 * hidden;
+    const int rows = batch * seq_len;
+    const T alpha = static_cast<T>(param.alpha);
+    const T* input = param.Input->template data<T>();
+    T* out = param.Out->template mutable_data<T>();
+
+    // q, k and v of all of the tokens, [batch * seq_len, 3 * hidden].
+    qkv_.Resize(std::vector<int64_t>({rows, qkv_width}));
+    T* qkv = qkv_.template mutable_data<T>();
+#ifndef PADDLE_WITH_MKLML
+    lite::x86::math::SgemmWithPackedB(false,
+                                      rows,
+                                      qkv_width,
+                                      hidden,
+                                      1.f,
+                                      input,
+                                      hidden,
+                                      packed_w_.data<float>(),
+                                      0.f,
+                                      qkv,
+                                      qkv_width);
+#else
+    blas.MatMul(rows, qkv_width, hidden, input, param.QKVW->template data<T>(),
+                qkv);
+#endif
+    const T* qkv_bias = param.QKVBias->template data<T>();
+    auto add_bias =
+        jit::KernelFuncs<jit::VAddTuple<T>, fluid::CPUPlace>::Cache().At(
+            qkv_width);
+    lite::x86::RunParallelFor(0, rows, [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; i++) {
+        T* row = qkv + i * qkv_width;
+        add_bias(qkv_bias, row, row, qkv_width);
+      }
+    });
+
+    // The mask is broadcasted from the trailing dims, the strides of the
+    // broadcasted dims are 0.
+    const T* mask = param.Mask ? param.Mask->template data<T>() : nullptr;
+    int64_t mask_strides[4] = {0, 0, 0, 0};
+    if (mask) {
+      const int64_t full_dims[4] = {batch, head_number, seq_len, seq_len};
+      auto mask_dims = param.Mask->dims().Vectorize();
+      mask_dims.insert(mask_dims.begin(), 4 - mask_dims.size(), 1);
+      int64_t stride = 1;
+      for (int i = 3; i >= 0; i--) {
+        CHECK(mask_dims[i] == 1 || mask_dims[i] == full_dims[i])
+            << "The mask " << param.Mask->dims()
+            << " can not be broadcasted to the scores";
+        mask_strides[i] = mask_dims[i] == 1 ? 0 : stride;
+        stride *= mask_dims[i];
+      }
+      CHECK_EQ(mask_dims[3], seq_len)
+          << "The mask should not be broadcasted along the keys";
+    }
+
+    auto exp =
+        jit::KernelFuncs<jit::VExpTuple<T>, fluid::CPUPlace>::Cache().At(
+            seq_len);
+    const int num_blocks = (seq_len + kBlockRows - 1) / kBlockRows;
+    lite::x86::RunParallelFor(
+        0,
+        static_cast<int64_t>(batch) * head_number * num_blocks,
+        [&](int64_t begin, int64_t end) {
+          std::vector<T> scores(kBlockRows * seq_len);
+          for (int64_t t = begin; t < end; t++) {
+            const int block = t % num_blocks;
+            const int head = (t / num_blocks) % head_number;
+            const int b = t / num_blocks / head_number;
+            const int q_begin = block * kBlockRows;
+            const int block_rows = (std::min)(kBlockRows, seq_len - q_begin);
+            const T* seq = qkv + static_cast<int64_t>(b) * seq_len * qkv_width;
+            const T* q = seq + q_begin * qkv_width + head * head_size;
+            const T* k = seq + hidden + head * head_size;
+            const T* v = seq + 2 * hidden + head * head_size;
+
+            // scores = alpha * q * k^T
+            blas.GEMM(false,
+                      true,
+                      block_rows,
+                      seq_len,
+                      head_size,
+                      alpha,
+                      q,
+                      qkv_width,
+                      k,
+                      qkv_width,
+                      static_cast<T>(0),
+                      scores.data(),
+                      seq_len);
+            for (int i = 0; i < block_rows; i++) {
+              T* row = scores.data() + i * seq_len;
+              if (mask) {
+                const T* mask_row = mask + b * mask_strides[0] +
+                                    head * mask_strides[1] +
+                                    (q_begin + i) * mask_strides[2];
+                for (int j = 0; j < seq_len; j++) {
+                  row[j] += mask_row[j];
+                }
+              }
+              T max_score = row[0];
+              for (int j = 1; j < seq_len; j++) {
+                max_score = (std::max)(max_score, row[j]);
+              }
+              for (int j = 0; j < seq_len; j++) {
+                row[j] -= max_score;
+              }
+              exp(row, row, seq_len);
+              T sum = 0;
+              for (int j = 0; j < seq_len; j++) {
+                sum += row[j];
+              }
+              const T inv_sum = static_cast<T>(1) / sum;
+              for (int j = 0; j < seq_len; j++) {
+                row[j] *= inv_sum;
+              }
+            }
+
+            // out = scores * v
+            T* out_block = out +
+                           (static_cast<int64_t>(b) * seq_len + q_begin) *
+                               hidden +
+                           head * head_size;
+            blas.GEMM(false,
+                      false,
+                      block_rows,
+                      head_size,
+                      seq_len,
+                      static_cast<T>(1),
+                      scores.data(),
+                      seq_len,
+                      v,
+                      qkv_width,
+                      static_cast<T>(0),
+                      out_block,
+                      hidden);
+          }
+        });
+  }
+
+  virtual ~FusedMultiheadAttentionCompute() = default;
+
+ private:
+  Tensor qkv_;
+#ifndef PADDLE_WITH_MKLML
+  Tensor packed_w_;
+#endif
+};
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
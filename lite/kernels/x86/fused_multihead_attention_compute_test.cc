@@ -0,0 +1,170 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/fused_multihead_attention_compute.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+// The unfused attention: the projections, the scores of every head, the
+// softmax and the context.
+static void MultiheadAttentionRef(const lite::Tensor& input,
+                                  const lite::Tensor& w,
+                                  const lite::Tensor& bias,
+                                  const lite::Tensor* mask,
+                                  int head_number,
+                                  float alpha,
+                                  std::vector<float>* out) {
+  const int batch = input.dims()[0];
+  const int seq_len = input.dims()[1];
+  const int hidden = input.dims()[2];
+  const int head_size = hidden / head_number;
+  const float* x = input.data<float>();
+  const float* w_data = w.data<float>();
+  const float* b_data = bias.data<float>();
+  std::vector<float> qkv(batch * seq_len * 3 * hidden);
+  for (int i = 0; i < batch * seq_len; i++) {
+    for (int j = 0; j < 3 * hidden; j++) {
+      float sum = b_data[j];
+      for (int k = 0; k < hidden; k++) {
+        sum += x[i * hidden + k] * w_data[k * 3 * hidden + j];
+      }
+      qkv[i * 3 * hidden + j] = sum;
+    }
+  }
+  out->assign(batch * seq_len * hidden, 0.f);
+  std::vector<float> scores(seq_len);
+  for (int b = 0; b < batch; b++) {
+    for (int h = 0; h < head_number; h++) {
+      for (int i = 0; i < seq_len; i++) {
+        const float* q = &qkv[(b * seq_len + i) * 3 * hidden + h * head_size];
+        float max_score = -1e30f;
+        for (int j = 0; j < seq_len; j++) {
+          const float* k =
+              &qkv[(b * seq_len + j) * 3 * hidden + hidden + h * head_size];
+          float dot = 0.f;
+          for (int d = 0; d < head_size; d++) {
+            dot += q[d] * k[d];
+          }
+          scores[j] = alpha * dot;
+          if (mask) {
+            // The mask is [batch, 1, 1, seq_len].
+            scores[j] += mask->data<float>()[b * seq_len + j];
+          }
+          max_score = std::max(max_score, scores[j]);
+        }
+        float sum = 0.f;
+        for (int j = 0; j < seq_len; j++) {
+          scores[j] = std::exp(scores[j] - max_score);
+          sum += scores[j];
+        }
+        for (int j = 0; j < seq_len; j++) {
+          const float* v = &qkv[(b * seq_len + j) * 3 * hidden + 2 * hidden +
+                                h * head_size];
+          for (int d = 0; d < head_size; d++) {
+            (*out)[(b * seq_len + i) * hidden + h * head_size + d] +=
+                scores[j] / sum * v[d];
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST(fused_multihead_attention_x86, retrive_op) {
+  auto kernels = KernelRegistry::Global().Create("fused_multihead_attention");
+  ASSERT_FALSE(kernels.empty());
+  ASSERT_TRUE(kernels.front());
+}
+
+TEST(fused_multihead_attention_x86, compute) {
+  const int batch = 2;
+  const int head_number = 4;
+  const int head_size = 8;
+  const int hidden = head_number * head_size;
+  const float alpha = 1.f / std::sqrt(static_cast<float>(head_size));
+  // The sequences shorter and longer than a tile of the queries.
+  for (int seq_len : {5, 45}) {
+    for (bool with_mask : {false, true}) {
+      lite::Tensor input, w, bias, mask, out;
+      input.Resize({batch, seq_len, hidden});
+      w.Resize({hidden, 3 * hidden});
+      bias.Resize({3 * hidden});
+      mask.Resize({batch, 1, 1, seq_len});
+      out.Resize({batch, seq_len, hidden});
+      auto* input_data = input.mutable_data<float>();
+      for (int i = 0; i < input.numel(); i++) {
+        input_data[i] = static_cast<float>(i % 13) / 13.f - 0.5f;
+      }
+      auto* w_data = w.mutable_data<float>();
+      for (int i = 0; i < w.numel(); i++) {
+        w_data[i] = static_cast<float>(i % 11) / 22.f - 0.25f;
+      }
+      auto* bias_data = bias.mutable_data<float>();
+      for (int i = 0; i < bias.numel(); i++) {
+        bias_data[i] = static_cast<float>(i % 5) / 10.f;
+      }
+      // The padded tokens of the second sequence are masked out.
+      auto* mask_data = mask.mutable_data<float>();
+      for (int i = 0; i < mask.numel(); i++) {
+        mask_data[i] = i >= seq_len && i % seq_len >= 3 ? -10000.f : 0.f;
+      }
+
+      FusedMultiheadAttentionCompute<float> kernel;
+      operators::FusedMultiheadAttentionParam param;
+      param.Input = &input;
+      param.QKVW = &w;
+      param.QKVBias = &bias;
+      param.Mask = with_mask ? &mask : nullptr;
+      param.Out = &out;
+      param.head_number = head_number;
+      param.alpha = alpha;
+      std::unique_ptr<KernelContext> ctx(new KernelContext);
+      ctx->As<X86Context>();
+      kernel.SetContext(std::move(ctx));
+      kernel.SetParam(param);
+      kernel.PrepareForRun();
+      kernel.Run();
+
+      std::vector<float> ref;
+      MultiheadAttentionRef(input,
+                            w,
+                            bias,
+                            with_mask ? &mask : nullptr,
+                            head_number,
+                            alpha,
+                            &ref);
+      auto* out_data = out.data<float>();
+      for (size_t i = 0; i < ref.size(); i++) {
+        EXPECT_NEAR(out_data[i], ref[i], 1e-4);
+      }
+    }
+  }
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_KERNEL(fused_multihead_attention, kX86, kFloat, kNCHW, def);
@@ -13,8 +13,12 @@
 // limitations under the License.
 #pragma once
 
+#include <cstring>
 #include <string>
 #include <vector>
+#include "lite/backends/x86/jit/helper.h"
+#include "lite/backends/x86/jit/kernel_base.h"
+#include "lite/backends/x86/jit/kernels.h"
 #include "lite/backends/x86/math/blas.h"
 #include "lite/backends/x86/math/detail/gru_cpu_kernel.h"
 #include "lite/backends/x86/math/detail/gru_kernel.h"
@@ -26,9 +30,6 @@
 #include "lite/core/types.h"
 #include "lite/fluid/eigen.h"
 
-// DECLARE_int32(paddle_num_threads);
-extern int32_t paddle_num_threads;
-
 namespace paddle {
 namespace lite {
 namespace kernels {
@@ -52,9 +53,55 @@ static inline int64_t CalculateSeqWidth(const DDim& dims) {
   return dims.count(1, dims.size());
 }
 
+/*
+ * The input of gru is the projection of the gates {u, r, c} of all the time
+ * steps, made by the fc before it. If not origin_mode, GRU runs in the fused
+ * mode: the recurrent weights are packed once with MKL, and the JIT GRU
+ * kernels activate the gates of the rows right after the GEMM of them.
+ */
 template <typename T>
 class GRUCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
  public:
+  void PrepareForRun() override {
+#ifdef PADDLE_WITH_MKLML
+    auto& context = ctx_->As<X86Context>();
+    auto& param = *param_.get_mutable<operators::GRUParam>();
+    if (param.origin_mode) return;
+    auto blas = lite::x86::math::GetBlas<TARGET(kX86), T>(context);
+    int frame_size = param.weight->dims()[0];
+    const T* weight_data = param.weight->template data<T>();
+    ReleasePackedWeights();
+    packed_gate_ = blas.GEMM_ALLOC(CblasBMatrix,
+                                   1 /*height of C*/,
+                                   frame_size * 2 /*width of weight*/,
+                                   frame_size /*height of weight*/);
+    CHECK(packed_gate_);
+    blas.GEMM_PACK(CblasBMatrix,
+                   CblasNoTrans,
+                   1 /*height of C*/,
+                   frame_size * 2,
+                   frame_size,
+                   T(1.0),
+                   weight_data,
+                   frame_size * 2,
+                   packed_gate_);
+    packed_state_ = blas.GEMM_ALLOC(CblasBMatrix,
+                                    1 /*height of C*/,
+                                    frame_size /*width of weight*/,
+                                    frame_size /*height of weight*/);
+    CHECK(packed_state_);
+    blas.GEMM_PACK(CblasBMatrix,
+                   CblasNoTrans,
+                   1 /*height of C*/,
+                   frame_size,
+                   frame_size,
+                   T(1.0),
+                   weight_data + 2 * frame_size * frame_size,
+                   frame_size,
+                   packed_state_);
+#endif
+  }
+
   void Run() override {
     auto& context = ctx_->As<X86Context>();
     auto& param = *param_.get_mutable<operators::GRUParam>();
@@ -118,78 +165,15 @@ class GRUCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
     auto active_gate =
         lite::x86::math::detail::GetActivationType(param.gate_activation);
 
-#ifdef PADDLE_WITH_MKLML
-    // use MKL packed to speedup GEMM
-    if (paddle_num_threads >= 4) {
-      auto blas = lite::x86::math::GetBlas<TARGET(kX86), T>(context);
-      T* packed_gate = blas.GEMM_ALLOC(CblasBMatrix,
-                                       1 /*height of C*/,
-                                       frame_size * 2 /*width of weight*/,
-                                       frame_size /*height of height*/);
-      CHECK(packed_gate);
-      blas.GEMM_PACK(CblasBMatrix,
-                     CblasNoTrans,
-                     1 /*cur bs?*/,
-                     frame_size * 2,
-                     frame_size,
-                     T(1.0),
-                     gru_value.gate_weight,
-                     frame_size * 2,
-                     packed_gate);
-      T* packed_state = blas.GEMM_ALLOC(CblasBMatrix,
-                                        1 /*height of C*/,
-                                        frame_size /*width of weight*/,
-                                        frame_size /*height of height*/);
-      CHECK(packed_state);
-      blas.GEMM_PACK(CblasBMatrix,
-                     CblasNoTrans,
-                     1 /*cur bs?*/,
-                     frame_size,
-                     frame_size,
-                     T(1.0),
-                     gru_value.state_weight,
-                     frame_size,
-                     packed_state);
-      for (size_t n = 0; n < seq_len; n++) {
-        int64_t bstart = static_cast<int64_t>(batch_starts[n]);
-        int64_t bend = static_cast<int64_t>(batch_starts[n + 1]);
-        int64_t cur_batch_size = bend - bstart;
-
-        gru_value.output_value = batch_hidden_ptr + bstart * batch_hidden_width;
-        gru_value.gate_value = batch_gate_ptr + bstart * batch_gate_width;
-        gru_value.reset_output_value = batch_reset_hidden_prev_ptr +
-                                       bstart * batch_reset_hidden_prev_width;
-
-        if (gru_value.prev_out_value) {
-          blas.GEMM_COMPUTE(CblasNoTrans,
-                            CblasPacked,
-                            cur_batch_size,
-                            frame_size * 2,
-                            frame_size,
-                            gru_value.prev_out_value,
-                            frame_size,
-                            packed_gate,
-                            frame_size * 2,
-                            T(1),
-                            gru_value.gate_value,
-                            frame_size * 3);
-        }
-
-        lite::x86::math::detail::forward_final_output(
-            lite::x86::math::detail::forward::gru_finalOutput<T>(),
-            gru_value,
-            frame_size,
-            cur_batch_size,
-            active_node,
-            origin_mode);
-
-        gru_value.prev_out_value = gru_value.output_value;
-      }
-
-      blas.GEMM_FREE(packed_gate);
-      blas.GEMM_FREE(packed_state);
+    if (!origin_mode) {
+      RunFused(context,
+               batch_starts,
+               frame_size,
+               gru_value.prev_out_value,
+               batch_gate_ptr,
+               batch_reset_hidden_prev_ptr,
+               batch_hidden_ptr);
     } else {
-#endif
       for (size_t n = 0; n < seq_len; n++) {
         int64_t bstart = static_cast<int64_t>(batch_starts[n]);
         int64_t bend = static_cast<int64_t>(batch_starts[n + 1]);
@@ -211,13 +195,168 @@ class GRUCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
 
         gru_value.prev_out_value = gru_value.output_value;
       }
-#ifdef PADDLE_WITH_MKLML
     }
-#endif
     lite::x86::math::Batch2LoDTensorFunctor<TARGET(kX86), T> to_seq;
     batch_hidden->set_lod(batch_gate->lod());
     to_seq(context, *batch_hidden, hidden);
   }
+
+  virtual ~GRUCompute() { ReleasePackedWeights(); }
+
+ private:
+  // out += x * w, x is [m, k] and w is [k, n], packed_w is used instead of
+  // w with MKL. The leading dimension of out is 3 * k, the width of gates.
+  void RecurrentGemm(const X86Context& context,
+                     int m,
+                     int n,
+                     int k,
+                     const T* x,
+                     const T* w,
+                     const T* packed_w,
+                     T* out) {
+    auto blas = lite::x86::math::GetBlas<TARGET(kX86), T>(context);
+#ifdef PADDLE_WITH_MKLML
+    blas.GEMM_COMPUTE(CblasNoTrans,
+                      CblasPacked,
+                      m,
+                      n,
+                      k,
+                      x,
+                      k,
+                      packed_w,
+                      n,
+                      T(1),
+                      out,
+                      k * 3);
+#else
+    blas.GEMM(false, false, m, n, k, T(1), x, k, w, n, T(1), out, k * 3);
+#endif
+  }
+
+  // For every step, the GEMM of the update and the reset gates, then the
+  // reset gate is activated and multiplied by the last hidden by
+  // GRUHtPart1, then the GEMM of the candidate by the reset hidden, and the
+  // hidden is computed by GRUHtPart2, both on the rows just computed.
+  void RunFused(const X86Context& context,
+                const std::vector<uint64_t>& batch_starts,
+                int frame_size,
+                const T* prev_hidden,
+                T* batch_gate_ptr,
+                T* batch_reset_hidden_prev_ptr,
+                T* batch_hidden_ptr) {
+    auto& param = *param_.get_mutable<operators::GRUParam>();
+    const T* gate_weight = param.weight->template data<T>();
+    const T* state_weight = gate_weight + 2 * frame_size * frame_size;
+    const T* packed_gate = nullptr;
+    const T* packed_state = nullptr;
+#ifdef PADDLE_WITH_MKLML
+    packed_gate = packed_gate_;
+    packed_state = packed_state_;
+#endif
+    jit::gru_attr_t attr(frame_size,
+                         jit::to_kerneltype(param.gate_activation),
+                         jit::to_kerneltype(param.activation));
+    auto compute_h1 =
+        jit::KernelFuncs<jit::GRUH1Tuple<T>, fluid::CPUPlace>::Cache().At(
+            attr);
+    auto compute_part1 =
+        jit::KernelFuncs<jit::GRUHtPart1Tuple<T>, fluid::CPUPlace>::Cache()
+            .At(attr);
+    auto compute_part2 =
+        jit::KernelFuncs<jit::GRUHtPart2Tuple<T>, fluid::CPUPlace>::Cache()
+            .At(attr);
+    auto act_gate = GateActFunc(attr.act_gate, frame_size);
+
+    jit::gru_t step;
+    for (size_t n = 0; n + 1 < batch_starts.size(); n++) {
+      int64_t bstart = static_cast<int64_t>(batch_starts[n]);
+      int cur_batch_size = static_cast<int>(batch_starts[n + 1] - bstart);
+      T* gate_t = batch_gate_ptr + bstart * frame_size * 3;
+      T* reset_hidden_t = batch_reset_hidden_prev_ptr + bstart * frame_size;
+      T* hidden_t = batch_hidden_ptr + bstart * frame_size;
+      if (!prev_hidden) {
+        // The last hidden is zero, so is the reset hidden. The reset gate is
+        // still activated as GRUHtPart1 does, BatchGate keeps the activated
+        // update and reset gates of every step.
+        std::memset(reset_hidden_t, 0, sizeof(T) * cur_batch_size * frame_size);
+        for (int i = 0; i < cur_batch_size; i++) {
+          step.gates = gate_t + i * frame_size * 3;
+          step.ht = hidden_t + i * frame_size;
+          compute_h1(&step, &attr);
+          T* reset_gate = gate_t + i * frame_size * 3 + frame_size;
+          act_gate(reset_gate, reset_gate, frame_size);
+        }
+        prev_hidden = hidden_t;
+        continue;
+      }
+      RecurrentGemm(context,
+                    cur_batch_size,
+                    frame_size * 2,
+                    frame_size,
+                    prev_hidden,
+                    gate_weight,
+                    packed_gate,
+                    gate_t);
+      for (int i = 0; i < cur_batch_size; i++) {
+        step.gates = gate_t + i * frame_size * 3;
+        step.ht_1 = prev_hidden + i * frame_size;
+        step.ht = reset_hidden_t + i * frame_size;
+        compute_part1(&step, &attr);
+      }
+      RecurrentGemm(context,
+                    cur_batch_size,
+                    frame_size,
+                    frame_size,
+                    reset_hidden_t,
+                    state_weight,
+                    packed_state,
+                    gate_t + frame_size * 2);
+      for (int i = 0; i < cur_batch_size; i++) {
+        step.gates = gate_t + i * frame_size * 3;
+        step.ht_1 = prev_hidden + i * frame_size;
+        step.ht = hidden_t + i * frame_size;
+        compute_part2(&step, &attr);
+      }
+      prev_hidden = hidden_t;
+    }
+  }
+
+  // The JIT kernel of the activation of the gates on `d` elements.
+  static typename jit::VSigmoidTuple<T>::func_type GateActFunc(
+      jit::KernelType type, int d) {
+    using Place = fluid::CPUPlace;
+    switch (type) {
+      case jit::kVSigmoid:
+        return jit::KernelFuncs<jit::VSigmoidTuple<T>, Place>::Cache().At(d);
+      case jit::kVTanh:
+        return jit::KernelFuncs<jit::VTanhTuple<T>, Place>::Cache().At(d);
+      case jit::kVRelu:
+        return jit::KernelFuncs<jit::VReluTuple<T>, Place>::Cache().At(d);
+      case jit::kVIdentity:
+        return jit::KernelFuncs<jit::VIdentityTuple<T>, Place>::Cache().At(d);
+      default:
+        LOG(FATAL) << "Unsupported gate activation: " << jit::to_string(type);
+    }
+    return nullptr;
+  }
+
+  void ReleasePackedWeights() {
+#ifdef PADDLE_WITH_MKLML
+    if (packed_gate_ || packed_state_) {
+      auto blas =
+          lite::x86::math::GetBlas<TARGET(kX86), T>(ctx_->As<X86Context>());
+      if (packed_gate_) blas.GEMM_FREE(packed_gate_);
+      if (packed_state_) blas.GEMM_FREE(packed_state_);
+      packed_gate_ = nullptr;
+      packed_state_ = nullptr;
+    }
+#endif
+  }
+
+#ifdef PADDLE_WITH_MKLML
+  T* packed_gate_{nullptr};
+  T* packed_state_{nullptr};
+#endif
 };
 
 }  // namespace x86
@@ -14,6 +14,7 @@
 
 #include <gtest/gtest.h>
 
+#include <cmath>
 #include <iostream>
 #include <memory>
 #include <utility>
@@ -148,6 +149,151 @@ TEST(gru_x86, run_test) {
   }
 }
 
+// Run every sequence step by step.
+static void GRURef(const std::vector<float>& input,
+                   const std::vector<uint64_t>& lod,
+                   const std::vector<float>& weight,
+                   const std::vector<float>& bias,
+                   const std::vector<float>& h0,
+                   int d,
+                   bool is_reverse,
+                   bool origin_mode,
+                   std::vector<float>* hidden) {
+  auto sigmoid = [](float x) { return 1.f / (1.f + std::exp(-x)); };
+  const float* state_weight = weight.data() + 2 * d * d;
+  for (size_t s = 0; s + 1 < lod.size(); s++) {
+    std::vector<float> h(h0.begin() + s * d, h0.begin() + (s + 1) * d);
+    int len = static_cast<int>(lod[s + 1] - lod[s]);
+    for (int t = 0; t < len; t++) {
+      int row = static_cast<int>(lod[s]) + (is_reverse ? len - 1 - t : t);
+      std::vector<float> gates(3 * d), reset_h(d);
+      for (int j = 0; j < 3 * d; j++) {
+        gates[j] = input[row * 3 * d + j] + bias[j];
+      }
+      for (int j = 0; j < 2 * d; j++) {
+        for (int k = 0; k < d; k++) {
+          gates[j] += h[k] * weight[k * 2 * d + j];
+        }
+        gates[j] = sigmoid(gates[j]);
+      }
+      for (int j = 0; j < d; j++) {
+        reset_h[j] = gates[d + j] * h[j];
+      }
+      for (int j = 0; j < d; j++) {
+        float c = gates[2 * d + j];
+        for (int k = 0; k < d; k++) {
+          c += reset_h[k] * state_weight[k * d + j];
+        }
+        c = std::tanh(c);
+        float u = gates[j];
+        gates[2 * d + j] = origin_mode ? u * h[j] + (1 - u) * c
+                                       : u * c + (1 - u) * h[j];
+      }
+      for (int j = 0; j < d; j++) {
+        h[j] = gates[2 * d + j];
+        (*hidden)[row * d + j] = h[j];
+      }
+    }
+  }
+}
+
+TEST(gru_x86, compare_with_ref) {
+  std::vector<uint64_t> lod{0, 2, 6, 9};
+  int num_seq = static_cast<int>(lod.size()) - 1;
+  int num_rows = static_cast<int>(lod.back());
+  for (int d : {5, 8}) {
+    for (bool origin_mode : {false, true}) {
+      for (bool is_reverse : {false, true}) {
+        for (bool with_h0 : {false, true}) {
+          lite::Tensor input, h0, weight, bias;
+          lite::Tensor batch_gate, batch_reset_hidden_prev, batch_hidden;
+          lite::Tensor hidden;
+          input.Resize({num_rows, 3 * d});
+          input.set_lod({lod});
+          weight.Resize({d, 3 * d});
+          bias.Resize({1, 3 * d});
+          h0.Resize({num_seq, d});
+          batch_gate.Resize({num_rows, 3 * d});
+          batch_reset_hidden_prev.Resize({num_rows, d});
+          batch_hidden.Resize({num_rows, d});
+          hidden.Resize({num_rows, d});
+
+          auto fill = [](lite::Tensor* x, int seed) {
+            float* data = x->mutable_data<float>();
+            for (int64_t i = 0; i < x->numel(); i++) {
+              data[i] = ((i * 37 + seed * 11) % 29) / 29.f - 0.5f;
+            }
+            return std::vector<float>(data, data + x->numel());
+          };
+          auto input_data = fill(&input, 1);
+          auto weight_data = fill(&weight, 2);
+          auto bias_data = fill(&bias, 3);
+          auto h0_data = fill(&h0, 4);
+          if (!with_h0) {
+            std::fill(h0_data.begin(), h0_data.end(), 0.f);
+          }
+
+          GRUCompute<float> gru;
+          operators::GRUParam param;
+          param.input = &input;
+          param.h0 = with_h0 ? &h0 : nullptr;
+          param.weight = &weight;
+          param.bias = &bias;
+          param.batch_gate = &batch_gate;
+          param.batch_reset_hidden_prev = &batch_reset_hidden_prev;
+          param.batch_hidden = &batch_hidden;
+          param.hidden = &hidden;
+          param.gate_activation = "sigmoid";
+          param.activation = "tanh";
+          param.is_reverse = is_reverse;
+          param.origin_mode = origin_mode;
+
+          std::unique_ptr<KernelContext> ctx(new KernelContext);
+          ctx->As<X86Context>();
+          gru.SetContext(std::move(ctx));
+          gru.SetParam(param);
+          gru.PrepareForRun();
+          gru.Run();
+
+          std::vector<float> hidden_ref(num_rows * d);
+          GRURef(input_data,
+                 lod,
+                 weight_data,
+                 bias_data,
+                 h0_data,
+                 d,
+                 is_reverse,
+                 origin_mode,
+                 &hidden_ref);
+          const float* hidden_data = hidden.data<float>();
+          for (int i = 0; i < num_rows * d; i++) {
+            EXPECT_NEAR(hidden_data[i], hidden_ref[i], 1e-5);
+          }
+
+          // Without h0, the reset hidden of the first step is zero, and the
+          // reset gate is activated as in the other steps.
+          if (!with_h0 && !origin_mode) {
+            auto sigmoid = [](float x) { return 1.f / (1.f + std::exp(-x)); };
+            const auto& batch_lod = batch_gate.lod();
+            const float* gate_data = batch_gate.data<float>();
+            const float* reset_data = batch_reset_hidden_prev.data<float>();
+            for (uint64_t r = batch_lod[0][0]; r < batch_lod[0][1]; r++) {
+              uint64_t row = batch_lod[1][r];
+              for (int j = 0; j < d; j++) {
+                EXPECT_EQ(reset_data[r * d + j], 0.f);
+                EXPECT_NEAR(
+                    gate_data[r * 3 * d + d + j],
+                    sigmoid(input_data[row * 3 * d + d + j] + bias_data[d + j]),
+                    1e-5);
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
 }  // namespace x86
 }  // namespace kernels
 }  // namespace lite
@@ -14,6 +14,7 @@
 #pragma once
 
 #include <vector>
+#include "lite/backends/x86/math/embedding.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_registry.h"
 #include "lite/fluid/eigen.h"
@@ -40,6 +41,22 @@ class LookupTableCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
     int64_t row_number = table_t->dims()[0];
     int64_t row_width = table_t->dims()[1];
 
+    if (lite::x86::math::IsCompressedEmbedding(*table_t)) {
+      // The rows are dequantized to fp32.
+      lite::x86::math::EmbeddingTable table(*table_t, param.weight_scale);
+      float *output = output_t->template mutable_data<float>();
+      for (int64_t i = 0; i < ids_numel; ++i) {
+        if (padding_idx != -1 && ids[i] == padding_idx) {
+          memset(output + i * row_width, 0, row_width * sizeof(float));
+        } else {
+          CHECK_LT(ids[i], row_number);
+          CHECK_GE(ids[i], 0);
+          table.CopyRow(ids[i], output + i * row_width);
+        }
+      }
+      return;
+    }
+
     const T *table = table_t->template data<T>();
     T *output = output_t->template mutable_data<T>();
     memset(output, 0, output_t->dims().production() * sizeof(T));
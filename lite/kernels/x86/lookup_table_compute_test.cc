@@ -14,10 +14,12 @@
 
 #include "lite/kernels/x86/lookup_table_compute.h"
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <cmath>
 #include <string>
 #include <vector>
 #include "lite/core/op_registry.h"
+#include "lite/utils/float16.h"
 
 namespace paddle {
 namespace lite {
@@ -74,6 +76,71 @@ TEST(lookup_table_x86, compute) {
   }
 }
 
+// The tables compressed by embedding_quant_pass are dequantized by rows.
+TEST(lookup_table_x86, compressed_table) {
+  const int vocab_size = 40;
+  const int emb_size = 21;
+  const int num_ids = 30;
+  const int64_t padding_idx = 3;
+
+  lite::Tensor w_fp32, w_int8, w_fp16, ids;
+  w_fp32.Resize({vocab_size, emb_size});
+  w_int8.Resize({vocab_size, emb_size});
+  w_fp16.Resize({vocab_size, emb_size});
+  auto* fp32_data = w_fp32.mutable_data<float>();
+  auto* int8_data = w_int8.mutable_data<int8_t>();
+  auto* fp16_data = w_fp16.mutable_data<float16>();
+  w_fp16.set_precision(PRECISION(kFP16));
+  std::vector<float> scales(vocab_size);
+  for (int i = 0; i < vocab_size; i++) {
+    float abs_max = 0.f;
+    for (int j = 0; j < emb_size; j++) {
+      float x = static_cast<float>((i * emb_size + j) % 23 - 11) / (i + 1);
+      fp32_data[i * emb_size + j] = x;
+      fp16_data[i * emb_size + j] = float16(x);
+      abs_max = std::max(abs_max, std::fabs(x));
+    }
+    scales[i] = abs_max / 127.f;
+    for (int j = 0; j < emb_size; j++) {
+      int8_data[i * emb_size + j] = static_cast<int8_t>(
+          std::round(fp32_data[i * emb_size + j] / scales[i]));
+    }
+  }
+  ids.Resize({num_ids, 1});
+  auto* ids_data = ids.mutable_data<int64_t>();
+  for (int i = 0; i < num_ids; i++) {
+    ids_data[i] = (i * 7) % vocab_size;
+  }
+
+  for (auto* w : {&w_int8, &w_fp16}) {
+    LookupTableCompute<float> lookup_table;
+    operators::LookupTableParam param;
+    lite::Tensor out;
+    out.Resize({num_ids, emb_size});
+    param.W = w;
+    param.Ids = &ids;
+    param.Out = &out;
+    param.padding_idx = padding_idx;
+    if (w == &w_int8) {
+      param.weight_scale = scales;
+    }
+    lookup_table.SetParam(param);
+    lookup_table.Run();
+
+    auto* out_data = out.data<float>();
+    for (int i = 0; i < num_ids; i++) {
+      int64_t id = ids_data[i];
+      for (int j = 0; j < emb_size; j++) {
+        float ref = id == padding_idx ? 0.f : fp32_data[id * emb_size + j];
+        // The half of a quantization step, or the precision of fp16.
+        float eps = w == &w_int8 ? scales[id] * 0.5f + 1e-6f
+                                 : std::fabs(ref) * 1e-3f + 1e-6f;
+        EXPECT_NEAR(out_data[i * emb_size + j], ref, eps);
+      }
+    }
+  }
+}
+
 }  // namespace x86
 }  // namespace kernels
 }  // namespace lite
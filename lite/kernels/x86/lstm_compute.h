@@ -0,0 +1,244 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+
+#include <string>
+#include <vector>
+#include "lite/backends/x86/jit/helper.h"
+#include "lite/backends/x86/jit/kernel_base.h"
+#include "lite/backends/x86/jit/kernels.h"
+#include "lite/backends/x86/math/blas.h"
+#include "lite/backends/x86/math/sequence2batch.h"
+#include "lite/core/kernel.h"
+#include "lite/core/op_registry.h"
+#include "lite/core/types.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+/*
+ * The input of lstm is the projection of the gates {c, i, f, o} of all the
+ * time steps, made by the fc before it. The sequences are reordered to the
+ * batches of the time steps by LoDTensor2BatchFunctor, then every step is
+ * one GEMM of the hidden of the last step by the recurrent weight, which is
+ * packed once with MKL, and the cell of every row by the JIT LSTM kernels.
+ *
+ * BatchGate and BatchCellPreAct are only used by the backward. Here
+ * BatchGate is the work space of the JIT kernels, which overwrite the gates
+ * in place with the activations and the intermediate products, so it keeps
+ * neither the gates before the activations nor the ones after them.
+ * BatchCellPreAct keeps the cells of the batches before the cell activation.
+ */
+template <typename T>
+class LstmCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
+ public:
+  using param_t = operators::LstmParam;
+
+  void PrepareForRun() override {
+#ifdef PADDLE_WITH_MKLML
+    auto& context = ctx_->As<X86Context>();
+    auto& param = *param_.get_mutable<operators::LstmParam>();
+    auto blas = lite::x86::math::GetBlas<TARGET(kX86), T>(context);
+    int frame_size = param.Weight->dims()[0];
+    ReleasePackedWeight();
+    packed_weight_ = blas.GEMM_ALLOC(CblasBMatrix,
+                                     1 /*height of C*/,
+                                     frame_size * 4 /*width of weight*/,
+                                     frame_size /*height of weight*/);
+    CHECK(packed_weight_);
+    blas.GEMM_PACK(CblasBMatrix,
+                   CblasNoTrans,
+                   1 /*height of C*/,
+                   frame_size * 4,
+                   frame_size,
+                   T(1.0),
+                   param.Weight->template data<T>(),
+                   frame_size * 4,
+                   packed_weight_);
+#endif
+  }
+
+  void Run() override {
+    auto& context = ctx_->As<X86Context>();
+    auto& param = *param_.get_mutable<operators::LstmParam>();
+    auto* input = param.Input;
+    auto* weight = param.Weight;
+    auto* bias = param.Bias;
+    auto* h0 = param.H0;
+    auto* c0 = param.C0;
+    auto* batch_gate = param.BatchGate;
+    auto* batch_cell = param.BatchCellPreAct;
+    auto* hidden = param.Hidden;
+    auto* cell = param.Cell;
+
+    auto in_dims = input->dims();
+    int frame_size = static_cast<int>(in_dims[1] / 4);
+    DDim out_dims(std::vector<int64_t>{in_dims[0], frame_size});
+
+    lite::x86::math::LoDTensor2BatchFunctor<TARGET(kX86), T> to_batch;
+    to_batch(context, *input, batch_gate, true, param.is_reverse);
+    T* batch_gate_data = batch_gate->template mutable_data<T>();
+
+    // The bias of the gates, and the weights of the peephole after them.
+    const T* bias_data = bias->template data<T>();
+    auto add_bias =
+        jit::KernelFuncs<jit::VAddTuple<T>, fluid::CPUPlace>::Cache().At(
+            frame_size * 4);
+    for (int64_t i = 0; i < in_dims[0]; i++) {
+      T* gate = batch_gate_data + i * frame_size * 4;
+      add_bias(bias_data, gate, gate, frame_size * 4);
+    }
+
+    jit::lstm_attr_t attr(
+        frame_size,
+        jit::to_kerneltype(param.gate_activation),
+        jit::to_kerneltype(param.candidate_activation),
+        jit::to_kerneltype(param.cell_activation),
+        param.use_peepholes);
+    auto compute_ctht =
+        jit::KernelFuncs<jit::LSTMCtHtTuple<T>, fluid::CPUPlace>::Cache().At(
+            attr);
+    auto compute_c1h1 =
+        jit::KernelFuncs<jit::LSTMC1H1Tuple<T>, fluid::CPUPlace>::Cache().At(
+            attr);
+    jit::lstm_t step;
+    std::vector<T> checked;
+    if (param.use_peepholes) {
+      checked.resize(frame_size * 2);
+      step.wp = bias_data + frame_size * 4;
+      step.checked = checked.data();
+    }
+
+    // Since the batch computing for LSTM reorders the input sequence
+    // according to their length. The initialized states also need to
+    // reorder.
+    const auto& order = batch_gate->lod()[2];
+    Tensor ordered_h0, ordered_c0;
+    const T* prev_hidden = nullptr;
+    const T* prev_cell = nullptr;
+    if (h0) {
+      ReorderState(context, *h0, order, &ordered_h0);
+      prev_hidden = ordered_h0.template data<T>();
+    }
+    if (c0) {
+      ReorderState(context, *c0, order, &ordered_c0);
+      prev_cell = ordered_c0.template data<T>();
+    }
+
+    Tensor batch_hidden;
+    batch_hidden.Resize(out_dims);
+    batch_cell->Resize(out_dims);
+    T* batch_hidden_data = batch_hidden.mutable_data<T>();
+    T* batch_cell_data = batch_cell->template mutable_data<T>();
+
+    auto blas = lite::x86::math::GetBlas<TARGET(kX86), T>(context);
+    const auto& batch_starts = batch_gate->lod()[0];
+    size_t num_batch = batch_starts.size() - 1;
+    for (size_t n = 0; n < num_batch; n++) {
+      int64_t bstart = static_cast<int64_t>(batch_starts[n]);
+      int64_t bend = static_cast<int64_t>(batch_starts[n + 1]);
+      int cur_batch_size = static_cast<int>(bend - bstart);
+      T* gate_t = batch_gate_data + bstart * frame_size * 4;
+      T* hidden_t = batch_hidden_data + bstart * frame_size;
+      T* cell_t = batch_cell_data + bstart * frame_size;
+
+      // The sequences of a batch are sorted by the length, so the rows of
+      // the batch are the first rows of the last one.
+      if (prev_hidden) {
+#ifdef PADDLE_WITH_MKLML
+        blas.GEMM_COMPUTE(CblasNoTrans,
+                          CblasPacked,
+                          cur_batch_size,
+                          frame_size * 4,
+                          frame_size,
+                          prev_hidden,
+                          frame_size,
+                          packed_weight_,
+                          frame_size * 4,
+                          T(1),
+                          gate_t,
+                          frame_size * 4);
+#else
+        blas.GEMM(CblasNoTrans,
+                  CblasNoTrans,
+                  cur_batch_size,
+                  frame_size * 4,
+                  frame_size,
+                  T(1),
+                  prev_hidden,
+                  weight->template data<T>(),
+                  T(1),
+                  gate_t);
+#endif
+      }
+
+      for (int i = 0; i < cur_batch_size; i++) {
+        step.gates = gate_t + i * frame_size * 4;
+        step.ct = cell_t + i * frame_size;
+        step.ht = hidden_t + i * frame_size;
+        if (prev_cell) {
+          step.ct_1 = prev_cell + i * frame_size;
+          compute_ctht(&step, &attr);
+        } else {
+          compute_c1h1(&step, &attr);
+        }
+      }
+      prev_hidden = hidden_t;
+      prev_cell = cell_t;
+    }
+
+    lite::x86::math::Batch2LoDTensorFunctor<TARGET(kX86), T> to_seq;
+    batch_hidden.set_lod(batch_gate->lod());
+    hidden->template mutable_data<T>();
+    to_seq(context, batch_hidden, hidden);
+    batch_cell->set_lod(batch_gate->lod());
+    cell->template mutable_data<T>();
+    to_seq(context, *batch_cell, cell);
+  }
+
+  virtual ~LstmCompute() { ReleasePackedWeight(); }
+
+ private:
+  void ReorderState(const X86Context& context,
+                    const Tensor& src,
+                    const std::vector<uint64_t>& order,
+                    Tensor* dst) {
+    lite::x86::math::CopyMatrixRowsFunctor<TARGET(kX86), T> row_shuffle;
+    dst->Resize(src.dims());
+    dst->template mutable_data<T>();
+    row_shuffle(context, src, order, dst, true);
+  }
+
+  void ReleasePackedWeight() {
+#ifdef PADDLE_WITH_MKLML
+    if (packed_weight_) {
+      auto blas =
+          lite::x86::math::GetBlas<TARGET(kX86), T>(ctx_->As<X86Context>());
+      blas.GEMM_FREE(packed_weight_);
+      packed_weight_ = nullptr;
+    }
+#endif
+  }
+
+#ifdef PADDLE_WITH_MKLML
+  T* packed_weight_{nullptr};
+#endif
+};
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
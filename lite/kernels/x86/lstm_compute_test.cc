@@ -0,0 +1,177 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "lite/kernels/x86/lstm_compute.h"
+#include <gtest/gtest.h>
+#include <cmath>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+static float Sigmoid(float x) { return 1.f / (1.f + std::exp(-x)); }
+
+// Run every sequence step by step.
+static void LstmRef(const std::vector<float>& input,
+                    const std::vector<uint64_t>& lod,
+                    const std::vector<float>& weight,
+                    const std::vector<float>& bias,
+                    const std::vector<float>& h0,
+                    const std::vector<float>& c0,
+                    int d,
+                    bool use_peepholes,
+                    bool is_reverse,
+                    std::vector<float>* hidden,
+                    std::vector<float>* cell) {
+  for (size_t s = 0; s + 1 < lod.size(); s++) {
+    std::vector<float> h(h0.begin() + s * d, h0.begin() + (s + 1) * d);
+    std::vector<float> c(c0.begin() + s * d, c0.begin() + (s + 1) * d);
+    int len = static_cast<int>(lod[s + 1] - lod[s]);
+    for (int t = 0; t < len; t++) {
+      int row = static_cast<int>(lod[s]) + (is_reverse ? len - 1 - t : t);
+      std::vector<float> gates(4 * d);
+      for (int j = 0; j < 4 * d; j++) {
+        gates[j] = input[row * 4 * d + j] + bias[j];
+        for (int k = 0; k < d; k++) {
+          gates[j] += h[k] * weight[k * 4 * d + j];
+        }
+      }
+      for (int j = 0; j < d; j++) {
+        float ig = gates[d + j];
+        float fg = gates[2 * d + j];
+        if (use_peepholes) {
+          ig += c[j] * bias[4 * d + j];
+          fg += c[j] * bias[5 * d + j];
+        }
+        c[j] = std::tanh(gates[j]) * Sigmoid(ig) + c[j] * Sigmoid(fg);
+        float og = gates[3 * d + j];
+        if (use_peepholes) {
+          og += c[j] * bias[6 * d + j];
+        }
+        h[j] = std::tanh(c[j]) * Sigmoid(og);
+        (*hidden)[row * d + j] = h[j];
+        (*cell)[row * d + j] = c[j];
+      }
+    }
+  }
+}
+
+TEST(lstm_x86, retrive_op) {
+  auto lstm = KernelRegistry::Global().Create("lstm");
+  ASSERT_FALSE(lstm.empty());
+  ASSERT_TRUE(lstm.front());
+}
+
+TEST(lstm_x86, init) {
+  LstmCompute<float> lstm;
+  ASSERT_EQ(lstm.precision(), PRECISION(kFloat));
+  ASSERT_EQ(lstm.target(), TARGET(kX86));
+}
+
+TEST(lstm_x86, run_test) {
+  std::vector<uint64_t> lod{0, 2, 6, 9};
+  int num_seq = static_cast<int>(lod.size()) - 1;
+  int num_rows = static_cast<int>(lod.back());
+  for (int d : {5, 8, 16}) {
+    for (bool use_peepholes : {false, true}) {
+      for (bool is_reverse : {false, true}) {
+        for (bool with_init : {false, true}) {
+          lite::Tensor input, weight, bias, h0, c0;
+          lite::Tensor hidden, cell, batch_gate, batch_cell_pre_act;
+          input.Resize({num_rows, 4 * d});
+          input.set_lod({lod});
+          weight.Resize({d, 4 * d});
+          bias.Resize({1, (use_peepholes ? 7 : 4) * d});
+          h0.Resize({num_seq, d});
+          c0.Resize({num_seq, d});
+          hidden.Resize({num_rows, d});
+          cell.Resize({num_rows, d});
+          batch_gate.Resize({num_rows, 4 * d});
+          batch_cell_pre_act.Resize({num_rows, d});
+
+          auto fill = [](lite::Tensor* x, int seed) {
+            float* data = x->mutable_data<float>();
+            for (int64_t i = 0; i < x->numel(); i++) {
+              data[i] = ((i * 37 + seed * 11) % 29) / 29.f - 0.5f;
+            }
+            return std::vector<float>(data, data + x->numel());
+          };
+          auto input_data = fill(&input, 1);
+          auto weight_data = fill(&weight, 2);
+          auto bias_data = fill(&bias, 3);
+          auto h0_data = fill(&h0, 4);
+          auto c0_data = fill(&c0, 5);
+          if (!with_init) {
+            std::fill(h0_data.begin(), h0_data.end(), 0.f);
+            std::fill(c0_data.begin(), c0_data.end(), 0.f);
+          }
+
+          LstmCompute<float> lstm;
+          operators::LstmParam param;
+          param.Input = &input;
+          param.Weight = &weight;
+          param.Bias = &bias;
+          param.H0 = with_init ? &h0 : nullptr;
+          param.C0 = with_init ? &c0 : nullptr;
+          param.Hidden = &hidden;
+          param.Cell = &cell;
+          param.BatchGate = &batch_gate;
+          param.BatchCellPreAct = &batch_cell_pre_act;
+          param.use_peepholes = use_peepholes;
+          param.is_reverse = is_reverse;
+          param.gate_activation = "sigmoid";
+          param.cell_activation = "tanh";
+          param.candidate_activation = "tanh";
+
+          std::unique_ptr<KernelContext> ctx(new KernelContext);
+          ctx->As<X86Context>();
+          lstm.SetContext(std::move(ctx));
+          lstm.SetParam(param);
+          lstm.PrepareForRun();
+          lstm.Run();
+
+          std::vector<float> hidden_ref(num_rows * d), cell_ref(num_rows * d);
+          LstmRef(input_data,
+                  lod,
+                  weight_data,
+                  bias_data,
+                  h0_data,
+                  c0_data,
+                  d,
+                  use_peepholes,
+                  is_reverse,
+                  &hidden_ref,
+                  &cell_ref);
+          const float* hidden_data = hidden.data<float>();
+          const float* cell_data = cell.data<float>();
+          for (int i = 0; i < num_rows * d; i++) {
+            EXPECT_NEAR(hidden_data[i], hidden_ref[i], 1e-5);
+            EXPECT_NEAR(cell_data[i], cell_ref[i], 1e-5);
+          }
+        }
+      }
+    }
+  }
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_KERNEL(lstm, kX86, kFloat, kNCHW, def);
@@ -0,0 +1,974 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/nchwc_compute.h"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include "lite/backends/x86/jit/helper.h"
+#include "lite/backends/x86/jit/kernel_base.h"
+#include "lite/backends/x86/jit/kernels.h"
+#include "lite/backends/x86/parallel.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+using lite::x86::math::NCHWcMutableData;
+using lite::x86::math::NCHWcNumel;
+
+// The elementwise kernels run `func(offset, size)` on the chunks of the
+// elements in parallel.
+static const int64_t kNCHWcChunkSize = 4096;
+
+template <typename Func>
+static void ForEachNCHWcChunk(int64_t numel, Func func) {
+  const int64_t num_chunks = (numel + kNCHWcChunkSize - 1) / kNCHWcChunkSize;
+  lite::x86::RunParallelFor(0, num_chunks, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      const int64_t offset = i * kNCHWcChunkSize;
+      func(offset,
+           static_cast<int>((std::min)(kNCHWcChunkSize, numel - offset)));
+    }
+  });
+}
+
+template <typename Tuple>
+static typename Tuple::func_type GetNCHWcJitFunc(int size) {
+  return jit::KernelFuncs<Tuple, fluid::CPUPlace>::Cache().At(size);
+}
+
+template <int B>
+bool ConvNCHWcCompute<B>::IsParamSupported() const {
+  auto& param = this->template Param<param_t>();
+  if (!param.filter || param.filter->dims().size() != 4u) return false;
+  auto& act_param = param.activation_param;
+  return !act_param.has_active ||
+         act_param.active_type == lite_api::ActivationType::kRelu ||
+         act_param.active_type == lite_api::ActivationType::kRelu6 ||
+         act_param.active_type == lite_api::ActivationType::kLeakyRelu;
+}
+
+template <int B>
+void ConvNCHWcCompute<B>::PrepareForRun() {
+  CHECK(IsParamSupported()) << "[X86] Unsupported param of the NCHWc conv";
+  auto& param = this->template Param<param_t>();
+  const auto& w_dims = param.filter->dims();
+  auto& p = conv_param_;
+  p.groups = param.groups;
+  p.oc = static_cast<int>(w_dims[0]);
+  p.ic = static_cast<int>(w_dims[1]) * param.groups;
+  p.kh = static_cast<int>(w_dims[2]);
+  p.kw = static_cast<int>(w_dims[3]);
+
+  auto& act_param = param.activation_param;
+  if (act_param.has_active) {
+    p.act_type = act_param.active_type;
+    if (act_param.active_type == lite_api::ActivationType::kRelu6) {
+      p.act_alpha = act_param.Relu_clipped_coef;
+    } else if (act_param.active_type ==
+               lite_api::ActivationType::kLeakyRelu) {
+      p.act_alpha = act_param.Leaky_relu_alpha;
+    }
+  }
+
+  packed_filter_.Resize(
+      {lite::x86::math::ConvNCHWcPackedFilterSize<B>(conv_param_)});
+  lite::x86::math::ConvNCHWcPackFilter<B>(
+      conv_param_,
+      param.filter->template data<float>(),
+      packed_filter_.template mutable_data<float>());
+}
+
+template <int B>
+void ConvNCHWcCompute<B>::Run() {
+  auto& param = this->template Param<param_t>();
+  const auto& x_dims = param.x->dims();
+  const auto& out_dims = param.output->dims();
+  const auto& paddings = *param.paddings;
+  const auto& dilations = *param.dilations;
+  auto& p = conv_param_;
+  p.batch = static_cast<int>(x_dims[0]);
+  p.ih = static_cast<int>(x_dims[2]);
+  p.iw = static_cast<int>(x_dims[3]);
+  p.oh = static_cast<int>(out_dims[2]);
+  p.ow = static_cast<int>(out_dims[3]);
+  p.stride_h = param.strides[0];
+  p.stride_w = param.strides[1];
+  p.pad_top = paddings[0];
+  p.pad_left = paddings[2];
+  p.dilation_h = dilations[0];
+  p.dilation_w = dilations[1];
+  CHECK_EQ(x_dims[1], p.ic);
+
+  lite::x86::math::ConvNCHWc<B>(
+      p,
+      param.x->template data<float>(),
+      packed_filter_.template data<float>(),
+      param.bias ? param.bias->template data<float>() : nullptr,
+      NCHWcMutableData<B>(param.output));
+}
+
+template <int B>
+bool PoolNCHWcCompute<B>::IsParamSupported() const {
+  auto& param = this->template Param<param_t>();
+  return param.ksize.size() == 2u &&
+         (param.pooling_type == "max" || param.pooling_type == "avg");
+}
+
+template <int B>
+void PoolNCHWcCompute<B>::Run() {
+  auto& param = this->template Param<param_t>();
+  const auto& x_dims = param.x->dims();
+  const auto& out_dims = param.output->dims();
+  CHECK_EQ(x_dims.size(), 4u) << "[X86] The NCHWc pool only supports pool2d";
+  CHECK(param.pooling_type == "max" || param.pooling_type == "avg")
+      << "[X86] Unsupported pooling type " << param.pooling_type;
+  if (param.global_pooling) {
+    for (size_t i = 0; i < param.ksize.size(); ++i) {
+      param.ksize[i] = static_cast<int>(x_dims[i + 2]);
+    }
+  }
+  const auto& paddings = *param.paddings;
+
+  lite::x86::math::PoolNCHWcParam p;
+  p.batch = static_cast<int>(x_dims[0]);
+  p.c = static_cast<int>(x_dims[1]);
+  p.ih = static_cast<int>(x_dims[2]);
+  p.iw = static_cast<int>(x_dims[3]);
+  p.oh = static_cast<int>(out_dims[2]);
+  p.ow = static_cast<int>(out_dims[3]);
+  p.kh = param.ksize[0];
+  p.kw = param.ksize[1];
+  p.stride_h = param.strides[0];
+  p.stride_w = param.strides[1];
+  p.pad_top = paddings[0];
+  p.pad_left = paddings[2];
+  p.is_max = param.pooling_type == "max";
+  p.exclusive = param.exclusive;
+  p.adaptive = param.adaptive;
+
+  lite::x86::math::PoolNCHWc<B>(
+      p, param.x->template data<float>(), NCHWcMutableData<B>(param.output));
+}
+
+template <typename Functor>
+struct NCHWcJitTuple;
+
+template <>
+struct NCHWcJitTuple<NCHWcAddFunctor> {
+  using type = jit::VAddTuple<float>;
+};
+
+template <>
+struct NCHWcJitTuple<NCHWcSubFunctor> {
+  using type = jit::VSubTuple<float>;
+};
+
+template <>
+struct NCHWcJitTuple<NCHWcMulFunctor> {
+  using type = jit::VMulTuple<float>;
+};
+
+// Whether Y is a vector of the channels of a 4-D X, only the dims of Y are
+// known when the kernel is picked.
+static bool IsChannelVector(const DDim& y_dims, int axis) {
+  const int rank = static_cast<int>(y_dims.size());
+  const int channel_dim = 1 - (axis < 0 ? 4 - rank : axis);
+  if (channel_dim < 0 || channel_dim >= rank) return false;
+  for (int i = 0; i < rank; i++) {
+    if (i != channel_dim && y_dims[i] != 1) return false;
+  }
+  return true;
+}
+
+// Expand Y to the dims of X in the memory order of X, for the broadcasts other
+// than the scalars and the vectors of the channels. `out` holds zeros for the
+// padded channels.
+template <int B>
+static void ExpandNCHWc(const DDim& x_dims,
+                        const DDim& y_dims,
+                        int axis,
+                        const float* y,
+                        float* out) {
+  const int rank = static_cast<int>(x_dims.size());
+  auto dims = y_dims.Vectorize();
+  if (axis < 0) {
+    axis = rank - static_cast<int>(dims.size());
+  }
+  // The trailing ones of Y are ignored as the elementwise ops do.
+  while (axis + dims.size() > static_cast<size_t>(rank) && !dims.empty() &&
+         dims.back() == 1) {
+    dims.pop_back();
+  }
+  CHECK(axis >= 0 && axis + dims.size() <= static_cast<size_t>(rank))
+      << "[X86] Can't broadcast " << y_dims << " to " << x_dims;
+  std::vector<int64_t> shape(rank, 1);
+  for (size_t i = 0; i < dims.size(); i++) {
+    shape[axis + i] = dims[i];
+  }
+  std::vector<int64_t> strides(rank, 0);
+  int64_t stride = 1;
+  for (int d = rank - 1; d >= 0; d--) {
+    CHECK(shape[d] == 1 || shape[d] == x_dims[d])
+        << "[X86] Can't broadcast " << y_dims << " to " << x_dims;
+    strides[d] = shape[d] == 1 ? 0 : stride;
+    stride *= shape[d];
+  }
+  const auto x_shape = x_dims.Vectorize();
+  auto blocked_offset = [](const std::vector<int64_t>& d,
+                           const std::vector<int64_t>& i) {
+    return (((i[0] * ((d[1] + B - 1) / B) + i[1] / B) * d[2] + i[2]) * d[3] +
+            i[3]) *
+               B +
+           i[1] % B;
+  };
+  // A 4-D Y is blocked as X, the others are in the plain order.
+  const bool y_blocked = y_dims.size() == 4u;
+  std::vector<int64_t> idx(rank, 0);
+  std::vector<int64_t> y_idx(rank, 0);
+  for (int64_t k = 0; k < x_dims.production(); k++) {
+    int64_t rest = k;
+    for (int d = rank - 1; d >= 0; d--) {
+      idx[d] = rest % x_shape[d];
+      rest /= x_shape[d];
+    }
+    int64_t src = 0;
+    if (y_blocked) {
+      for (int d = 0; d < rank; d++) {
+        y_idx[d] = shape[d] == 1 ? 0 : idx[d];
+      }
+      src = blocked_offset(shape, y_idx);
+    } else {
+      for (int d = 0; d < rank; d++) {
+        src += idx[d] * strides[d];
+      }
+    }
+    out[rank == 4 ? blocked_offset(x_shape, idx) : k] = y[src];
+  }
+}
+
+template <int B, typename Functor>
+bool ElementwiseNCHWcCompute<B, Functor>::IsParamSupported() const {
+  auto& param = this->template Param<param_t>();
+  // The dims of the activations are only known at runtime.
+  if (!param.Y || !param.Y->persistable()) return true;
+  const auto& y_dims = param.Y->dims();
+  return y_dims.production() == 1 || IsChannelVector(y_dims, param.axis);
+}
+
+template <int B, typename Functor>
+void ElementwiseNCHWcCompute<B, Functor>::Run() {
+  auto& param = this->template Param<param_t>();
+  const auto& x_dims = param.X->dims();
+  const auto& y_dims = param.Y->dims();
+  const float* x = param.X->template data<float>();
+  const float* y = param.Y->template data<float>();
+  float* out = NCHWcMutableData<B>(param.Out);
+  const int64_t numel = NCHWcNumel<B>(x_dims);
+  Functor functor;
+
+  if (y_dims.production() == 1) {
+    const float y0 = y[0];
+    ForEachNCHWcChunk(numel, [&](int64_t offset, int size) {
+      for (int i = 0; i < size; i++) {
+        out[offset + i] = functor(x[offset + i], y0);
+      }
+    });
+    return;
+  }
+
+  const int64_t c = x_dims.size() == 4u ? x_dims[1] : 0;
+  if (x_dims != y_dims && c > 0 && y_dims.production() == c &&
+      IsChannelVector(y_dims, param.axis)) {
+    const int64_t cb_num = (c + B - 1) / B;
+    const int64_t hw = x_dims[2] * x_dims[3];
+    std::vector<float> y_blocked(cb_num * B, 0.f);
+    std::memcpy(y_blocked.data(), y, c * sizeof(float));
+    lite::x86::RunParallelFor(
+        0, x_dims[0] * cb_num, [&](int64_t begin, int64_t end) {
+          for (int64_t idx = begin; idx < end; idx++) {
+            const float* xb = x + idx * hw * B;
+            const float* yb = y_blocked.data() + idx % cb_num * B;
+            float* ob = out + idx * hw * B;
+            for (int64_t i = 0; i < hw; i++) {
+              for (int j = 0; j < B; j++) {
+                ob[i * B + j] = functor(xb[i * B + j], yb[j]);
+              }
+            }
+          }
+        });
+    return;
+  }
+
+  std::vector<float> y_expanded;
+  if (x_dims != y_dims) {
+    y_expanded.assign(numel, 0.f);
+    ExpandNCHWc<B>(x_dims, y_dims, param.axis, y, y_expanded.data());
+    y = y_expanded.data();
+  }
+  using Tuple = typename NCHWcJitTuple<Functor>::type;
+  ForEachNCHWcChunk(numel, [&](int64_t offset, int size) {
+    GetNCHWcJitFunc<Tuple>(size)(x + offset, y + offset, out + offset, size);
+  });
+}
+
+template <int B>
+bool ActivationNCHWcCompute<B>::IsParamSupported() const {
+  switch (this->template Param<param_t>().active_type) {
+    case lite_api::ActivationType::kRelu:
+    case lite_api::ActivationType::kRelu6:
+    case lite_api::ActivationType::kLeakyRelu:
+    case lite_api::ActivationType::kSigmoid:
+    case lite_api::ActivationType::kTanh:
+      return true;
+    default:
+      return false;
+  }
+}
+
+template <int B>
+void ActivationNCHWcCompute<B>::Run() {
+  auto& param = this->template Param<param_t>();
+  const float* x = param.X->template data<float>();
+  float* out = NCHWcMutableData<B>(param.Out);
+  const int64_t numel = NCHWcNumel<B>(param.X->dims());
+  const float threshold = param.threshold;
+  const float alpha = param.Leaky_relu_alpha;
+  switch (param.active_type) {
+    case lite_api::ActivationType::kRelu:
+      ForEachNCHWcChunk(numel, [&](int64_t offset, int size) {
+        GetNCHWcJitFunc<jit::VReluTuple<float>>(size)(
+            x + offset, out + offset, size);
+      });
+      break;
+    case lite_api::ActivationType::kRelu6:
+      ForEachNCHWcChunk(numel, [&](int64_t offset, int size) {
+        for (int i = 0; i < size; i++) {
+          out[offset + i] =
+              (std::min)((std::max)(x[offset + i], 0.f), threshold);
+        }
+      });
+      break;
+    case lite_api::ActivationType::kLeakyRelu:
+      ForEachNCHWcChunk(numel, [&](int64_t offset, int size) {
+        for (int i = 0; i < size; i++) {
+          const float v = x[offset + i];
+          out[offset + i] = v > 0.f ? v : v * alpha;
+        }
+      });
+      break;
+    case lite_api::ActivationType::kSigmoid:
+      ForEachNCHWcChunk(numel, [&](int64_t offset, int size) {
+        GetNCHWcJitFunc<jit::VSigmoidTuple<float>>(size)(
+            x + offset, out + offset, size);
+      });
+      break;
+    case lite_api::ActivationType::kTanh:
+      ForEachNCHWcChunk(numel, [&](int64_t offset, int size) {
+        GetNCHWcJitFunc<jit::VTanhTuple<float>>(size)(
+            x + offset, out + offset, size);
+      });
+      break;
+    default:
+      LOG(FATAL) << "[X86] The NCHWc activation should have been declined by "
+                 << "IsParamSupported";
+  }
+}
+
+// Concat the inputs of the dims `dims` along the axis, as the x86 concat.
+static void ConcatPlain(const std::vector<const float*>& inputs,
+                        const std::vector<std::vector<int64_t>>& dims,
+                        int axis,
+                        float* out) {
+  int64_t outer = 1;
+  for (int i = 0; i < axis; i++) {
+    outer *= dims[0][i];
+  }
+  std::vector<int64_t> sizes;
+  int64_t out_size = 0;
+  for (auto& d : dims) {
+    int64_t size = 1;
+    for (size_t i = axis; i < d.size(); i++) {
+      size *= d[i];
+    }
+    sizes.push_back(size);
+    out_size += size;
+  }
+  int64_t offset = 0;
+  for (size_t k = 0; k < inputs.size(); k++) {
+    for (int64_t i = 0; i < outer; i++) {
+      std::memcpy(out + i * out_size + offset,
+                  inputs[k] + i * sizes[k],
+                  sizes[k] * sizeof(float));
+    }
+    offset += sizes[k];
+  }
+}
+
+template <int B>
+void ConcatNCHWcCompute<B>::Run() {
+  auto& param = this->template Param<param_t>();
+  const auto& out_dims = param.output->dims();
+  const int rank = static_cast<int>(out_dims.size());
+  int axis = param.axis;
+  if (param.axis_tensor != nullptr) {
+    axis = param.axis_tensor->template data<int>()[0];
+  }
+  if (axis < 0) {
+    axis += rank;
+  }
+  CHECK(axis >= 0 && axis < rank) << "[X86] Invalid concat axis " << axis;
+
+  float* out = NCHWcMutableData<B>(param.output);
+  std::vector<const float*> inputs;
+  std::vector<std::vector<int64_t>> dims;
+  for (auto* x : param.x) {
+    inputs.push_back(x->template data<float>());
+    dims.push_back(x->dims().Vectorize());
+  }
+  if (rank != 4) {
+    ConcatPlain(inputs, dims, axis, out);
+    return;
+  }
+
+  // Concat [N, C/B, H, W, B] along N, H or W.
+  if (axis != 1) {
+    for (auto& d : dims) {
+      d = {d[0], (d[1] + B - 1) / B, d[2], d[3], B};
+    }
+    ConcatPlain(inputs, dims, axis, out);
+    return;
+  }
+
+  const int64_t batch = out_dims[0];
+  const int64_t hw = out_dims[2] * out_dims[3];
+  const int64_t out_cb = (out_dims[1] + B - 1) / B;
+  // The blocks are copied as they are if every input but the last one has
+  // the channels of multiples of B.
+  bool aligned = true;
+  for (size_t k = 0; k + 1 < dims.size(); k++) {
+    aligned = aligned && dims[k][1] % B == 0;
+  }
+  if (aligned) {
+    int64_t offset_cb = 0;
+    for (size_t k = 0; k < inputs.size(); k++) {
+      const int64_t cb = (dims[k][1] + B - 1) / B;
+      for (int64_t n = 0; n < batch; n++) {
+        std::memcpy(out + (n * out_cb + offset_cb) * hw * B,
+                    inputs[k] + n * cb * hw * B,
+                    cb * hw * B * sizeof(float));
+      }
+      offset_cb += cb;
+    }
+    return;
+  }
+
+  std::memset(out, 0, NCHWcNumel<B>(out_dims) * sizeof(float));
+  int64_t offset = 0;
+  for (size_t k = 0; k < inputs.size(); k++) {
+    const int64_t c = dims[k][1];
+    const int64_t cb = (c + B - 1) / B;
+    for (int64_t n = 0; n < batch; n++) {
+      for (int64_t i = 0; i < c; i++) {
+        const float* src = inputs[k] + ((n * cb + i / B) * hw * B) + i % B;
+        const int64_t o = offset + i;
+        float* dst = out + ((n * out_cb + o / B) * hw * B) + o % B;
+        for (int64_t j = 0; j < hw; j++) {
+          dst[j * B] = src[j * B];
+        }
+      }
+    }
+    offset += c;
+  }
+}
+
+template <int B, bool ToBlocked>
+void LayoutNCHWcCompute<B, ToBlocked>::Run() {
+  auto& param = this->template Param<param_t>();
+  const auto& dims = param.x->dims();
+  const float* x = param.x->template data<float>();
+  if (dims.size() != 4u) {
+    float* y = param.y->template mutable_data<float>();
+    std::memcpy(y, x, dims.production() * sizeof(float));
+    return;
+  }
+  const int n = static_cast<int>(dims[0]);
+  const int c = static_cast<int>(dims[1]);
+  const int hw = static_cast<int>(dims[2] * dims[3]);
+  if (ToBlocked) {
+    lite::x86::math::NCHWToNCHWc<B>(x, n, c, hw, NCHWcMutableData<B>(param.y));
+  } else {
+    lite::x86::math::NCHWcToNCHW<B>(
+        x, n, c, hw, param.y->template mutable_data<float>());
+  }
+}
+
+#define INSTANTIATE_NCHWC_KERNELS(B)                           \
+  template class ConvNCHWcCompute<B>;                          \
+  template class PoolNCHWcCompute<B>;                          \
+  template class ElementwiseNCHWcCompute<B, NCHWcAddFunctor>; \
+  template class ElementwiseNCHWcCompute<B, NCHWcSubFunctor>; \
+  template class ElementwiseNCHWcCompute<B, NCHWcMulFunctor>; \
+  template class ActivationNCHWcCompute<B>;                    \
+  template class ConcatNCHWcCompute<B>;                        \
+  template class LayoutNCHWcCompute<B, true>;                  \
+  template class LayoutNCHWcCompute<B, false>;
+
+INSTANTIATE_NCHWC_KERNELS(8)
+INSTANTIATE_NCHWC_KERNELS(16)
+#undef INSTANTIATE_NCHWC_KERNELS
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+namespace nchwc = paddle::lite::kernels::x86;
+
+typedef nchwc::ConvNCHWcCompute<8> ConvNCHWc8;
+typedef nchwc::ConvNCHWcCompute<16> ConvNCHWc16;
+typedef nchwc::PoolNCHWcCompute<8> PoolNCHWc8;
+typedef nchwc::PoolNCHWcCompute<16> PoolNCHWc16;
+typedef nchwc::ElementwiseNCHWcCompute<8, nchwc::NCHWcAddFunctor> AddNCHWc8;
+typedef nchwc::ElementwiseNCHWcCompute<16, nchwc::NCHWcAddFunctor> AddNCHWc16;
+typedef nchwc::ElementwiseNCHWcCompute<8, nchwc::NCHWcSubFunctor> SubNCHWc8;
+typedef nchwc::ElementwiseNCHWcCompute<16, nchwc::NCHWcSubFunctor> SubNCHWc16;
+typedef nchwc::ElementwiseNCHWcCompute<8, nchwc::NCHWcMulFunctor> MulNCHWc8;
+typedef nchwc::ElementwiseNCHWcCompute<16, nchwc::NCHWcMulFunctor> MulNCHWc16;
+typedef nchwc::ActivationNCHWcCompute<8> ActNCHWc8;
+typedef nchwc::ActivationNCHWcCompute<16> ActNCHWc16;
+typedef nchwc::ConcatNCHWcCompute<8> ConcatNCHWc8;
+typedef nchwc::ConcatNCHWcCompute<16> ConcatNCHWc16;
+typedef nchwc::LayoutNCHWcCompute<8, true> NCHWToNCHWc8;
+typedef nchwc::LayoutNCHWcCompute<16, true> NCHWToNCHWc16;
+typedef nchwc::LayoutNCHWcCompute<8, false> NCHWc8ToNCHW;
+typedef nchwc::LayoutNCHWcCompute<16, false> NCHWc16ToNCHW;
+
+REGISTER_LITE_KERNEL(conv2d, kX86, kFloat, kNCHWc8, ConvNCHWc8, def)
+    .BindInput("Input",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHWc8))})
+    .BindInput("Filter",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW))})
+    .BindInput("Bias",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW))})
+    .BindOutput("Output",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHWc8))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(conv2d, kX86, kFloat, kNCHWc16, ConvNCHWc16, def)
+    .BindInput("Input",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHWc16))})
+    .BindInput("Filter",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW))})
+    .BindInput("Bias",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW))})
+    .BindOutput("Output",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHWc16))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(depthwise_conv2d, kX86, kFloat, kNCHWc8, ConvNCHWc8, def)
+    .BindInput("Input",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHWc8))})
+    .BindInput("Filter",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW))})
+    .BindInput("Bias",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW))})
+    .BindOutput("Output",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHWc8))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(depthwise_conv2d, kX86, kFloat, kNCHWc16, ConvNCHWc16, def)
+    .BindInput("Input",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHWc16))})
+    .BindInput("Filter",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW))})
+    .BindInput("Bias",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW))})
+    .BindOutput("Output",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHWc16))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(pool2d, kX86, kFloat, kNCHWc8, PoolNCHWc8, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHWc8))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHWc8))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(pool2d, kX86, kFloat, kNCHWc16, PoolNCHWc16, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHWc16))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHWc16))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(elementwise_add, kX86, kFloat, kNCHWc8, AddNCHWc8, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHWc8))})
+    .BindInput("Y",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHWc8))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHWc8))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(elementwise_add, kX86, kFloat, kNCHWc16, AddNCHWc16, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHWc16))})
+    .BindInput("Y",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHWc16))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHWc16))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(elementwise_sub, kX86, kFloat, kNCHWc8, SubNCHWc8, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHWc8))})
+    .BindInput("Y",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHWc8))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHWc8))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(elementwise_sub, kX86, kFloat, kNCHWc16, SubNCHWc16, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHWc16))})
+    .BindInput("Y",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHWc16))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHWc16))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(elementwise_mul, kX86, kFloat, kNCHWc8, MulNCHWc8, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHWc8))})
+    .BindInput("Y",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHWc8))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHWc8))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(elementwise_mul, kX86, kFloat, kNCHWc16, MulNCHWc16, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHWc16))})
+    .BindInput("Y",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHWc16))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHWc16))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(relu, kX86, kFloat, kNCHWc8, ActNCHWc8, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHWc8))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHWc8))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(relu, kX86, kFloat, kNCHWc16, ActNCHWc16, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHWc16))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHWc16))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(relu6, kX86, kFloat, kNCHWc8, ActNCHWc8, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHWc8))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHWc8))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(relu6, kX86, kFloat, kNCHWc16, ActNCHWc16, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHWc16))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHWc16))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(leaky_relu, kX86, kFloat, kNCHWc8, ActNCHWc8, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHWc8))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHWc8))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(leaky_relu, kX86, kFloat, kNCHWc16, ActNCHWc16, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHWc16))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHWc16))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(sigmoid, kX86, kFloat, kNCHWc8, ActNCHWc8, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHWc8))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHWc8))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(sigmoid, kX86, kFloat, kNCHWc16, ActNCHWc16, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHWc16))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHWc16))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(tanh, kX86, kFloat, kNCHWc8, ActNCHWc8, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHWc8))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHWc8))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(tanh, kX86, kFloat, kNCHWc16, ActNCHWc16, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHWc16))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHWc16))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(concat, kX86, kFloat, kNCHWc8, ConcatNCHWc8, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHWc8))})
+    .BindInput("AxisTensor",
+               {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt32))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHWc8))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(concat, kX86, kFloat, kNCHWc16, ConcatNCHWc16, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHWc16))})
+    .BindInput("AxisTensor",
+               {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt32))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHWc16))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(layout, kX86, kFloat, kNCHW, NCHWToNCHWc8, nchw2nchwc8)
+    .BindInput("Input",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHWc8))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(layout, kX86, kFloat, kNCHW, NCHWc8ToNCHW, nchwc82nchw)
+    .BindInput("Input",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHWc8))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(layout, kX86, kFloat, kNCHW, NCHWToNCHWc16, nchw2nchwc16)
+    .BindInput("Input",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHWc16))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(layout, kX86, kFloat, kNCHW, NCHWc16ToNCHW, nchwc162nchw)
+    .BindInput("Input",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHWc16))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(
+    layout_once, kX86, kFloat, kNCHW, NCHWToNCHWc8, nchw2nchwc8)
+    .BindInput("Input",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHWc8))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(
+    layout_once, kX86, kFloat, kNCHW, NCHWc8ToNCHW, nchwc82nchw)
+    .BindInput("Input",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHWc8))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(
+    layout_once, kX86, kFloat, kNCHW, NCHWToNCHWc16, nchw2nchwc16)
+    .BindInput("Input",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHWc16))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(
+    layout_once, kX86, kFloat, kNCHW, NCHWc16ToNCHW, nchwc162nchw)
+    .BindInput("Input",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHWc16))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW))})
+    .Finalize();
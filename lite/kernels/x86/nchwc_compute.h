@@ -0,0 +1,149 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "lite/backends/x86/math/nchwc.h"
+#include "lite/core/kernel.h"
+#include "lite/core/op_registry.h"
+#include "lite/operators/op_params.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+/*
+ * The float kernels on the blocked layouts NCHWc8 and NCHWc16, see
+ * lite/backends/x86/math/nchwc.h for the memory order. They are picked when
+ * the valid places contain Place{kX86, kFloat, kNCHWc8 or kNCHWc16}, and the
+ * layout kernels convert the tensors at the boundaries of the blocked ops.
+ */
+template <int B>
+struct NCHWcLayout;
+
+template <>
+struct NCHWcLayout<8> {
+  static constexpr DataLayoutType value = DATALAYOUT(kNCHWc8);
+};
+
+template <>
+struct NCHWcLayout<16> {
+  static constexpr DataLayoutType value = DATALAYOUT(kNCHWc16);
+};
+
+template <int B>
+using NCHWcKernel =
+    KernelLite<TARGET(kX86), PRECISION(kFloat), NCHWcLayout<B>::value>;
+
+// conv2d and depthwise_conv2d, relu, relu6 and leaky_relu are fused. The
+// convs fused with the other activations are left to the NCHW kernels.
+template <int B>
+class ConvNCHWcCompute : public NCHWcKernel<B> {
+ public:
+  using param_t = operators::ConvParam;
+
+  void PrepareForRun() override;
+
+  bool IsParamSupported() const override;
+
+  void Run() override;
+
+  virtual ~ConvNCHWcCompute() = default;
+
+ private:
+  lite::x86::math::ConvNCHWcParam conv_param_;
+  Tensor packed_filter_;
+};
+
+template <int B>
+class PoolNCHWcCompute : public NCHWcKernel<B> {
+ public:
+  using param_t = operators::PoolParam;
+
+  bool IsParamSupported() const override;
+
+  void Run() override;
+
+  virtual ~PoolNCHWcCompute() = default;
+};
+
+struct NCHWcAddFunctor {
+  inline float operator()(float x, float y) const { return x + y; }
+};
+
+struct NCHWcSubFunctor {
+  inline float operator()(float x, float y) const { return x - y; }
+};
+
+struct NCHWcMulFunctor {
+  inline float operator()(float x, float y) const { return x * y; }
+};
+
+// Y of the same dims as X, a scalar or a vector of the channels of X is
+// computed in place, the other broadcasts expand Y first. A persistable Y
+// which is neither a scalar nor a vector of the channels is left to the NCHW
+// kernels.
+template <int B, typename Functor>
+class ElementwiseNCHWcCompute : public NCHWcKernel<B> {
+ public:
+  using param_t = operators::ElementwiseParam;
+
+  bool IsParamSupported() const override;
+
+  void Run() override;
+
+  virtual ~ElementwiseNCHWcCompute() = default;
+};
+
+// relu, relu6, leaky_relu, sigmoid and tanh.
+template <int B>
+class ActivationNCHWcCompute : public NCHWcKernel<B> {
+ public:
+  using param_t = operators::ActivationParam;
+
+  bool IsParamSupported() const override;
+
+  void Run() override;
+
+  virtual ~ActivationNCHWcCompute() = default;
+};
+
+template <int B>
+class ConcatNCHWcCompute : public NCHWcKernel<B> {
+ public:
+  using param_t = operators::ConcatParam;
+
+  void Run() override;
+
+  virtual ~ConcatNCHWcCompute() = default;
+};
+
+// The layout and layout_once kernels between NCHW and NCHWc<B>, the tensors
+// of the ranks other than 4 are copied as they are.
+template <int B, bool ToBlocked>
+class LayoutNCHWcCompute
+    : public KernelLite<TARGET(kX86), PRECISION(kFloat), DATALAYOUT(kNCHW)> {
+ public:
+  using param_t = operators::LayoutParam;
+
+  void Run() override;
+
+  virtual ~LayoutNCHWcCompute() = default;
+};
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,486 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/nchwc_compute.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+template <typename KernelT, typename ParamT>
+static void run_kernel(const ParamT& param) {
+  KernelT kernel;
+  std::unique_ptr<KernelContext> ctx(new KernelContext);
+  ctx->As<X86Context>();
+  kernel.SetContext(std::move(ctx));
+  kernel.SetParam(param);
+  kernel.PrepareForRun();
+  kernel.Run();
+}
+
+static void fill_data(lite::Tensor* x, int seed) {
+  float* data = x->mutable_data<float>();
+  for (int64_t i = 0; i < x->numel(); i++) {
+    data[i] = static_cast<float>((i * 37 + seed * 11) % 29) / 14.f - 1.f;
+  }
+}
+
+template <int B>
+static void to_blocked(const lite::Tensor& x, lite::Tensor* y) {
+  operators::LayoutParam param;
+  param.x = &x;
+  param.y = y;
+  y->Resize(x.dims());
+  run_kernel<LayoutNCHWcCompute<B, true>>(param);
+}
+
+template <int B>
+static void from_blocked(const lite::Tensor& x, lite::Tensor* y) {
+  operators::LayoutParam param;
+  param.x = &x;
+  param.y = y;
+  y->Resize(x.dims());
+  run_kernel<LayoutNCHWcCompute<B, false>>(param);
+}
+
+static void check_tensor(const lite::Tensor& out,
+                         const std::vector<float>& ref) {
+  ASSERT_EQ(out.numel(), static_cast<int64_t>(ref.size()));
+  const float* data = out.data<float>();
+  for (size_t i = 0; i < ref.size(); i++) {
+    EXPECT_NEAR(data[i], ref[i], 1e-4f) << "at " << i;
+  }
+}
+
+static void conv_ref(const lite::Tensor& x,
+                     const lite::Tensor& w,
+                     const lite::Tensor& bias,
+                     int stride,
+                     int pad,
+                     int dilation,
+                     int groups,
+                     float relu6_threshold,
+                     const DDim& out_dims,
+                     std::vector<float>* out) {
+  const int batch = x.dims()[0];
+  const int in_c = x.dims()[1];
+  const int h = x.dims()[2];
+  const int w_in = x.dims()[3];
+  const int out_c = out_dims[1];
+  const int out_h = out_dims[2];
+  const int out_w = out_dims[3];
+  const int k = w.dims()[2];
+  const int gin = in_c / groups;
+  const int gout = out_c / groups;
+  const float* xd = x.data<float>();
+  const float* wd = w.data<float>();
+  out->resize(out_dims.production());
+  for (int b = 0; b < batch; b++) {
+    for (int oc = 0; oc < out_c; oc++) {
+      int g = oc / gout;
+      for (int oh = 0; oh < out_h; oh++) {
+        for (int ow = 0; ow < out_w; ow++) {
+          float acc = bias.data<float>()[oc];
+          for (int ic = 0; ic < gin; ic++) {
+            for (int i = 0; i < k; i++) {
+              for (int j = 0; j < k; j++) {
+                int ih = oh * stride - pad + i * dilation;
+                int iw = ow * stride - pad + j * dilation;
+                if (ih < 0 || ih >= h || iw < 0 || iw >= w_in) continue;
+                acc += xd[((b * in_c + g * gin + ic) * h + ih) * w_in + iw] *
+                       wd[((oc * gin + ic) * k + i) * k + j];
+              }
+            }
+          }
+          acc = (std::min)((std::max)(acc, 0.f), relu6_threshold);
+          (*out)[((b * out_c + oc) * out_h + oh) * out_w + ow] = acc;
+        }
+      }
+    }
+  }
+}
+
+template <int B>
+static void test_conv_nchwc(int batch,
+                            int in_c,
+                            int h,
+                            int out_c,
+                            int k,
+                            int stride,
+                            int pad,
+                            int dilation,
+                            int groups) {
+  int out_h = (h + 2 * pad - (dilation * (k - 1) + 1)) / stride + 1;
+  lite::Tensor x, filter, bias, x_blocked, out_blocked, out;
+  x.Resize({batch, in_c, h, h});
+  filter.Resize({out_c, in_c / groups, k, k});
+  bias.Resize({out_c});
+  fill_data(&x, 1);
+  fill_data(&filter, 2);
+  fill_data(&bias, 3);
+  to_blocked<B>(x, &x_blocked);
+
+  operators::ConvParam param;
+  param.x = &x_blocked;
+  param.filter = &filter;
+  param.bias = &bias;
+  param.output = &out_blocked;
+  param.strides = {stride, stride};
+  param.paddings = std::make_shared<std::vector<int>>(
+      std::vector<int>{pad, pad, pad, pad});
+  param.dilations =
+      std::make_shared<std::vector<int>>(std::vector<int>{dilation, dilation});
+  param.groups = groups;
+  param.activation_param.has_active = true;
+  param.activation_param.active_type = lite_api::ActivationType::kRelu6;
+  param.activation_param.Relu_clipped_coef = 0.5f;
+  out_blocked.Resize({batch, out_c, out_h, out_h});
+  run_kernel<ConvNCHWcCompute<B>>(param);
+  from_blocked<B>(out_blocked, &out);
+
+  std::vector<float> ref;
+  conv_ref(
+      x, filter, bias, stride, pad, dilation, groups, 0.5f, out.dims(), &ref);
+  check_tensor(out, ref);
+}
+
+TEST(conv_nchwc_x86, compute) {
+  // dense, unaligned channels, block aligned groups, unaligned groups and
+  // depthwise.
+  for (int s : {1, 2}) {
+    test_conv_nchwc<8>(2, 16, 9, 24, 3, s, 1, 1, 1);
+    test_conv_nchwc<8>(1, 3, 11, 10, 3, s, 1, 2, 1);
+    test_conv_nchwc<8>(1, 32, 7, 16, 1, s, 0, 1, 2);
+    test_conv_nchwc<8>(1, 12, 7, 6, 3, s, 1, 1, 3);
+    test_conv_nchwc<8>(2, 20, 9, 20, 3, s, 1, 1, 20);
+    test_conv_nchwc<16>(1, 16, 9, 40, 3, s, 1, 1, 1);
+    test_conv_nchwc<16>(1, 24, 8, 24, 5, s, 2, 1, 24);
+  }
+}
+
+template <int B>
+static void test_pool_nchwc(const std::string& type,
+                            bool exclusive,
+                            bool adaptive) {
+  lite::Tensor x, x_blocked, out_blocked, out;
+  x.Resize({2, 11, 9, 9});
+  fill_data(&x, 4);
+  to_blocked<B>(x, &x_blocked);
+  const int k = 3, stride = 2, pad = 1;
+  const int out_hw = adaptive ? 4 : (9 + 2 * pad - k) / stride + 1;
+
+  operators::PoolParam param;
+  param.x = &x_blocked;
+  param.output = &out_blocked;
+  param.pooling_type = type;
+  param.ksize = {adaptive ? out_hw : k, adaptive ? out_hw : k};
+  param.strides = {stride, stride};
+  param.paddings = std::make_shared<std::vector<int>>(
+      std::vector<int>{pad, pad, pad, pad});
+  param.exclusive = exclusive;
+  param.adaptive = adaptive;
+  out_blocked.Resize({2, 11, out_hw, out_hw});
+  run_kernel<PoolNCHWcCompute<B>>(param);
+  from_blocked<B>(out_blocked, &out);
+
+  std::vector<float> ref;
+  const float* xd = x.data<float>();
+  for (int nc = 0; nc < 22; nc++) {
+    for (int oh = 0; oh < out_hw; oh++) {
+      for (int ow = 0; ow < out_hw; ow++) {
+        int hs, he, ws, we;
+        if (adaptive) {
+          hs = oh * 9 / out_hw;
+          he = ((oh + 1) * 9 + out_hw - 1) / out_hw;
+          ws = ow * 9 / out_hw;
+          we = ((ow + 1) * 9 + out_hw - 1) / out_hw;
+        } else {
+          hs = (std::max)(oh * stride - pad, 0);
+          he = (std::min)(oh * stride - pad + k, 9);
+          ws = (std::max)(ow * stride - pad, 0);
+          we = (std::min)(ow * stride - pad + k, 9);
+        }
+        float v = type == "max" ? -1e10f : 0.f;
+        for (int i = hs; i < he; i++) {
+          for (int j = ws; j < we; j++) {
+            float e = xd[(nc * 9 + i) * 9 + j];
+            v = type == "max" ? (std::max)(v, e) : v + e;
+          }
+        }
+        if (type == "avg") {
+          v /= exclusive || adaptive ? (he - hs) * (we - ws) : k * k;
+        }
+        ref.push_back(v);
+      }
+    }
+  }
+  check_tensor(out, ref);
+}
+
+TEST(pool_nchwc_x86, compute) {
+  test_pool_nchwc<8>("max", true, false);
+  test_pool_nchwc<8>("avg", true, false);
+  test_pool_nchwc<8>("avg", false, false);
+  test_pool_nchwc<16>("avg", true, true);
+  test_pool_nchwc<16>("max", true, false);
+}
+
+TEST(elementwise_nchwc_x86, channel_broadcast) {
+  lite::Tensor x, y, x_blocked, y_blocked, out_blocked, out;
+  x.Resize({2, 13, 3, 5});
+  y.Resize({13});
+  fill_data(&x, 5);
+  fill_data(&y, 6);
+  to_blocked<8>(x, &x_blocked);
+  to_blocked<8>(y, &y_blocked);
+
+  operators::ElementwiseParam param;
+  param.X = &x_blocked;
+  param.Y = &y_blocked;
+  param.Out = &out_blocked;
+  param.axis = 1;
+  out_blocked.Resize(x.dims());
+  run_kernel<ElementwiseNCHWcCompute<8, NCHWcAddFunctor>>(param);
+  from_blocked<8>(out_blocked, &out);
+
+  std::vector<float> ref(x.numel());
+  for (int64_t i = 0; i < x.numel(); i++) {
+    ref[i] = x.data<float>()[i] + y.data<float>()[i / 15 % 13];
+  }
+  check_tensor(out, ref);
+}
+
+template <typename Functor>
+static void test_elementwise_broadcast(const std::vector<int64_t>& y_dims,
+                                       int axis) {
+  lite::Tensor x, y, x_blocked, y_blocked, out_blocked, out;
+  x.Resize({2, 13, 3, 5});
+  y.Resize(y_dims);
+  fill_data(&x, 8);
+  fill_data(&y, 9);
+  to_blocked<8>(x, &x_blocked);
+  to_blocked<8>(y, &y_blocked);
+
+  operators::ElementwiseParam param;
+  param.X = &x_blocked;
+  param.Y = &y_blocked;
+  param.Out = &out_blocked;
+  param.axis = axis;
+  out_blocked.Resize(x.dims());
+  run_kernel<ElementwiseNCHWcCompute<8, Functor>>(param);
+  from_blocked<8>(out_blocked, &out);
+
+  // The strides of Y aligned to the dims of X from `axis`.
+  if (axis < 0) axis = 4 - static_cast<int>(y_dims.size());
+  std::vector<int64_t> strides(4, 0);
+  int64_t stride = 1;
+  for (int d = static_cast<int>(y_dims.size()) - 1; d >= 0; d--) {
+    strides[axis + d] = y_dims[d] == 1 ? 0 : stride;
+    stride *= y_dims[d];
+  }
+  Functor functor;
+  std::vector<float> ref(x.numel());
+  for (int64_t i = 0; i < x.numel(); i++) {
+    int64_t rest = i;
+    int64_t offset = 0;
+    for (int d = 3; d >= 0; d--) {
+      offset += rest % x.dims()[d] * strides[d];
+      rest /= x.dims()[d];
+    }
+    ref[i] = functor(x.data<float>()[i], y.data<float>()[offset]);
+  }
+  check_tensor(out, ref);
+}
+
+TEST(elementwise_nchwc_x86, broadcast) {
+  test_elementwise_broadcast<NCHWcAddFunctor>({2, 13, 3, 5}, -1);
+  test_elementwise_broadcast<NCHWcMulFunctor>({1}, -1);
+  test_elementwise_broadcast<NCHWcSubFunctor>({1, 13, 1, 1}, -1);
+  // The broadcasts other than the scalars and the channels.
+  test_elementwise_broadcast<NCHWcMulFunctor>({2, 1, 3, 5}, -1);
+  test_elementwise_broadcast<NCHWcSubFunctor>({3, 5}, 2);
+  test_elementwise_broadcast<NCHWcAddFunctor>({13, 3}, 1);
+}
+
+TEST(activation_nchwc_x86, compute) {
+  for (auto type : {lite_api::ActivationType::kRelu,
+                    lite_api::ActivationType::kRelu6,
+                    lite_api::ActivationType::kLeakyRelu,
+                    lite_api::ActivationType::kSigmoid,
+                    lite_api::ActivationType::kTanh}) {
+    lite::Tensor x, x_blocked, out_blocked, out;
+    x.Resize({2, 21, 17, 19});
+    fill_data(&x, 10);
+    float* xd = x.mutable_data<float>();
+    for (int64_t i = 0; i < x.numel(); i++) {
+      xd[i] *= 8.f;
+    }
+    to_blocked<16>(x, &x_blocked);
+
+    operators::ActivationParam param;
+    param.X = &x_blocked;
+    param.Out = &out_blocked;
+    param.active_type = type;
+    param.threshold = 3.f;
+    param.Leaky_relu_alpha = 0.1f;
+    out_blocked.Resize(x.dims());
+    run_kernel<ActivationNCHWcCompute<16>>(param);
+    from_blocked<16>(out_blocked, &out);
+
+    std::vector<float> ref(x.numel());
+    for (int64_t i = 0; i < x.numel(); i++) {
+      float v = xd[i];
+      switch (type) {
+        case lite_api::ActivationType::kRelu:
+          ref[i] = (std::max)(v, 0.f);
+          break;
+        case lite_api::ActivationType::kRelu6:
+          ref[i] = (std::min)((std::max)(v, 0.f), 3.f);
+          break;
+        case lite_api::ActivationType::kLeakyRelu:
+          ref[i] = v > 0.f ? v : 0.1f * v;
+          break;
+        case lite_api::ActivationType::kSigmoid:
+          ref[i] = 1.f / (1.f + std::exp(-v));
+          break;
+        default:
+          ref[i] = std::tanh(v);
+      }
+    }
+    check_tensor(out, ref);
+  }
+}
+
+// The params which the NCHWc kernels don't support are declined when the
+// kernels are picked, so the ops run with the NCHW kernels.
+TEST(nchwc_x86, param_supported) {
+  lite::Tensor filter;
+  filter.Resize({8, 8, 3, 3});
+  operators::ConvParam conv_param;
+  conv_param.filter = &filter;
+  conv_param.activation_param.has_active = true;
+  conv_param.activation_param.active_type = lite_api::ActivationType::kRelu6;
+  ConvNCHWcCompute<8> conv;
+  conv.SetParam(conv_param);
+  EXPECT_TRUE(conv.IsParamSupported());
+  conv_param.activation_param.active_type =
+      lite_api::ActivationType::kHardSwish;
+  conv.SetParam(conv_param);
+  EXPECT_FALSE(conv.IsParamSupported());
+
+  operators::PoolParam pool_param;
+  pool_param.ksize = {3, 3};
+  pool_param.pooling_type = "avg";
+  PoolNCHWcCompute<8> pool;
+  pool.SetParam(pool_param);
+  EXPECT_TRUE(pool.IsParamSupported());
+  pool_param.ksize = {3, 3, 3};
+  pool.SetParam(pool_param);
+  EXPECT_FALSE(pool.IsParamSupported());
+
+  operators::ActivationParam act_param;
+  act_param.active_type = lite_api::ActivationType::kSigmoid;
+  ActivationNCHWcCompute<8> act;
+  act.SetParam(act_param);
+  EXPECT_TRUE(act.IsParamSupported());
+  act_param.active_type = lite_api::ActivationType::kSwish;
+  act.SetParam(act_param);
+  EXPECT_FALSE(act.IsParamSupported());
+
+  // Only the persistable Y is known when the kernels are picked.
+  lite::Tensor y;
+  operators::ElementwiseParam ew_param;
+  ew_param.Y = &y;
+  ElementwiseNCHWcCompute<8, NCHWcAddFunctor> ew;
+  y.Resize({3, 5});
+  ew_param.axis = 2;
+  ew.SetParam(ew_param);
+  EXPECT_TRUE(ew.IsParamSupported());
+  y.set_persistable(true);
+  EXPECT_FALSE(ew.IsParamSupported());
+  y.Resize({1, 16, 1, 1});
+  ew_param.axis = -1;
+  ew.SetParam(ew_param);
+  EXPECT_TRUE(ew.IsParamSupported());
+  y.Resize({16});
+  ew_param.axis = 1;
+  ew.SetParam(ew_param);
+  EXPECT_TRUE(ew.IsParamSupported());
+  y.Resize({16});
+  ew_param.axis = -1;
+  ew.SetParam(ew_param);
+  EXPECT_FALSE(ew.IsParamSupported());
+}
+
+template <int B>
+static void test_concat_nchwc(const std::vector<int>& channels, int axis) {
+  std::vector<lite::Tensor> xs(channels.size());
+  std::vector<lite::Tensor> xs_blocked(channels.size());
+  operators::ConcatParam param;
+  int out_c = 0;
+  for (size_t i = 0; i < channels.size(); i++) {
+    int h = axis == 2 ? 2 + static_cast<int>(i) : 3;
+    xs[i].Resize({2, channels[i], h, 4});
+    fill_data(&xs[i], 7 + i);
+    to_blocked<B>(xs[i], &xs_blocked[i]);
+    param.x.push_back(&xs_blocked[i]);
+    out_c += channels[i];
+  }
+  // The reference is the plain concat.
+  std::vector<float> ref;
+  int outer = axis == 1 ? 2 : 2 * channels[0];
+  for (int o = 0; o < outer; o++) {
+    for (auto& x : xs) {
+      int64_t size = x.numel() / outer;
+      ref.insert(ref.end(),
+                 x.data<float>() + o * size,
+                 x.data<float>() + (o + 1) * size);
+    }
+  }
+  lite::Tensor out_blocked, out;
+  param.output = &out_blocked;
+  param.axis = axis;
+  if (axis == 1) {
+    out_blocked.Resize({2, out_c, 3, 4});
+  } else {
+    int h = 0;
+    for (auto& x : xs) h += x.dims()[2];
+    out_blocked.Resize({2, channels[0], h, 4});
+  }
+  run_kernel<ConcatNCHWcCompute<B>>(param);
+  from_blocked<B>(out_blocked, &out);
+  check_tensor(out, ref);
+}
+
+TEST(concat_nchwc_x86, compute) {
+  test_concat_nchwc<8>({8, 16, 5}, 1);
+  test_concat_nchwc<8>({5, 11, 3}, 1);
+  test_concat_nchwc<16>({7, 7}, 2);
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_KERNEL(conv2d, kX86, kFloat, kNCHWc8, def);
+USE_LITE_KERNEL(layout, kX86, kFloat, kNCHW, nchw2nchwc8);
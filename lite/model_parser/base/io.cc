@@ -13,6 +13,12 @@
 // limitations under the License.
 
 #include "lite/model_parser/base/io.h"
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 namespace paddle {
 namespace lite {
@@ -56,6 +62,86 @@ void BinaryFileReader::Read(void* dst, size_t size) const {
   cur_ += size;
 }
 
+#ifndef _WIN32
+MappedFile::MappedFile(const std::string& path) {
+  int fd = open(path.c_str(), O_RDONLY);
+  CHECK_GE(fd, 0) << "Unable to open file: " << path;
+  struct stat st;
+  CHECK_EQ(fstat(fd, &st), 0) << "Unable to stat file: " << path;
+  size_ = static_cast<size_t>(st.st_size);
+  if (size_ > 0) {
+    void* addr =
+        mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    CHECK(addr != MAP_FAILED) << "Unable to map file: " << path;
+    data_ = static_cast<char*>(addr);
+  }
+  close(fd);
+}
+
+MappedFile::~MappedFile() {
+  if (data_) {
+    munmap(data_, size_);
+  }
+}
+
+void MappedFile::AdviseRandomAccess(const void* addr, size_t size) {
+  if (!addr || size == 0) return;
+  // madvise needs an address aligned to the page.
+  const uintptr_t page_size = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+  uintptr_t begin = reinterpret_cast<uintptr_t>(addr) & ~(page_size - 1);
+  uintptr_t end = reinterpret_cast<uintptr_t>(addr) + size;
+  if (madvise(reinterpret_cast<void*>(begin), end - begin, MADV_RANDOM)) {
+    VLOG(3) << "madvise failed, the pages are read ahead as usual.";
+  }
+}
+#else
+// The file is read into the memory since mmap is unavailable.
+MappedFile::MappedFile(const std::string& path) {
+  FILE* file = fopen(path.c_str(), "rb");
+  CHECK(file) << "Unable to open file: " << path;
+  fseek(file, 0L, SEEK_END);
+  size_ = ftell(file);
+  fseek(file, 0L, SEEK_SET);
+  if (size_ > 0) {
+    data_ = static_cast<char*>(TargetMalloc(TargetType::kHost, size_));
+    CHECK_EQ(fread(data_, 1, size_, file), size_) << "Failed to read " << path;
+  }
+  fclose(file);
+}
+
+MappedFile::~MappedFile() {
+  if (data_) {
+    TargetFree(TargetType::kHost, data_);
+  }
+}
+
+void MappedFile::AdviseRandomAccess(const void* addr, size_t size) {}
+#endif
+
+MappedFileReader::MappedFileReader(const std::string& path, size_t offset)
+    : file_(std::make_shared<MappedFile>(path)) {
+  CHECK_LE(offset, file_->size());
+  buf_ = file_->data() + offset;
+  length_ = file_->size() - offset;
+}
+
+void MappedFileReader::Read(void* dst, size_t size) const {
+  CHECK(dst);
+  CHECK_LE(cur_ + size, length_) << "Failed to read " << size << " bytes.";
+  lite::TargetCopy(TargetType::kHost, dst, buf_ + cur_, size);
+  cur_ += size;
+}
+
+const void* MappedFileReader::ReadInPlace(
+    size_t size, std::shared_ptr<const void>* holder) const {
+  CHECK(holder);
+  CHECK_LE(cur_ + size, length_) << "Failed to read " << size << " bytes.";
+  const void* data = buf_ + cur_;
+  *holder = file_;
+  cur_ += size;
+  return data;
+}
+
 void BinaryFileWriter::Write(const void* src, size_t size) const {
   CHECK(src);
   CHECK_EQ(fwrite(src, 1, size, file_), size) << "Failed to read " << size
@@ -80,6 +80,14 @@ class ByteReader {
   virtual size_t current() const = 0;
   virtual bool ReachEnd() const = 0;
 
+  // Skip `size` bytes and return their address if the reader is backed by a
+  // memory mapping, which is kept alive by `holder`. Otherwise nothing is read
+  // and nullptr is returned.
+  virtual const void* ReadInPlace(size_t size,
+                                  std::shared_ptr<const void>* holder) const {
+    return nullptr;
+  }
+
   template <typename T,
             typename = typename std::enable_if<
                 std::is_trivially_copyable<T>::value>::type>
@@ -115,6 +123,9 @@ class ByteWriter {
 
   virtual size_t Align(size_t bytes_size) const = 0;
 
+  // The number of the written bytes.
+  virtual size_t current() const = 0;
+
   virtual ~ByteWriter() = default;
 
  private:
@@ -141,6 +152,47 @@ class BinaryFileReader : public ByteReader {
   mutable size_t cur_{0};
 };
 
+// A private and writable mapping of a whole file. The pages are shared by the
+// processes which map the same file until they are written, and the writes
+// are never carried through to the file.
+class MappedFile {
+ public:
+  explicit MappedFile(const std::string& path);
+  ~MappedFile();
+  const char* data() const { return data_; }
+  size_t size() const { return size_; }
+
+  // The mapped bytes in [addr, addr + size) are read at random, e.g. the
+  // rows of the embedding tables, so the pages around a read are not read
+  // ahead and only the read pages become resident.
+  static void AdviseRandomAccess(const void* addr, size_t size);
+
+ private:
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  char* data_{nullptr};
+  size_t size_{0};
+};
+
+// Read a file by a memory mapping, so that the bytes can be used in place.
+class MappedFileReader : public ByteReader {
+ public:
+  explicit MappedFileReader(const std::string& path, size_t offset = 0);
+  void Read(void* dst, size_t size) const override;
+  const void* ReadInPlace(size_t size,
+                          std::shared_ptr<const void>* holder) const override;
+  bool ReachEnd() const override { return cur_ >= length_; }
+  size_t length() const override { return length_; }
+  size_t current() const override { return cur_; }
+
+ private:
+  std::shared_ptr<MappedFile> file_;
+  const char* buf_{nullptr};
+  size_t length_{0};
+  mutable size_t cur_{0};
+};
+
 class BinaryFileWriter : public ByteWriter {
  public:
   explicit BinaryFileWriter(const std::string& path) {
@@ -154,6 +206,8 @@ class BinaryFileWriter : public ByteWriter {
   }
   void Write(const void* src, size_t size) const override;
 
+  size_t current() const override { return cur_; }
+
   // Fill a number of zero characters to align the number
   // of written bytes to a certain position.
   size_t Align(size_t scalar_size) const override {
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include "lite/model_parser/flatbuffers/io.h"
+#include <cstdint>
 #include <cstring>
 #include <limits>
 #include <memory>
@@ -68,6 +69,30 @@ void FillTensor(lite::Tensor* tensor, const ParamDescReadAPI& param) {
   std::memcpy(dst, param.GetData(), param.byte_size());
   tensor->set_persistable(true);
 }
+
+void ShareTensor(lite::Tensor* tensor,
+                 const ParamDescReadAPI& param,
+                 const std::shared_ptr<const void>& holder) {
+  CHECK(tensor);
+  CHECK(param.GetData());
+  auto* data = const_cast<void*>(param.GetData());
+  if (reinterpret_cast<uintptr_t>(data) % kParamDataAlignment != 0 ||
+      param.byte_size() == 0) {
+    // The params saved before the data was aligned are copied.
+    FillTensor(tensor, param);
+    return;
+  }
+  tensor->Resize(param.Dim());
+  tensor->set_precision(lite::ConvertPrecisionType(param.GetDataType()));
+  // The buffer keeps the mapping alive, and falls back to a private
+  // allocation once the tensor outgrows it.
+  std::shared_ptr<lite::Buffer> buffer(
+      new lite::Buffer(data, TargetType::kHost, param.byte_size()),
+      [holder](lite::Buffer* x) { delete x; });
+  buffer->set_detachable(true);
+  tensor->ResetBuffer(buffer, param.byte_size());
+  tensor->set_persistable(true);
+}
 #ifdef LITE_WITH_FLATBUFFERS_DESC
 void ParamSerializer::ForwardWrite(const lite::Scope& scope,
                                    const std::set<std::string>& param_names) {
@@ -99,10 +124,18 @@ void ParamSerializer::ForwardWrite(const lite::Scope& scope,
 
     const size_t param_bytes = buf_->size();
     CHECK(param_bytes) << "The bytes size of param can not be zero";
-    constexpr uint32_t offset = sizeof(uint32_t);
+    // Pad the param to align its data in the file, see ShareTensor.
+    const size_t begin = writer_->current() + 2 * sizeof(uint32_t);
+    const uint32_t padding_bytes =
+        (kParamDataAlignment - begin % kParamDataAlignment) %
+        kParamDataAlignment;
+    const uint32_t offset = sizeof(uint32_t) + padding_bytes;
     const uint32_t total_size = param_bytes + offset;
     writer_->Write<uint32_t>(total_size);
     writer_->Write<uint32_t>(offset);
+    for (uint32_t j = 0; j < padding_bytes; ++j) {
+      writer_->Write<uint8_t>(0U);
+    }
     writer_->Write(buf_->data(), param_bytes);
   }
 }
@@ -130,6 +163,16 @@ void ParamDeserializer::ForwardRead(lite::Scope* scope) {
     uint32_t offset = reader_->Read<uint32_t>();
     uint32_t param_bytes = total_size - offset;
     ReadBytesToBuffer(offset - sizeof(offset));
+    std::shared_ptr<const void> holder;
+    const void* mapped_data = reader_->ReadInPlace(param_bytes, &holder);
+    if (mapped_data) {
+      fbs::ParamDescView param(
+          flatbuffers::GetRoot<proto::ParamDesc>(mapped_data));
+      ShareTensor(scope->Var(param.Name())->GetMutable<lite::Tensor>(),
+                  param,
+                  holder);
+      continue;
+    }
     ReadBytesToBuffer(param_bytes);
     fbs::ParamDescView param(buf_.get());
     FillTensor(scope->Var(param.Name())->GetMutable<lite::Tensor>(), param);
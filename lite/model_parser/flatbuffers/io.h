@@ -33,6 +33,12 @@ void FillParam(const std::string& name,
 
 void FillTensor(lite::Tensor* tensor, const ParamDescReadAPI& param);
 
+// Point the tensor to the data of the param without copying if the data is
+// aligned, the data is kept alive by `holder`.
+void ShareTensor(lite::Tensor* tensor,
+                 const ParamDescReadAPI& param,
+                 const std::shared_ptr<const void>& holder);
+
 #ifdef LITE_WITH_FLATBUFFERS_DESC
 class ParamSerializer {
  public:
@@ -128,6 +128,22 @@ TEST(CombinedParamsDesc, Scope) {
     deserializer.ForwardRead(&scope_3);
     check_params(scope_3);
   }
+
+  {
+    Scope scope_4;
+    LOG(INFO) << "Load params from mapped file...";
+    model_parser::MappedFileReader reader(path);
+    fbs::ParamDeserializer deserializer(&reader);
+    deserializer.ForwardRead(&scope_4);
+    check_params(scope_4);
+    // The data is aligned in the file, so it's used in place.
+    for (auto& name : param_names) {
+      const auto& tensor = scope_4.FindVar(name)->Get<Tensor>();
+      EXPECT_EQ(
+          reinterpret_cast<uintptr_t>(tensor.raw_data()) % kParamDataAlignment,
+          0u);
+    }
+  }
 }
 #endif  // LITE_WITH_FLATBUFFERS_DESC
 
@@ -30,6 +30,10 @@ namespace paddle {
 namespace lite {
 namespace fbs {
 
+// The alignment of the data of the serialized params, which is the same as the
+// host allocator, so that the mapped data can be used by the tensors in place.
+constexpr size_t kParamDataAlignment = 64;
+
 class ParamDescView : public ParamDescReadAPI {
  public:
   explicit ParamDescView(model_parser::Buffer* buf) {
@@ -167,10 +171,34 @@ class ParamDesc : public ParamDescAPI {
     model_parser::memcpy(buffer->data(), buf_.data(), buf_.size());
   }
 
+  // Pack the desc by hand instead of ParamDesc::Pack to align the data to
+  // kParamDataAlignment from the beginning of the buffer.
   void SyncBuffer() {
     fbb_.Reset();
-    flatbuffers::Offset<proto::ParamDesc> desc =
-        proto::ParamDesc::Pack(fbb_, desc_);
+    const auto& data = lod_tensor_->data;
+    fbb_.PreAlign(data.size() * sizeof(int8_t), kParamDataAlignment);
+    auto data_offset = fbb_.CreateVector(data);
+    auto lod_offset = fbb_.CreateVector(lod_tensor_->lod);
+    auto dim_offset = fbb_.CreateVector(lod_tensor_->dim);
+    auto tensor_offset =
+        proto::ParamDesc_::CreateLoDTensorDesc(fbb_,
+                                               lod_tensor_->lod_level,
+                                               lod_offset,
+                                               dim_offset,
+                                               lod_tensor_->data_type,
+                                               data_offset);
+    flatbuffers::Offset<proto::ParamDesc_::VersionDesc> version_offset;
+    if (desc_->version) {
+      version_offset = proto::ParamDesc_::CreateVersionDesc(
+          fbb_, desc_->version->version, desc_->version->model_version);
+    }
+    auto name_offset = fbb_.CreateString(desc_->name);
+    auto desc =
+        proto::CreateParamDesc(fbb_,
+                               version_offset,
+                               name_offset,
+                               proto::ParamDesc_::VariableDesc_LoDTensorDesc,
+                               tensor_offset.Union());
     fbb_.Finish(desc);
     buf_ = fbb_.Release();
   }
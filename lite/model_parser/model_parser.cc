@@ -16,6 +16,7 @@
 #include <algorithm>
 #include <fstream>
 #include <limits>
+#include <memory>
 #include <set>
 #include <utility>
 
@@ -648,18 +649,24 @@ void LoadModelNaiveFromMemory(const std::string &model_buffer,
 
 void LoadModelNaiveFromFile(const std::string &filename,
                             Scope *scope,
-                            cpp::ProgramDesc *cpp_prog) {
+                            cpp::ProgramDesc *cpp_prog,
+                            bool use_mmap) {
   CHECK(cpp_prog);
   CHECK(scope);
   // ModelFile
   const std::string prog_path = filename;
 
   // Offset
-  model_parser::BinaryFileReader reader(filename, 0);
+  std::unique_ptr<model_parser::ByteReader> reader;
+  if (use_mmap) {
+    reader.reset(new model_parser::MappedFileReader(filename, 0));
+  } else {
+    reader.reset(new model_parser::BinaryFileReader(filename, 0));
+  }
 
   // (1)get meta version
   uint16_t meta_version;
-  reader.Read(&meta_version, sizeof(uint16_t));
+  reader->Read(&meta_version, sizeof(uint16_t));
   VLOG(4) << "Meta_version:" << meta_version;
 
   switch (meta_version) {
@@ -673,10 +680,10 @@ void LoadModelNaiveFromFile(const std::string &filename,
 #endif
       break;
     case 1:
-      LoadModelFbsFromFile(&reader, scope, cpp_prog, 1);
+      LoadModelFbsFromFile(reader.get(), scope, cpp_prog, 1);
       break;
     case 2:
-      LoadModelFbsFromFile(&reader, scope, cpp_prog, 2);
+      LoadModelFbsFromFile(reader.get(), scope, cpp_prog, 2);
       break;
     default:
       LOG(FATAL) << "The model format cannot be recognized. Please make sure "
@@ -740,7 +747,7 @@ void LoadModelNaiveV0FromFile(const std::string &filename,
   VLOG(4) << "Load naive buffer model in '" << filename << "' successfully";
 }
 #endif  // LITE_ON_TINY_PUBLISH
-void LoadModelFbsFromFile(model_parser::BinaryFileReader *reader,
+void LoadModelFbsFromFile(model_parser::ByteReader *reader,
                           Scope *scope,
                           cpp::ProgramDesc *cpp_prog,
                           uint16_t meta_version) {
@@ -38,6 +38,10 @@ class ConvOpLite : public OpLite {
 
   bool CheckShape() const override;
   bool InferShapeImpl() const override;
+  // The paddings of SAME depend on the input shape.
+  bool InferShapeUpdatesParam() const override {
+    return padding_algorithm_ == "SAME";
+  }
 
 #ifdef LITE_WITH_PROFILE
   void GetOpRuntimeInfo(paddle::lite::profile::OpCharacter* ch) {
@@ -39,6 +39,11 @@ class ConvTransposeOpLite : public OpLite {
 
   bool InferShapeImpl() const override;
 
+  // The paddings of SAME depend on the input shape.
+  bool InferShapeUpdatesParam() const override {
+    return padding_algorithm_ == "SAME";
+  }
+
   bool AttachImpl(const cpp::OpDesc &opdesc, lite::Scope *scope) override;
 
   void AttachKernel(KernelBase *kernel) override { kernel->SetParam(param_); }
@@ -79,6 +79,9 @@ bool FlattenOp::AttachImpl(const cpp::OpDesc &opdesc, lite::Scope *scope) {
   axis_ = opdesc.GetAttr<int>("axis");
 
   param_.inplace = false;
+  if (opdesc.HasAttr("inplace")) {
+    param_.inplace = opdesc.GetAttr<bool>("inplace");
+  }
 
   CHECK(param_.x) << "Input(X) of FlattenOp should not be null.";
   CHECK(param_.output) << "Output(Out) of FlattenOp should not be null.";
@@ -122,6 +125,9 @@ bool FlattenContiguousRangeOp::AttachImpl(const cpp::OpDesc &opdesc,
   param_.xshape = xshape_var->GetMutable<lite::Tensor>();
   param_.start_axis = opdesc.GetAttr<int>("start_axis");
   param_.stop_axis = opdesc.GetAttr<int>("stop_axis");
+  if (opdesc.HasAttr("inplace")) {
+    param_.inplace = opdesc.GetAttr<bool>("inplace");
+  }
   return true;
 }
 
@@ -0,0 +1,71 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/operators/fused_elementwise_add_layer_norm_op.h"
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace operators {
+
+bool FusedElementwiseAddLayerNormOp::CheckShape() const {
+  CHECK_OR_FALSE(param_.X)
+  CHECK_OR_FALSE(param_.Y)
+  CHECK_OR_FALSE(param_.Scale)
+  CHECK_OR_FALSE(param_.Bias)
+  CHECK_OR_FALSE(param_.Out)
+  // Y is broadcasted along the leading dims of X only, e.g. the position
+  // embedding, and every normalized row of X has a whole row of Y.
+  const auto& x_dims = param_.X->dims();
+  const auto& y_dims = param_.Y->dims();
+  CHECK_GE_OR_FALSE(x_dims.size(), y_dims.size())
+  for (size_t i = 1; i <= y_dims.size(); i++) {
+    CHECK_EQ_OR_FALSE(y_dims[y_dims.size() - i], x_dims[x_dims.size() - i])
+  }
+  auto right = x_dims.Flatten2D(param_.begin_norm_axis)[1];
+  CHECK_EQ_OR_FALSE(param_.Y->numel() % right, 0)
+  CHECK_EQ_OR_FALSE(param_.Scale->numel(), right)
+  CHECK_EQ_OR_FALSE(param_.Bias->numel(), right)
+  return true;
+}
+
+bool FusedElementwiseAddLayerNormOp::InferShapeImpl() const {
+  param_.Out->Resize(param_.X->dims());
+  param_.Out->set_lod(param_.X->lod());
+  return true;
+}
+
+bool FusedElementwiseAddLayerNormOp::AttachImpl(const cpp::OpDesc &op_desc,
+                                                lite::Scope *scope) {
+  param_.X = scope->FindTensor(op_desc.Input("X").front());
+  param_.Y = scope->FindTensor(op_desc.Input("Y").front());
+  param_.Scale = scope->FindTensor(op_desc.Input("Scale").front());
+  param_.Bias = scope->FindTensor(op_desc.Input("Bias").front());
+  param_.Out = scope->FindMutableTensor(op_desc.Output("Out").front());
+  CHECK(param_.X);
+  CHECK(param_.Y);
+  CHECK(param_.Scale);
+  CHECK(param_.Bias);
+  CHECK(param_.Out);
+  param_.begin_norm_axis = op_desc.GetAttr<int>("begin_norm_axis");
+  param_.epsilon = op_desc.GetAttr<float>("epsilon");
+  return true;
+}
+
+}  // namespace operators
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_LITE_OP(fused_elementwise_add_layer_norm,
+                 paddle::lite::operators::FusedElementwiseAddLayerNormOp);
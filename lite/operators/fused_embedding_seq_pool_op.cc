@@ -0,0 +1,88 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/operators/fused_embedding_seq_pool_op.h"
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace operators {
+
+bool FusedEmbeddingSeqPoolOp::CheckShape() const {
+  CHECK_OR_FALSE(param_.W)
+  CHECK_OR_FALSE(param_.Ids)
+  CHECK_OR_FALSE(param_.Out)
+  CHECK_EQ(param_.Ids->lod().size(), 1UL)
+      << "Input(Ids) of FusedEmbeddingSeqPoolOp should have one level LoD.";
+  CHECK_EQ(param_.combiner, "sum") << "Only the sum combiner is supported.";
+
+  const auto &table_dims = param_.W->dims();
+  const auto &ids_dims = param_.Ids->dims();
+  CHECK_EQ_OR_FALSE(table_dims.size(), 2)
+  if (param_.lookup_table_version == 1) {
+    CHECK_EQ_OR_FALSE(ids_dims[ids_dims.size() - 1], 1)
+  }
+  return true;
+}
+
+bool FusedEmbeddingSeqPoolOp::InferShapeImpl() const {
+  const auto &table_dims = param_.W->dims();
+  const auto &ids_dims = param_.Ids->dims();
+
+  // The same shape as the output of sequence_pool on the output of
+  // lookup_table(_v2).
+  std::vector<int64_t> out_dims = ids_dims.Vectorize();
+  if (param_.lookup_table_version == 1) {
+    out_dims.back() = table_dims[1];
+  } else {
+    out_dims.push_back(table_dims[1]);
+  }
+  out_dims[0] = param_.Ids->lod()[0].size() - 1;
+  param_.Out->Resize(lite::DDim{out_dims});
+  return true;
+}
+
+bool FusedEmbeddingSeqPoolOp::AttachImpl(const cpp::OpDesc &op_desc,
+                                         lite::Scope *scope) {
+  auto input = op_desc.Input("W").front();
+  param_.W = scope->FindTensor(input);
+  param_.Ids = scope->FindTensor(op_desc.Input("Ids").front());
+  param_.Out = scope->FindMutableTensor(op_desc.Output("Out").front());
+  CHECK(param_.W);
+  CHECK(param_.Ids);
+  CHECK(param_.Out);
+
+  if (op_desc.HasAttr("padding_idx")) {
+    param_.padding_idx = op_desc.GetAttr<int64_t>("padding_idx");
+  }
+  if (op_desc.HasAttr("combiner")) {
+    param_.combiner = op_desc.GetAttr<std::string>("combiner");
+  }
+  if (op_desc.HasAttr("lookup_table_version")) {
+    param_.lookup_table_version = op_desc.GetAttr<int>("lookup_table_version");
+  }
+  // The table is quantized to int8 by embedding_quant_pass.
+  auto scale_name = input + "_quant_scale";
+  if (op_desc.HasAttr(scale_name)) {
+    param_.weight_scale = op_desc.GetAttr<std::vector<float>>(scale_name);
+  }
+  return true;
+}
+
+}  // namespace operators
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_LITE_OP(fused_embedding_seq_pool,
+                 paddle::lite::operators::FusedEmbeddingSeqPoolOp);
@@ -0,0 +1,75 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/operators/fused_multihead_attention_op.h"
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace operators {
+
+bool FusedMultiheadAttentionOp::CheckShape() const {
+  CHECK_OR_FALSE(param_.Input)
+  CHECK_OR_FALSE(param_.QKVW)
+  CHECK_OR_FALSE(param_.QKVBias)
+  CHECK_OR_FALSE(param_.Out)
+
+  const auto &input_dims = param_.Input->dims();
+  const auto &w_dims = param_.QKVW->dims();
+  CHECK_EQ_OR_FALSE(input_dims.size(), 3)
+  CHECK_EQ_OR_FALSE(w_dims.size(), 2)
+  const int64_t hidden = input_dims[2];
+  CHECK_EQ_OR_FALSE(w_dims[0], hidden)
+  CHECK_EQ_OR_FALSE(w_dims[1], 3 * hidden)
+  CHECK_EQ_OR_FALSE(param_.QKVBias->numel(), 3 * hidden)
+  CHECK_GT_OR_FALSE(param_.head_number, 0)
+  CHECK_EQ_OR_FALSE(hidden % param_.head_number, 0)
+  if (param_.Mask) {
+    CHECK_OR_FALSE(param_.Mask->dims().size() <= 4)
+  }
+  return true;
+}
+
+bool FusedMultiheadAttentionOp::InferShapeImpl() const {
+  param_.Out->Resize(param_.Input->dims());
+  param_.Out->set_lod(param_.Input->lod());
+  return true;
+}
+
+bool FusedMultiheadAttentionOp::AttachImpl(const cpp::OpDesc &op_desc,
+                                           lite::Scope *scope) {
+  param_.Input = scope->FindTensor(op_desc.Input("Input").front());
+  param_.QKVW = scope->FindTensor(op_desc.Input("QKVW").front());
+  param_.QKVBias = scope->FindTensor(op_desc.Input("QKVBias").front());
+  param_.Out = scope->FindMutableTensor(op_desc.Output("Out").front());
+  CHECK(param_.Input);
+  CHECK(param_.QKVW);
+  CHECK(param_.QKVBias);
+  CHECK(param_.Out);
+  if (op_desc.HasInput("Mask") && !op_desc.Input("Mask").empty()) {
+    param_.Mask = scope->FindTensor(op_desc.Input("Mask").front());
+  }
+  param_.head_number = op_desc.GetAttr<int>("head_number");
+  if (op_desc.HasAttr("alpha")) {
+    param_.alpha = op_desc.GetAttr<float>("alpha");
+  }
+  return true;
+}
+
+}  // namespace operators
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_LITE_OP(fused_multihead_attention,
+                 paddle::lite::operators::FusedMultiheadAttentionOp);
@@ -69,6 +69,11 @@ bool LookupTableOpLite::AttachImpl(const cpp::OpDesc& op_desc,
   if (op_desc.HasAttr("entry")) {
     param_.entry = op_desc.GetAttr<std::string>("entry");
   }
+  // The table is quantized to int8 by embedding_quant_pass.
+  auto scale_name = input + "_quant_scale";
+  if (op_desc.HasAttr(scale_name)) {
+    param_.weight_scale = op_desc.GetAttr<std::vector<float>>(scale_name);
+  }
 
   return true;
 }
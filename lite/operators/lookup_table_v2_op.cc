@@ -57,6 +57,11 @@ bool LookupTableV2OpLite::AttachImpl(const cpp::OpDesc &op_desc,
   param_.Out = scope->FindMutableTensor(out);
 
   param_.padding_idx = op_desc.GetAttr<int64_t>("padding_idx");
+  // The table is quantized to int8 by embedding_quant_pass.
+  auto scale_name = input + "_quant_scale";
+  if (op_desc.HasAttr(scale_name)) {
+    param_.weight_scale = op_desc.GetAttr<std::vector<float>>(scale_name);
+  }
 
   return true;
 }
@@ -371,6 +371,8 @@ struct ConcatParam : ParamBase {
   lite::Tensor* output{};
   int axis{0};
   lite::Tensor* axis_tensor{};
+  // The inputs are kept as the slices of the output.
+  bool inplace{false};
   // get a vector of input tensors
   const std::vector<const Tensor*>* input_tensor_ptrs() override {
     if (!input_tensor_ptrs_cache_) {
@@ -597,6 +599,8 @@ struct SplitParam : ParamBase {
   int axis{-1};
   int num{0};
   std::vector<int> sections;
+  // The outputs are kept as the slices of the input.
+  bool inplace{false};
   ///////////////////////////////////////////////////////////////////////////////////
   // get a vector of input tensors
   const std::vector<const Tensor*>* input_tensor_ptrs() override {
@@ -1020,6 +1024,54 @@ struct LookupTableParam : ParamBase {
   bool is_test{true};
   std::string entry_config{""};  // used in distributed training
   std::string entry{"none"};
+  // The scales of the rows of W quantized to int8 by embedding_quant_pass.
+  std::vector<float> weight_scale{};
+};
+
+// The lookup_table(_v2) + sequence_pool(SUM) fused by
+// lite_embedding_seq_pool_fuse_pass.
+struct FusedEmbeddingSeqPoolParam : ParamBase {
+  const lite::Tensor* W{nullptr};
+  const lite::Tensor* Ids{nullptr};
+  lite::Tensor* Out{nullptr};
+  int64_t padding_idx{-1};
+  std::string combiner{"sum"};
+  std::vector<float> weight_scale{};
+  // The version of the fused lookup_table, the last dim of the ids of
+  // lookup_table is 1 and replaced by the width of the table, while it is
+  // kept by lookup_table_v2.
+  int lookup_table_version{1};
+};
+
+// The multi-head attention of the transformer encoder fused by
+// lite_multihead_attention_fuse_pass, from the q/k/v projections to the
+// context before the output projection.
+struct FusedMultiheadAttentionParam : ParamBase {
+  // [batch, seq_len, hidden]
+  const lite::Tensor* Input{nullptr};
+  // The weights and biases of q, k and v concatenated, [hidden, 3 * hidden]
+  // and [3 * hidden].
+  const lite::Tensor* QKVW{nullptr};
+  const lite::Tensor* QKVBias{nullptr};
+  // Added to the scores, broadcasted to [batch, head_number, seq_len,
+  // seq_len] from the trailing dims.
+  const lite::Tensor* Mask{nullptr};
+  // [batch, seq_len, hidden]
+  lite::Tensor* Out{nullptr};
+  int head_number{1};
+  // The scale of the scores, e.g. 1 / sqrt(hidden / head_number).
+  float alpha{1.f};
+};
+
+// The elementwise_add of the residual and the following layer_norm.
+struct FusedElementwiseAddLayerNormParam : ParamBase {
+  const lite::Tensor* X{nullptr};
+  const lite::Tensor* Y{nullptr};
+  const lite::Tensor* Scale{nullptr};
+  const lite::Tensor* Bias{nullptr};
+  lite::Tensor* Out{nullptr};
+  int begin_norm_axis{1};
+  float epsilon{1e-5f};
 };
 
 struct LookupTableDequantParam : ParamBase {
@@ -1396,6 +1448,7 @@ struct SqueezeParam : ParamBase {
   lite::Tensor* Out{};
   lite::Tensor* XShape{};
   std::vector<int> axes{};
+  bool inplace{false};
   ///////////////////////////////////////////////////////////////////////////////////
   // get a vector of input tensors
   const std::vector<const Tensor*>* input_tensor_ptrs() override {
@@ -1420,6 +1473,7 @@ struct UnsqueezeParam : ParamBase {
   std::vector<int> axes{};
   const lite::Tensor* axes_tensor{};
   std::vector<const lite::Tensor*> axes_tensor_vct{};
+  bool inplace{false};
   ///////////////////////////////////////////////////////////////////////////////////
   // get a vector of input tensors
   const std::vector<const Tensor*>* input_tensor_ptrs() override {
@@ -2034,6 +2088,7 @@ struct FlattenContiguousRangeParam : ParamBase {
   lite::Tensor* xshape;
   int start_axis;
   int stop_axis;
+  bool inplace{false};
 };
 
 }  // namespace operators
@@ -39,6 +39,12 @@ class PoolOpLite : public OpLite {
 
   bool InferShapeImpl() const override;
 
+  // The paddings of SAME and the ksize of global pooling depend on the input
+  // shape.
+  bool InferShapeUpdatesParam() const override {
+    return padding_algorithm_ == "SAME" || param_.global_pooling;
+  }
+
   // TODO(Superjomn) replace framework::OpDesc with a lite one.
   bool AttachImpl(const cpp::OpDesc &op_desc, lite::Scope *scope) override {
     AttachParam(&param_);
@@ -0,0 +1,151 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// The framework overhead of the models with many small ops: the shape
+// bookkeeping of DDim and Tensor, OpLite::InferShape and Instruction::Run.
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "lite/api/paddle_use_kernels.h"
+#include "lite/api/paddle_use_ops.h"
+#include "lite/core/op_registry.h"
+#include "lite/core/program.h"
+#include "lite/core/scope.h"
+#include "lite/core/tensor.h"
+
+namespace paddle {
+namespace lite {
+
+static const std::vector<int64_t> kShape({1, 8, 4, 4});
+
+static void BM_DDimCopy(benchmark::State& state) {  // NOLINT
+  DDim dims(kShape);
+  for (auto _ : state) {
+    DDim copied = dims;
+    benchmark::DoNotOptimize(copied);
+  }
+}
+BENCHMARK(BM_DDimCopy);
+
+static void BM_DDimSliceFlatten(benchmark::State& state) {  // NOLINT
+  DDim dims(kShape);
+  for (auto _ : state) {
+    auto slice = dims.Slice(1, 3);
+    auto mat = dims.Flatten2D(2);
+    benchmark::DoNotOptimize(slice);
+    benchmark::DoNotOptimize(mat);
+  }
+}
+BENCHMARK(BM_DDimSliceFlatten);
+
+static void BM_TensorResize(benchmark::State& state) {  // NOLINT
+  Tensor tensor;
+  DDim dims(kShape);
+  for (auto _ : state) {
+    tensor.Resize(dims);
+    tensor.Resize(kShape);
+    benchmark::DoNotOptimize(tensor.dims());
+  }
+}
+BENCHMARK(BM_TensorResize);
+
+// A chain of scale ops on a small tensor.
+class SmallOpsModel {
+ public:
+  explicit SmallOpsModel(int num_ops) {
+    std::vector<Place> places({Place{TARGET(kHost), PRECISION(kFloat)},
+#ifdef LITE_WITH_X86
+                               Place{TARGET(kX86), PRECISION(kFloat)},
+#endif
+#ifdef LITE_WITH_ARM
+                               Place{TARGET(kARM), PRECISION(kFloat)},
+#endif
+                               Place{TARGET(kHost), PRECISION(kAny)}});
+    auto* x = scope_.Var(VarName(0))->GetMutable<Tensor>();
+    x->Resize(kShape);
+    auto* x_data = x->mutable_data<float>();
+    for (int64_t i = 0; i < x->numel(); i++) {
+      x_data[i] = static_cast<float>(i);
+    }
+    for (int i = 0; i < num_ops; i++) {
+      scope_.Var(VarName(i + 1))->GetMutable<Tensor>();
+      cpp::OpDesc desc;
+      desc.SetType("scale");
+      desc.SetInput("X", {VarName(i)});
+      desc.SetOutput("Out", {VarName(i + 1)});
+      desc.SetAttr("scale", 1.f);
+      desc.SetAttr("bias", 0.f);
+      desc.SetAttr("bias_after_scale", true);
+      auto op = LiteOpRegistry::Global().Create("scale");
+      CHECK(op) << "no op for scale";
+      op->Attach(desc, &scope_);
+      auto kernels = op->CreateKernels(places);
+      CHECK(!kernels.empty()) << "no kernel for scale";
+      auto kernel = std::move(kernels.front());
+      kernel->SetContext(
+          ContextScheduler::Global().NewContext(kernel->target()));
+      ops_.push_back(op);
+      insts_.emplace_back(op, std::move(kernel));
+    }
+  }
+
+  void InferShape() {
+    for (auto& op : ops_) {
+      op->InferShape();
+    }
+  }
+
+  void Run() {
+    for (auto& inst : insts_) {
+      inst.Run();
+    }
+  }
+
+ private:
+  static std::string VarName(int i) { return "var_" + std::to_string(i); }
+
+  Scope scope_;
+  std::vector<std::shared_ptr<OpLite>> ops_;
+  std::vector<Instruction> insts_;
+};
+
+static void BM_InferShape(benchmark::State& state) {  // NOLINT
+  SmallOpsModel model(state.range(0));
+  model.Run();
+  for (auto _ : state) {
+    model.InferShape();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_InferShape)->Arg(16)->Arg(128)->Arg(512);
+
+static void BM_InstructionRun(benchmark::State& state) {  // NOLINT
+  SmallOpsModel model(state.range(0));
+  model.Run();
+  for (auto _ : state) {
+    model.Run();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_InstructionRun)->Arg(16)->Arg(128)->Arg(512);
+
+}  // namespace lite
+}  // namespace paddle
+
+BENCHMARK_MAIN();
@@ -0,0 +1,589 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// The kernel benchmarks of x86 and host. The cases are read from a shape list
+// in the format of ops.txt, one case per line:
+//   <op>  [<dims of the input>]  (<key>=<value>, ...)
+// Every case reports GFLOP/s, bytes/s and the ratio of its roofline time to
+// the measured time. The roofline time is bounded by the peak GFLOP/s and the
+// peak bandwidth of the machine, so the ratio tells how far a kernel is from
+// the hardware no matter whether it is bound by the compute or the memory.
+//
+// Besides the flags of Google Benchmark:
+//   --ops_path=<file>      the shape list, required.
+//   --peak_gflops=<value>  the peak GFLOP/s, measured by a large fc if unset.
+//   --peak_gbps=<value>    the peak GB/s, measured by a large copy if unset.
+//   --threads=<num>        the number of the threads of the x86 kernels.
+// Use --benchmark_out=<file> --benchmark_out_format=json for the results to
+// be compared between commits, e.g. by tools/compare.py of Google Benchmark.
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "lite/api/paddle_use_kernels.h"
+#include "lite/api/paddle_use_ops.h"
+#ifdef LITE_WITH_X86
+#include "lite/backends/x86/parallel.h"
+#endif
+#include "lite/core/op_registry.h"
+#include "lite/core/scope.h"
+#include "lite/core/tensor.h"
+
+namespace paddle {
+namespace lite {
+
+static double g_peak_gflops = 0;
+static double g_peak_gbps = 0;
+
+// A line of the shape list.
+struct OpCase {
+  std::string name;
+  std::string op;
+  std::vector<int64_t> dims;
+  std::map<std::string, std::string> params;
+
+  std::string Str(const std::string& key, const std::string& def) const {
+    auto it = params.find(key);
+    return it == params.end() ? def : it->second;
+  }
+  int Int(const std::string& key, int def) const {
+    auto it = params.find(key);
+    return it == params.end() ? def : std::atoi(it->second.c_str());
+  }
+  float Float(const std::string& key, float def) const {
+    auto it = params.find(key);
+    return it == params.end() ? def : std::strtof(it->second.c_str(), nullptr);
+  }
+  // The values of "[1 2]", "1x2" or "1", a single value is repeated `n`
+  // times.
+  std::vector<int> Ints(const std::string& key, int n, int def) const {
+    auto it = params.find(key);
+    if (it == params.end()) return std::vector<int>(n, def);
+    std::string value = it->second;
+    std::replace_if(value.begin(),
+                    value.end(),
+                    [](char c) { return c == '[' || c == ']' || c == 'x'; },
+                    ' ');
+    std::istringstream ss(value);
+    std::vector<int> ints;
+    int v;
+    while (ss >> v) {
+      ints.push_back(v);
+    }
+    if (ints.size() == 1) {
+      ints.resize(n, ints[0]);
+    }
+    return ints;
+  }
+};
+
+static std::string Trim(const std::string& str) {
+  auto begin = str.find_first_not_of(" \t\r\n");
+  if (begin == std::string::npos) return "";
+  auto end = str.find_last_not_of(" \t\r\n");
+  return str.substr(begin, end - begin + 1);
+}
+
+static bool ParseOpCase(const std::string& line, OpCase* op_case) {
+  auto dims_begin = line.find('[');
+  auto dims_end = line.find(']', dims_begin);
+  auto params_begin = line.find('(', dims_end);
+  auto params_end = line.rfind(')');
+  if (dims_begin == std::string::npos || dims_end == std::string::npos) {
+    return false;
+  }
+  op_case->op = Trim(line.substr(0, dims_begin));
+  std::istringstream dims(line.substr(dims_begin + 1, dims_end - dims_begin));
+  int64_t dim;
+  while (dims >> dim) {
+    op_case->dims.push_back(dim);
+  }
+  if (op_case->op.empty() || op_case->dims.empty()) return false;
+
+  std::string params;
+  if (params_begin != std::string::npos && params_end > params_begin) {
+    params = line.substr(params_begin + 1, params_end - params_begin - 1);
+  }
+  // The params are split by the commas out of the brackets.
+  int depth = 0;
+  std::string param;
+  for (size_t i = 0; i <= params.size(); i++) {
+    char c = i < params.size() ? params[i] : ',';
+    if (c == '[') depth++;
+    if (c == ']') depth--;
+    if (c != ',' || depth > 0) {
+      param += c;
+      continue;
+    }
+    auto eq = param.find('=');
+    if (eq != std::string::npos) {
+      op_case->params[Trim(param.substr(0, eq))] = Trim(param.substr(eq + 1));
+    }
+    param.clear();
+  }
+
+  // The name is the line with the tabs replaced, it is the key to compare
+  // the results of the commits.
+  op_case->name = Trim(line);
+  std::replace(op_case->name.begin(), op_case->name.end(), '\t', ' ');
+  return true;
+}
+
+static std::vector<OpCase> LoadOpCases(const std::string& path) {
+  std::ifstream file(path);
+  CHECK(file) << "Failed to open the shape list " << path;
+  std::vector<OpCase> op_cases;
+  std::string line;
+  while (std::getline(file, line)) {
+    if (Trim(line).empty() || Trim(line)[0] == '#') continue;
+    OpCase op_case;
+    if (ParseOpCase(line, &op_case)) {
+      op_cases.push_back(op_case);
+    } else {
+      LOG(WARNING) << "Invalid line of the shape list " << path << ": "
+                   << line;
+    }
+  }
+  return op_cases;
+}
+
+// Build the op of a case, the inputs are filled with the random values of a
+// fixed seed.
+class OpBuilder {
+ public:
+  explicit OpBuilder(Scope* scope) : scope_(scope), engine_(1024) {}
+
+  // Returns false if the op of the case is not supported. `flops` is 0 for
+  // the ops which are not bound by the compute, e.g. NMS.
+  bool Build(const OpCase& c, cpp::OpDesc* desc, double* flops) {
+    const auto& dims = c.dims;
+    const int64_t numel = DDim(dims).production();
+    *flops = 0;
+    if (c.op == "conv" || c.op == "conv2d") {
+      if (dims.size() != 4) return false;
+      const int64_t n = dims[0], ic = dims[1], ih = dims[2], iw = dims[3];
+      const int oc = c.Int("ch_out", static_cast<int>(ic));
+      const int groups = c.Int("group", 1);
+      auto kernel = c.Ints("kernel", 2, 3);
+      auto strides = c.Ints("stride", 2, 1);
+      auto dilations = c.Ints("dilation", 2, 1);
+      auto pads = c.Ints("pad", 4, 0);
+      if (pads.size() == 2) {
+        pads = {pads[0], pads[0], pads[1], pads[1]};
+      }
+      if (kernel.size() != 2 || strides.size() != 2 || dilations.size() != 2 ||
+          pads.size() != 4) {
+        return false;
+      }
+      const int64_t oh =
+          (ih + pads[0] + pads[1] - (dilations[0] * (kernel[0] - 1) + 1)) /
+              strides[0] +
+          1;
+      const int64_t ow =
+          (iw + pads[2] + pads[3] - (dilations[1] * (kernel[1] - 1) + 1)) /
+              strides[1] +
+          1;
+      bool depthwise = groups == ic && groups == oc;
+      desc->SetType(depthwise ? "depthwise_conv2d" : "conv2d");
+      desc->SetInput("Input", {Input("input", dims)});
+      desc->SetInput(
+          "Filter",
+          {Input("filter", {oc, ic / groups, kernel[0], kernel[1]})});
+      if (c.Int("flag_bias", 0)) {
+        desc->SetInput("Bias", {Input("bias", {oc})});
+      }
+      desc->SetOutput("Output", {Output("output")});
+      desc->SetAttr("strides", strides);
+      desc->SetAttr("paddings", pads);
+      desc->SetAttr("dilations", dilations);
+      desc->SetAttr("groups", groups);
+      // The flag_act of ops.txt: 1 relu, 2 relu6, 4 leaky_relu.
+      const int act = c.Int("flag_act", 0);
+      if (act == 1 || act == 2 || act == 4) {
+        desc->SetAttr("with_act", true);
+        desc->SetAttr<std::string>(
+            "act_type", act == 1 ? "relu" : act == 2 ? "relu6" : "leaky_relu");
+        desc->SetAttr("fuse_brelu_threshold", 6.f);
+        desc->SetAttr("leaky_relu_alpha", 0.1f);
+      }
+      *flops = 2.0 * n * oc * oh * ow * (ic / groups) * kernel[0] * kernel[1];
+    } else if (c.op == "fc") {
+      if (dims.size() < 2) return false;
+      const int64_t k = dims.back();
+      const int64_t m = numel / k;
+      auto param_dim = c.Ints("param_dim", 2, static_cast<int>(k));
+      if (param_dim.size() != 2 || param_dim[0] != k) return false;
+      const int64_t n = param_dim[1];
+      desc->SetType("fc");
+      desc->SetInput("Input", {Input("input", dims)});
+      desc->SetInput("W", {Input("w", {k, n})});
+      if (c.Int("flag_bias", 1)) {
+        desc->SetInput("Bias", {Input("bias", {n})});
+      }
+      desc->SetOutput("Out", {Output("out")});
+      desc->SetAttr("in_num_col_dims", static_cast<int>(dims.size()) - 1);
+      desc->SetAttr<std::string>("activation_type", c.Str("act_type", ""));
+      *flops = 2.0 * m * n * k;
+    } else if (c.op == "matmul") {
+      if (dims.size() < 2) return false;
+      const bool transpose_x = c.Int("transpose_X", 0);
+      const bool transpose_y = c.Int("transpose_Y", 0);
+      const int64_t m = dims[dims.size() - (transpose_x ? 1 : 2)];
+      const int64_t k = dims[dims.size() - (transpose_x ? 2 : 1)];
+      auto y_ints = c.Ints("y_dims", 2, static_cast<int>(k));
+      std::vector<int64_t> y_dims(y_ints.begin(), y_ints.end());
+      if (y_dims.size() < 2) return false;
+      const int64_t n = y_dims[y_dims.size() - (transpose_y ? 2 : 1)];
+      desc->SetType("matmul");
+      desc->SetInput("X", {Input("x", dims)});
+      desc->SetInput("Y", {Input("y", y_dims)});
+      desc->SetOutput("Out", {Output("out")});
+      desc->SetAttr("transpose_X", transpose_x);
+      desc->SetAttr("transpose_Y", transpose_y);
+      desc->SetAttr("alpha", c.Float("alpha", 1.f));
+      *flops = 2.0 * (numel / (m * k)) * m * n * k;
+    } else if (c.op == "softmax") {
+      desc->SetType("softmax");
+      desc->SetInput("X", {Input("x", dims)});
+      desc->SetOutput("Out", {Output("out")});
+      desc->SetAttr("axis", c.Int("axis", -1));
+      // max, subtract, exp, sum and divide.
+      *flops = 5.0 * numel;
+    } else if (c.op == "layer_norm") {
+      const int axis =
+          c.Int("begin_norm_axis", static_cast<int>(dims.size()) - 1);
+      if (axis <= 0 || axis >= static_cast<int>(dims.size())) return false;
+      const int64_t right = DDim(dims).Slice(axis, static_cast<int>(dims.size())).production();
+      desc->SetType("layer_norm");
+      desc->SetInput("X", {Input("x", dims)});
+      desc->SetInput("Scale", {Input("scale", {right})});
+      desc->SetInput("Bias", {Input("bias", {right})});
+      desc->SetOutput("Y", {Output("y")});
+      desc->SetOutput("Mean", {Output("mean")});
+      desc->SetOutput("Variance", {Output("variance")});
+      desc->SetAttr("begin_norm_axis", axis);
+      desc->SetAttr("epsilon", c.Float("epsilon", 1e-5f));
+      // The mean and the variance, then normalize, scale and shift.
+      *flops = 8.0 * numel;
+    } else if (c.op == "pooling" || c.op == "pool2d") {
+      if (dims.size() != 4) return false;
+      const bool global = c.Int("flag_global", 0);
+      const bool ceil_mode = c.Int("ceil_mode", 0);
+      auto kernel = c.Ints("kernel", 2, 2);
+      auto strides = c.Ints("stride", 2, 2);
+      auto pads = c.Ints("pad", 4, 0);
+      if (pads.size() == 2) {
+        pads = {pads[0], pads[0], pads[1], pads[1]};
+      }
+      if (kernel.size() != 2 || strides.size() != 2 || pads.size() != 4) {
+        return false;
+      }
+      int64_t out_size = 1;
+      for (int i = 0; i < 2 && !global; i++) {
+        int64_t in = dims[2 + i] + pads[2 * i] + pads[2 * i + 1] - kernel[i];
+        out_size *=
+            (ceil_mode ? in + strides[i] - 1 : in) / strides[i] + 1;
+      }
+      const int64_t window =
+          global ? dims[2] * dims[3] : kernel[0] * kernel[1];
+      desc->SetType("pool2d");
+      desc->SetInput("X", {Input("x", dims)});
+      desc->SetOutput("Out", {Output("out")});
+      desc->SetAttr<std::string>("pooling_type", c.Str("pooling_type", "max"));
+      desc->SetAttr("ksize", kernel);
+      desc->SetAttr("global_pooling", global);
+      desc->SetAttr("strides", strides);
+      desc->SetAttr("paddings", pads);
+      desc->SetAttr("exclusive", static_cast<bool>(c.Int("exclusive", 1)));
+      desc->SetAttr("ceil_mode", ceil_mode);
+      *flops = 1.0 * dims[0] * dims[1] * out_size * window;
+    } else if (c.op == "activation") {
+      const std::string act_type = c.Str("act_type", "relu");
+      desc->SetType(act_type);
+      desc->SetInput("X", {Input("x", dims)});
+      desc->SetOutput("Out", {Output("out")});
+      desc->SetAttr("alpha", c.Float("alpha", 0.1f));
+      desc->SetAttr("threshold", c.Float("threshold", 6.f));
+      desc->SetAttr("Relu_clipped_coef", c.Float("threshold", 6.f));
+      *flops = 1.0 * numel;
+    } else if (c.op == "sequence_pool" || c.op == "sequence_reverse") {
+      // The rows of [T, D] are split into `seq_num` sequences evenly.
+      if (dims.size() != 2) return false;
+      const int64_t seq_num = c.Int("seq_num", 1);
+      if (seq_num <= 0 || seq_num > dims[0]) return false;
+      std::vector<uint64_t> offsets;
+      for (int64_t i = 0; i <= seq_num; i++) {
+        offsets.push_back(static_cast<uint64_t>(dims[0] * i / seq_num));
+      }
+      desc->SetType(c.op);
+      desc->SetInput("X", {Input("x", dims)});
+      scope_->FindVar("x")->GetMutable<Tensor>()->set_lod({offsets});
+      if (c.op == "sequence_pool") {
+        desc->SetOutput("Out", {Output("out")});
+        desc->SetOutput("MaxIndex", {Output("max_index")});
+        desc->SetAttr<std::string>("pooltype", c.Str("pooltype", "SUM"));
+        *flops = 1.0 * numel;
+      } else {
+        desc->SetOutput("Y", {Output("y")});
+      }
+    } else if (c.op == "multiclass_nms") {
+      // The boxes of [N, M, 4] and the scores of [N, class_num, M].
+      if (dims.size() != 3 || dims[2] != 4) return false;
+      const int64_t class_num = c.Int("class_num", 80);
+      desc->SetType("multiclass_nms");
+      desc->SetInput("BBoxes", {Boxes("bboxes", dims)});
+      desc->SetInput("Scores",
+                     {Input("scores", {dims[0], class_num, dims[1]}, 0.f)});
+      desc->SetOutput("Out", {Output("out")});
+      desc->SetAttr("background_label", c.Int("background_label", -1));
+      desc->SetAttr("score_threshold", c.Float("score_threshold", 0.05f));
+      desc->SetAttr("nms_threshold", c.Float("nms_threshold", 0.5f));
+      desc->SetAttr("nms_top_k", c.Int("nms_top_k", 1000));
+      desc->SetAttr("keep_top_k", c.Int("keep_top_k", 100));
+      desc->SetAttr("nms_eta", c.Float("nms_eta", 1.f));
+      desc->SetAttr("normalized", static_cast<bool>(c.Int("normalized", 1)));
+    } else {
+      return false;
+    }
+    return true;
+  }
+
+ private:
+  std::string Input(const std::string& name,
+                    const std::vector<int64_t>& dims,
+                    float min = -1.f) {
+    auto* tensor = scope_->NewTensor(name);
+    tensor->Resize(dims);
+    std::uniform_real_distribution<float> dist(min, 1.f);
+    auto* data = tensor->mutable_data<float>();
+    for (int64_t i = 0; i < tensor->numel(); i++) {
+      data[i] = dist(engine_);
+    }
+    return name;
+  }
+
+  // The boxes of [x1, y1, x2, y2] in [0, 1].
+  std::string Boxes(const std::string& name,
+                    const std::vector<int64_t>& dims) {
+    auto* tensor = scope_->NewTensor(name);
+    tensor->Resize(dims);
+    std::uniform_real_distribution<float> corner(0.f, 0.9f);
+    std::uniform_real_distribution<float> size(0.02f, 0.1f);
+    auto* data = tensor->mutable_data<float>();
+    for (int64_t i = 0; i < tensor->numel(); i += 4) {
+      data[i] = corner(engine_);
+      data[i + 1] = corner(engine_);
+      data[i + 2] = data[i] + size(engine_);
+      data[i + 3] = data[i + 1] + size(engine_);
+    }
+    return name;
+  }
+
+  std::string Output(const std::string& name) {
+    scope_->NewTensor(name);
+    return name;
+  }
+
+  Scope* scope_;
+  std::mt19937 engine_;
+};
+
+// The kernel of a case, the x86 kernels are preferred to the host ones.
+class KernelBench {
+ public:
+  explicit KernelBench(const OpCase& op_case) {
+    cpp::OpDesc desc;
+    OpBuilder builder(&scope_);
+    if (!builder.Build(op_case, &desc, &flops_)) {
+      error_ = "unsupported op or params";
+      return;
+    }
+    op_ = LiteOpRegistry::Global().Create(desc.Type());
+    if (!op_) {
+      error_ = "no op " + desc.Type();
+      return;
+    }
+    op_->Attach(desc, &scope_);
+    std::vector<Place> places({
+#ifdef LITE_WITH_X86
+        Place{TARGET(kX86), PRECISION(kFloat)},
+#endif
+        Place{TARGET(kHost), PRECISION(kFloat)},
+        Place{TARGET(kHost), PRECISION(kAny)}});
+    auto kernels = op_->CreateKernels(places);
+    if (kernels.empty()) {
+      error_ = "no kernel of " + desc.Type();
+      return;
+    }
+    kernel_ = std::move(kernels.front());
+    kernel_->SetContext(
+        ContextScheduler::Global().NewContext(kernel_->target()));
+    if (!op_->CheckShape() || !op_->InferShape()) {
+      error_ = "invalid shapes";
+      return;
+    }
+    // The first run prepares the kernel and allocates the outputs.
+    kernel_->Launch();
+    for (auto* var_names : {&desc.inputs(), &desc.outputs()}) {
+      for (auto& arg : *var_names) {
+        for (auto& name : arg.second) {
+          bytes_ += scope_.FindVar(name)->Get<Tensor>().memory_size();
+        }
+      }
+    }
+  }
+
+  const std::string& error() const { return error_; }
+  std::string summary() const { return kernel_->summary(); }
+  double flops() const { return flops_; }
+  // The bytes of the inputs and the outputs, the least memory traffic.
+  double bytes() const { return bytes_; }
+
+  void Run() { kernel_->Launch(); }
+
+ private:
+  Scope scope_;
+  std::shared_ptr<OpLite> op_;
+  std::unique_ptr<KernelBase> kernel_;
+  std::string error_;
+  double flops_{0};
+  double bytes_{0};
+};
+
+static void BM_Kernel(benchmark::State& state,  // NOLINT
+                      const OpCase& op_case) {
+  KernelBench bench(op_case);
+  if (!bench.error().empty()) {
+    state.SkipWithError(bench.error().c_str());
+    return;
+  }
+  for (auto _ : state) {
+    bench.Run();
+  }
+  const double iterations = static_cast<double>(state.iterations());
+  const double roofline_seconds =
+      (std::max)(bench.flops() / (g_peak_gflops * 1e9),
+                 bench.bytes() / (g_peak_gbps * 1e9));
+  state.SetLabel(bench.summary());
+  state.SetBytesProcessed(static_cast<int64_t>(bench.bytes() * iterations));
+  state.counters["GFLOPS"] = benchmark::Counter(
+      bench.flops() * iterations * 1e-9, benchmark::Counter::kIsRate);
+  state.counters["intensity"] = bench.flops() / bench.bytes();
+  // The roofline time over the measured time, 1 is the best.
+  state.counters["roofline"] = benchmark::Counter(
+      roofline_seconds * iterations, benchmark::Counter::kIsRate);
+  state.counters["peak_GFLOPS"] = g_peak_gflops;
+  state.counters["peak_GBps"] = g_peak_gbps;
+}
+
+template <typename Func>
+static double BestSeconds(int repeats, Func func) {
+  double best = (std::numeric_limits<double>::max)();
+  for (int i = 0; i < repeats; i++) {
+    auto start = std::chrono::steady_clock::now();
+    func();
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    best = (std::min)(best, elapsed.count());
+  }
+  return best;
+}
+
+// The GFLOP/s of a large fc, which is bound by the compute.
+static double MeasurePeakGflops() {
+  OpCase op_case;
+  CHECK(ParseOpCase("fc [1024 1024] (param_dim=1024x1024, flag_bias=0)",
+                    &op_case));
+  KernelBench bench(op_case);
+  CHECK(bench.error().empty()) << bench.error();
+  return bench.flops() / BestSeconds(10, [&]() { bench.Run(); }) * 1e-9;
+}
+
+// The GB/s of copying a buffer much larger than the caches, the bytes of both
+// the read and the write are counted.
+static double MeasurePeakGbps() {
+  const size_t size = 16 * 1024 * 1024;
+  std::vector<float> src(size, 1.f);
+  std::vector<float> dst(size, 0.f);
+  double seconds = BestSeconds(
+      5, [&]() { std::copy(src.begin(), src.end(), dst.begin()); });
+  benchmark::DoNotOptimize(dst.data());
+  return 2.0 * size * sizeof(float) / seconds * 1e-9;
+}
+
+static bool ParseFlag(const std::string& arg,
+                      const std::string& flag,
+                      std::string* value) {
+  if (arg.compare(0, flag.size(), flag) != 0) return false;
+  *value = arg.substr(flag.size());
+  return true;
+}
+
+}  // namespace lite
+}  // namespace paddle
+
+int main(int argc, char** argv) {
+  using namespace paddle::lite;  // NOLINT
+  std::string ops_path;
+  std::string peak_gflops;
+  std::string peak_gbps;
+  std::string threads;
+  // Take the flags of this program out before Google Benchmark parses the
+  // rest.
+  int num_args = 1;
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (!ParseFlag(arg, "--ops_path=", &ops_path) &&
+        !ParseFlag(arg, "--peak_gflops=", &peak_gflops) &&
+        !ParseFlag(arg, "--peak_gbps=", &peak_gbps) &&
+        !ParseFlag(arg, "--threads=", &threads)) {
+      argv[num_args++] = argv[i];
+    }
+  }
+  argc = num_args;
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+  CHECK(!ops_path.empty()) << "--ops_path=<shape list> is required";
+
+#ifdef LITE_WITH_X86
+  if (!threads.empty()) {
+    paddle::lite::x86::SetNumThreads(std::atoi(threads.c_str()));
+  }
+#endif
+  g_peak_gflops = peak_gflops.empty() ? MeasurePeakGflops()
+                                      : std::atof(peak_gflops.c_str());
+  g_peak_gbps =
+      peak_gbps.empty() ? MeasurePeakGbps() : std::atof(peak_gbps.c_str());
+  LOG(INFO) << "The roofline of " << g_peak_gflops << " GFLOP/s and "
+            << g_peak_gbps << " GB/s";
+
+  for (auto& op_case : LoadOpCases(ops_path)) {
+    benchmark::RegisterBenchmark(op_case.name.c_str(), BM_Kernel, op_case)
+        ->UseRealTime();
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
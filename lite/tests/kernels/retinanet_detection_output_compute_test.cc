@@ -0,0 +1,442 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include "lite/api/paddle_use_kernels.h"
+#include "lite/api/paddle_use_ops.h"
+#include "lite/core/arena/framework.h"
+#include "lite/tests/utils/fill_data.h"
+
+namespace paddle {
+namespace lite {
+
+template <class T>
+bool SortScorePairDescend(const std::pair<float, T>& pair1,
+                          const std::pair<float, T>& pair2) {
+  return pair1.first > pair2.first;
+}
+
+template <class T>
+bool SortScoreTwoPairDescend(const std::pair<float, std::pair<T, T>>& pair1,
+                             const std::pair<float, std::pair<T, T>>& pair2) {
+  return pair1.first > pair2.first;
+}
+
+template <class T>
+static void GetMaxScoreIndex(const std::vector<T>& scores,
+                             const T threshold,
+                             int top_k,
+                             std::vector<std::pair<T, int>>* sorted_indices) {
+  for (size_t i = 0; i < scores.size(); ++i) {
+    if (scores[i] > threshold) {
+      sorted_indices->push_back(std::make_pair(scores[i], i));
+    }
+  }
+  // Sort the score pair according to the scores in descending order
+  std::stable_sort(sorted_indices->begin(),
+                   sorted_indices->end(),
+                   SortScorePairDescend<int>);
+  // Keep top_k scores if needed.
+  if (top_k > -1 && top_k < static_cast<int>(sorted_indices->size())) {
+    sorted_indices->resize(top_k);
+  }
+}
+
+template <class T>
+static T BBoxArea(const std::vector<T>& box, const bool normalized) {
+  if (box[2] < box[0] || box[3] < box[1]) {
+    // If coordinate values are is invalid
+    // (e.g. xmax < xmin or ymax < ymin), return 0.
+    return static_cast<T>(0.);
+  } else {
+    const T w = box[2] - box[0];
+    const T h = box[3] - box[1];
+    if (normalized) {
+      return w * h;
+    } else {
+      // If coordinate values are not within range [0, 1].
+      return (w + 1) * (h + 1);
+    }
+  }
+}
+
+template <class T>
+static T JaccardOverlap(const std::vector<T>& box1,
+                        const std::vector<T>& box2,
+                        const bool normalized) {
+  if (box2[0] > box1[2] || box2[2] < box1[0] || box2[1] > box1[3] ||
+      box2[3] < box1[1]) {
+    return static_cast<T>(0.);
+  } else {
+    const T inter_xmin = std::max(box1[0], box2[0]);
+    const T inter_ymin = std::max(box1[1], box2[1]);
+    const T inter_xmax = std::min(box1[2], box2[2]);
+    const T inter_ymax = std::min(box1[3], box2[3]);
+    T norm = normalized ? static_cast<T>(0.) : static_cast<T>(1.);
+    T inter_w = inter_xmax - inter_xmin + norm;
+    T inter_h = inter_ymax - inter_ymin + norm;
+    const T inter_area = inter_w * inter_h;
+    const T bbox1_area = BBoxArea<T>(box1, normalized);
+    const T bbox2_area = BBoxArea<T>(box2, normalized);
+    return inter_area / (bbox1_area + bbox2_area - inter_area);
+  }
+}
+
+template <class T>
+static void NMSFast(const std::vector<std::vector<T>>& cls_dets,
+                    const T nms_threshold,
+                    const T eta,
+                    std::vector<int>* selected_indices) {
+  int64_t num_boxes = cls_dets.size();
+  std::vector<std::pair<T, int>> sorted_indices;
+  for (int64_t i = 0; i < num_boxes; ++i) {
+    sorted_indices.push_back(std::make_pair(cls_dets[i][4], i));
+  }
+  // Sort the score pair according to the scores in descending order
+  std::stable_sort(
+      sorted_indices.begin(), sorted_indices.end(), SortScorePairDescend<int>);
+  selected_indices->clear();
+  T adaptive_threshold = nms_threshold;
+
+  while (sorted_indices.size() != 0) {
+    const int idx = sorted_indices.front().second;
+    bool keep = true;
+    for (size_t k = 0; k < selected_indices->size(); ++k) {
+      if (keep) {
+        const int kept_idx = (*selected_indices)[k];
+        T overlap = JaccardOverlap<T>(cls_dets[idx], cls_dets[kept_idx], false);
+        keep = overlap <= adaptive_threshold;
+      } else {
+        break;
+      }
+    }
+    if (keep) {
+      selected_indices->push_back(idx);
+    }
+    sorted_indices.erase(sorted_indices.begin());
+    if (keep && eta < 1 && adaptive_threshold > 0.5) {
+      adaptive_threshold *= eta;
+    }
+  }
+}
+
+template <class T>
+static void DeltaScoreToPrediction(
+    const T* bboxes_data,
+    const T* anchors_data,
+    T im_height,
+    T im_width,
+    T im_scale,
+    int class_num,
+    const std::vector<std::pair<T, int>>& sorted_indices,
+    std::map<int, std::vector<std::vector<T>>>* preds) {
+  im_height = static_cast<T>(std::round(im_height / im_scale));
+  im_width = static_cast<T>(std::round(im_width / im_scale));
+  T zero(0);
+  for (const auto& it : sorted_indices) {
+    T score = it.first;
+    int idx = it.second;
+    int a = idx / class_num;
+    int c = idx % class_num;
+
+    int box_offset = a * 4;
+    T anchor_box_width =
+        anchors_data[box_offset + 2] - anchors_data[box_offset] + 1;
+    T anchor_box_height =
+        anchors_data[box_offset + 3] - anchors_data[box_offset + 1] + 1;
+    T anchor_box_center_x = anchors_data[box_offset] + anchor_box_width / 2;
+    T anchor_box_center_y =
+        anchors_data[box_offset + 1] + anchor_box_height / 2;
+    T target_box_center_x =
+        bboxes_data[box_offset] * anchor_box_width + anchor_box_center_x;
+    T target_box_center_y =
+        bboxes_data[box_offset + 1] * anchor_box_height + anchor_box_center_y;
+    T target_box_width =
+        std::exp(bboxes_data[box_offset + 2]) * anchor_box_width;
+    T target_box_height =
+        std::exp(bboxes_data[box_offset + 3]) * anchor_box_height;
+    T pred_box_xmin = target_box_center_x - target_box_width / 2;
+    T pred_box_ymin = target_box_center_y - target_box_height / 2;
+    T pred_box_xmax = target_box_center_x + target_box_width / 2 - 1;
+    T pred_box_ymax = target_box_center_y + target_box_height / 2 - 1;
+    pred_box_xmin = pred_box_xmin / im_scale;
+    pred_box_ymin = pred_box_ymin / im_scale;
+    pred_box_xmax = pred_box_xmax / im_scale;
+    pred_box_ymax = pred_box_ymax / im_scale;
+
+    pred_box_xmin = std::max(std::min(pred_box_xmin, im_width - 1), zero);
+    pred_box_ymin = std::max(std::min(pred_box_ymin, im_height - 1), zero);
+    pred_box_xmax = std::max(std::min(pred_box_xmax, im_width - 1), zero);
+    pred_box_ymax = std::max(std::min(pred_box_ymax, im_height - 1), zero);
+
+    std::vector<T> one_pred{
+        pred_box_xmin, pred_box_ymin, pred_box_xmax, pred_box_ymax, score};
+    (*preds)[c].push_back(one_pred);
+  }
+}
+
+template <class T>
+static void MultiClassNMS(
+    const std::map<int, std::vector<std::vector<T>>>& preds,
+    int class_num,
+    const int keep_top_k,
+    const T nms_threshold,
+    const T nms_eta,
+    std::vector<std::vector<T>>* nmsed_out,
+    int* num_nmsed_out) {
+  std::map<int, std::vector<int>> indices;
+  int num_det = 0;
+  for (int c = 0; c < class_num; ++c) {
+    if (static_cast<bool>(preds.count(c))) {
+      const std::vector<std::vector<T>> cls_dets = preds.at(c);
+      NMSFast(cls_dets, nms_threshold, nms_eta, &(indices[c]));
+      num_det += indices[c].size();
+    }
+  }
+
+  std::vector<std::pair<float, std::pair<int, int>>> score_index_pairs;
+  for (const auto& it : indices) {
+    int label = it.first;
+    const std::vector<int>& label_indices = it.second;
+    for (size_t j = 0; j < label_indices.size(); ++j) {
+      int idx = label_indices[j];
+      score_index_pairs.push_back(
+          std::make_pair(preds.at(label)[idx][4], std::make_pair(label, idx)));
+    }
+  }
+  // Keep top k results per image.
+  std::stable_sort(score_index_pairs.begin(),
+                   score_index_pairs.end(),
+                   SortScoreTwoPairDescend<int>);
+  if (num_det > keep_top_k) {
+    score_index_pairs.resize(keep_top_k);
+  }
+
+  for (const auto& it : score_index_pairs) {
+    int label = it.second.first;
+    int idx = it.second.second;
+    const std::vector<T>& pred = preds.at(label)[idx];
+    std::vector<T> one_pred{static_cast<T>(label),
+                            pred[4],
+                            pred[0],
+                            pred[1],
+                            pred[2],
+                            pred[3]};
+    nmsed_out->push_back(one_pred);
+  }
+
+  *num_nmsed_out = (num_det > keep_top_k ? keep_top_k : num_det);
+}
+
+class RetinanetDetectionOutputComputeTester : public arena::TestCase {
+ protected:
+  // common attributes for this op.
+  std::string type_ = "retinanet_detection_output";
+  std::vector<std::string> bboxes_;
+  std::vector<std::string> scores_;
+  std::vector<std::string> anchors_;
+  std::string im_info_ = "im_info";
+  std::string out_ = "out";
+  int batch_size_{2};
+  std::vector<int> num_anchors_;
+  int class_num_{3};
+  float score_threshold_{0.05f};
+  int nms_top_k_{1000};
+  float nms_threshold_{0.3f};
+  float nms_eta_{1.f};
+  int keep_top_k_{100};
+
+ public:
+  RetinanetDetectionOutputComputeTester(const Place& place,
+                                        const std::string& alias,
+                                        int batch_size,
+                                        const std::vector<int>& num_anchors,
+                                        int class_num,
+                                        int nms_top_k,
+                                        float nms_eta,
+                                        int keep_top_k)
+      : TestCase(place, alias),
+        batch_size_(batch_size),
+        num_anchors_(num_anchors),
+        class_num_(class_num),
+        nms_top_k_(nms_top_k),
+        nms_eta_(nms_eta),
+        keep_top_k_(keep_top_k) {
+    for (size_t l = 0; l < num_anchors_.size(); ++l) {
+      bboxes_.push_back("bboxes_" + std::to_string(l));
+      scores_.push_back("scores_" + std::to_string(l));
+      anchors_.push_back("anchors_" + std::to_string(l));
+    }
+  }
+
+  // The implementation of the kernel before it used the shared NMS engine of
+  // lite/backends/host/math/nms.h.
+  void RunBaseline(Scope* scope) override {
+    auto* im_info = scope->FindTensor(im_info_);
+    auto* outs = scope->NewTensor(out_);
+    CHECK(outs);
+    outs->set_precision(PRECISION(kFloat));
+
+    std::vector<std::vector<std::vector<float>>> all_nmsed_out;
+    std::vector<uint64_t> batch_starts = {0};
+    for (int i = 0; i < batch_size_; ++i) {
+      std::map<int, std::vector<std::vector<float>>> preds;
+      for (size_t l = 0; l < num_anchors_.size(); ++l) {
+        int num_anchors = num_anchors_[l];
+        const float* scores_data =
+            scope->FindTensor(scores_[l])->data<float>() +
+            i * num_anchors * class_num_;
+        const float* bboxes_data =
+            scope->FindTensor(bboxes_[l])->data<float>() + i * num_anchors * 4;
+        const float* anchors_data =
+            scope->FindTensor(anchors_[l])->data<float>();
+        std::vector<float> scores(scores_data,
+                                  scores_data + num_anchors * class_num_);
+        std::vector<std::pair<float, int>> sorted_indices;
+        // For the highest level, we take the threshold 0.0
+        float threshold =
+            l < num_anchors_.size() - 1 ? score_threshold_ : 0.f;
+        GetMaxScoreIndex(scores, threshold, nms_top_k_, &sorted_indices);
+        const float* im_info_data = im_info->data<float>() + i * 3;
+        DeltaScoreToPrediction(bboxes_data,
+                               anchors_data,
+                               im_info_data[0],
+                               im_info_data[1],
+                               im_info_data[2],
+                               class_num_,
+                               sorted_indices,
+                               &preds);
+      }
+      std::vector<std::vector<float>> nmsed_out;
+      int num_nmsed_out = 0;
+      MultiClassNMS(preds,
+                    class_num_,
+                    keep_top_k_,
+                    nms_threshold_,
+                    nms_eta_,
+                    &nmsed_out,
+                    &num_nmsed_out);
+      all_nmsed_out.push_back(nmsed_out);
+      batch_starts.push_back(batch_starts.back() + num_nmsed_out);
+    }
+
+    int64_t num_kept = static_cast<int64_t>(batch_starts.back());
+    outs->Resize({num_kept, 6});
+    float* odata = outs->mutable_data<float>();
+    for (auto& nmsed_out : all_nmsed_out) {
+      for (auto& one_pred : nmsed_out) {
+        odata[0] = one_pred[0] + 1;  // label
+        std::copy(one_pred.begin() + 1, one_pred.end(), odata + 1);
+        odata += 6;
+      }
+    }
+
+    LoD lod;
+    lod.emplace_back(batch_starts);
+    outs->set_lod(lod);
+  }
+
+  void PrepareOpDesc(cpp::OpDesc* op_desc) {
+    op_desc->SetType(type_);
+    op_desc->SetInput("BBoxes", bboxes_);
+    op_desc->SetInput("Scores", scores_);
+    op_desc->SetInput("Anchors", anchors_);
+    op_desc->SetInput("ImInfo", {im_info_});
+    op_desc->SetOutput("Out", {out_});
+    op_desc->SetAttr("score_threshold", score_threshold_);
+    op_desc->SetAttr("nms_top_k", nms_top_k_);
+    op_desc->SetAttr("nms_threshold", nms_threshold_);
+    op_desc->SetAttr("nms_eta", nms_eta_);
+    op_desc->SetAttr("keep_top_k", keep_top_k_);
+  }
+
+  void PrepareData() override {
+    for (size_t l = 0; l < num_anchors_.size(); ++l) {
+      int num_anchors = num_anchors_[l];
+      DDim scores_dims({batch_size_, num_anchors, class_num_});
+      DDim bboxes_dims({batch_size_, num_anchors, 4});
+      DDim anchors_dims({num_anchors, 4});
+
+      // The scores are rounded, so that there are ties.
+      std::vector<float> scores(scores_dims.production());
+      fill_data_rand(scores.data(), 0.f, 1.f, scores.size());
+      for (auto& score : scores) {
+        score = std::round(score * 20.f) / 20.f;
+      }
+      SetCommonTensor(scores_[l], scores_dims, scores.data());
+
+      std::vector<float> bboxes(bboxes_dims.production());
+      fill_data_rand(bboxes.data(), -0.5f, 0.5f, bboxes.size());
+      SetCommonTensor(bboxes_[l], bboxes_dims, bboxes.data());
+
+      std::vector<float> anchors(anchors_dims.production());
+      fill_data_rand(anchors.data(), 0.f, 160.f, anchors.size());
+      for (int a = 0; a < num_anchors; ++a) {
+        anchors[a * 4 + 2] = anchors[a * 4] + 8.f * (l + 1) + a % 16;
+        anchors[a * 4 + 3] = anchors[a * 4 + 1] + 8.f * (l + 1) + a % 8;
+      }
+      SetCommonTensor(anchors_[l], anchors_dims, anchors.data());
+    }
+
+    std::vector<float> im_info;
+    for (int i = 0; i < batch_size_; ++i) {
+      im_info.insert(im_info.end(), {240.f, 320.f, 1.5f});
+    }
+    SetCommonTensor(im_info_, DDim({batch_size_, 3}), im_info.data());
+  }
+};
+
+void TestRetinanetDetectionOutput(Place place, float abs_error) {
+  std::vector<int> num_anchors{300, 120, 30};
+  for (int class_num : {1, 4}) {
+    for (int nms_top_k : {50, 1000}) {
+      for (float nms_eta : {1.f, 0.9f}) {
+        for (int keep_top_k : {10, 100}) {
+          std::unique_ptr<arena::TestCase> tester(
+              new RetinanetDetectionOutputComputeTester(place,
+                                                        "def",
+                                                        2,
+                                                        num_anchors,
+                                                        class_num,
+                                                        nms_top_k,
+                                                        nms_eta,
+                                                        keep_top_k));
+          arena::Arena arena(std::move(tester), place, abs_error);
+          arena.TestPrecision();
+        }
+      }
+    }
+  }
+}
+
+TEST(retinanet_detection_output, precision) {
+  float abs_error = 2e-5;
+  Place place;
+#if defined(LITE_WITH_ARM) || defined(LITE_WITH_X86)
+  place = TARGET(kHost);
+#else
+  return;
+#endif
+
+  TestRetinanetDetectionOutput(place, abs_error);
+}
+
+}  // namespace lite
+}  // namespace paddle
@@ -14,7 +14,10 @@
 
 #include <gflags/gflags.h>
 #include <gtest/gtest.h>
+#include <cstdio>
+#include <string>
 #include "lite/core/context.h"
+#include "lite/core/kernel_tuner.h"
 #include "lite/core/profile/timer.h"
 #include "lite/operators/op_params.h"
 #include "lite/tests/utils/naive_math_impl.h"
@@ -478,6 +481,125 @@ void test_conv_int8(const DDim& dims_in,
                     float alpha = 1.f) {}
 #endif  // LITE_WITH_ARM
 
+#ifdef LITE_WITH_ARM
+// The kernel tuning prepares every candidate impl of an int8 out conv, which
+// must not rescale the relu6 clip of the others, e.g. the picked one.
+TEST(TestConvInt8Relu6, test_conv_tuned_vs_untuned) {
+  paddle::lite::DeviceInfo::Init();
+  const float six = 6.f;
+  const int ch = 16;
+  const std::string tuning_file = "conv_int8_relu6_tuning.txt";
+  std::remove(tuning_file.c_str());
+  for (auto& stride : {1, 2}) {
+    DDim dim_in({1, ch, 17, 17});
+    DDim dim_w({ch, ch, 3, 3});
+    ConvParam param;
+    get_conv_param<PRECISION(kInt8)>(
+        dim_w, 1, {stride, stride}, {1, 1, 1, 1}, {1, 1}, true, true, &param);
+    param.activation_param.has_active = true;
+    param.activation_param.active_type =
+        paddle::lite_api::ActivationType::kRelu6;
+    param.activation_param.Relu_clipped_coef = six;
+    // The clip is below the saturation of the int8 output.
+    std::vector<float> scale_in{1.f / 127};
+    std::vector<float> scale_out{2.f * six / 127};
+    std::vector<float> scale_w(ch, 1.f / 127);
+    param.input_scale = scale_in[0];
+    param.output_scale = scale_out[0];
+    param.weight_scale = scale_w;
+    param.x->Resize(dim_in);
+    DDim dim_out = compute_out_dim(dim_in, param);
+    param.output->Resize(dim_out);
+    paddle::lite::fill_tensor_rand(*param.x, -127, 127);
+    paddle::lite::fill_tensor_rand(*param.filter, -127, 127);
+    paddle::lite::fill_tensor_rand(*param.bias, -1.f, 1.f);
+
+    Tensor tin_fp32;
+    Tensor weight_fp32;
+    Tensor tout_basic_fp32;
+    Tensor tout_basic_int8;
+    tin_fp32.Resize(dim_in);
+    weight_fp32.Resize(dim_w);
+    tout_basic_fp32.Resize(dim_out);
+    tout_basic_int8.Resize(dim_out);
+    auto din_fp32 = tin_fp32.mutable_data<float>();
+    auto wptr_fp32 = weight_fp32.mutable_data<float>();
+    paddle::lite::arm::math::int8_to_fp32(param.x->data<int8_t>(),
+                                          din_fp32,
+                                          scale_in.data(),
+                                          1,
+                                          1,
+                                          dim_in.production());
+    paddle::lite::arm::math::int8_to_fp32(param.filter->data<int8_t>(),
+                                          wptr_fp32,
+                                          scale_w.data(),
+                                          ch,
+                                          1,
+                                          dim_w.count(1, 4));
+    fill_tensor_const(tout_basic_fp32, 0.f);
+    auto dout_basic_fp32 = tout_basic_fp32.mutable_data<float>();
+    conv_basic<float, float>(din_fp32,
+                             dout_basic_fp32,
+                             dim_in[0],
+                             dim_out[1],
+                             dim_out[2],
+                             dim_out[3],
+                             dim_in[1],
+                             dim_in[2],
+                             dim_in[3],
+                             wptr_fp32,
+                             param.bias->data<float>(),
+                             1,
+                             3,
+                             3,
+                             stride,
+                             stride,
+                             1,
+                             1,
+                             1,
+                             1,
+                             true,
+                             2,
+                             six,
+                             1.f);
+    paddle::lite::arm::math::fp32_to_int8(
+        dout_basic_fp32,
+        tout_basic_int8.mutable_data<int8_t>(),
+        scale_out.data(),
+        1,
+        1,
+        dim_out.production());
+
+    for (bool tuned : {false, true}) {
+      if (tuned) {
+        paddle::lite::KernelTuner::Global().Enable(tuning_file);
+      }
+      std::unique_ptr<paddle::lite::KernelContext> ctx(
+          new paddle::lite::KernelContext);
+      ctx->As<paddle::lite::ARMContext>().SetRunMode(
+          paddle::lite_api::PowerMode::LITE_POWER_NO_BIND, 1);
+      paddle::lite::kernels::arm::ConvCompute<PRECISION(kInt8),
+                                              PRECISION(kInt8)>
+          conv;
+      conv.SetContext(std::move(ctx));
+      conv.SetParam(param);
+      conv.PrepareForRun();
+      conv.Launch();
+      paddle::lite::KernelTuner::Global().Disable();
+
+      auto* out = param.output->data<int8_t>();
+      auto* basic = tout_basic_int8.data<int8_t>();
+      for (int i = 0; i < dim_out.production(); ++i) {
+        ASSERT_LE(std::abs(out[i] - basic[i]), 1)
+            << "stride: " << stride << ", tuned: " << tuned << ", i: " << i;
+      }
+    }
+    release_param(&param);
+  }
+  std::remove(tuning_file.c_str());
+}
+#endif  // LITE_WITH_ARM
+
 #if 1  /// 3x3dw
 TEST(TestConv3x3DWInt8, test_conv3x3_depthwise) {
   if (FLAGS_basic_test) {
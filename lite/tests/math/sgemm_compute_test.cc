@@ -14,11 +14,18 @@
 
 #include <gflags/gflags.h>
 #include <gtest/gtest.h>
+#include <functional>
+#include <string>
 #include "lite/tests/utils/fill_data.h"
 #include "lite/tests/utils/naive_math_impl.h"
 #ifdef LITE_WITH_ARM
 #include "lite/backends/arm/math/funcs.h"
 #endif  // LITE_WITH_ARM
+#ifdef LITE_WITH_X86
+#include "lite/backends/x86/math/blas.h"
+#include "lite/backends/x86/math/sgemm_kernel.h"
+#include "lite/backends/x86/parallel.h"
+#endif  // LITE_WITH_X86
 #include "lite/core/context.h"
 #include "lite/core/profile/timer.h"
 #include "lite/core/tensor.h"
@@ -40,9 +47,9 @@ DEFINE_int32(threads, 1, "threads num");
 DEFINE_int32(warmup, 0, "warmup times");
 DEFINE_int32(repeats, 1, "repeats times");
 
-#ifdef LITE_WITH_ARM
+#if defined(LITE_WITH_ARM) || defined(LITE_WITH_X86)
 // sgemm_test wiil not be operated except that it's
-// on arm backend.
+// on arm or x86 backend.
 DEFINE_bool(basic_test, true, "do all tests");
 #else
 DEFINE_bool(basic_test, false, "do all tests");
@@ -67,6 +74,26 @@ DEFINE_double(beta, 0.0, "beta");
 DEFINE_bool(flag_relu, false, "do relu");
 DEFINE_bool(flag_bias, false, "with bias");
 
+#ifdef LITE_WITH_X86
+bool check_sgemm_result(const Tensor& tc_basic, const Tensor& tc) {
+  double max_ratio = 0;
+  double max_diff = 0;
+  tensor_cmp_host(tc_basic, tc, max_ratio, max_diff);
+  LOG(INFO) << "compare result, max diff: " << max_diff
+            << ", max ratio: " << max_ratio;
+  if (std::abs(max_ratio) > 1e-4f && std::abs(max_diff) > 5e-5f) {
+    Tensor tdiff;
+    tdiff.set_precision(PRECISION(kFloat));
+    tdiff.Resize(tc.dims());
+    tensor_diff(tc_basic, tc, tdiff);
+    LOG(INFO) << "diff result: ";
+    print_tensor(tdiff);
+    return false;
+  }
+  return true;
+}
+#endif  // LITE_WITH_X86
+
 bool test_sgemm(bool tra,
                 bool trb,
                 int m,
@@ -81,6 +108,13 @@ bool test_sgemm(bool tra,
                 bool has_relu,
                 int cls,
                 int ths) {
+#if defined(LITE_WITH_X86) && !defined(LITE_WITH_ARM)
+  // The bias and the activation are fused by the x86 kernels, e.g. fc, not
+  // by sgemm.
+  if (has_bias || has_relu) {
+    return true;
+  }
+#endif
   int size_a = tra ? k * lda : m * lda;
   int size_b = trb ? n * ldb : k * ldb;
 
@@ -239,6 +273,84 @@ bool test_sgemm(bool tra,
       return false;
     }
   }
+#elif defined(LITE_WITH_X86)
+  //! compute with every kernel which can run on the cpu, and with the blas
+  //! library for comparison.
+  double ops = 2.0 * m * n * k;
+  paddle::lite::x86::SetNumThreads(ths);
+  auto kernels = paddle::lite::x86::math::GetSgemmKernels();
+  for (size_t idx = 0; idx <= kernels.size(); ++idx) {
+    std::string name;
+    std::function<void()> gemm;
+    if (idx < kernels.size()) {
+      auto* kernel = kernels[idx];
+      name = kernel->name;
+      gemm = [&, kernel]() {
+        paddle::lite::x86::math::SgemmImpl(*kernel,
+                                           tra,
+                                           trb,
+                                           m,
+                                           n,
+                                           k,
+                                           alpha,
+                                           da,
+                                           lda,
+                                           db,
+                                           ldb,
+                                           nullptr,
+                                           beta,
+                                           dc,
+                                           ldc);
+      };
+    } else {
+#ifdef PADDLE_WITH_MKLML
+      name = "mkl";
+      gemm = [&]() {
+        paddle::lite::x86::math::CBlas<float>::GEMM(
+            CblasRowMajor,
+            tra ? CblasTrans : CblasNoTrans,
+            trb ? CblasTrans : CblasNoTrans,
+            m,
+            n,
+            k,
+            alpha,
+            da,
+            lda,
+            db,
+            ldb,
+            beta,
+            dc,
+            ldc);
+      };
+#else
+      break;
+#endif
+    }
+    memcpy(dc, dc_backup, sizeof(float) * m * ldc);
+    for (int j = 0; j < FLAGS_warmup; ++j) {
+      gemm();
+    }
+    Timer t1;
+    for (int i = 0; i < FLAGS_repeats; ++i) {
+      if (i == FLAGS_repeats - 1) {
+        memcpy(dc, dc_backup, sizeof(float) * m * ldc);
+      }
+      t1.Start();
+      gemm();
+      t1.Stop();
+    }
+    LOG(INFO) << name << ", M: " << m << ", N: " << n << ", K: " << k
+              << ", threads: " << ths << ", GOPS: " << ops * 1e-9f
+              << " GOPS, avg time: " << t1.LapTimes().Avg()
+              << " ms, min time: " << t1.LapTimes().Min()
+              << " ms, mean GOPs: " << ops * 1e-6f / t1.LapTimes().Avg()
+              << " GOPs, max GOPs: " << ops * 1e-6f / t1.LapTimes().Min()
+              << " GOPs";
+    if (FLAGS_check_result && !check_sgemm_result(tc_basic, tc)) {
+      LOG(INFO) << name << " failed";
+      return false;
+    }
+  }
 #endif
   return true;
 }
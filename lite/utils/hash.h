@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #pragma once
+#include <cstdint>
 #include <functional>
 
 namespace paddle {
@@ -25,5 +26,17 @@ inline void CombineHash(const T& from, size_t* to) {
   *to ^= h(from) + 0x9e3779b9 + (*to << 6) + (*to >> 2);
 }
 
+// Combine a 64-bit value into the hash. The value is mixed by the finalizer
+// of MurmurHash3 first, so the small values such as the dims of tensors are
+// spread over all the bits.
+inline void CombineHash64(uint64_t from, uint64_t* to) {
+  from ^= from >> 33;
+  from *= 0xff51afd7ed558ccdULL;
+  from ^= from >> 33;
+  from *= 0xc4ceb9fe1a85ec53ULL;
+  from ^= from >> 33;
+  *to ^= from + 0x9e3779b97f4a7c15ULL + (*to << 6) + (*to >> 2);
+}
+
 }  // namespace lite
 }  // namespace paddle
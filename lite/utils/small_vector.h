@@ -0,0 +1,115 @@
+// Copyright (c) 2020 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+
+/*
+ * A vector of the trivial values which stores up to N values inline, so
+ * copying and resizing it never allocates on the heap unless it grows
+ * larger than N, in which case all the values are moved to a std::vector.
+ */
+template <typename T, size_t N>
+class SmallVector {
+  static_assert(std::is_trivial<T>::value,
+                "SmallVector only supports the trivial types");
+
+ public:
+  using value_type = T;
+  using size_type = size_t;
+  using reference = T &;
+  using const_reference = const T &;
+  using iterator = T *;
+  using const_iterator = const T *;
+
+  SmallVector() = default;
+
+  template <typename InputIt>
+  void assign(InputIt first, InputIt last) {
+    resize(static_cast<size_t>(std::distance(first, last)));
+    std::copy(first, last, begin());
+  }
+
+  void resize(size_t size, const T &value = T()) {
+    if (size <= N) {
+      if (!is_inline()) {
+        std::copy(heap_.begin(), heap_.begin() + size, inline_);
+        heap_.clear();
+      } else if (size > size_) {
+        std::fill(inline_ + size_, inline_ + size, value);
+      }
+    } else {
+      if (is_inline()) {
+        heap_.assign(inline_, inline_ + size_);
+      }
+      heap_.resize(size, value);
+    }
+    size_ = size;
+  }
+
+  void push_back(const T &value) {
+    resize(size_ + 1);
+    back() = value;
+  }
+
+  void clear() { resize(0); }
+
+  T *data() { return is_inline() ? inline_ : heap_.data(); }
+  const T *data() const { return is_inline() ? inline_ : heap_.data(); }
+
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  T &operator[](size_t i) { return data()[i]; }
+  const T &operator[](size_t i) const { return data()[i]; }
+
+  T &front() { return data()[0]; }
+  const T &front() const { return data()[0]; }
+  T &back() { return data()[size_ - 1]; }
+  const T &back() const { return data()[size_ - 1]; }
+
+  iterator begin() { return data(); }
+  iterator end() { return data() + size_; }
+  const_iterator begin() const { return data(); }
+  const_iterator end() const { return data() + size_; }
+
+  operator std::vector<T>() const { return std::vector<T>(begin(), end()); }
+
+  friend bool operator==(const SmallVector &a, const SmallVector &b) {
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+  }
+
+  friend bool operator!=(const SmallVector &a, const SmallVector &b) {
+    return !(a == b);
+  }
+
+ private:
+  bool is_inline() const { return size_ <= N; }
+
+  size_t size_{0};
+  T inline_[N]{};
+  // Holds all the values if there are more than N ones.
+  std::vector<T> heap_;
+};
+
+}  // namespace lite
+}  // namespace paddle